@@ -0,0 +1,211 @@
+#include "async_writer.h"
+
+#include "benchmark.h"
+#include "filesystem.h"
+#include "log.h"
+#include "memory.h"
+
+#include <SDL2/SDL_error.h>
+#include <SDL2/SDL_mutex.h>
+#include <SDL2/SDL_thread.h>
+#include <stdio.h>
+#include <string.h>
+
+typedef struct {
+    char *path;
+    ASYNC_WRITER_ENCODE encode;
+    void *user_data;
+} M_JOB;
+
+static struct {
+    bool is_started;
+    SDL_Thread *thread;
+    SDL_mutex *mutex;
+    SDL_cond *cond;
+    bool is_busy;
+    bool is_failed;
+    bool quit;
+    M_JOB job;
+} m_Writer = {};
+
+static bool M_Run(M_JOB *job);
+static int M_WorkerThread(void *arg);
+static void M_Start(void);
+
+static bool M_Run(M_JOB *const job)
+{
+    BENCHMARK *const benchmark = Benchmark_Start();
+    bool result = false;
+    char *tmp_path = nullptr;
+
+    size_t size = 0;
+    char *const data = job->encode(job->user_data, &size);
+    job->user_data = nullptr;
+    if (data == nullptr) {
+        LOG_ERROR("Cannot encode %s", job->path);
+        goto cleanup;
+    }
+
+    const size_t tmp_path_size = strlen(job->path) + 5;
+    tmp_path = Memory_Alloc(tmp_path_size);
+    snprintf(tmp_path, tmp_path_size, "%s.tmp", job->path);
+
+    MYFILE *const fp = File_Open(tmp_path, FILE_OPEN_WRITE);
+    if (fp == nullptr) {
+        LOG_ERROR("Cannot open %s for writing", tmp_path);
+        goto cleanup;
+    }
+    File_WriteData(fp, data, size);
+    const bool is_complete = File_Pos(fp) == size;
+    File_Close(fp);
+
+    if (!is_complete) {
+        LOG_ERROR("Cannot write %s", tmp_path);
+        File_Delete(tmp_path);
+        goto cleanup;
+    }
+    if (!File_Rename(tmp_path, job->path)) {
+        LOG_ERROR("Cannot replace %s", job->path);
+        File_Delete(tmp_path);
+        goto cleanup;
+    }
+    result = true;
+
+cleanup:
+    Benchmark_End(benchmark, job->path);
+    Memory_FreePointer(&tmp_path);
+    Memory_Free(data);
+    Memory_FreePointer(&job->path);
+    return result;
+}
+
+static int M_WorkerThread(void *const arg)
+{
+    SDL_LockMutex(m_Writer.mutex);
+    while (true) {
+        while (!m_Writer.is_busy && !m_Writer.quit) {
+            SDL_CondWait(m_Writer.cond, m_Writer.mutex);
+        }
+        if (!m_Writer.is_busy) {
+            break;
+        }
+        SDL_UnlockMutex(m_Writer.mutex);
+
+        const bool result = M_Run(&m_Writer.job);
+
+        SDL_LockMutex(m_Writer.mutex);
+        m_Writer.is_busy = false;
+        if (!result) {
+            m_Writer.is_failed = true;
+        }
+        SDL_CondBroadcast(m_Writer.cond);
+    }
+    SDL_UnlockMutex(m_Writer.mutex);
+    return 0;
+}
+
+static void M_Start(void)
+{
+    if (m_Writer.is_started) {
+        return;
+    }
+    m_Writer.is_started = true;
+    m_Writer.quit = false;
+
+    m_Writer.mutex = SDL_CreateMutex();
+    m_Writer.cond = SDL_CreateCond();
+    if (m_Writer.mutex == nullptr || m_Writer.cond == nullptr) {
+        LOG_ERROR("Failed to create async writer: %s", SDL_GetError());
+        return;
+    }
+
+    m_Writer.thread = SDL_CreateThread(M_WorkerThread, "writer", nullptr);
+    if (m_Writer.thread == nullptr) {
+        LOG_ERROR("SDL_CreateThread(): %s", SDL_GetError());
+    }
+}
+
+void AsyncWriter_Submit(
+    const char *const path, const ASYNC_WRITER_ENCODE encode,
+    void *const user_data)
+{
+    M_Start();
+
+    const M_JOB job = {
+        .path = Memory_DupStr(path),
+        .encode = encode,
+        .user_data = user_data,
+    };
+
+    if (m_Writer.thread == nullptr) {
+        M_JOB sync_job = job;
+        if (!M_Run(&sync_job)) {
+            m_Writer.is_failed = true;
+        }
+        return;
+    }
+
+    SDL_LockMutex(m_Writer.mutex);
+    while (m_Writer.is_busy) {
+        SDL_CondWait(m_Writer.cond, m_Writer.mutex);
+    }
+    m_Writer.job = job;
+    m_Writer.is_busy = true;
+    SDL_CondBroadcast(m_Writer.cond);
+    SDL_UnlockMutex(m_Writer.mutex);
+}
+
+bool AsyncWriter_IsBusy(void)
+{
+    if (m_Writer.thread == nullptr) {
+        return false;
+    }
+    SDL_LockMutex(m_Writer.mutex);
+    const bool result = m_Writer.is_busy;
+    SDL_UnlockMutex(m_Writer.mutex);
+    return result;
+}
+
+bool AsyncWriter_Wait(void)
+{
+    if (m_Writer.thread == nullptr) {
+        const bool result = !m_Writer.is_failed;
+        m_Writer.is_failed = false;
+        return result;
+    }
+
+    SDL_LockMutex(m_Writer.mutex);
+    while (m_Writer.is_busy) {
+        SDL_CondWait(m_Writer.cond, m_Writer.mutex);
+    }
+    const bool result = !m_Writer.is_failed;
+    m_Writer.is_failed = false;
+    SDL_UnlockMutex(m_Writer.mutex);
+    return result;
+}
+
+void AsyncWriter_Shutdown(void)
+{
+    if (!m_Writer.is_started) {
+        return;
+    }
+
+    if (m_Writer.thread != nullptr) {
+        SDL_LockMutex(m_Writer.mutex);
+        m_Writer.quit = true;
+        SDL_CondBroadcast(m_Writer.cond);
+        SDL_UnlockMutex(m_Writer.mutex);
+        SDL_WaitThread(m_Writer.thread, nullptr);
+        m_Writer.thread = nullptr;
+    }
+    if (m_Writer.cond != nullptr) {
+        SDL_DestroyCond(m_Writer.cond);
+        m_Writer.cond = nullptr;
+    }
+    if (m_Writer.mutex != nullptr) {
+        SDL_DestroyMutex(m_Writer.mutex);
+        m_Writer.mutex = nullptr;
+    }
+    m_Writer.is_failed = false;
+    m_Writer.is_started = false;
+}
@@ -30,8 +30,7 @@ static void M_Log(
             Log_Message(file, line, func, "took %.02f ms", elapsed_start);
         } else {
             Log_Message(
-                file, line, func, "%s: took %.02f ms (%.02f ms)", message,
-                elapsed_start);
+                file, line, func, "%s: took %.02f ms", message, elapsed_start);
         }
     }
 }
@@ -60,3 +59,19 @@ void Benchmark_End_Impl(
     Benchmark_Tick_Impl(b, file, line, func, message);
     Memory_FreePointer(&b);
 }
+
+double Benchmark_Measure(
+    void (*const func)(void *user_data), void *const user_data,
+    const int32_t passes)
+{
+    if (passes <= 0) {
+        return 0.0;
+    }
+    const Uint64 start = SDL_GetPerformanceCounter();
+    for (int32_t i = 0; i < passes; i++) {
+        func(user_data);
+    }
+    const Uint64 elapsed = SDL_GetPerformanceCounter() - start;
+    return (double)elapsed * 1e9 / (double)SDL_GetPerformanceFrequency()
+        / passes;
+}
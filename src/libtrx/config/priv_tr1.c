@@ -219,6 +219,9 @@ void Config_Sanitize(void)
         g_Config.gameplay.turbo_speed, CLOCK_TURBO_SPEED_MIN,
         CLOCK_TURBO_SPEED_MAX);
     CLAMPL(g_Config.gameplay.maximum_save_slots, 0);
+    CLAMP(
+        g_Config.gameplay.maximum_active_enemies, 1,
+        CONFIG_MAX_ACTIVE_ENEMIES);
     CLAMPL(g_Config.rendering.anisotropy_filter, 1.0);
     CLAMP(g_Config.rendering.wireframe_width, 1.0, 100.0);
 
@@ -117,7 +117,11 @@ void Config_Sanitize(void)
     CLAMP(
         g_Config.gameplay.turbo_speed, CLOCK_TURBO_SPEED_MIN,
         CLOCK_TURBO_SPEED_MAX);
+    CLAMP(
+        g_Config.gameplay.maximum_active_enemies, 1,
+        CONFIG_MAX_ACTIVE_ENEMIES);
     CLAMP(g_Config.rendering.scaler, 1, 4);
+    CLAMP(g_Config.rendering.software_threads, 0, 64);
 
     if (g_Config.rendering.render_mode != RM_HARDWARE
         && g_Config.rendering.render_mode != RM_SOFTWARE) {
@@ -1,8 +1,13 @@
 #include "audio_internal.h"
 
+#include "benchmark.h"
 #include "debug.h"
+#include "filesystem.h"
+#include "hash.h"
 #include "log.h"
 #include "memory.h"
+#include "thread_pool.h"
+#include "utils.h"
 
 #include <SDL2/SDL_audio.h>
 #include <errno.h>
@@ -23,12 +28,24 @@
 #include <string.h>
 #include <time.h>
 
+// Playback positions are 32.32 fixed point numbers, so that pitch shifting
+// does not accumulate rounding errors over long or looped samples.
+#define POSITION_SHIFT 32
+#define POSITION_ONE ((uint64_t)1 << POSITION_SHIFT)
+#define POSITION_FRAC_MASK (POSITION_ONE - 1)
+#define MIX_BLOCK_SIZE 256
+#define SILENT_GAIN (1.0f / 65536.0f)
+
+#define CACHE_DIR "cache/samples"
+#define CACHE_MAGIC 0x53585254 // TRXS
+#define CACHE_FORMAT_VERSION 1
+
 typedef struct {
     char *original_data;
     size_t original_size;
 
+    // always mono, as we handle 3d sound ourselves
     float *sample_data;
-    int32_t channels;
     int32_t num_samples;
 } AUDIO_SAMPLE;
 
@@ -43,12 +60,21 @@ typedef struct {
     int32_t volume; // volume specified in hundredths of decibel
     int32_t pan; // pan specified in hundredths of decibel
 
-    // pitch shift means the same samples can be reused twice, hence float
-    float current_sample;
+    uint64_t position;
+    uint64_t step;
 
     AUDIO_SAMPLE *sample;
 } AUDIO_SAMPLE_SOUND;
 
+typedef struct {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t key;
+    uint64_t original_size;
+    int32_t num_samples;
+    int32_t reserved;
+} M_CACHE_HEADER;
+
 typedef struct {
     const char *data;
     const char *ptr;
@@ -59,12 +85,28 @@ typedef struct {
 static int32_t m_LoadedSamplesCount = 0;
 static AUDIO_SAMPLE m_LoadedSamples[AUDIO_MAX_SAMPLES] = {};
 static AUDIO_SAMPLE_SOUND m_Samples[AUDIO_MAX_ACTIVE_SAMPLES] = {};
+static bool m_IsInterpolated = false;
+static bool m_IsCacheEnabled = false;
+static THREAD_POOL *m_DecodePool = nullptr;
+static float m_VoiceBuffer[MIX_BLOCK_SIZE] = {};
 
 static double M_DecibelToMultiplier(double db_gain);
 static bool M_RecalculateChannelVolumes(int32_t sound_id);
 static int32_t M_ReadAVBuffer(void *opaque, uint8_t *dst, int32_t dst_size);
 static int64_t M_SeekAVBuffer(void *opaque, int64_t offset, int32_t whence);
 static bool M_Convert(const int32_t sample_id);
+static char *M_GetCachePath(uint64_t key);
+static bool M_ReadCache(AUDIO_SAMPLE *sample, uint64_t key);
+static void M_WriteCache(const AUDIO_SAMPLE *sample, uint64_t key);
+static void M_DecodeJob(void *user_data, int32_t job_idx, int32_t worker_idx);
+static uint64_t M_ConvertPitch(float pitch);
+static void M_Resample(
+    const AUDIO_SAMPLE *sample, uint64_t position, uint64_t step,
+    int32_t count, float *dst);
+static void M_Pan(
+    const float *src, int32_t count, float volume_l, float volume_r,
+    float *dst);
+static bool M_MixSound(AUDIO_SAMPLE_SOUND *sound, float *dst, int32_t count);
 
 static double M_DecibelToMultiplier(double db_gain)
 {
@@ -354,7 +396,6 @@ static bool M_Convert(const int32_t sample_id)
     int32_t sample_format_bytes = av_get_bytes_per_sample(swr.dst.format);
     sample->num_samples = working_buffer_size / sample_format_bytes
         / swr.dst.ch_layout.nb_channels;
-    sample->channels = swr.src.ch_layout.nb_channels;
     sample->sample_data = working_buffer;
     result = true;
 
@@ -391,7 +432,6 @@ cleanup:
         sample->original_data = nullptr;
         sample->original_size = 0;
         sample->num_samples = 0;
-        sample->channels = 0;
         Memory_FreePointer(&working_buffer);
     }
 
@@ -411,6 +451,220 @@ cleanup:
     return result;
 }
 
+static char *M_GetCachePath(const uint64_t key)
+{
+    const char *const fmt = CACHE_DIR "/%016llx.pcm";
+    const size_t out_size =
+        snprintf(nullptr, 0, fmt, (unsigned long long)key) + 1;
+    char *const out = Memory_Alloc(out_size);
+    snprintf(out, out_size, fmt, (unsigned long long)key);
+    return out;
+}
+
+static bool M_ReadCache(AUDIO_SAMPLE *const sample, const uint64_t key)
+{
+    char *path = M_GetCachePath(key);
+    MYFILE *fp = nullptr;
+    if (File_Exists(path)) {
+        fp = File_Open(path, FILE_OPEN_READ);
+    }
+    Memory_FreePointer(&path);
+    if (fp == nullptr) {
+        return false;
+    }
+
+    bool result = false;
+    M_CACHE_HEADER header;
+    const size_t file_size = File_Size(fp);
+    if (file_size < sizeof(header)) {
+        goto finish;
+    }
+
+    File_ReadData(fp, &header, sizeof(header));
+    if (header.magic != CACHE_MAGIC || header.version != CACHE_FORMAT_VERSION
+        || header.key != key || header.original_size != sample->original_size
+        || header.num_samples <= 0
+        || (size_t)header.num_samples
+            != (file_size - sizeof(header)) / sizeof(float)) {
+        goto finish;
+    }
+
+    sample->sample_data = Memory_Alloc(header.num_samples * sizeof(float));
+    sample->num_samples = header.num_samples;
+    File_ReadData(fp, sample->sample_data, header.num_samples * sizeof(float));
+    result = true;
+
+finish:
+    File_Close(fp);
+    return result;
+}
+
+static void M_WriteCache(const AUDIO_SAMPLE *const sample, const uint64_t key)
+{
+    // Write to a temporary file first, so that a crash or another process
+    // reading the cache never sees a partially written sample.
+    char *path = M_GetCachePath(key);
+    const size_t tmp_path_size = strlen(path) + 5;
+    char *tmp_path = Memory_Alloc(tmp_path_size);
+    snprintf(tmp_path, tmp_path_size, "%s.tmp", path);
+
+    MYFILE *const fp = File_Open(tmp_path, FILE_OPEN_WRITE);
+    if (fp == nullptr) {
+        LOG_ERROR("Cannot open %s for writing", tmp_path);
+        goto cleanup;
+    }
+
+    const M_CACHE_HEADER header = {
+        .magic = CACHE_MAGIC,
+        .version = CACHE_FORMAT_VERSION,
+        .key = key,
+        .original_size = sample->original_size,
+        .num_samples = sample->num_samples,
+    };
+    const size_t data_size = sample->num_samples * sizeof(float);
+    File_WriteData(fp, &header, sizeof(header));
+    File_WriteData(fp, sample->sample_data, data_size);
+    const bool is_complete = File_Pos(fp) == sizeof(header) + data_size;
+    File_Close(fp);
+
+    if (!is_complete) {
+        LOG_ERROR("Cannot write %s", tmp_path);
+        File_Delete(tmp_path);
+        goto cleanup;
+    }
+    if (!File_Rename(tmp_path, path)) {
+        LOG_ERROR("Cannot replace %s", path);
+        File_Delete(tmp_path);
+    }
+
+cleanup:
+    Memory_FreePointer(&tmp_path);
+    Memory_FreePointer(&path);
+}
+
+static void M_DecodeJob(
+    void *const user_data, const int32_t job_idx, const int32_t worker_idx)
+{
+    AUDIO_SAMPLE *const sample = &m_LoadedSamples[job_idx];
+    if (sample->original_data == nullptr || sample->sample_data != nullptr) {
+        return;
+    }
+
+    if (!m_IsCacheEnabled) {
+        M_Convert(job_idx);
+        return;
+    }
+
+    // the cache is keyed on the compressed bytes, so that a hit does not
+    // need to touch libav at all
+    const uint64_t key =
+        Hash_Update(HASH_SEED, sample->original_data, sample->original_size);
+    if (M_ReadCache(sample, key)) {
+        return;
+    }
+    if (M_Convert(job_idx) && sample->num_samples > 0) {
+        M_WriteCache(sample, key);
+    }
+}
+
+static uint64_t M_ConvertPitch(const float pitch)
+{
+    return pitch > 0.0f ? (uint64_t)((double)pitch * POSITION_ONE) : 0;
+}
+
+static void M_Resample(
+    const AUDIO_SAMPLE *const sample, uint64_t position, const uint64_t step,
+    const int32_t count, float *const dst)
+{
+    const float *const src = sample->sample_data;
+    const bool is_aligned = (position & POSITION_FRAC_MASK) == 0;
+    if (step == POSITION_ONE && (is_aligned || !m_IsInterpolated)) {
+        // unpitched sounds are by far the most common case
+        memcpy(dst, &src[position >> POSITION_SHIFT], count * sizeof(float));
+        return;
+    }
+
+    if (!m_IsInterpolated) {
+        for (int32_t i = 0; i < count; i++) {
+            dst[i] = src[position >> POSITION_SHIFT];
+            position += step;
+        }
+        return;
+    }
+
+    const int32_t last = sample->num_samples - 1;
+    for (int32_t i = 0; i < count; i++) {
+        const int32_t idx = position >> POSITION_SHIFT;
+        const float frac = (float)(position & POSITION_FRAC_MASK)
+            * (1.0f / (float)POSITION_ONE);
+        const float a = src[idx];
+        const float b = src[MIN(idx + 1, last)];
+        dst[i] = a + (b - a) * frac;
+        position += step;
+    }
+}
+
+static void M_Pan(
+    const float *const src, const int32_t count, const float volume_l,
+    const float volume_r, float *const dst)
+{
+    // kept free of branches and aliasing so that the compiler can vectorise
+    // it for whatever CPU we are built for
+    for (int32_t i = 0; i < count; i++) {
+        dst[i * 2 + 0] += src[i] * volume_l;
+        dst[i * 2 + 1] += src[i] * volume_r;
+    }
+}
+
+// Returns false once a non-looped sound has played to the end.
+static bool M_MixSound(
+    AUDIO_SAMPLE_SOUND *const sound, float *dst, int32_t count)
+{
+    const AUDIO_SAMPLE *const sample = sound->sample;
+    if (sample->sample_data == nullptr || sample->num_samples <= 0) {
+        return false;
+    }
+
+    // Inaudible sounds still advance so that they stay in sync if they
+    // become audible again, but skip all of the actual mixing.
+    const bool is_silent =
+        sound->volume_l < SILENT_GAIN && sound->volume_r < SILENT_GAIN;
+    const uint64_t end = (uint64_t)sample->num_samples << POSITION_SHIFT;
+    const uint64_t step = sound->step;
+
+    while (count > 0) {
+        int32_t block_size = MIN(count, MIX_BLOCK_SIZE);
+        if (step > 0) {
+            const uint64_t remaining =
+                (end - sound->position + step - 1) / step;
+            if (remaining < (uint64_t)block_size) {
+                block_size = remaining;
+            }
+        }
+
+        if (!is_silent) {
+            M_Resample(
+                sample, sound->position, step, block_size, m_VoiceBuffer);
+            M_Pan(
+                m_VoiceBuffer, block_size, sound->volume_l, sound->volume_r,
+                dst);
+        }
+
+        sound->position += step * block_size;
+        dst += block_size * AUDIO_WORKING_CHANNELS;
+        count -= block_size;
+
+        if (sound->position >= end) {
+            if (!sound->is_looped) {
+                return false;
+            }
+            sound->position %= end;
+        }
+    }
+
+    return true;
+}
+
 void Audio_Sample_Init(void)
 {
     for (int32_t sound_id = 0; sound_id < AUDIO_MAX_ACTIVE_SAMPLES;
@@ -421,7 +675,8 @@ void Audio_Sample_Init(void)
         sound->volume = 0.0f;
         sound->pitch = 1.0f;
         sound->pan = 0.0f;
-        sound->current_sample = 0.0f;
+        sound->position = 0;
+        sound->step = POSITION_ONE;
         sound->sample = nullptr;
     }
 }
@@ -434,6 +689,8 @@ void Audio_Sample_Shutdown(void)
 
     Audio_Sample_CloseAll();
     Audio_Sample_UnloadAll();
+    ThreadPool_Free(m_DecodePool);
+    m_DecodePool = nullptr;
 }
 
 bool Audio_Sample_Unload(const int32_t sample_id)
@@ -526,8 +783,39 @@ bool Audio_Sample_LoadMany(size_t count, const char **contents, size_t *sizes)
     }
     if (!result) {
         Audio_Sample_UnloadAll();
+        return false;
     }
-    return result;
+    return Audio_Sample_DecodeAll();
+}
+
+bool Audio_Sample_DecodeAll(void)
+{
+    if (!g_AudioDeviceID) {
+        return false;
+    }
+
+    BENCHMARK *const benchmark = Benchmark_Start();
+    if (m_IsCacheEnabled) {
+        File_CreateDirectory("cache");
+        File_CreateDirectory(CACHE_DIR);
+    }
+
+    // Every sample decodes into its own slot, so the jobs need no locking.
+    // Nothing can be playing these samples yet either, as they have only
+    // just been loaded. The pool lives until the audio shutdown, so that
+    // level loads do not keep spawning and joining threads.
+    if (m_DecodePool == nullptr) {
+        m_DecodePool = ThreadPool_Create(ThreadPool_GetCPUCount());
+    }
+    ThreadPool_Run(m_DecodePool, M_DecodeJob, nullptr, m_LoadedSamplesCount);
+
+    Benchmark_End(benchmark, nullptr);
+    return true;
+}
+
+void Audio_Sample_SetCacheEnabled(const bool is_enabled)
+{
+    m_IsCacheEnabled = is_enabled;
 }
 
 int32_t Audio_Sample_Play(
@@ -561,7 +849,8 @@ int32_t Audio_Sample_Play(
         sound->pitch = pitch;
         sound->pan = pan;
         sound->is_looped = is_looped;
-        sound->current_sample = 0.0f;
+        sound->position = 0;
+        sound->step = M_ConvertPitch(pitch);
         sound->sample = &m_LoadedSamples[sample_id];
 
         M_RecalculateChannelVolumes(sound_id);
@@ -720,14 +1009,29 @@ bool Audio_Sample_SetPitch(int32_t sound_id, float pitch)
 
     SDL_LockAudioDevice(g_AudioDeviceID);
     m_Samples[sound_id].pitch = pitch;
+    m_Samples[sound_id].step = M_ConvertPitch(pitch);
     M_RecalculateChannelVolumes(sound_id);
     SDL_UnlockAudioDevice(g_AudioDeviceID);
 
     return true;
 }
 
+void Audio_Sample_SetInterpolation(const bool is_enabled)
+{
+    if (!g_AudioDeviceID) {
+        m_IsInterpolated = is_enabled;
+        return;
+    }
+
+    SDL_LockAudioDevice(g_AudioDeviceID);
+    m_IsInterpolated = is_enabled;
+    SDL_UnlockAudioDevice(g_AudioDeviceID);
+}
+
 void Audio_Sample_Mix(float *dst_buffer, size_t len)
 {
+    const int32_t count = len / sizeof(float) / AUDIO_WORKING_CHANNELS;
+
     for (int32_t sound_id = 0; sound_id < AUDIO_MAX_ACTIVE_SAMPLES;
          sound_id++) {
         AUDIO_SAMPLE_SOUND *sound = &m_Samples[sound_id];
@@ -735,39 +1039,7 @@ void Audio_Sample_Mix(float *dst_buffer, size_t len)
             continue;
         }
 
-        int32_t samples_requested =
-            len / sizeof(AUDIO_WORKING_FORMAT) / AUDIO_WORKING_CHANNELS;
-        float src_sample_idx = sound->current_sample;
-        const float *src_buffer = sound->sample->sample_data;
-        float *dst_ptr = dst_buffer;
-
-        while ((dst_ptr - dst_buffer) / AUDIO_WORKING_CHANNELS
-               < samples_requested) {
-
-            // because we handle 3d sound ourselves, downmix to mono
-            float src_sample = 0.0f;
-            for (int32_t i = 0; i < sound->sample->channels; i++) {
-                src_sample += src_buffer
-                    [(int32_t)src_sample_idx * sound->sample->channels + i];
-            }
-            src_sample /= (float)sound->sample->channels;
-
-            *dst_ptr++ += src_sample * sound->volume_l;
-            *dst_ptr++ += src_sample * sound->volume_r;
-            src_sample_idx += sound->pitch;
-
-            if ((int32_t)src_sample_idx >= sound->sample->num_samples) {
-                if (sound->is_looped) {
-                    src_sample_idx = 0.0f;
-                } else {
-                    break;
-                }
-            }
-        }
-
-        sound->current_sample = src_sample_idx;
-        if (sound->current_sample >= sound->sample->num_samples
-            && !sound->is_looped) {
+        if (!M_MixSound(sound, dst_buffer, count)) {
             Audio_Sample_Close(sound_id);
         }
     }
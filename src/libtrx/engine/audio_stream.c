@@ -4,9 +4,13 @@
 #include "filesystem.h"
 #include "log.h"
 #include "memory.h"
+#include "utils.h"
 
+#include <SDL2/SDL_atomic.h>
 #include <SDL2/SDL_audio.h>
 #include <SDL2/SDL_error.h>
+#include <SDL2/SDL_mutex.h>
+#include <SDL2/SDL_thread.h>
 #include <errno.h>
 #include <libavcodec/avcodec.h>
 #include <libavcodec/codec.h>
@@ -24,13 +28,28 @@
 #include <stdio.h>
 #include <string.h>
 
-#define READ_BUFFER_SIZE                                                       \
-    (AUDIO_SAMPLES * AUDIO_WORKING_CHANNELS * sizeof(AUDIO_WORKING_FORMAT))
+// Capacity of the decoded PCM ring buffer of each stream in floats. Must be
+// a power of two. This holds about 0.75 s of stereo audio.
+#define RING_CAPACITY (1 << 16)
+#define RING_REFILL_THRESHOLD (RING_CAPACITY / 2)
+#define DECODER_IDLE_MS 20
+
+// A lock-free single-producer, single-consumer queue of float samples. The
+// positions run freely and are only masked on access, so the queue is empty
+// when they are equal and full when they are RING_CAPACITY apart.
+typedef struct {
+    float *data;
+    SDL_atomic_t read_pos;
+    SDL_atomic_t write_pos;
+} M_RING;
 
 typedef struct {
     bool is_used;
     bool is_playing;
-    bool is_read_done;
+    // Set by the mixer once the stream has played out. The stream is closed
+    // on the game thread, as closing joins the decoder thread.
+    bool is_finished;
+    SDL_atomic_t is_read_done;
     bool is_looped;
     float volume;
     double duration;
@@ -60,25 +79,109 @@ typedef struct {
         SwrContext *ctx;
     } swr;
 
+    // Resampled audio that did not fit into the ring buffer yet. Only
+    // touched by whoever holds the decoder mutex.
     struct {
-        SDL_AudioStream *stream;
-    } sdl;
+        float *data;
+        size_t capacity;
+        size_t size;
+        size_t pos;
+    } pending;
+
+    // The decoder thread owns all of the libav state above. The mixer only
+    // ever touches the ring buffer, so it never has to wait for a decode.
+    struct {
+        SDL_Thread *thread;
+        SDL_mutex *mutex;
+        SDL_sem *wake;
+        SDL_atomic_t quit;
+    } decoder;
+
+    M_RING ring;
+
+    struct {
+        int32_t underruns;
+        size_t min_fill;
+    } stats;
 } AUDIO_STREAM_SOUND;
 
 extern SDL_AudioDeviceID g_AudioDeviceID;
 
 static AUDIO_STREAM_SOUND m_Streams[AUDIO_MAX_ACTIVE_STREAMS] = {};
-static float m_MixBuffer[AUDIO_SAMPLES * AUDIO_WORKING_CHANNELS] = {};
 
-static size_t m_DecodeBufferCapacity = 0;
-static float *m_DecodeBuffer = nullptr;
+static size_t M_RingGetFill(M_RING *ring);
+static size_t M_RingWrite(M_RING *ring, const float *src, size_t count);
+static size_t M_RingMix(M_RING *ring, float *dst, size_t count, float volume);
+static void M_RingReset(M_RING *ring);
 
 static void M_SeekToStart(AUDIO_STREAM_SOUND *stream);
 static bool M_DecodeFrame(AUDIO_STREAM_SOUND *stream);
 static bool M_EnqueueFrame(AUDIO_STREAM_SOUND *stream);
+static bool M_FlushPending(AUDIO_STREAM_SOUND *stream);
+static bool M_Fill(AUDIO_STREAM_SOUND *stream);
+static int M_DecoderThread(void *arg);
+static bool M_StartDecoder(AUDIO_STREAM_SOUND *stream);
+static void M_StopDecoder(AUDIO_STREAM_SOUND *stream);
 static bool M_InitialiseFromPath(int32_t sound_id, const char *file_path);
 static void M_Clear(AUDIO_STREAM_SOUND *stream);
 
+static size_t M_RingGetFill(M_RING *const ring)
+{
+    const uint32_t read_pos = SDL_AtomicGet(&ring->read_pos);
+    const uint32_t write_pos = SDL_AtomicGet(&ring->write_pos);
+    return write_pos - read_pos;
+}
+
+static size_t M_RingWrite(
+    M_RING *const ring, const float *const src, size_t count)
+{
+    const uint32_t read_pos = SDL_AtomicGet(&ring->read_pos);
+    const uint32_t write_pos = SDL_AtomicGet(&ring->write_pos);
+    const size_t space = RING_CAPACITY - (uint32_t)(write_pos - read_pos);
+    if (count > space) {
+        count = space;
+    }
+
+    const size_t start = write_pos & (RING_CAPACITY - 1);
+    const size_t first = MIN(count, RING_CAPACITY - start);
+    memcpy(&ring->data[start], src, first * sizeof(float));
+    memcpy(ring->data, src + first, (count - first) * sizeof(float));
+
+    // publish the samples only after they have been written
+    SDL_AtomicSet(&ring->write_pos, write_pos + count);
+    return count;
+}
+
+static size_t M_RingMix(
+    M_RING *const ring, float *const dst, size_t count, const float volume)
+{
+    const uint32_t read_pos = SDL_AtomicGet(&ring->read_pos);
+    const uint32_t write_pos = SDL_AtomicGet(&ring->write_pos);
+    const size_t available = (uint32_t)(write_pos - read_pos);
+    if (count > available) {
+        count = available;
+    }
+
+    const size_t start = read_pos & (RING_CAPACITY - 1);
+    const size_t first = MIN(count, RING_CAPACITY - start);
+    const float *const src = &ring->data[start];
+    for (size_t i = 0; i < first; i++) {
+        dst[i] += src[i] * volume;
+    }
+    for (size_t i = first; i < count; i++) {
+        dst[i] += ring->data[i - first] * volume;
+    }
+
+    SDL_AtomicSet(&ring->read_pos, read_pos + count);
+    return count;
+}
+
+static void M_RingReset(M_RING *const ring)
+{
+    SDL_AtomicSet(&ring->read_pos, 0);
+    SDL_AtomicSet(&ring->write_pos, 0);
+}
+
 static void M_SeekToStart(AUDIO_STREAM_SOUND *stream)
 {
     ASSERT(stream != nullptr);
@@ -196,34 +299,26 @@ static bool M_EnqueueFrame(AUDIO_STREAM_SOUND *stream)
             (const uint8_t **)stream->av.frame->data,
             stream->av.frame->nb_samples);
 
-        size_t out_pos = 0;
         while (resampled_size > 0) {
-            const size_t out_buffer_size = av_samples_get_buffer_size(
-                nullptr, stream->swr.dst.ch_layout.nb_channels, resampled_size,
-                stream->swr.dst.format, 1);
-
-            if (out_pos + out_buffer_size > m_DecodeBufferCapacity) {
-                m_DecodeBufferCapacity = out_pos + out_buffer_size;
-                m_DecodeBuffer =
-                    Memory_Realloc(m_DecodeBuffer, m_DecodeBufferCapacity);
+            const size_t out_count =
+                resampled_size * stream->swr.dst.ch_layout.nb_channels;
+            const size_t new_size = stream->pending.size + out_count;
+            if (new_size > stream->pending.capacity) {
+                stream->pending.capacity = new_size;
+                stream->pending.data = Memory_Realloc(
+                    stream->pending.data, new_size * sizeof(float));
             }
-            if (m_DecodeBuffer != nullptr && out_buffer != nullptr) {
+            if (out_buffer != nullptr) {
                 memcpy(
-                    (uint8_t *)m_DecodeBuffer + out_pos, out_buffer,
-                    out_buffer_size);
+                    &stream->pending.data[stream->pending.size], out_buffer,
+                    out_count * sizeof(float));
             }
-            out_pos += out_buffer_size;
+            stream->pending.size = new_size;
 
             resampled_size = swr_convert(
                 stream->swr.ctx, &out_buffer, out_samples, nullptr, 0);
         }
 
-        if (SDL_AudioStreamPut(stream->sdl.stream, m_DecodeBuffer, out_pos)) {
-            LOG_ERROR("Got an error when decoding frame: %s", SDL_GetError());
-            av_frame_unref(stream->av.frame);
-            break;
-        }
-
         double time_base_sec = av_q2d(stream->av.stream->time_base);
         stream->timestamp =
             stream->av.frame->best_effort_timestamp * time_base_sec;
@@ -243,6 +338,102 @@ cleanup:
     return true;
 }
 
+static bool M_FlushPending(AUDIO_STREAM_SOUND *const stream)
+{
+    stream->pending.pos += M_RingWrite(
+        &stream->ring, &stream->pending.data[stream->pending.pos],
+        stream->pending.size - stream->pending.pos);
+    if (stream->pending.pos < stream->pending.size) {
+        return false;
+    }
+    stream->pending.pos = 0;
+    stream->pending.size = 0;
+    return true;
+}
+
+// Decodes a single packet. Returns false once the ring buffer is full or
+// there is nothing left to decode.
+static bool M_Fill(AUDIO_STREAM_SOUND *const stream)
+{
+    if (!M_FlushPending(stream) || SDL_AtomicGet(&stream->is_read_done)) {
+        return false;
+    }
+    if (M_DecodeFrame(stream)) {
+        M_EnqueueFrame(stream);
+    } else {
+        SDL_AtomicSet(&stream->is_read_done, 1);
+    }
+    return true;
+}
+
+static int M_DecoderThread(void *const arg)
+{
+    AUDIO_STREAM_SOUND *const stream = arg;
+    while (!SDL_AtomicGet(&stream->decoder.quit)) {
+        // Let go of the lock after every packet so that seeking never has to
+        // wait for long, as it also holds up the mixer.
+        SDL_LockMutex(stream->decoder.mutex);
+        const bool is_busy = M_Fill(stream);
+        SDL_UnlockMutex(stream->decoder.mutex);
+        if (!is_busy) {
+            SDL_SemWaitTimeout(stream->decoder.wake, DECODER_IDLE_MS);
+        }
+    }
+    return 0;
+}
+
+static bool M_StartDecoder(AUDIO_STREAM_SOUND *const stream)
+{
+    stream->ring.data = Memory_Alloc(RING_CAPACITY * sizeof(float));
+    M_RingReset(&stream->ring);
+    SDL_AtomicSet(&stream->decoder.quit, 0);
+
+    stream->decoder.mutex = SDL_CreateMutex();
+    stream->decoder.wake = SDL_CreateSemaphore(0);
+    if (stream->decoder.mutex == nullptr || stream->decoder.wake == nullptr) {
+        LOG_ERROR("Failed to create audio decoder: %s", SDL_GetError());
+        return false;
+    }
+
+    // Decode the first packet right away so that the stream can start
+    // playing before the decoder thread gets scheduled.
+    if (M_DecodeFrame(stream)) {
+        M_EnqueueFrame(stream);
+        M_FlushPending(stream);
+    }
+
+    stream->decoder.thread =
+        SDL_CreateThread(M_DecoderThread, "audio_stream", stream);
+    if (stream->decoder.thread == nullptr) {
+        LOG_ERROR("SDL_CreateThread(): %s", SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+static void M_StopDecoder(AUDIO_STREAM_SOUND *const stream)
+{
+    if (stream->decoder.thread != nullptr) {
+        SDL_AtomicSet(&stream->decoder.quit, 1);
+        SDL_SemPost(stream->decoder.wake);
+        SDL_WaitThread(stream->decoder.thread, nullptr);
+        stream->decoder.thread = nullptr;
+    }
+    if (stream->decoder.wake != nullptr) {
+        SDL_DestroySemaphore(stream->decoder.wake);
+        stream->decoder.wake = nullptr;
+    }
+    if (stream->decoder.mutex != nullptr) {
+        SDL_DestroyMutex(stream->decoder.mutex);
+        stream->decoder.mutex = nullptr;
+    }
+    Memory_FreePointer(&stream->ring.data);
+    Memory_FreePointer(&stream->pending.data);
+    stream->pending.capacity = 0;
+    stream->pending.size = 0;
+    stream->pending.pos = 0;
+}
+
 static bool M_InitialiseFromPath(int32_t sound_id, const char *file_path)
 {
     ASSERT(file_path != nullptr);
@@ -320,12 +511,7 @@ static bool M_InitialiseFromPath(int32_t sound_id, const char *file_path)
         goto cleanup;
     }
 
-    M_DecodeFrame(stream);
-
-    const int32_t sdl_sample_rate = stream->av.codec_ctx->sample_rate;
-    const int32_t sdl_channels = stream->av.codec_ctx->ch_layout.nb_channels;
-
-    stream->is_read_done = false;
+    SDL_AtomicSet(&stream->is_read_done, 0);
     stream->is_used = true;
     stream->is_playing = true;
     stream->is_looped = false;
@@ -337,17 +523,14 @@ static bool M_InitialiseFromPath(int32_t sound_id, const char *file_path)
         (double)stream->av.format_ctx->duration / (double)AV_TIME_BASE;
     stream->start_at = -1.0; // negative value means unset
     stream->stop_at = -1.0; // negative value means unset
+    stream->stats.underruns = 0;
+    stream->stats.min_fill = RING_CAPACITY;
 
-    stream->sdl.stream = SDL_NewAudioStream(
-        AUDIO_WORKING_FORMAT, sdl_channels, AUDIO_WORKING_RATE,
-        AUDIO_WORKING_FORMAT, sdl_channels, AUDIO_WORKING_RATE);
-    if (!stream->sdl.stream) {
-        LOG_ERROR("Failed to create SDL stream: %s", SDL_GetError());
+    if (!M_StartDecoder(stream)) {
         goto cleanup;
     }
 
     ret = true;
-    M_EnqueueFrame(stream);
 
 cleanup:
     if (error_code) {
@@ -371,12 +554,12 @@ static void M_Clear(AUDIO_STREAM_SOUND *stream)
 
     stream->is_used = false;
     stream->is_playing = false;
-    stream->is_read_done = true;
+    stream->is_finished = false;
+    SDL_AtomicSet(&stream->is_read_done, 1);
     stream->is_looped = false;
     stream->volume = 0.0f;
     stream->duration = 0.0;
     stream->timestamp = 0.0;
-    stream->sdl.stream = nullptr;
     stream->finish_callback = nullptr;
     stream->finish_callback_user_data = nullptr;
 }
@@ -391,8 +574,6 @@ void Audio_Stream_Init(void)
 
 void Audio_Stream_Shutdown(void)
 {
-    Memory_FreePointer(&m_DecodeBuffer);
-    m_DecodeBufferCapacity = 0;
     if (!g_AudioDeviceID) {
         return;
     }
@@ -445,6 +626,8 @@ int32_t Audio_Stream_CreateFromFile(const char *file_path)
 
     ASSERT(file_path != nullptr);
 
+    Audio_Stream_Update();
+
     for (int32_t sound_id = 0; sound_id < AUDIO_MAX_ACTIVE_STREAMS;
          sound_id++) {
         AUDIO_STREAM_SOUND *stream = &m_Streams[sound_id];
@@ -473,6 +656,16 @@ bool Audio_Stream_Close(int32_t sound_id)
 
     AUDIO_STREAM_SOUND *stream = &m_Streams[sound_id];
 
+    // the decoder thread must be gone before its libav state is freed
+    const bool had_decoder = stream->decoder.thread != nullptr;
+    M_StopDecoder(stream);
+    if (had_decoder) {
+        LOG_DEBUG(
+            "Audio stream %d closed: %d underruns, lowest buffer fill %d%%",
+            sound_id, stream->stats.underruns,
+            (int32_t)(stream->stats.min_fill * 100 / RING_CAPACITY));
+    }
+
     if (stream->av.codec_ctx) {
         // XXX: potential libav bug - avcodec_close should free this info
         if (stream->av.codec_ctx->extradata != nullptr) {
@@ -505,10 +698,6 @@ bool Audio_Stream_Close(int32_t sound_id)
     stream->av.stream = nullptr;
     stream->av.codec = nullptr;
 
-    if (stream->sdl.stream) {
-        SDL_FreeAudioStream(stream->sdl.stream);
-    }
-
     void (*finish_callback)(int32_t, void *) = stream->finish_callback;
     void *finish_callback_user_data = stream->finish_callback_user_data;
 
@@ -572,8 +761,27 @@ bool Audio_Stream_SetFinishCallback(
     return true;
 }
 
+void Audio_Stream_Update(void)
+{
+    if (!g_AudioDeviceID) {
+        return;
+    }
+
+    for (int32_t sound_id = 0; sound_id < AUDIO_MAX_ACTIVE_STREAMS;
+         sound_id++) {
+        SDL_LockAudioDevice(g_AudioDeviceID);
+        const bool is_finished = m_Streams[sound_id].is_finished;
+        SDL_UnlockAudioDevice(g_AudioDeviceID);
+        if (is_finished) {
+            Audio_Stream_Close(sound_id);
+        }
+    }
+}
+
 void Audio_Stream_Mix(float *dst_buffer, size_t len)
 {
+    const size_t count = len / sizeof(float);
+
     for (int32_t sound_id = 0; sound_id < AUDIO_MAX_ACTIVE_STREAMS;
          sound_id++) {
         AUDIO_STREAM_SOUND *stream = &m_Streams[sound_id];
@@ -581,68 +789,28 @@ void Audio_Stream_Mix(float *dst_buffer, size_t len)
             continue;
         }
 
-        while ((SDL_AudioStreamAvailable(stream->sdl.stream) < (int32_t)len)
-               && !stream->is_read_done) {
-            if (M_DecodeFrame(stream)) {
-                M_EnqueueFrame(stream);
-            } else {
-                stream->is_read_done = true;
-            }
-        }
-
-        memset(m_MixBuffer, 0, READ_BUFFER_SIZE);
-        int32_t bytes_gotten = SDL_AudioStreamGet(
-            stream->sdl.stream, m_MixBuffer, READ_BUFFER_SIZE);
-        if (bytes_gotten < 0) {
-            LOG_ERROR("Error reading from sdl.stream: %s", SDL_GetError());
-            stream->is_playing = false;
-            stream->is_used = false;
-            stream->is_read_done = true;
-        } else if (bytes_gotten == 0) {
+        // The decoder thread resamples everything to the working format, so
+        // all that is left to do here is to scale and add.
+        const size_t fill = M_RingGetFill(&stream->ring);
+        const bool is_read_done = SDL_AtomicGet(&stream->is_read_done);
+        if (fill == 0 && is_read_done) {
             // legit end of stream. looping is handled in
             // M_DecodeFrame
             stream->is_playing = false;
-            stream->is_used = false;
-            stream->is_read_done = true;
-        } else {
-            int32_t samples_gotten = bytes_gotten
-                / (AUDIO_WORKING_CHANNELS * sizeof(AUDIO_WORKING_FORMAT));
-
-            const float *src_ptr = &m_MixBuffer[0];
-            float *dst_ptr = dst_buffer;
-
-            const int32_t channels =
-                stream->av.codec_ctx->ch_layout.nb_channels;
-            if (channels == AUDIO_WORKING_CHANNELS) {
-                for (int32_t s = 0; s < samples_gotten; s++) {
-                    for (int32_t c = 0; c < AUDIO_WORKING_CHANNELS; c++) {
-                        *dst_ptr++ += *src_ptr++ * stream->volume;
-                    }
-                }
-            } else if (channels == 1) {
-                for (int32_t s = 0; s < samples_gotten; s++) {
-                    for (int32_t c = 0; c < AUDIO_WORKING_CHANNELS; c++) {
-                        *dst_ptr++ += *src_ptr * stream->volume;
-                    }
-                    src_ptr++;
-                }
-            } else {
-                for (int32_t s = 0; s < samples_gotten; s++) {
-                    // downmix to mono
-                    float src_sample = 0.0f;
-                    for (int32_t i = 0; i < channels; i++) {
-                        src_sample += *src_ptr++;
-                    }
-                    src_sample /= (float)channels;
-                    for (int32_t c = 0; c < AUDIO_WORKING_CHANNELS; c++) {
-                        *dst_ptr++ += src_sample * stream->volume;
-                    }
-                }
-            }
+            stream->is_finished = true;
+            continue;
         }
 
-        if (!stream->is_used) {
-            Audio_Stream_Close(sound_id);
+        if (fill < count && !is_read_done) {
+            stream->stats.underruns++;
+        }
+        if (fill < stream->stats.min_fill) {
+            stream->stats.min_fill = fill;
+        }
+
+        M_RingMix(&stream->ring, dst_buffer, count, stream->volume);
+        if (fill - MIN(fill, count) < RING_REFILL_THRESHOLD) {
+            SDL_SemPost(stream->decoder.wake);
         }
     }
 }
@@ -657,11 +825,19 @@ double Audio_Stream_GetTimestamp(int32_t sound_id)
     double timestamp = -1.0;
     AUDIO_STREAM_SOUND *stream = &m_Streams[sound_id];
 
-    if (stream->duration > 0.0) {
-        SDL_LockAudioDevice(g_AudioDeviceID);
-        timestamp = stream->timestamp;
-        SDL_UnlockAudioDevice(g_AudioDeviceID);
+    SDL_LockAudioDevice(g_AudioDeviceID);
+    if (stream->duration > 0.0 && stream->decoder.mutex != nullptr) {
+        // The decoder runs ahead of playback by whatever is still queued up
+        // in the ring buffer.
+        SDL_LockMutex(stream->decoder.mutex);
+        const size_t queued = M_RingGetFill(&stream->ring)
+            + stream->pending.size - stream->pending.pos;
+        timestamp = stream->timestamp
+            - (double)queued / (AUDIO_WORKING_RATE * AUDIO_WORKING_CHANNELS);
+        SDL_UnlockMutex(stream->decoder.mutex);
+        timestamp = MAX(timestamp, 0.0);
     }
+    SDL_UnlockAudioDevice(g_AudioDeviceID);
 
     return timestamp;
 }
@@ -688,13 +864,23 @@ bool Audio_Stream_SeekTimestamp(int32_t sound_id, double timestamp)
     }
 
     if (m_Streams[sound_id].is_playing) {
+        // Holding both locks keeps the mixer and the decoder away from the
+        // ring buffer while it gets thrown away.
         SDL_LockAudioDevice(g_AudioDeviceID);
         AUDIO_STREAM_SOUND *stream = &m_Streams[sound_id];
+        SDL_LockMutex(stream->decoder.mutex);
         const double time_base_sec = av_q2d(stream->av.stream->time_base);
         av_seek_frame(
             stream->av.format_ctx, 0, timestamp / time_base_sec,
             AVSEEK_FLAG_ANY);
         avcodec_flush_buffers(stream->av.codec_ctx);
+        stream->timestamp = timestamp;
+        stream->pending.size = 0;
+        stream->pending.pos = 0;
+        M_RingReset(&stream->ring);
+        SDL_AtomicSet(&stream->is_read_done, 0);
+        SDL_UnlockMutex(stream->decoder.mutex);
+        SDL_SemPost(stream->decoder.wake);
         SDL_UnlockAudioDevice(g_AudioDeviceID);
         return true;
     }
@@ -723,3 +909,25 @@ bool Audio_Stream_SetStopTimestamp(int32_t sound_id, double timestamp)
     m_Streams[sound_id].stop_at = timestamp;
     return true;
 }
+
+bool Audio_Stream_GetStats(
+    const int32_t sound_id, AUDIO_STREAM_STATS *const out_stats)
+{
+    if (!g_AudioDeviceID || sound_id < 0
+        || sound_id >= AUDIO_MAX_ACTIVE_STREAMS) {
+        return false;
+    }
+
+    SDL_LockAudioDevice(g_AudioDeviceID);
+    AUDIO_STREAM_SOUND *const stream = &m_Streams[sound_id];
+    const bool is_used = stream->is_used;
+    if (is_used) {
+        out_stats->underruns = stream->stats.underruns;
+        out_stats->buffer_fill =
+            (float)M_RingGetFill(&stream->ring) / RING_CAPACITY;
+        out_stats->min_buffer_fill =
+            (float)stream->stats.min_fill / RING_CAPACITY;
+    }
+    SDL_UnlockAudioDevice(g_AudioDeviceID);
+    return is_used;
+}
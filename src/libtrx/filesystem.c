@@ -13,6 +13,7 @@
 
 #if defined(_WIN32)
     #include <direct.h>
+    #include <windows.h>
     #define PATH_SEPARATOR "\\"
 #else
     #include <sys/stat.h>
@@ -444,3 +445,29 @@ void File_CreateDirectory(const char *path)
 #endif
     Memory_FreePointer(&full_path);
 }
+
+bool File_Delete(const char *const path)
+{
+    char *full_path = File_GetFullPath(path);
+    ASSERT(full_path != nullptr);
+    const bool result = remove(full_path) == 0;
+    Memory_FreePointer(&full_path);
+    return result;
+}
+
+bool File_Rename(const char *const old_path, const char *const new_path)
+{
+    char *old_full_path = File_GetFullPath(old_path);
+    char *new_full_path = File_GetFullPath(new_path);
+    ASSERT(old_full_path != nullptr);
+    ASSERT(new_full_path != nullptr);
+#if defined(_WIN32)
+    const bool result =
+        MoveFileExA(old_full_path, new_full_path, MOVEFILE_REPLACE_EXISTING);
+#else
+    const bool result = rename(old_full_path, new_full_path) == 0;
+#endif
+    Memory_FreePointer(&old_full_path);
+    Memory_FreePointer(&new_full_path);
+    return result;
+}
@@ -4,9 +4,12 @@
 #include "game/game_buf.h"
 #include "game/objects/common.h"
 #include "log.h"
+#include "memory.h"
 #include "utils.h"
 
 #include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
 
 #if TR_VERSION > 1
 typedef enum {
@@ -17,11 +20,19 @@ typedef enum {
 } ROT_PACK_MODE;
 #endif
 
+typedef struct {
+    uint32_t frame_ofs;
+    int32_t anim_idx;
+} FRAME_BASE_ENTRY;
+
 static ANIM_FRAME *m_Frames = nullptr;
 
 static int32_t M_GetAnimFrameCount(int32_t anim_idx, int32_t frame_data_length);
-static OBJECT *M_GetAnimObject(int32_t anim_idx);
-static ANIM_FRAME *M_FindFrameBase(uint32_t frame_ofs);
+static OBJECT **M_MapAnimObjects(int32_t anim_count);
+static int M_CompareFrameBases(const void *a, const void *b);
+static FRAME_BASE_ENTRY *M_IndexFrameBases(int32_t anim_count);
+static ANIM_FRAME *M_FindFrameBase(
+    const FRAME_BASE_ENTRY *index, int32_t anim_count, uint32_t frame_ofs);
 static int32_t M_ParseFrame(
     ANIM_FRAME *frame, const int16_t *data_ptr, int16_t mesh_count,
     uint8_t frame_size);
@@ -46,29 +57,65 @@ static int32_t M_GetAnimFrameCount(
 #endif
 }
 
-static OBJECT *M_GetAnimObject(const int32_t anim_idx)
+static OBJECT **M_MapAnimObjects(const int32_t anim_count)
 {
+    // Maps each animation to the first loaded object that starts with it, so
+    // that the frame loader does not have to scan every object per animation.
+    OBJECT **const objects = Memory_Alloc(sizeof(OBJECT *) * anim_count);
     for (int32_t i = 0; i < O_NUMBER_OF; i++) {
         OBJECT *const obj = Object_Get(i);
-        if (obj->loaded && obj->mesh_count >= 0 && obj->anim_idx == anim_idx) {
-            return obj;
+        if (obj->loaded && obj->mesh_count >= 0 && obj->anim_idx >= 0
+            && obj->anim_idx < anim_count
+            && objects[obj->anim_idx] == nullptr) {
+            objects[obj->anim_idx] = obj;
         }
     }
+    return objects;
+}
 
-    return nullptr;
+static int M_CompareFrameBases(const void *const a, const void *const b)
+{
+    const FRAME_BASE_ENTRY *const entry_a = a;
+    const FRAME_BASE_ENTRY *const entry_b = b;
+    if (entry_a->frame_ofs != entry_b->frame_ofs) {
+        return entry_a->frame_ofs < entry_b->frame_ofs ? -1 : 1;
+    }
+    return entry_a->anim_idx - entry_b->anim_idx;
 }
 
-static ANIM_FRAME *M_FindFrameBase(const uint32_t frame_ofs)
+static FRAME_BASE_ENTRY *M_IndexFrameBases(const int32_t anim_count)
 {
-    const int32_t anim_count = Anim_GetTotalCount();
+    FRAME_BASE_ENTRY *const index =
+        Memory_Alloc(sizeof(FRAME_BASE_ENTRY) * anim_count);
     for (int32_t i = 0; i < anim_count; i++) {
-        const ANIM *const anim = Anim_GetAnim(i);
-        if (anim->frame_ofs == frame_ofs) {
-            return anim->frame_ptr;
+        index[i].frame_ofs = Anim_GetAnim(i)->frame_ofs;
+        index[i].anim_idx = i;
+    }
+    qsort(index, anim_count, sizeof(FRAME_BASE_ENTRY), M_CompareFrameBases);
+    return index;
+}
+
+static ANIM_FRAME *M_FindFrameBase(
+    const FRAME_BASE_ENTRY *const index, const int32_t anim_count,
+    const uint32_t frame_ofs)
+{
+    // Find the first entry with the offset, which is the lowest animation
+    // index sharing it.
+    int32_t lo = 0;
+    int32_t hi = anim_count;
+    while (lo < hi) {
+        const int32_t mid = lo + (hi - lo) / 2;
+        if (index[mid].frame_ofs < frame_ofs) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
         }
     }
 
-    return nullptr;
+    if (lo == anim_count || index[lo].frame_ofs != frame_ofs) {
+        return nullptr;
+    }
+    return Anim_GetAnim(index[lo].anim_idx)->frame_ptr;
 }
 
 static int32_t M_ParseFrame(
@@ -166,11 +213,12 @@ void Anim_LoadFrames(const int16_t *data, const int32_t data_length)
     BENCHMARK *const benchmark = Benchmark_Start();
 
     const int32_t anim_count = Anim_GetTotalCount();
+    OBJECT **const anim_objects = M_MapAnimObjects(anim_count);
     OBJECT *cur_obj = nullptr;
     int32_t frame_idx = 0;
 
     for (int32_t i = 0; i < anim_count; i++) {
-        OBJECT *const next_obj = M_GetAnimObject(i);
+        OBJECT *const next_obj = anim_objects[i];
         const bool obj_changed = next_obj != nullptr;
         if (obj_changed) {
             cur_obj = next_obj;
@@ -197,15 +245,24 @@ void Anim_LoadFrames(const int16_t *data, const int32_t data_length)
         }
     }
 
+    Memory_Free(anim_objects);
+
     // Some OG data contains objects that point to the previous object's frames,
     // so ensure everything that's loaded is configured as such.
+    FRAME_BASE_ENTRY *const frame_bases = M_IndexFrameBases(anim_count);
     for (int32_t i = 0; i < O_NUMBER_OF; i++) {
         OBJECT *const obj = Object_Get(i);
         if (obj->loaded && obj->mesh_count >= 0 && obj->anim_idx == -1
             && obj->frame_base == nullptr) {
-            obj->frame_base = M_FindFrameBase(obj->frame_ofs);
+            obj->frame_base =
+                M_FindFrameBase(frame_bases, anim_count, obj->frame_ofs);
         }
     }
+    Memory_Free(frame_bases);
 
-    Benchmark_End(benchmark, nullptr);
+    char message[64];
+    snprintf(
+        message, sizeof(message), "%d animations, %d frames", anim_count,
+        frame_idx);
+    Benchmark_End(benchmark, message);
 }
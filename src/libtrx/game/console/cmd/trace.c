@@ -0,0 +1,49 @@
+#include "game/console/common.h"
+#include "game/console/registry.h"
+#include "game/game_string.h"
+#include "game/state_trace.h"
+#include "strings.h"
+
+#include <stdio.h>
+
+static COMMAND_RESULT M_Entrypoint(const COMMAND_CONTEXT *ctx);
+
+static COMMAND_RESULT M_Entrypoint(const COMMAND_CONTEXT *const ctx)
+{
+    if (String_IsEmpty(ctx->args)) {
+        const STATE_TRACE_STATUS status = StateTrace_GetStatus();
+        if (!status.is_active) {
+            Console_Log(GS(OSD_TRACE_NONE));
+        } else {
+            Console_Log(
+                GS(OSD_TRACE_STATUS), status.frame, status.checkpoint_count);
+        }
+        return CR_SUCCESS;
+    }
+
+    if (String_Equivalent(ctx->args, "stop")) {
+        const STATE_TRACE_STATUS status = StateTrace_GetStatus();
+        if (!status.is_active) {
+            Console_Log(GS(OSD_TRACE_NONE));
+            return CR_FAILURE;
+        }
+        StateTrace_Stop();
+        Console_Log(GS(OSD_TRACE_STOP), status.frame);
+        return CR_SUCCESS;
+    }
+
+    char path[256];
+    int32_t interval = STATE_TRACE_DEFAULT_INTERVAL;
+    const int32_t parsed = sscanf(ctx->args, "%255s %d", path, &interval);
+    if (parsed < 1 || interval <= 0) {
+        return CR_BAD_INVOCATION;
+    }
+    if (!StateTrace_StartRecording(path, interval)) {
+        Console_Log(GS(OSD_TRACE_FAIL), path);
+        return CR_FAILURE;
+    }
+    Console_Log(GS(OSD_TRACE_START), path, interval);
+    return CR_SUCCESS;
+}
+
+REGISTER_CONSOLE_COMMAND("trace", M_Entrypoint)
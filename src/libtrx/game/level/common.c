@@ -326,13 +326,11 @@ void Level_ReadTexturePages(
 #else
     const int32_t texture_size_16_bit =
         num_pages * TEXTURE_PAGE_SIZE * sizeof(uint16_t);
-    uint16_t *input = Memory_Alloc(texture_size_16_bit);
-    uint16_t *input_ptr = input;
-    VFile_Read(file, input, texture_size_16_bit);
+    const uint16_t *input =
+        VFile_ReadView(file, texture_size_16_bit, sizeof(uint16_t));
     for (int32_t i = 0; i < num_pages * TEXTURE_PAGE_SIZE; i++) {
-        *output++ = M_ARGB1555To8888(*input_ptr++);
+        *output++ = M_ARGB1555To8888(*input++);
     }
-    Memory_FreePointer(&input);
 #endif
 
     Benchmark_End(benchmark, nullptr);
@@ -447,11 +445,9 @@ void Level_ReadRooms(VFILE *const file)
     Room_InitialiseFlipStatus();
 
     const int32_t floor_data_size = VFile_ReadS32(file);
-    int16_t *floor_data = Memory_Alloc(sizeof(int16_t) * floor_data_size);
-    VFile_Read(file, floor_data, sizeof(int16_t) * floor_data_size);
-
+    const int16_t *const floor_data = VFile_ReadView(
+        file, sizeof(int16_t) * floor_data_size, sizeof(int16_t));
     Room_ParseFloorData(floor_data);
-    Memory_FreePointer(&floor_data);
 
 finish:
     Benchmark_End(benchmark, nullptr);
@@ -722,13 +718,13 @@ void Level_ReadAnimatedTextureRanges(
 void Level_ReadLightMap(VFILE *const file)
 {
     BENCHMARK *const benchmark = Benchmark_Start();
-    for (int32_t i = 0; i < 32; i++) {
+    for (int32_t i = 0; i < LIGHT_MAP_COUNT; i++) {
         LIGHT_MAP *const light_map = Output_GetLightMap(i);
         VFile_Read(file, light_map->index, sizeof(uint8_t) * 256);
         light_map->index[0] = 0;
     }
 
-    for (int32_t i = 0; i < 32; i++) {
+    for (int32_t i = 0; i < LIGHT_MAP_COUNT; i++) {
         const LIGHT_MAP *const light_map = Output_GetLightMap(i);
         for (int32_t j = 0; j < 256; j++) {
             SHADE_MAP *const shade_map = Output_GetShadeMap(j);
@@ -910,6 +906,7 @@ void Level_LoadObjectsAndItems(void)
     // have been processed. A cached item count must be used as individual
     // initialisations may increment the total item count.
     Object_SetupAllObjects();
+    Room_FlagObjectSectors();
 
     const int32_t item_count = Item_GetLevelCount();
     for (int32_t i = 0; i < item_count; i++) {
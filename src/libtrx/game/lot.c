@@ -0,0 +1,150 @@
+#include "game/lot.h"
+
+#include "game/const.h"
+#include "utils.h"
+
+#include <string.h>
+
+#define SHARED_SEARCH_SLOTS 8
+#define SHARED_SEARCH_TTL LOGIC_FPS
+
+typedef struct {
+    const LOT_INFO *lot;
+    const int16_t *zone;
+    int16_t target_box;
+    uint16_t search_num;
+    int32_t frame;
+} M_SHARED_SEARCH;
+
+static struct {
+    int32_t max_expansion;
+    int32_t total_budget;
+    int32_t frame;
+    int32_t budget;
+    int32_t searching;
+    int32_t last_searching;
+    int32_t next_shared;
+    M_SHARED_SEARCH shared[SHARED_SEARCH_SLOTS];
+} m_Search = {};
+
+static int32_t M_GetExpansion(void);
+static const M_SHARED_SEARCH *M_FindSharedSearch(
+    const LOT_INFO *lot, const int16_t *zone);
+static void M_ShareSearch(const LOT_INFO *lot, const int16_t *zone);
+static bool M_AdoptSearch(
+    LOT_INFO *lot, const int16_t *zone, int32_t box_count);
+
+static int32_t M_GetExpansion(void)
+{
+    // Split the frame budget evenly between the creatures that were still
+    // searching on the last frame, but never give anyone less than the
+    // original fixed expansion.
+    const int32_t share =
+        m_Search.total_budget / MAX(m_Search.last_searching, 1);
+    return MAX(MIN(share, m_Search.budget), m_Search.max_expansion);
+}
+
+static const M_SHARED_SEARCH *M_FindSharedSearch(
+    const LOT_INFO *const lot, const int16_t *const zone)
+{
+    for (int32_t i = 0; i < SHARED_SEARCH_SLOTS; i++) {
+        const M_SHARED_SEARCH *const shared = &m_Search.shared[i];
+        const LOT_INFO *const src = shared->lot;
+        if (src == nullptr || src == lot || shared->zone != zone
+            || shared->target_box != lot->required_box
+            || m_Search.frame - shared->frame > SHARED_SEARCH_TTL) {
+            continue;
+        }
+
+        // The source creature may have retargeted or its slot may have been
+        // reused since the search was shared.
+        if (src->head != NO_BOX || src->target_box != shared->target_box
+            || src->search_num != shared->search_num) {
+            continue;
+        }
+
+        if (src->step == lot->step && src->drop == lot->drop
+            && src->block_mask == lot->block_mask) {
+            return shared;
+        }
+    }
+    return nullptr;
+}
+
+static void M_ShareSearch(const LOT_INFO *const lot, const int16_t *const zone)
+{
+    M_SHARED_SEARCH *const shared = &m_Search.shared[m_Search.next_shared];
+    shared->lot = lot;
+    shared->zone = zone;
+    shared->target_box = lot->target_box;
+    shared->search_num = lot->search_num;
+    shared->frame = m_Search.frame;
+    m_Search.next_shared = (m_Search.next_shared + 1) % SHARED_SEARCH_SLOTS;
+}
+
+static bool M_AdoptSearch(
+    LOT_INFO *const lot, const int16_t *const zone, const int32_t box_count)
+{
+    const M_SHARED_SEARCH *const shared = M_FindSharedSearch(lot, zone);
+    if (shared == nullptr) {
+        return false;
+    }
+
+    // Drop whatever is left of our own search queue.
+    int16_t box_num = lot->head;
+    while (box_num != NO_BOX) {
+        BOX_NODE *const node = &lot->node[box_num];
+        box_num = node->next_expansion;
+        node->next_expansion = NO_BOX;
+    }
+
+    const LOT_INFO *const src = shared->lot;
+    for (int32_t i = 0; i < box_count; i++) {
+        lot->node[i].search_num = src->node[i].search_num;
+        lot->node[i].exit_box = src->node[i].exit_box;
+    }
+    lot->search_num = src->search_num;
+    lot->target_box = src->target_box;
+    // The adopted search is finished, so our queue is empty. A stale tail
+    // would stop Box_UpdateLOT from queueing that box on the next retarget.
+    lot->head = NO_BOX;
+    lot->tail = NO_BOX;
+    return true;
+}
+
+void LOT_ResetSearch(const int32_t max_expansion, const int32_t slot_count)
+{
+    memset(&m_Search, 0, sizeof(m_Search));
+    m_Search.max_expansion = max_expansion;
+    m_Search.total_budget = max_expansion * slot_count;
+    m_Search.budget = m_Search.total_budget;
+}
+
+void LOT_StartSearchFrame(void)
+{
+    m_Search.frame++;
+    m_Search.last_searching = m_Search.searching;
+    m_Search.searching = 0;
+    m_Search.budget = m_Search.total_budget;
+}
+
+void LOT_UpdateSharedSearch(
+    LOT_INFO *const lot, const int16_t *const zone, const int32_t box_count)
+{
+    const bool is_retargeting =
+        lot->required_box != NO_BOX && lot->required_box != lot->target_box;
+    if (is_retargeting && M_AdoptSearch(lot, zone, box_count)) {
+        return;
+    }
+
+    const bool is_searching = is_retargeting || lot->head != NO_BOX;
+    const int32_t expansion = M_GetExpansion();
+    Box_UpdateLOT(lot, expansion);
+    m_Search.budget = MAX(m_Search.budget - expansion, 0);
+
+    if (lot->head != NO_BOX) {
+        m_Search.searching++;
+    } else if (is_searching) {
+        M_ShareSearch(lot, zone);
+    }
+}
@@ -16,7 +16,7 @@ static int32_t m_PaletteSize = 0;
 static RGB_888 *m_Palette8 = nullptr;
 static RGB_888 *m_Palette16 = nullptr;
 
-static LIGHT_MAP m_LightMap[32];
+static LIGHT_MAP m_LightMap[LIGHT_MAP_COUNT];
 static SHADE_MAP m_ShadeMap[256];
 
 static int32_t m_ObjectTextureCount = 0;
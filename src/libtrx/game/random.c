@@ -28,6 +28,11 @@ int32_t Random_GetControl(void)
     return (m_RandControl >> 10) & 0x7FFF;
 }
 
+int32_t Random_GetControlSeed(void)
+{
+    return m_RandControl;
+}
+
 void Random_SeedDraw(int32_t seed)
 {
     LOG_DEBUG("%d", seed);
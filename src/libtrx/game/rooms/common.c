@@ -8,6 +8,7 @@
 #include "game/rooms/const.h"
 #include "game/rooms/enum.h"
 #include "game/sound/common.h"
+#include "memory.h"
 #include "utils.h"
 
 #define FD_NULL_INDEX 0
@@ -26,64 +27,113 @@
     #define FD_LADDER_TYPE(t) ((t & 0x7F00) >> 8)
 #endif
 
+// Room lookup grid cells are 8×8 sectors, unless the grid would get too big.
+#define GRID_SHIFT (WALL_SHIFT + 3)
+#define GRID_MAX_CELLS 0x10000
+
+typedef struct {
+    bool is_valid;
+    int32_t shift;
+    int32_t min_x;
+    int32_t min_z;
+    int32_t size_x;
+    int32_t size_z;
+    // Rooms overlapping each cell, in ascending order, stored as one array
+    // with cell_start[i]..cell_start[i + 1] spanning cell i.
+    int32_t *cell_start;
+    int16_t *room_nums;
+} M_GRID;
+
 static int32_t m_RoomCount = 0;
 static ROOM *m_Rooms = nullptr;
 static bool m_FlipStatus = false;
 static int32_t m_FlipEffect = -1;
 static int32_t m_FlipTimer = 0;
 static int32_t m_FlipSlotFlags[MAX_FLIP_MAPS] = {};
+static M_GRID m_Grid = {};
 
+static int32_t M_CountTriggerCommands(
+    const int16_t *data, int32_t *out_camera_count);
 static const int16_t *M_ReadTrigger(
     const int16_t *data, int16_t fd_entry, SECTOR *sector);
 static void M_AddFlipItems(const ROOM *room);
 static void M_RemoveFlipItems(const ROOM *room);
+static BOUNDS_32 M_GetInnerBounds(const ROOM *room);
+static bool M_ContainsPos(const ROOM *room, int32_t x, int32_t y, int32_t z);
+static BOUNDS_32 M_GetGridBounds(int32_t room_num);
+static void M_FreeGrid(void);
+static void M_BuildGrid(void);
+
+static int32_t M_CountTriggerCommands(
+    const int16_t *data, int32_t *const out_camera_count)
+{
+    int32_t count = 0;
+    while (true) {
+        int16_t command = *data++;
+        count++;
+        if (FD_TRIG_CMD_TYPE(command) == TO_CAMERA) {
+            (*out_camera_count)++;
+            command = *data++;
+        }
+        if (FD_IS_DONE(command)) {
+            return count;
+        }
+    }
+}
 
 static const int16_t *M_ReadTrigger(
     const int16_t *data, const int16_t fd_entry, SECTOR *const sector)
 {
-    TRIGGER *const trigger = GameBuf_Alloc(sizeof(TRIGGER), GBUF_FLOOR_DATA);
-
     const int16_t trig_setup = *data++;
-    trigger->type = FD_TRIG_TYPE(fd_entry);
-    trigger->timer = FD_TRIG_TIMER(trig_setup);
-    trigger->one_shot = FD_TRIG_ONE_SHOT(trig_setup);
-    trigger->mask = FD_TRIG_MASK(trig_setup);
-    trigger->item_index = NO_ITEM;
-
-    if (trigger->type == TT_SWITCH || trigger->type == TT_KEY
-        || trigger->type == TT_PICKUP) {
+    const TRIGGER_TYPE type = FD_TRIG_TYPE(fd_entry);
+    int16_t item_index = NO_ITEM;
+
+    if (type == TT_SWITCH || type == TT_KEY || type == TT_PICKUP) {
         const int16_t item_data = *data++;
-        trigger->item_index = FD_TRIG_CMD_ARG(item_data);
+        item_index = FD_TRIG_CMD_ARG(item_data);
         if (FD_IS_DONE(item_data)) {
             return data;
         }
     }
 
-    TRIGGER_CMD *cmd;
+    // The commands and their camera data are stored in a single block after
+    // the trigger, so walking them does not jump around memory.
+    int32_t camera_count = 0;
+    const int32_t cmd_count = M_CountTriggerCommands(data, &camera_count);
+    const size_t cmds_size = cmd_count * sizeof(TRIGGER_CMD)
+        + camera_count * sizeof(TRIGGER_CAMERA_DATA);
+
+    TRIGGER_CMD *cmds;
     if (sector->trigger == nullptr) {
+        TRIGGER *const trigger =
+            GameBuf_Alloc(sizeof(TRIGGER) + cmds_size, GBUF_FLOOR_DATA);
+        trigger->type = type;
+        trigger->timer = FD_TRIG_TIMER(trig_setup);
+        trigger->one_shot = FD_TRIG_ONE_SHOT(trig_setup);
+        trigger->mask = FD_TRIG_MASK(trig_setup);
+        trigger->item_index = item_index;
+        cmds = (TRIGGER_CMD *)(trigger + 1);
+        trigger->command = cmds;
         sector->trigger = trigger;
-        sector->trigger->command =
-            GameBuf_Alloc(sizeof(TRIGGER_CMD), GBUF_FLOOR_DATA);
-        cmd = sector->trigger->command;
     } else {
         // Some old TRLEs have incorrectly formatted floor data, with multiple
         // trigger entries defined where regular triggers overlap dummies. In
         // this case we link the new commands onto the old.
-        cmd = sector->trigger->command;
+        TRIGGER_CMD *cmd = sector->trigger->command;
         while (cmd->next_cmd != nullptr) {
             cmd = cmd->next_cmd;
         }
-        cmd->next_cmd = GameBuf_Alloc(sizeof(TRIGGER_CMD), GBUF_FLOOR_DATA);
-        cmd = cmd->next_cmd;
+        cmds = GameBuf_Alloc(cmds_size, GBUF_FLOOR_DATA);
+        cmd->next_cmd = cmds;
     }
 
-    while (true) {
+    TRIGGER_CAMERA_DATA *cam_data = (TRIGGER_CAMERA_DATA *)&cmds[cmd_count];
+    for (int32_t i = 0; i < cmd_count; i++) {
+        TRIGGER_CMD *const cmd = &cmds[i];
         int16_t command = *data++;
         cmd->type = FD_TRIG_CMD_TYPE(command);
 
         if (cmd->type == TO_CAMERA) {
-            TRIGGER_CAMERA_DATA *const cam_data =
-                GameBuf_Alloc(sizeof(TRIGGER_CAMERA_DATA), GBUF_FLOOR_DATA);
             cmd->parameter = (void *)cam_data;
             cam_data->camera_num = FD_TRIG_CMD_ARG(command);
 
@@ -91,17 +141,12 @@ static const int16_t *M_ReadTrigger(
             cam_data->timer = FD_TRIG_TIMER(command);
             cam_data->glide = FD_TRIG_CAM_GLIDE(command);
             cam_data->one_shot = FD_TRIG_ONE_SHOT(command);
+            cam_data++;
         } else {
             cmd->parameter = (void *)(intptr_t)FD_TRIG_CMD_ARG(command);
         }
 
-        if (FD_IS_DONE(command)) {
-            cmd->next_cmd = nullptr;
-            break;
-        }
-
-        cmd->next_cmd = GameBuf_Alloc(sizeof(TRIGGER_CMD), GBUF_FLOOR_DATA);
-        cmd = cmd->next_cmd;
+        cmd->next_cmd = i + 1 < cmd_count ? &cmds[i + 1] : nullptr;
     }
 
     return data;
@@ -170,8 +215,150 @@ static void M_RemoveFlipItems(const ROOM *const room)
     }
 }
 
+static BOUNDS_32 M_GetInnerBounds(const ROOM *const room)
+{
+    // The outermost sectors of a room are walls and are not part of it.
+    return (BOUNDS_32) {
+        .min.x = room->pos.x + WALL_L,
+        .max.x = room->pos.x + (room->size.x - 1) * WALL_L,
+        .min.y = room->max_ceiling,
+        .max.y = room->min_floor,
+        .min.z = room->pos.z + WALL_L,
+        .max.z = room->pos.z + (room->size.z - 1) * WALL_L,
+    };
+}
+
+static bool M_ContainsPos(
+    const ROOM *const room, const int32_t x, const int32_t y, const int32_t z)
+{
+    if (room->flip_status == RFS_FLIPPED) {
+        return false;
+    }
+    const BOUNDS_32 bounds = M_GetInnerBounds(room);
+    return x >= bounds.min.x && x < bounds.max.x && y >= bounds.min.y
+        && y <= bounds.max.y && z >= bounds.min.z && z < bounds.max.z;
+}
+
+// Flipping swaps the rooms between the two slots of a pair, and only the
+// slot that references the other one can hold the active room. Indexing that
+// slot over both rooms keeps the grid valid across flips.
+static BOUNDS_32 M_GetGridBounds(const int32_t room_num)
+{
+    const ROOM *const room = &m_Rooms[room_num];
+    BOUNDS_32 bounds = M_GetInnerBounds(room);
+    if (room->flipped_room < 0) {
+        return bounds;
+    }
+
+    const BOUNDS_32 flipped = M_GetInnerBounds(&m_Rooms[room->flipped_room]);
+    if (flipped.min.x >= flipped.max.x || flipped.min.z >= flipped.max.z) {
+        return bounds;
+    }
+    if (bounds.min.x >= bounds.max.x || bounds.min.z >= bounds.max.z) {
+        return flipped;
+    }
+    bounds.min.x = MIN(bounds.min.x, flipped.min.x);
+    bounds.min.z = MIN(bounds.min.z, flipped.min.z);
+    bounds.max.x = MAX(bounds.max.x, flipped.max.x);
+    bounds.max.z = MAX(bounds.max.z, flipped.max.z);
+    return bounds;
+}
+
+static void M_FreeGrid(void)
+{
+    Memory_FreePointer(&m_Grid.cell_start);
+    Memory_FreePointer(&m_Grid.room_nums);
+    m_Grid = (M_GRID) {};
+}
+
+static void M_BuildGrid(void)
+{
+    M_FreeGrid();
+    m_Grid.is_valid = true;
+
+    int32_t min_x = INT32_MAX;
+    int32_t min_z = INT32_MAX;
+    int32_t max_x = INT32_MIN;
+    int32_t max_z = INT32_MIN;
+    for (int32_t i = 0; i < m_RoomCount; i++) {
+        const BOUNDS_32 bounds = M_GetGridBounds(i);
+        if (bounds.min.x < bounds.max.x && bounds.min.z < bounds.max.z) {
+            min_x = MIN(min_x, bounds.min.x);
+            min_z = MIN(min_z, bounds.min.z);
+            max_x = MAX(max_x, bounds.max.x);
+            max_z = MAX(max_z, bounds.max.z);
+        }
+    }
+    if (min_x > max_x) {
+        return;
+    }
+
+    // Grow the cells for levels spread over a very large area.
+    m_Grid.shift = GRID_SHIFT;
+    while (true) {
+        m_Grid.size_x = ((max_x - 1 - min_x) >> m_Grid.shift) + 1;
+        m_Grid.size_z = ((max_z - 1 - min_z) >> m_Grid.shift) + 1;
+        if (m_Grid.size_x * m_Grid.size_z <= GRID_MAX_CELLS) {
+            break;
+        }
+        m_Grid.shift++;
+    }
+
+    m_Grid.min_x = min_x;
+    m_Grid.min_z = min_z;
+    const int32_t cell_count = m_Grid.size_x * m_Grid.size_z;
+    m_Grid.cell_start = Memory_Alloc(sizeof(int32_t) * (cell_count + 1));
+
+    // Count the rooms per cell, turn the counts into start offsets, then fill
+    // the cells walking the rooms in order so that each cell stays sorted.
+    for (int32_t pass = 0; pass < 2; pass++) {
+        for (int32_t i = 0; i < m_RoomCount; i++) {
+            const BOUNDS_32 bounds = M_GetGridBounds(i);
+            if (bounds.min.x >= bounds.max.x || bounds.min.z >= bounds.max.z) {
+                continue;
+            }
+            const int32_t cx1 = (bounds.min.x - min_x) >> m_Grid.shift;
+            const int32_t cx2 = (bounds.max.x - 1 - min_x) >> m_Grid.shift;
+            const int32_t cz1 = (bounds.min.z - min_z) >> m_Grid.shift;
+            const int32_t cz2 = (bounds.max.z - 1 - min_z) >> m_Grid.shift;
+            for (int32_t cz = cz1; cz <= cz2; cz++) {
+                for (int32_t cx = cx1; cx <= cx2; cx++) {
+                    const int32_t cell = cz * m_Grid.size_x + cx;
+                    if (pass == 0) {
+                        m_Grid.cell_start[cell + 1]++;
+                    } else {
+                        m_Grid.room_nums[m_Grid.cell_start[cell]++] = i;
+                    }
+                }
+            }
+        }
+
+        if (pass == 0) {
+            for (int32_t cell = 0; cell < cell_count; cell++) {
+                m_Grid.cell_start[cell + 1] += m_Grid.cell_start[cell];
+            }
+            m_Grid.room_nums = Memory_Alloc(
+                sizeof(int16_t) * MAX(m_Grid.cell_start[cell_count], 1));
+        }
+    }
+
+    // The fill pass advanced each start to the next cell's start.
+    for (int32_t cell = cell_count; cell > 0; cell--) {
+        m_Grid.cell_start[cell] = m_Grid.cell_start[cell - 1];
+    }
+    m_Grid.cell_start[0] = 0;
+}
+
+void Room_Shutdown(void)
+{
+    M_FreeGrid();
+    m_RoomCount = 0;
+    m_Rooms = nullptr;
+}
+
 void Room_InitialiseRooms(const int32_t num_rooms)
 {
+    M_FreeGrid();
     m_RoomCount = num_rooms;
     m_Rooms = num_rooms == 0
         ? nullptr
@@ -204,6 +391,7 @@ void Room_InitialiseFlipStatus(void)
         }
     }
 
+    Room_InvalidateLookup();
     m_FlipStatus = false;
     m_FlipEffect = -1;
     m_FlipTimer = 0;
@@ -302,7 +490,7 @@ void Room_PopulateSectorData(
     sector->floor.tilt = 0;
     sector->ceiling.tilt = 0;
     sector->portal_room.wall = NO_ROOM;
-    sector->is_death_sector = false;
+    sector->flags = 0;
     sector->trigger = nullptr;
 #if TR_VERSION == 2
     sector->ladder = LADDER_NONE;
@@ -331,7 +519,7 @@ void Room_PopulateSectorData(
             break;
 
         case FT_LAVA:
-            sector->is_death_sector = true;
+            sector->flags |= SF_DEATH;
             break;
 
         case FT_TRIGGER:
@@ -350,6 +538,46 @@ void Room_PopulateSectorData(
     } while (!FD_IS_DONE(fd_entry));
 }
 
+void Room_FlagObjectSectors(void)
+{
+    for (int32_t i = 0; i < Room_GetCount(); i++) {
+        const ROOM *const room = Room_Get(i);
+        for (int32_t j = 0; j < room->size.x * room->size.z; j++) {
+            SECTOR *const sector = &room->sectors[j];
+            sector->flags &= ~(SF_FLOOR_OBJECTS | SF_CEILING_OBJECTS);
+            if (sector->trigger == nullptr) {
+                continue;
+            }
+
+            const TRIGGER_CMD *cmd = sector->trigger->command;
+            for (; cmd != nullptr; cmd = cmd->next_cmd) {
+                if (cmd->type != TO_OBJECT) {
+                    continue;
+                }
+
+                const ITEM *const item =
+                    Item_Get((int16_t)(intptr_t)cmd->parameter);
+                const OBJECT *const obj = Object_Get(item->object_id);
+#if TR_VERSION == 1
+                if (obj->floor_height_func != nullptr) {
+                    sector->flags |= SF_FLOOR_OBJECTS;
+                }
+                if (obj->ceiling_height_func != nullptr) {
+                    sector->flags |= SF_CEILING_OBJECTS;
+                }
+#elif TR_VERSION == 2
+                if (obj->floor != nullptr) {
+                    sector->flags |= SF_FLOOR_OBJECTS;
+                }
+                if (obj->ceiling != nullptr) {
+                    sector->flags |= SF_CEILING_OBJECTS;
+                }
+#endif
+            }
+        }
+    }
+}
+
 int32_t Room_GetAdjoiningRooms(
     int16_t init_room_num, int16_t out_room_nums[],
     const int32_t max_room_num_count)
@@ -385,18 +613,36 @@ int16_t Room_GetIndexFromPos(const int32_t x, const int32_t y, const int32_t z)
 
 int32_t Room_FindByPos(const int32_t x, const int32_t y, const int32_t z)
 {
-    for (int32_t i = 0; i < Room_GetCount(); i++) {
-        const ROOM *const room = Room_Get(i);
-        if (room->flip_status == RFS_FLIPPED) {
-            continue;
+    if (!m_Grid.is_valid) {
+        M_BuildGrid();
+    }
+
+    if (x < m_Grid.min_x || z < m_Grid.min_z) {
+        return NO_ROOM_NEG;
+    }
+    const int32_t cx = (x - m_Grid.min_x) >> m_Grid.shift;
+    const int32_t cz = (z - m_Grid.min_z) >> m_Grid.shift;
+    if (cx >= m_Grid.size_x || cz >= m_Grid.size_z) {
+        return NO_ROOM_NEG;
+    }
+
+    const int32_t cell = cz * m_Grid.size_x + cx;
+    for (int32_t i = m_Grid.cell_start[cell]; i < m_Grid.cell_start[cell + 1];
+         i++) {
+        const int16_t room_num = m_Grid.room_nums[i];
+        if (M_ContainsPos(&m_Rooms[room_num], x, y, z)) {
+            return room_num;
         }
-        const int32_t x1 = room->pos.x + WALL_L;
-        const int32_t x2 = room->pos.x + (room->size.x - 1) * WALL_L;
-        const int32_t y1 = room->max_ceiling;
-        const int32_t y2 = room->min_floor;
-        const int32_t z1 = room->pos.z + WALL_L;
-        const int32_t z2 = room->pos.z + (room->size.z - 1) * WALL_L;
-        if (x >= x1 && x < x2 && y >= y1 && y <= y2 && z >= z1 && z < z2) {
+    }
+
+    return NO_ROOM_NEG;
+}
+
+int32_t Room_FindByPosLinear(
+    const int32_t x, const int32_t y, const int32_t z)
+{
+    for (int32_t i = 0; i < Room_GetCount(); i++) {
+        if (M_ContainsPos(Room_Get(i), x, y, z)) {
             return i;
         }
     }
@@ -404,6 +650,11 @@ int32_t Room_FindByPos(const int32_t x, const int32_t y, const int32_t z)
     return NO_ROOM_NEG;
 }
 
+void Room_InvalidateLookup(void)
+{
+    m_Grid.is_valid = false;
+}
+
 BOUNDS_32 Room_GetWorldBounds(void)
 {
     BOUNDS_32 bounds = {
@@ -62,7 +62,9 @@ static void M_SetupLibAV(void)
 
 static void M_SetupSDL(void)
 {
-    if (SDL_Init(SDL_INIT_EVENTS | SDL_INIT_VIDEO) < 0) {
+    const uint32_t flags =
+        Shell_IsHeadless() ? SDL_INIT_EVENTS : SDL_INIT_EVENTS | SDL_INIT_VIDEO;
+    if (SDL_Init(flags) < 0) {
         Shell_ExitSystemFmt("Cannot initialize SDL: %s", SDL_GetError());
     }
 }
@@ -81,6 +83,9 @@ static void M_SetupGL(void)
 static void M_ShowFatalError(const char *const message)
 {
     LOG_ERROR("%s", message);
+    if (Shell_IsHeadless()) {
+        Shell_Terminate(1);
+    }
     SDL_Window *const window = Shell_GetWindow();
     SDL_ShowSimpleMessageBox(
         SDL_MESSAGEBOX_ERROR, "Tomb Raider Error", message, window);
@@ -92,7 +97,9 @@ void Shell_Setup(void)
     M_SetupHiDPI();
     M_SetupLibAV();
     M_SetupSDL();
-    M_SetupGL();
+    if (!Shell_IsHeadless()) {
+        M_SetupGL();
+    }
 }
 
 void Shell_Terminate(int32_t exit_code)
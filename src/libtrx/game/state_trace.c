@@ -0,0 +1,480 @@
+#include "game/state_trace.h"
+
+#include "filesystem.h"
+#include "game/effects.h"
+#include "game/items.h"
+#include "game/lara/common.h"
+#include "game/objects/common.h"
+#include "game/random.h"
+#include "game/rooms.h"
+#include "hash.h"
+#include "log.h"
+#include "memory.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TRACE_HEADER "# TRX state trace"
+
+static const char *m_SubsystemNames[STATE_TRACE_NUMBER_OF] = {
+    [STATE_TRACE_ITEMS] = "items",
+    [STATE_TRACE_LARA] = "lara",
+    [STATE_TRACE_CREATURES] = "creatures",
+    [STATE_TRACE_EFFECTS] = "effects",
+    [STATE_TRACE_ROOMS] = "rooms",
+    [STATE_TRACE_RANDOM] = "random",
+};
+
+static struct {
+    bool is_active;
+    bool is_comparing;
+    int32_t interval;
+    int32_t frame;
+    int32_t checkpoint_count;
+    MYFILE *fp;
+
+    STATE_TRACE_CHECKPOINT *reference;
+    int32_t reference_count;
+    bool is_diverged;
+    int32_t diverged_frame;
+    uint32_t diverged_subsystems;
+} m_Trace = {};
+
+static uint64_t M_HashItems(void);
+static uint64_t M_HashLara(void);
+static uint64_t M_HashCreatures(void);
+static uint64_t M_HashEffects(void);
+static uint64_t M_HashRooms(void);
+static uint64_t M_HashRandom(void);
+static bool M_ParseCheckpoint(
+    const char *line, STATE_TRACE_CHECKPOINT *out_checkpoint);
+static bool M_LoadReference(const char *path);
+static void M_Write(const STATE_TRACE_CHECKPOINT *checkpoint);
+static void M_Compare(const STATE_TRACE_CHECKPOINT *checkpoint);
+
+static uint64_t M_HashItems(void)
+{
+    uint64_t hash = HASH_SEED;
+    for (int32_t i = 0; i < Item_GetTotalCount(); i++) {
+        const ITEM *const item = Item_Get(i);
+        const int32_t state[] = {
+            item->object_id,
+            item->status,
+            item->active,
+            item->gravity,
+            item->hit_status,
+            item->collidable,
+            item->flags,
+            item->timer,
+            item->hit_points,
+            item->current_anim_state,
+            item->goal_anim_state,
+            item->required_anim_state,
+            item->anim_num,
+            item->frame_num,
+            item->room_num,
+            item->speed,
+            item->fall_speed,
+            item->floor,
+            item->touch_bits,
+            item->mesh_bits,
+            item->pos.x,
+            item->pos.y,
+            item->pos.z,
+            item->rot.x,
+            item->rot.y,
+            item->rot.z,
+        };
+        hash = Hash_Update(hash, state, sizeof(state));
+    }
+    return hash;
+}
+
+static uint64_t M_HashLara(void)
+{
+    const LARA_INFO *const lara = Lara_GetLaraInfo();
+    const int32_t state[] = {
+        lara->item_num,
+        lara->gun_status,
+        lara->gun_type,
+        lara->request_gun_type,
+        lara->calc_fall_speed,
+        lara->water_status,
+        lara->pose_count,
+        lara->hit_frame,
+        lara->hit_direction,
+        lara->air,
+        lara->death_timer,
+        lara->current_active,
+        lara->hit_effect_count,
+        lara->water_surface_dist,
+        lara->mesh_effects,
+        lara->target != nullptr ? Item_GetIndex(lara->target) : -1,
+        lara->target_angles[0],
+        lara->target_angles[1],
+        lara->turn_rate,
+        lara->move_angle,
+        lara->head_rot.x,
+        lara->head_rot.y,
+        lara->head_rot.z,
+        lara->torso_rot.x,
+        lara->torso_rot.y,
+        lara->torso_rot.z,
+        lara->left_arm.frame_num,
+        lara->left_arm.lock,
+        lara->left_arm.rot.x,
+        lara->left_arm.rot.y,
+        lara->left_arm.rot.z,
+        lara->left_arm.flash_gun,
+        lara->right_arm.frame_num,
+        lara->right_arm.lock,
+        lara->right_arm.rot.x,
+        lara->right_arm.rot.y,
+        lara->right_arm.rot.z,
+        lara->right_arm.flash_gun,
+    };
+    return Hash_Update(HASH_SEED, state, sizeof(state));
+}
+
+static uint64_t M_HashCreatures(void)
+{
+    uint64_t hash = HASH_SEED;
+    for (int32_t i = 0; i < Item_GetTotalCount(); i++) {
+        const ITEM *const item = Item_Get(i);
+        if (item->data == nullptr || item->object_id < 0
+            || item->object_id >= O_NUMBER_OF
+            || !Object_Get(item->object_id)->intelligent) {
+            continue;
+        }
+
+        const CREATURE *const creature = item->data;
+        const LOT_INFO *const lot = &creature->lot;
+        const int32_t state[] = {
+            i,
+            creature->head_rotation,
+            creature->neck_rotation,
+            creature->maximum_turn,
+            creature->flags,
+            creature->item_num,
+            creature->mood,
+            creature->target.x,
+            creature->target.y,
+            creature->target.z,
+            lot->head,
+            lot->tail,
+            lot->search_num,
+            lot->block_mask,
+            lot->step,
+            lot->drop,
+            lot->fly,
+            lot->zone_count,
+            lot->target_box,
+            lot->required_box,
+            lot->target.x,
+            lot->target.y,
+            lot->target.z,
+        };
+        hash = Hash_Update(hash, state, sizeof(state));
+    }
+    return hash;
+}
+
+static uint64_t M_HashEffects(void)
+{
+    uint64_t hash = HASH_SEED;
+    int16_t effect_num = Effect_GetActiveNum();
+    while (effect_num != NO_EFFECT) {
+        const EFFECT *const effect = Effect_Get(effect_num);
+        const int32_t state[] = {
+            effect_num,
+            effect->object_id,
+            effect->room_num,
+            effect->speed,
+            effect->fall_speed,
+            effect->frame_num,
+            effect->counter,
+            effect->shade,
+            effect->pos.x,
+            effect->pos.y,
+            effect->pos.z,
+            effect->rot.x,
+            effect->rot.y,
+            effect->rot.z,
+        };
+        hash = Hash_Update(hash, state, sizeof(state));
+        effect_num = effect->next_active;
+    }
+    return hash;
+}
+
+static uint64_t M_HashRooms(void)
+{
+    int32_t state[3 + MAX_FLIP_MAPS] = {
+        Room_GetFlipStatus(),
+        Room_GetFlipEffect(),
+        Room_GetFlipTimer(),
+    };
+    for (int32_t i = 0; i < MAX_FLIP_MAPS; i++) {
+        state[3 + i] = Room_GetFlipSlotFlags(i);
+    }
+    return Hash_Update(HASH_SEED, state, sizeof(state));
+}
+
+static uint64_t M_HashRandom(void)
+{
+    // The draw RNG advances with rendering, so only the control RNG is
+    // deterministic across runs.
+    const int32_t seed = Random_GetControlSeed();
+    return Hash_Update(HASH_SEED, &seed, sizeof(seed));
+}
+
+static bool M_ParseCheckpoint(
+    const char *const line, STATE_TRACE_CHECKPOINT *const out_checkpoint)
+{
+    char *end;
+    out_checkpoint->frame = strtol(line, &end, 10);
+    if (end == line) {
+        return false;
+    }
+    for (int32_t i = 0; i < STATE_TRACE_NUMBER_OF; i++) {
+        const char *const start = end;
+        out_checkpoint->hashes[i] = strtoull(start, &end, 16);
+        if (end == start) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool M_LoadReference(const char *const path)
+{
+    char *data = nullptr;
+    if (!File_Load(path, &data, nullptr)) {
+        return false;
+    }
+
+    int32_t capacity = 64;
+    m_Trace.reference =
+        Memory_Alloc(sizeof(STATE_TRACE_CHECKPOINT) * capacity);
+    m_Trace.reference_count = 0;
+    m_Trace.interval = 0;
+
+    char *next_line = data;
+    while (next_line != nullptr) {
+        const char *const line = next_line;
+        next_line = strchr(next_line, '\n');
+        if (next_line != nullptr) {
+            *next_line++ = '\0';
+        }
+        if (line[0] == '#' || line[0] == '\0' || line[0] == '\r') {
+            continue;
+        }
+
+        if (sscanf(line, "interval %d", &m_Trace.interval) == 1) {
+            continue;
+        }
+
+        if (m_Trace.reference_count == capacity) {
+            capacity *= 2;
+            m_Trace.reference = Memory_Realloc(
+                m_Trace.reference, sizeof(STATE_TRACE_CHECKPOINT) * capacity);
+        }
+        STATE_TRACE_CHECKPOINT *const checkpoint =
+            &m_Trace.reference[m_Trace.reference_count];
+        if (!M_ParseCheckpoint(line, checkpoint)) {
+            LOG_ERROR("Malformed state trace line in %s: %s", path, line);
+            continue;
+        }
+        m_Trace.reference_count++;
+    }
+    Memory_FreePointer(&data);
+
+    if (m_Trace.interval <= 0) {
+        LOG_ERROR("State trace %s has no valid interval", path);
+        Memory_FreePointer(&m_Trace.reference);
+        return false;
+    }
+    LOG_INFO(
+        "Loaded %d state trace checkpoints from %s", m_Trace.reference_count,
+        path);
+    return true;
+}
+
+static void M_Write(const STATE_TRACE_CHECKPOINT *const checkpoint)
+{
+    char line[32 + 17 * STATE_TRACE_NUMBER_OF];
+    int32_t length = snprintf(line, sizeof(line), "%d", checkpoint->frame);
+    for (int32_t i = 0; i < STATE_TRACE_NUMBER_OF; i++) {
+        length += snprintf(
+            line + length, sizeof(line) - length, " %016llx",
+            (unsigned long long)checkpoint->hashes[i]);
+    }
+    line[length++] = '\n';
+    File_WriteData(m_Trace.fp, line, length);
+}
+
+static void M_Compare(const STATE_TRACE_CHECKPOINT *const checkpoint)
+{
+    if (m_Trace.is_diverged) {
+        return;
+    }
+
+    const int32_t idx = m_Trace.checkpoint_count - 1;
+    if (idx >= m_Trace.reference_count) {
+        // The run outlived the reference trace.
+        m_Trace.is_diverged = true;
+        m_Trace.diverged_frame = checkpoint->frame;
+        m_Trace.diverged_subsystems = 0;
+        LOG_ERROR(
+            "State diverged at frame %d: extra checkpoint", checkpoint->frame);
+        return;
+    }
+
+    const STATE_TRACE_CHECKPOINT *const reference = &m_Trace.reference[idx];
+    uint32_t diverged = 0;
+    for (int32_t i = 0; i < STATE_TRACE_NUMBER_OF; i++) {
+        if (reference->hashes[i] != checkpoint->hashes[i]) {
+            diverged |= 1 << i;
+        }
+    }
+    if (reference->frame != checkpoint->frame || diverged != 0) {
+        m_Trace.is_diverged = true;
+        m_Trace.diverged_frame = checkpoint->frame;
+        m_Trace.diverged_subsystems = diverged;
+        for (int32_t i = 0; i < STATE_TRACE_NUMBER_OF; i++) {
+            if (diverged & (1 << i)) {
+                LOG_ERROR(
+                    "State diverged at frame %d: %s", checkpoint->frame,
+                    m_SubsystemNames[i]);
+            }
+        }
+    }
+}
+
+const char *StateTrace_GetSubsystemName(const STATE_TRACE_SUBSYSTEM subsystem)
+{
+    return m_SubsystemNames[subsystem];
+}
+
+void StateTrace_Compute(STATE_TRACE_CHECKPOINT *const out_checkpoint)
+{
+    out_checkpoint->frame = m_Trace.frame;
+    out_checkpoint->hashes[STATE_TRACE_ITEMS] = M_HashItems();
+    out_checkpoint->hashes[STATE_TRACE_LARA] = M_HashLara();
+    out_checkpoint->hashes[STATE_TRACE_CREATURES] = M_HashCreatures();
+    out_checkpoint->hashes[STATE_TRACE_EFFECTS] = M_HashEffects();
+    out_checkpoint->hashes[STATE_TRACE_ROOMS] = M_HashRooms();
+    out_checkpoint->hashes[STATE_TRACE_RANDOM] = M_HashRandom();
+}
+
+bool StateTrace_StartRecording(const char *const path, const int32_t interval)
+{
+    StateTrace_Stop();
+    if (interval <= 0) {
+        LOG_ERROR("Invalid state trace interval: %d", interval);
+        return false;
+    }
+
+    m_Trace.fp = File_Open(path, FILE_OPEN_WRITE);
+    if (m_Trace.fp == nullptr) {
+        LOG_ERROR("Cannot open state trace %s", path);
+        return false;
+    }
+
+    char header[64];
+    const int32_t length = snprintf(
+        header, sizeof(header), TRACE_HEADER "\ninterval %d\n", interval);
+    File_WriteData(m_Trace.fp, header, length);
+
+    m_Trace.is_active = true;
+    m_Trace.is_comparing = false;
+    m_Trace.interval = interval;
+    m_Trace.frame = 0;
+    m_Trace.checkpoint_count = 0;
+    LOG_INFO("Recording state trace to %s every %d frames", path, interval);
+    return true;
+}
+
+bool StateTrace_StartComparing(const char *const path)
+{
+    StateTrace_Stop();
+    if (!M_LoadReference(path)) {
+        return false;
+    }
+
+    m_Trace.is_active = true;
+    m_Trace.is_comparing = true;
+    m_Trace.frame = 0;
+    m_Trace.checkpoint_count = 0;
+    m_Trace.is_diverged = false;
+    m_Trace.diverged_frame = -1;
+    m_Trace.diverged_subsystems = 0;
+    return true;
+}
+
+void StateTrace_Stop(void)
+{
+    if (!m_Trace.is_active) {
+        return;
+    }
+
+    if (m_Trace.fp != nullptr) {
+        File_Close(m_Trace.fp);
+        m_Trace.fp = nullptr;
+    }
+    if (m_Trace.is_comparing && !m_Trace.is_diverged
+        && m_Trace.checkpoint_count < m_Trace.reference_count) {
+        // The run ended before the reference trace did.
+        const int32_t frame =
+            m_Trace.reference[m_Trace.checkpoint_count].frame;
+        m_Trace.is_diverged = true;
+        m_Trace.diverged_frame = frame;
+        m_Trace.diverged_subsystems = 0;
+        LOG_ERROR(
+            "State diverged at frame %d: missing checkpoint (%d checkpoints, "
+            "expected %d)",
+            frame, m_Trace.checkpoint_count, m_Trace.reference_count);
+    }
+    // Keep reference_count around so that the status can still report it.
+    Memory_FreePointer(&m_Trace.reference);
+    m_Trace.is_active = false;
+    LOG_INFO(
+        "State trace stopped after %d frames (%d checkpoints)", m_Trace.frame,
+        m_Trace.checkpoint_count);
+}
+
+void StateTrace_Update(void)
+{
+    if (!m_Trace.is_active) {
+        return;
+    }
+
+    m_Trace.frame++;
+    if (m_Trace.frame % m_Trace.interval != 0) {
+        return;
+    }
+
+    STATE_TRACE_CHECKPOINT checkpoint;
+    StateTrace_Compute(&checkpoint);
+    m_Trace.checkpoint_count++;
+    if (m_Trace.is_comparing) {
+        M_Compare(&checkpoint);
+    } else {
+        M_Write(&checkpoint);
+    }
+}
+
+STATE_TRACE_STATUS StateTrace_GetStatus(void)
+{
+    return (STATE_TRACE_STATUS) {
+        .is_active = m_Trace.is_active,
+        .is_comparing = m_Trace.is_comparing,
+        .frame = m_Trace.frame,
+        .checkpoint_count = m_Trace.checkpoint_count,
+        .reference_count = m_Trace.is_comparing ? m_Trace.reference_count : 0,
+        .is_diverged = m_Trace.is_diverged,
+        .diverged_frame = m_Trace.diverged_frame,
+        .diverged_subsystems = m_Trace.diverged_subsystems,
+    };
+}
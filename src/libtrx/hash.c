@@ -0,0 +1,46 @@
+#include "hash.h"
+
+#include <string.h>
+
+#define HASH_PRIME 0x100000001B3ULL
+
+static uint32_t M_Rotate(uint32_t value, int32_t shift);
+
+static uint32_t M_Rotate(const uint32_t value, const int32_t shift)
+{
+    return (value << shift) | (value >> (32 - shift));
+}
+
+uint64_t Hash_Update(uint64_t hash, const void *const data, size_t size)
+{
+    const uint8_t *ptr = data;
+    while (size >= sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, ptr, sizeof(word));
+        hash = (hash ^ word) * HASH_PRIME;
+        ptr += sizeof(word);
+        size -= sizeof(word);
+    }
+    while (size > 0) {
+        hash = (hash ^ *ptr++) * HASH_PRIME;
+        size--;
+    }
+    return hash;
+}
+
+uint32_t Hash_Mix32(const uint32_t *const values, const size_t count)
+{
+    uint32_t hash = 0;
+    for (size_t i = 0; i < count; i++) {
+        hash ^= M_Rotate(values[i] * 0xCC9E2D51, 15) * 0x1B873593;
+        hash = M_Rotate(hash, 13) * 5 + 0xE6546B64;
+    }
+
+    hash ^= count * sizeof(uint32_t);
+    hash ^= hash >> 16;
+    hash *= 0x85EBCA6B;
+    hash ^= hash >> 13;
+    hash *= 0xC2B2AE35;
+    hash ^= hash >> 16;
+    return hash;
+}
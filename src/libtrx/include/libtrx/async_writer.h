@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stddef.h>
+
+// Writes files on a single background thread. The caller captures whatever
+// state it needs and hands it over together with an encoder, which runs on
+// the worker and turns it into the file contents. The data is first written
+// to a temporary file that then replaces the target, so a crash mid-write
+// never leaves a truncated file behind.
+
+// Returns the encoded data allocated with Memory_Alloc, or nullptr on
+// failure. The encoder owns user_data and must release it.
+typedef char *(*ASYNC_WRITER_ENCODE)(void *user_data, size_t *out_size);
+
+// Queues a write of the given path. Only one write is ever in flight; if the
+// previous one has not finished yet, this blocks until it does. If the
+// worker thread is unavailable, the write happens immediately.
+void AsyncWriter_Submit(
+    const char *path, ASYNC_WRITER_ENCODE encode, void *user_data);
+
+bool AsyncWriter_IsBusy(void);
+
+// Blocks until the pending write, if any, has finished. Returns false if the
+// last write failed; the failure is reported only once.
+bool AsyncWriter_Wait(void);
+
+// Finishes the pending write and stops the worker thread.
+void AsyncWriter_Shutdown(void);
@@ -22,3 +22,8 @@ void Benchmark_End_Impl(
 void Benchmark_Tick_Impl(
     BENCHMARK *b, const char *file, int32_t line, const char *func,
     const char *message);
+
+// Runs func the given number of times and returns the average duration of a
+// single run in nanoseconds.
+double Benchmark_Measure(
+    void (*func)(void *user_data), void *user_data, int32_t passes);
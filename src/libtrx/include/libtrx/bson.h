@@ -2,6 +2,9 @@
 
 #include "json.h"
 
+#include <stddef.h>
+#include <stdint.h>
+
 typedef enum {
     BSON_PARSE_ERROR_NONE = 0,
     BSON_PARSE_ERROR_INVALID_VALUE,
@@ -25,6 +28,144 @@ JSON_VALUE *BSON_ParseEx(
 
 const char *BSON_GetErrorDescription(BSON_PARSE_ERROR error);
 
+typedef enum {
+    BSON_TYPE_DOUBLE = 0x01,
+    BSON_TYPE_STRING = 0x02,
+    BSON_TYPE_OBJECT = 0x03,
+    BSON_TYPE_ARRAY = 0x04,
+    BSON_TYPE_BOOL = 0x08,
+    BSON_TYPE_NULL = 0x0A,
+    BSON_TYPE_INT32 = 0x10,
+} BSON_TYPE;
+
+// Iterates the fields of a BSON document or array in place. Nothing is
+// copied or allocated, so the data must outlive the reader and the fields it
+// returns. Malformed data stops the iteration and sets is_error.
+typedef struct {
+    const char *start;
+    const char *pos;
+    const char *end;
+    bool is_error;
+} BSON_READER;
+
+typedef struct {
+    BSON_TYPE type;
+    const char *key;
+    const char *value;
+    size_t value_size;
+} BSON_FIELD;
+
+bool BSON_ReaderInit(BSON_READER *reader, const char *data, size_t size);
+void BSON_ReaderRewind(BSON_READER *reader);
+bool BSON_ReaderNext(BSON_READER *reader, BSON_FIELD *field);
+// Returns the number of fields, or -1 if the data is malformed.
+int32_t BSON_ReaderCount(const BSON_READER *reader);
+
+// Keyed lookups scan the document from the start and are meant for small
+// documents; larger ones should be walked once with BSON_ReaderNext.
+bool BSON_ReaderFind(
+    const BSON_READER *reader, const char *key, BSON_FIELD *field);
+bool BSON_ReaderGetBool(const BSON_READER *reader, const char *key, bool d);
+int32_t BSON_ReaderGetInt(
+    const BSON_READER *reader, const char *key, int32_t d);
+double BSON_ReaderGetDouble(
+    const BSON_READER *reader, const char *key, double d);
+const char *BSON_ReaderGetString(
+    const BSON_READER *reader, const char *key, const char *d);
+bool BSON_ReaderGetObject(
+    const BSON_READER *reader, const char *key, BSON_READER *out);
+bool BSON_ReaderGetArray(
+    const BSON_READER *reader, const char *key, BSON_READER *out);
+
+// Value getters return the default if the field has a different type.
+// Doubles are truncated when read as integers.
+bool BSON_FieldGetBool(const BSON_FIELD *field, bool d);
+int32_t BSON_FieldGetInt(const BSON_FIELD *field, int32_t d);
+double BSON_FieldGetDouble(const BSON_FIELD *field, double d);
+const char *BSON_FieldGetString(const BSON_FIELD *field, const char *d);
+// Opens a nested document or array.
+bool BSON_FieldGetReader(const BSON_FIELD *field, BSON_READER *out);
+
+typedef enum {
+    BSON_DECODE_BOOL,
+    BSON_DECODE_INT,
+    BSON_DECODE_DOUBLE,
+} BSON_DECODE_TYPE;
+
+// Maps a key to a struct member, so that a document can be decoded straight
+// into a struct. Integers are stored according to the member size.
+typedef struct {
+    const char *key;
+    BSON_DECODE_TYPE type;
+    size_t offset;
+    size_t size;
+} BSON_DECODE_FIELD;
+
+#define BSON_DECODE_FIELD_EX(key_, type_, struct_, member)                     \
+    {                                                                          \
+        .key = key_,                                                           \
+        .type = type_,                                                         \
+        .offset = offsetof(struct_, member),                                   \
+        .size = sizeof(((struct_ *)nullptr)->member),                          \
+    }
+#define BSON_DECODE_BOOL_FIELD(key, struct_, member)                           \
+    BSON_DECODE_FIELD_EX(key, BSON_DECODE_BOOL, struct_, member)
+#define BSON_DECODE_INT_FIELD(key, struct_, member)                            \
+    BSON_DECODE_FIELD_EX(key, BSON_DECODE_INT, struct_, member)
+#define BSON_DECODE_DOUBLE_FIELD(key, struct_, member)                         \
+    BSON_DECODE_FIELD_EX(key, BSON_DECODE_DOUBLE, struct_, member)
+
+// Stores the field into the target if the table has a matching key, and
+// returns whether it did. Tables listed in the order the fields are written
+// are matched in constant time; hint carries the position between calls and
+// should start at 0.
+bool BSON_DecodeField(
+    const BSON_FIELD *field, const BSON_DECODE_FIELD *table,
+    int32_t table_size, void *target, int32_t *hint);
+
+// Decodes every field the table knows about and skips the rest. Members
+// without a matching field are left untouched.
+bool BSON_ReaderDecode(
+    BSON_READER *reader, const BSON_DECODE_FIELD *table, int32_t table_size,
+    void *target);
+
+#define BSON_WRITER_MAX_DEPTH 32
+
+// Builds a BSON document in a single pass. Documents and arrays are opened
+// with BSON_WriterBegin*, filled with the typed appends, and closed with
+// BSON_WriterEnd, which back-patches their length. Keys are ignored for the
+// root document and for array elements, which are keyed by their index.
+typedef struct {
+    char *data;
+    size_t size;
+    size_t capacity;
+    int32_t depth;
+    struct {
+        size_t offset;
+        // The index of the next array element, or -1 for objects.
+        int32_t next_idx;
+    } stack[BSON_WRITER_MAX_DEPTH];
+} BSON_WRITER;
+
+void BSON_WriterInit(BSON_WRITER *writer, size_t capacity);
+void BSON_WriterFree(BSON_WRITER *writer);
+
+void BSON_WriterBeginObject(BSON_WRITER *writer, const char *key);
+void BSON_WriterBeginArray(BSON_WRITER *writer, const char *key);
+void BSON_WriterEnd(BSON_WRITER *writer);
+
+void BSON_WriterAppendNull(BSON_WRITER *writer, const char *key);
+void BSON_WriterAppendBool(BSON_WRITER *writer, const char *key, bool value);
+void BSON_WriterAppendInt(BSON_WRITER *writer, const char *key, int32_t value);
+void BSON_WriterAppendDouble(
+    BSON_WRITER *writer, const char *key, double value);
+void BSON_WriterAppendString(
+    BSON_WRITER *writer, const char *key, const char *value);
+
+// Hands over the finished document, allocated with Memory_Alloc, and resets
+// the writer. The out_size parameter is optional.
+char *BSON_WriterFinish(BSON_WRITER *writer, size_t *out_size);
+
 /* Write out a BSON binary string. Return 0 if an error occurred (malformed
  * JSON input, or malloc failed). The out_size parameter is optional. */
 void *BSON_Write(const JSON_VALUE *value, size_t *out_size);
@@ -1,5 +1,7 @@
 #pragma once
 
+#define CONFIG_MAX_ACTIVE_ENEMIES 256
+
 #if TR_VERSION == 1
     #include "./types_tr1.h"
 #elif TR_VERSION == 2
@@ -124,6 +124,8 @@ typedef struct {
         bool enable_music_in_inventory;
         bool enable_ps_uzi_sfx;
         bool enable_pitched_sounds;
+        bool enable_sample_interpolation;
+        bool enable_sample_cache;
         bool load_music_triggers;
         UNDERWATER_MUSIC_MODE underwater_music_mode;
         MUSIC_LOAD_CONDITION music_load_condition;
@@ -165,6 +167,7 @@ typedef struct {
         bool enable_tr2_swimming;
         bool enable_tr2_swim_cancel;
         bool enable_swing_cancel;
+        bool enable_shared_pathfinding;
         bool fix_floor_data_issues;
         bool fix_descending_glitch;
         bool fix_wall_jump_glitch;
@@ -181,6 +184,7 @@ typedef struct {
         int32_t turbo_speed;
         int32_t start_lara_hitpoints;
         int32_t maximum_save_slots;
+        int32_t maximum_active_enemies;
         int32_t camera_speed;
         TARGET_LOCK_MODE target_mode;
     } gameplay;
@@ -62,6 +62,8 @@ typedef struct {
         int32_t sound_volume;
         int32_t music_volume;
         bool enable_lara_mic;
+        bool enable_sample_interpolation;
+        bool enable_sample_cache;
         UNDERWATER_MUSIC_MODE underwater_music_mode;
     } audio;
 
@@ -79,7 +81,9 @@ typedef struct {
         bool enable_console;
         bool enable_fmv;
         bool enable_auto_item_selection;
+        bool enable_shared_pathfinding;
         int32_t turbo_speed;
+        int32_t maximum_active_enemies;
     } gameplay;
 
     struct {
@@ -93,6 +97,7 @@ typedef struct {
 
     struct {
         RENDER_MODE render_mode;
+        int32_t software_threads;
         ASPECT_MODE aspect_mode;
         bool enable_zbuffer;
         bool enable_perspective_filter;
@@ -9,6 +9,14 @@
 #define AUDIO_MAX_ACTIVE_STREAMS 10
 #define AUDIO_NO_SOUND (-1)
 
+typedef struct {
+    // number of mixer callbacks that ran out of decoded audio
+    int32_t underruns;
+    // how full the decoded audio buffer is, from 0 to 1
+    float buffer_fill;
+    float min_buffer_fill;
+} AUDIO_STREAM_STATS;
+
 bool Audio_Init(void);
 bool Audio_Shutdown(void);
 
@@ -27,10 +35,19 @@ double Audio_Stream_GetDuration(int32_t sound_id);
 bool Audio_Stream_SeekTimestamp(int32_t sound_id, double timestamp);
 bool Audio_Stream_SetStartTimestamp(int32_t sound_id, double timestamp);
 bool Audio_Stream_SetStopTimestamp(int32_t sound_id, double timestamp);
+bool Audio_Stream_GetStats(int32_t sound_id, AUDIO_STREAM_STATS *out_stats);
+// Closes streams that have finished playing and runs their finish callbacks.
+// Must be called regularly from the game thread.
+void Audio_Stream_Update(void);
 
 bool Audio_Sample_LoadMany(size_t count, const char **contents, size_t *sizes);
 bool Audio_Sample_LoadSingle(
     int32_t sample_num, const char *content, size_t size);
+// Decodes all loaded samples up front across all CPU cores, rather than on
+// first playback.
+bool Audio_Sample_DecodeAll(void);
+// Keeps decoded samples in the cache directory to skip decoding next time.
+void Audio_Sample_SetCacheEnabled(bool is_enabled);
 bool Audio_Sample_Unload(int32_t sample_id);
 bool Audio_Sample_UnloadAll(void);
 
@@ -47,3 +64,4 @@ bool Audio_Sample_CloseAll(void);
 bool Audio_Sample_SetPan(int32_t sound_id, int32_t pan);
 bool Audio_Sample_SetVolume(int32_t sound_id, int32_t volume);
 bool Audio_Sample_SetPitch(int32_t sound_id, float pan);
+void Audio_Sample_SetInterpolation(bool is_enabled);
@@ -73,3 +73,8 @@ void File_Close(MYFILE *file);
 bool File_Load(const char *path, char **output_data, size_t *output_size);
 
 void File_CreateDirectory(const char *path);
+
+bool File_Delete(const char *path);
+
+// Replaces new_path with old_path, overwriting it if it already exists.
+bool File_Rename(const char *old_path, const char *new_path);
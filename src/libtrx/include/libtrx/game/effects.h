@@ -2,3 +2,6 @@
 
 #include "effects/const.h"
 #include "effects/types.h"
+
+extern EFFECT *Effect_Get(int16_t effect_num);
+extern int16_t Effect_GetActiveNum(void);
@@ -2,6 +2,8 @@
 
 #include "math.h"
 
+#define NO_BOX (-1)
+
 typedef struct {
     int16_t exit_box;
     uint16_t search_num;
@@ -23,3 +25,12 @@ typedef struct {
     int16_t required_box;
     XYZ_32 target;
 } LOT_INFO;
+
+// Shared pathfinding bookkeeping; only used with
+// gameplay.enable_shared_pathfinding.
+void LOT_ResetSearch(int32_t max_expansion, int32_t slot_count);
+void LOT_StartSearchFrame(void);
+void LOT_UpdateSharedSearch(
+    LOT_INFO *lot, const int16_t *zone, int32_t box_count);
+
+extern bool Box_UpdateLOT(LOT_INFO *lot, int32_t expansion);
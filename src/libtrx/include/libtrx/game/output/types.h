@@ -68,6 +68,8 @@ typedef struct {
     uint8_t a;
 } RGBA_8888;
 
+#define LIGHT_MAP_COUNT 32
+
 typedef struct {
     uint8_t index[256];
 } LIGHT_MAP;
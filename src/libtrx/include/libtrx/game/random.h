@@ -9,4 +9,7 @@ void Random_SeedDraw(int32_t seed);
 int32_t Random_GetControl(void);
 int32_t Random_GetDraw(void);
 
+// Returns the control RNG state without advancing it.
+int32_t Random_GetControlSeed(void);
+
 void Random_FreezeDraw(bool is_frozen);
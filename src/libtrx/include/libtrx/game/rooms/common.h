@@ -4,6 +4,7 @@
 #include "./types.h"
 
 void Room_InitialiseRooms(int32_t num_rooms);
+void Room_Shutdown(void);
 int32_t Room_GetCount(void);
 ROOM *Room_Get(int32_t room_num);
 
@@ -27,9 +28,17 @@ void Room_ParseFloorData(const int16_t *floor_data);
 void Room_PopulateSectorData(
     SECTOR *sector, const int16_t *floor_data, uint16_t start_index,
     uint16_t null_index);
+// Sets the SF_FLOOR_OBJECTS and SF_CEILING_OBJECTS sector flags. Call once the
+// objects are set up.
+void Room_FlagObjectSectors(void);
 
 int16_t Room_GetIndexFromPos(int32_t x, int32_t y, int32_t z);
 int32_t Room_FindByPos(int32_t x, int32_t y, int32_t z);
+// The original linear scan, kept to verify and benchmark Room_FindByPos.
+int32_t Room_FindByPosLinear(int32_t x, int32_t y, int32_t z);
+// Rebuilds the Room_FindByPos grid on the next lookup. Call after moving or
+// resizing rooms.
+void Room_InvalidateLookup(void);
 BOUNDS_32 Room_GetWorldBounds(void);
 
 SECTOR *Room_GetWorldSector(const ROOM *room, int32_t x_pos, int32_t z_pos);
@@ -22,6 +22,14 @@ typedef enum {
     RFS_FLIPPED = 2,
 } ROOM_FLIP_STATUS;
 
+typedef enum {
+    SF_DEATH = 0x01,
+    // The triggers reference objects with floor or ceiling height functions,
+    // such as bridges and trapdoors.
+    SF_FLOOR_OBJECTS = 0x02,
+    SF_CEILING_OBJECTS = 0x04,
+} SECTOR_FLAG;
+
 typedef enum {
     FT_FLOOR = 0,
     FT_DOOR = 1,
@@ -40,7 +40,7 @@ typedef struct {
 typedef struct {
     uint16_t idx;
     int16_t box;
-    bool is_death_sector;
+    uint8_t flags;
 #if TR_VERSION == 2
     LADDER_DIRECTION ladder;
 #endif
@@ -20,5 +20,9 @@ void Shell_GetWindowSize(int32_t *out_width, int32_t *out_height);
 
 extern const char *Shell_GetConfigPath(void);
 extern const char *Shell_GetGameFlowPath(void);
+
+// Headless mode runs the game logic without creating a window, GL context or
+// audio device.
+extern bool Shell_IsHeadless(void);
 extern void Shell_ProcessInput(void);
 extern void Shell_ProcessEvents(void);
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <stdint.h>
+
+// Deterministic checkpoints of the game logic state. Every N logic frames a
+// hash of each subsystem is either written to a trace file or compared against
+// a previously recorded trace, which makes it possible to tell whether a change
+// to the game logic changed its behaviour. Only state that does not depend on
+// rendering or on pointer values is hashed.
+
+typedef enum {
+    STATE_TRACE_ITEMS,
+    STATE_TRACE_LARA,
+    STATE_TRACE_CREATURES,
+    STATE_TRACE_EFFECTS,
+    STATE_TRACE_ROOMS,
+    STATE_TRACE_RANDOM,
+    STATE_TRACE_NUMBER_OF,
+} STATE_TRACE_SUBSYSTEM;
+
+typedef struct {
+    int32_t frame;
+    uint64_t hashes[STATE_TRACE_NUMBER_OF];
+} STATE_TRACE_CHECKPOINT;
+
+typedef struct {
+    bool is_active;
+    bool is_comparing;
+    int32_t frame;
+    int32_t checkpoint_count;
+    // Only set when comparing.
+    int32_t reference_count;
+    bool is_diverged;
+    int32_t diverged_frame;
+    // Empty when the traces differ in length rather than in content.
+    uint32_t diverged_subsystems;
+} STATE_TRACE_STATUS;
+
+#define STATE_TRACE_DEFAULT_INTERVAL 30
+
+const char *StateTrace_GetSubsystemName(STATE_TRACE_SUBSYSTEM subsystem);
+void StateTrace_Compute(STATE_TRACE_CHECKPOINT *out_checkpoint);
+
+bool StateTrace_StartRecording(const char *path, int32_t interval);
+bool StateTrace_StartComparing(const char *path);
+void StateTrace_Stop(void);
+
+// Call once after every logic frame.
+void StateTrace_Update(void);
+STATE_TRACE_STATUS StateTrace_GetStatus(void);
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// 64-bit FNV-1a, fed eight bytes at a time. Good enough to tell files apart
+// and fast enough to run over a whole level, but not cryptographically
+// secure.
+
+#define HASH_SEED 0xCBF29CE484222325ULL
+
+// Continues hashing from a previous result, or from HASH_SEED.
+uint64_t Hash_Update(uint64_t hash, const void *data, size_t size);
+
+// MurmurHash3 over a handful of 32-bit words, for indexing small
+// power-of-two lookup tables on hot paths where short keys would make
+// Hash_Update too slow.
+uint32_t Hash_Mix32(const uint32_t *values, size_t count);
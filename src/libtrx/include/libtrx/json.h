@@ -4,6 +4,9 @@
 #define JSON_INVALID_STRING nullptr
 #define JSON_INVALID_NUMBER 0x7FFFFFFF
 
+// Objects with at least this many keys get a hash index on the first lookup.
+#define JSON_OBJECT_INDEX_THRESHOLD 8
+
 #include <inttypes.h>
 #include <stddef.h>
 #include <stdint.h>
@@ -53,10 +56,14 @@ typedef struct JSON_OBJECT_ELEMENT {
     size_t ref_count;
 } JSON_OBJECT_ELEMENT;
 
+typedef struct JSON_OBJECT_INDEX JSON_OBJECT_INDEX;
+
 typedef struct {
     JSON_OBJECT_ELEMENT *start;
     size_t length;
     size_t ref_count;
+    // Built lazily by key lookups; see JSON_OBJECT_INDEX_THRESHOLD.
+    JSON_OBJECT_INDEX *index;
 } JSON_OBJECT;
 
 typedef struct JSON_ARRAY_ELEMENT {
@@ -78,7 +85,20 @@ typedef struct {
     size_t row_no;
 } JSON_VALUE_EX;
 
+// Turns the object key hash index on or off. Only useful for benchmarking.
+void JSON_SetObjectIndexEnabled(bool enabled);
+
+// Looks up every key of the tree with or without the object index and
+// returns the average duration of a pass in nanoseconds.
+double JSON_BenchmarkQueries(
+    JSON_VALUE *root, bool use_index, int32_t passes, size_t *out_count);
+// Times parsing the given JSON5 file and querying its tree, and prints the
+// results.
+bool JSON_Benchmark(const char *path, int32_t passes);
+
 // values
+// Trees built with these functions allocate each node separately, while
+// parsed trees are a single allocation. JSON_ValueFree handles both.
 JSON_VALUE *JSON_ValueFromBool(int b);
 JSON_VALUE *JSON_ValueFromInt(int number);
 JSON_VALUE *JSON_ValueFromInt64(int64_t number);
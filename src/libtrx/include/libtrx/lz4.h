@@ -0,0 +1,15 @@
+#pragma once
+
+#include <stddef.h>
+
+// A minimal compressor and decompressor for the LZ4 block format. It trades
+// ratio for speed, so it suits data that is written often and read rarely.
+
+// The largest compressed size for an input of the given size.
+size_t LZ4_GetBound(size_t size);
+
+// Returns the compressed size, or 0 if out_size is below LZ4_GetBound.
+size_t LZ4_Compress(const char *data, size_t size, char *out, size_t out_size);
+
+// Fails unless the block decodes to exactly out_size bytes.
+bool LZ4_Decompress(const char *data, size_t size, char *out, size_t out_size);
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <stdint.h>
+
+// A fork-join pool of worker threads. The thread calling ThreadPool_Run takes
+// part in the work as worker 0 and the call returns only after every job has
+// finished, so the jobs may safely reference the caller's stack.
+
+typedef void (*THREAD_POOL_JOB)(
+    void *user_data, int32_t job_idx, int32_t worker_idx);
+
+typedef struct THREAD_POOL THREAD_POOL;
+
+// Returns the number of logical CPU cores, or 1 if it cannot be determined.
+int32_t ThreadPool_GetCPUCount(void);
+
+// Creates a pool with num_workers workers in total, including the calling
+// thread. A pool of a single worker spawns no threads.
+THREAD_POOL *ThreadPool_Create(int32_t num_workers);
+void ThreadPool_Free(THREAD_POOL *pool);
+
+int32_t ThreadPool_GetWorkerCount(const THREAD_POOL *pool);
+
+// Runs job(user_data, job_idx, worker_idx) for every job_idx in
+// [0, num_jobs). Jobs are handed out dynamically, in increasing order, and
+// no two jobs ever run at the same time on the same worker_idx.
+void ThreadPool_Run(
+    THREAD_POOL *pool, THREAD_POOL_JOB job, void *user_data, int32_t num_jobs);
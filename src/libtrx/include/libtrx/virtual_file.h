@@ -7,6 +7,9 @@ typedef struct {
     char *content;
     size_t size;
     char *cur_ptr;
+    bool is_mapped;
+    char *scratch;
+    size_t scratch_size;
 } VFILE;
 
 VFILE *VFile_CreateFromPath(const char *path);
@@ -25,6 +28,12 @@ uint8_t VFile_ReadU8(VFILE *file);
 uint16_t VFile_ReadU16(VFILE *file);
 uint32_t VFile_ReadU32(VFILE *file);
 
+// Returns a pointer to the next size bytes and advances past them, without
+// copying them out. If the data is not aligned to align bytes, it is copied to
+// a scratch buffer instead. The pointer is valid until the next call to this
+// function or until the file is closed, so callers must not hold on to it.
+const void *VFile_ReadView(VFILE *file, size_t size, size_t align);
+
 bool VFile_TrySkip(VFILE *file, int32_t offset);
 bool VFile_TryRead(VFILE *file, void *target, size_t size);
 bool VFile_TryReadS8(VFILE *file, int8_t *dst);
@@ -1,6 +1,7 @@
 #include "bson.h"
 
 #include "debug.h"
+#include "json_internal.h"
 #include "log.h"
 #include "memory.h"
 
@@ -236,12 +237,15 @@ static bool M_GetObjectSize(M_STATE *state)
     const int size = *(int32_t *)&state->src[state->offset];
     state->offset += sizeof(int32_t);
 
+    size_t count = 0;
     while (state->offset < start_offset + size - 1) {
         state->dom_size += sizeof(JSON_OBJECT_ELEMENT);
         if (!M_GetObjectElementWrappedSize(state)) {
             return false;
         }
+        count++;
     }
+    state->dom_size += JSON_ObjectIndexGetSize(count);
 
     if (state->offset + sizeof(char) > state->size) {
         state->error = BSON_PARSE_ERROR_PREMATURE_END_OF_BUFFER;
@@ -549,6 +553,12 @@ static void M_HandleObject(M_STATE *state, JSON_OBJECT *object)
     }
     object->ref_count = 1;
     object->length = count;
+    object->index = nullptr;
+    const size_t index_size = JSON_ObjectIndexGetSize(count);
+    if (index_size != 0) {
+        JSON_ObjectIndexBuildInto(object, state->dom);
+        state->dom += index_size;
+    }
     ASSERT(state->offset + sizeof(char) <= state->size);
     ASSERT(state->src[state->offset] == '\0');
     state->offset++;
@@ -0,0 +1,341 @@
+#include "bson.h"
+
+#include "debug.h"
+
+#include <string.h>
+
+static int32_t M_ReadInt32(const char *data);
+static bool M_GetValueSize(
+    BSON_TYPE type, const char *value, const char *end, size_t *out_size);
+static void M_Store(void *target, size_t size, int32_t value);
+
+static int32_t M_ReadInt32(const char *const data)
+{
+    int32_t value;
+    memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+static bool M_GetValueSize(
+    const BSON_TYPE type, const char *const value, const char *const end,
+    size_t *const out_size)
+{
+    const size_t available = end - value;
+    switch (type) {
+    case BSON_TYPE_NULL:
+        *out_size = 0;
+        return true;
+
+    case BSON_TYPE_BOOL:
+        *out_size = sizeof(uint8_t);
+        return available >= *out_size;
+
+    case BSON_TYPE_INT32:
+        *out_size = sizeof(int32_t);
+        return available >= *out_size;
+
+    case BSON_TYPE_DOUBLE:
+        *out_size = sizeof(double);
+        return available >= *out_size;
+
+    case BSON_TYPE_STRING: {
+        if (available < sizeof(int32_t)) {
+            return false;
+        }
+        const int32_t size = M_ReadInt32(value);
+        if (size < 1 || (size_t)size > available - sizeof(int32_t)
+            || value[sizeof(int32_t) + size - 1] != '\0') {
+            return false;
+        }
+        *out_size = sizeof(int32_t) + size;
+        return true;
+    }
+
+    case BSON_TYPE_OBJECT:
+    case BSON_TYPE_ARRAY: {
+        if (available < sizeof(int32_t)) {
+            return false;
+        }
+        const int32_t size = M_ReadInt32(value);
+        if (size < (int32_t)sizeof(int32_t) + 1 || (size_t)size > available
+            || value[size - 1] != '\0') {
+            return false;
+        }
+        *out_size = size;
+        return true;
+    }
+
+    default:
+        return false;
+    }
+}
+
+static void M_Store(void *const target, const size_t size, const int32_t value)
+{
+    switch (size) {
+    case sizeof(int8_t): {
+        const int8_t data = value;
+        memcpy(target, &data, size);
+        break;
+    }
+    case sizeof(int16_t): {
+        const int16_t data = value;
+        memcpy(target, &data, size);
+        break;
+    }
+    case sizeof(int32_t):
+        memcpy(target, &value, size);
+        break;
+    default:
+        ASSERT_FAIL();
+    }
+}
+
+bool BSON_ReaderInit(
+    BSON_READER *const reader, const char *const data, const size_t size)
+{
+    ASSERT(reader != nullptr);
+    reader->start = data;
+    reader->pos = data;
+    reader->end = data;
+    reader->is_error = true;
+
+    if (data == nullptr || size < sizeof(int32_t) + 1) {
+        return false;
+    }
+    const int32_t doc_size = M_ReadInt32(data);
+    if (doc_size < (int32_t)sizeof(int32_t) + 1 || (size_t)doc_size > size
+        || data[doc_size - 1] != '\0') {
+        return false;
+    }
+
+    reader->pos = data + sizeof(int32_t);
+    reader->end = data + doc_size - 1;
+    reader->is_error = false;
+    return true;
+}
+
+void BSON_ReaderRewind(BSON_READER *const reader)
+{
+    if (!reader->is_error) {
+        reader->pos = reader->start + sizeof(int32_t);
+    }
+}
+
+bool BSON_ReaderNext(BSON_READER *const reader, BSON_FIELD *const field)
+{
+    if (reader->is_error || reader->pos >= reader->end) {
+        return false;
+    }
+
+    const char *pos = reader->pos;
+    const BSON_TYPE type = (uint8_t)*pos++;
+    const char *const key = pos;
+    const char *const key_end = memchr(key, '\0', reader->end - key);
+    if (key_end == nullptr) {
+        reader->is_error = true;
+        return false;
+    }
+    pos = key_end + 1;
+
+    size_t value_size;
+    if (!M_GetValueSize(type, pos, reader->end, &value_size)) {
+        reader->is_error = true;
+        return false;
+    }
+
+    field->type = type;
+    field->key = key;
+    field->value = pos;
+    field->value_size = value_size;
+    reader->pos = pos + value_size;
+    return true;
+}
+
+int32_t BSON_ReaderCount(const BSON_READER *const reader)
+{
+    BSON_READER copy = *reader;
+    BSON_ReaderRewind(&copy);
+    BSON_FIELD field;
+    int32_t count = 0;
+    while (BSON_ReaderNext(&copy, &field)) {
+        count++;
+    }
+    return copy.is_error ? -1 : count;
+}
+
+bool BSON_ReaderFind(
+    const BSON_READER *const reader, const char *const key,
+    BSON_FIELD *const field)
+{
+    BSON_READER copy = *reader;
+    BSON_ReaderRewind(&copy);
+    while (BSON_ReaderNext(&copy, field)) {
+        if (strcmp(field->key, key) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool BSON_ReaderGetBool(
+    const BSON_READER *const reader, const char *const key, const bool d)
+{
+    BSON_FIELD field;
+    if (!BSON_ReaderFind(reader, key, &field)) {
+        return d;
+    }
+    return BSON_FieldGetBool(&field, d);
+}
+
+int32_t BSON_ReaderGetInt(
+    const BSON_READER *const reader, const char *const key, const int32_t d)
+{
+    BSON_FIELD field;
+    if (!BSON_ReaderFind(reader, key, &field)) {
+        return d;
+    }
+    return BSON_FieldGetInt(&field, d);
+}
+
+double BSON_ReaderGetDouble(
+    const BSON_READER *const reader, const char *const key, const double d)
+{
+    BSON_FIELD field;
+    if (!BSON_ReaderFind(reader, key, &field)) {
+        return d;
+    }
+    return BSON_FieldGetDouble(&field, d);
+}
+
+const char *BSON_ReaderGetString(
+    const BSON_READER *const reader, const char *const key,
+    const char *const d)
+{
+    BSON_FIELD field;
+    if (!BSON_ReaderFind(reader, key, &field)) {
+        return d;
+    }
+    return BSON_FieldGetString(&field, d);
+}
+
+bool BSON_ReaderGetObject(
+    const BSON_READER *const reader, const char *const key,
+    BSON_READER *const out)
+{
+    BSON_FIELD field;
+    return BSON_ReaderFind(reader, key, &field)
+        && field.type == BSON_TYPE_OBJECT && BSON_FieldGetReader(&field, out);
+}
+
+bool BSON_ReaderGetArray(
+    const BSON_READER *const reader, const char *const key,
+    BSON_READER *const out)
+{
+    BSON_FIELD field;
+    return BSON_ReaderFind(reader, key, &field)
+        && field.type == BSON_TYPE_ARRAY && BSON_FieldGetReader(&field, out);
+}
+
+bool BSON_FieldGetBool(const BSON_FIELD *const field, const bool d)
+{
+    if (field->type != BSON_TYPE_BOOL) {
+        return d;
+    }
+    return field->value[0] != 0;
+}
+
+int32_t BSON_FieldGetInt(const BSON_FIELD *const field, const int32_t d)
+{
+    switch (field->type) {
+    case BSON_TYPE_INT32:
+        return M_ReadInt32(field->value);
+    case BSON_TYPE_DOUBLE:
+        return BSON_FieldGetDouble(field, d);
+    default:
+        return d;
+    }
+}
+
+double BSON_FieldGetDouble(const BSON_FIELD *const field, const double d)
+{
+    switch (field->type) {
+    case BSON_TYPE_INT32:
+        return M_ReadInt32(field->value);
+    case BSON_TYPE_DOUBLE: {
+        double value;
+        memcpy(&value, field->value, sizeof(value));
+        return value;
+    }
+    default:
+        return d;
+    }
+}
+
+const char *BSON_FieldGetString(
+    const BSON_FIELD *const field, const char *const d)
+{
+    if (field->type != BSON_TYPE_STRING) {
+        return d;
+    }
+    return field->value + sizeof(int32_t);
+}
+
+bool BSON_FieldGetReader(const BSON_FIELD *const field, BSON_READER *const out)
+{
+    if (field->type != BSON_TYPE_OBJECT && field->type != BSON_TYPE_ARRAY) {
+        return false;
+    }
+    return BSON_ReaderInit(out, field->value, field->value_size);
+}
+
+bool BSON_DecodeField(
+    const BSON_FIELD *const field, const BSON_DECODE_FIELD *const table,
+    const int32_t table_size, void *const target, int32_t *const hint)
+{
+    for (int32_t i = 0; i < table_size; i++) {
+        const int32_t idx = (*hint + i) % table_size;
+        const BSON_DECODE_FIELD *const entry = &table[idx];
+        if (strcmp(entry->key, field->key) != 0) {
+            continue;
+        }
+        *hint = (idx + 1) % table_size;
+
+        char *const member = (char *)target + entry->offset;
+        switch (entry->type) {
+        case BSON_DECODE_BOOL: {
+            ASSERT(entry->size == sizeof(bool));
+            bool *const value = (bool *)member;
+            *value = BSON_FieldGetBool(field, *value);
+            return true;
+        }
+
+        case BSON_DECODE_INT:
+            if (field->type == BSON_TYPE_INT32
+                || field->type == BSON_TYPE_DOUBLE) {
+                M_Store(member, entry->size, BSON_FieldGetInt(field, 0));
+            }
+            return true;
+
+        case BSON_DECODE_DOUBLE: {
+            ASSERT(entry->size == sizeof(double));
+            double *const value = (double *)member;
+            *value = BSON_FieldGetDouble(field, *value);
+            return true;
+        }
+        }
+    }
+    return false;
+}
+
+bool BSON_ReaderDecode(
+    BSON_READER *const reader, const BSON_DECODE_FIELD *const table,
+    const int32_t table_size, void *const target)
+{
+    int32_t hint = 0;
+    BSON_FIELD field;
+    while (BSON_ReaderNext(reader, &field)) {
+        BSON_DecodeField(&field, table, table_size, target, &hint);
+    }
+    return !reader->is_error;
+}
@@ -1,5 +1,6 @@
-#include "json.h"
+#include "json_internal.h"
 
+#include "hash.h"
 #include "memory.h"
 
 #include <inttypes.h>
@@ -7,6 +8,14 @@
 #include <stdlib.h>
 #include <string.h>
 
+struct JSON_OBJECT_INDEX {
+    size_t count;
+    size_t capacity;
+    JSON_OBJECT_ELEMENT *slots[];
+};
+
+static bool m_IsIndexEnabled = true;
+
 static JSON_NUMBER *M_NumberNewInt(int number);
 static JSON_NUMBER *M_NumberNewInt64(int64_t number);
 static JSON_NUMBER *M_NumberNewDouble(double number);
@@ -24,6 +33,15 @@ static JSON_ARRAY *M_ValueAsArray(JSON_VALUE *const value);
 static void M_ArrayElementFree(JSON_ARRAY_ELEMENT *element);
 static void M_ObjectElementFree(JSON_OBJECT_ELEMENT *element);
 
+static size_t M_IndexGetSlot(
+    const JSON_OBJECT_INDEX *index, const char *key, bool *out_found);
+static void M_IndexInsert(
+    JSON_OBJECT_INDEX *index, JSON_OBJECT_ELEMENT *element);
+static size_t M_IndexGetCapacity(size_t length);
+static void M_IndexBuild(JSON_OBJECT *obj);
+static void M_IndexFree(JSON_OBJECT *obj);
+static JSON_OBJECT_ELEMENT *M_ObjectFind(JSON_OBJECT *obj, const char *key);
+
 static JSON_NUMBER *M_NumberNewInt(const int number)
 {
     const size_t size = snprintf(nullptr, 0, "%d", number) + 1;
@@ -155,6 +173,111 @@ static void M_ObjectElementFree(JSON_OBJECT_ELEMENT *element)
     }
 }
 
+static size_t M_IndexGetSlot(
+    const JSON_OBJECT_INDEX *const index, const char *const key,
+    bool *const out_found)
+{
+    const size_t mask = index->capacity - 1;
+    size_t slot = Hash_Update(HASH_SEED, key, strlen(key)) & mask;
+    while (index->slots[slot] != nullptr) {
+        if (!strcmp(index->slots[slot]->name->string, key)) {
+            *out_found = true;
+            return slot;
+        }
+        slot = (slot + 1) & mask;
+    }
+    *out_found = false;
+    return slot;
+}
+
+static void M_IndexInsert(
+    JSON_OBJECT_INDEX *const index, JSON_OBJECT_ELEMENT *const element)
+{
+    // Keep the first of duplicate keys, the same one a linear walk finds.
+    bool found;
+    const size_t slot = M_IndexGetSlot(index, element->name->string, &found);
+    if (!found) {
+        index->slots[slot] = element;
+        index->count++;
+    }
+}
+
+static size_t M_IndexGetCapacity(const size_t length)
+{
+    size_t capacity = 16;
+    while (capacity < length * 2) {
+        capacity *= 2;
+    }
+    return capacity;
+}
+
+static void M_IndexBuild(JSON_OBJECT *const obj)
+{
+    JSON_ObjectIndexBuildInto(
+        obj, Memory_Alloc(JSON_ObjectIndexGetSize(obj->length)));
+}
+
+static void M_IndexFree(JSON_OBJECT *const obj)
+{
+    // The index of a parsed object lives in the same block as the object.
+    if (obj->ref_count == 0) {
+        Memory_Free(obj->index);
+    }
+    obj->index = nullptr;
+}
+
+static JSON_OBJECT_ELEMENT *M_ObjectFind(
+    JSON_OBJECT *const obj, const char *const key)
+{
+    // Parsed objects come with an index from the parser. Once an edit drops
+    // it, they fall back to the linear walk rather than allocating a new one
+    // that nothing would free.
+    if (m_IsIndexEnabled && obj->index == nullptr && obj->ref_count == 0
+        && obj->length >= JSON_OBJECT_INDEX_THRESHOLD) {
+        M_IndexBuild(obj);
+    }
+
+    if (m_IsIndexEnabled && obj->index != nullptr) {
+        bool found;
+        const size_t slot = M_IndexGetSlot(obj->index, key, &found);
+        return found ? obj->index->slots[slot] : nullptr;
+    }
+
+    for (JSON_OBJECT_ELEMENT *elem = obj->start; elem != nullptr;
+         elem = elem->next) {
+        if (!strcmp(elem->name->string, key)) {
+            return elem;
+        }
+    }
+    return nullptr;
+}
+
+size_t JSON_ObjectIndexGetSize(const size_t length)
+{
+    if (length < JSON_OBJECT_INDEX_THRESHOLD) {
+        return 0;
+    }
+    return sizeof(JSON_OBJECT_INDEX)
+        + sizeof(JSON_OBJECT_ELEMENT *) * M_IndexGetCapacity(length);
+}
+
+void JSON_ObjectIndexBuildInto(JSON_OBJECT *const obj, void *const memory)
+{
+    JSON_OBJECT_INDEX *const index = memory;
+    memset(index, 0, JSON_ObjectIndexGetSize(obj->length));
+    index->capacity = M_IndexGetCapacity(obj->length);
+    for (JSON_OBJECT_ELEMENT *elem = obj->start; elem != nullptr;
+         elem = elem->next) {
+        M_IndexInsert(index, elem);
+    }
+    obj->index = index;
+}
+
+void JSON_SetObjectIndexEnabled(const bool enabled)
+{
+    m_IsIndexEnabled = enabled;
+}
+
 JSON_VALUE *JSON_ValueFromBool(const int b)
 {
     JSON_VALUE *const value = Memory_Alloc(sizeof(JSON_VALUE));
@@ -428,6 +551,7 @@ void JSON_ObjectFree(JSON_OBJECT *obj)
         M_ObjectElementFree(elem);
         elem = next;
     }
+    M_IndexFree(obj);
     if (obj->ref_count == 0) {
         Memory_Free(obj);
     }
@@ -450,6 +574,15 @@ void JSON_ObjectAppend(
         obj->start = elem;
     }
     obj->length++;
+
+    JSON_OBJECT_INDEX *const index = obj->index;
+    if (index != nullptr) {
+        if ((index->count + 1) * 2 > index->capacity) {
+            M_IndexFree(obj);
+        } else {
+            M_IndexInsert(index, elem);
+        }
+    }
 }
 
 void JSON_ObjectAppendBool(JSON_OBJECT *obj, const char *key, int b)
@@ -491,16 +624,7 @@ void JSON_ObjectAppendObject(
 
 bool JSON_ObjectContainsKey(JSON_OBJECT *const obj, const char *const key)
 {
-    JSON_OBJECT_ELEMENT *elem = obj->start;
-    while (elem != nullptr) {
-        if (!strcmp(elem->name->string, key)) {
-            return true;
-        }
-
-        elem = elem->next;
-    }
-
-    return false;
+    return M_ObjectFind(obj, key) != nullptr;
 }
 
 void JSON_ObjectEvictKey(JSON_OBJECT *const obj, const char *const key)
@@ -512,6 +636,7 @@ void JSON_ObjectEvictKey(JSON_OBJECT *const obj, const char *const key)
     JSON_OBJECT_ELEMENT *prev = nullptr;
     while (elem) {
         if (!strcmp(elem->name->string, key)) {
+            M_IndexFree(obj);
             if (prev == nullptr) {
                 obj->start = elem->next;
             } else {
@@ -540,14 +665,8 @@ JSON_VALUE *JSON_ObjectGetValue(JSON_OBJECT *const obj, const char *const key)
     if (obj == nullptr) {
         return nullptr;
     }
-    JSON_OBJECT_ELEMENT *elem = obj->start;
-    while (elem) {
-        if (!strcmp(elem->name->string, key)) {
-            return elem->value;
-        }
-        elem = elem->next;
-    }
-    return nullptr;
+    const JSON_OBJECT_ELEMENT *const elem = M_ObjectFind(obj, key);
+    return elem != nullptr ? elem->value : nullptr;
 }
 
 int JSON_ObjectGetBool(
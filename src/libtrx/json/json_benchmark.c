@@ -0,0 +1,107 @@
+#include "benchmark.h"
+#include "filesystem.h"
+#include "json.h"
+#include "log.h"
+#include "memory.h"
+
+#include <stdio.h>
+
+typedef struct {
+    const char *data;
+    size_t size;
+    JSON_VALUE *root;
+} M_PARSE_BENCHMARK;
+
+typedef struct {
+    JSON_VALUE *root;
+    size_t count;
+} M_QUERY_BENCHMARK;
+
+static size_t M_Query(JSON_VALUE *value);
+static void M_BenchmarkParse(void *user_data);
+static void M_BenchmarkQueries(void *user_data);
+
+static size_t M_Query(JSON_VALUE *const value)
+{
+    // Look up every key the way the loaders do, plus one that is missing.
+    size_t count = 0;
+    JSON_OBJECT *const obj = JSON_ValueAsObject(value);
+    if (obj != nullptr) {
+        for (JSON_OBJECT_ELEMENT *elem = obj->start; elem != nullptr;
+             elem = elem->next) {
+            count += JSON_ObjectGetValue(obj, elem->name->string) != nullptr;
+            count += M_Query(elem->value);
+        }
+        count += JSON_ObjectGetValue(obj, "") == nullptr;
+    }
+
+    JSON_ARRAY *const arr = JSON_ValueAsArray(value);
+    if (arr != nullptr) {
+        for (JSON_ARRAY_ELEMENT *elem = arr->start; elem != nullptr;
+             elem = elem->next) {
+            count += M_Query(elem->value);
+        }
+    }
+    return count;
+}
+
+static void M_BenchmarkParse(void *const user_data)
+{
+    M_PARSE_BENCHMARK *const benchmark = user_data;
+    JSON_ValueFree(benchmark->root);
+    benchmark->root = JSON_ParseEx(
+        benchmark->data, benchmark->size, JSON_PARSE_FLAGS_ALLOW_JSON5,
+        nullptr, nullptr, nullptr);
+}
+
+static void M_BenchmarkQueries(void *const user_data)
+{
+    M_QUERY_BENCHMARK *const benchmark = user_data;
+    benchmark->count = M_Query(benchmark->root);
+}
+
+double JSON_BenchmarkQueries(
+    JSON_VALUE *const root, const bool use_index, const int32_t passes,
+    size_t *const out_count)
+{
+    M_QUERY_BENCHMARK benchmark = { .root = root };
+    JSON_SetObjectIndexEnabled(use_index);
+    const double result =
+        Benchmark_Measure(M_BenchmarkQueries, &benchmark, passes);
+    JSON_SetObjectIndexEnabled(true);
+    *out_count = benchmark.count;
+    return result;
+}
+
+bool JSON_Benchmark(const char *const path, const int32_t passes)
+{
+    char *data = nullptr;
+    size_t size = 0;
+    if (!File_Load(path, &data, &size)) {
+        return false;
+    }
+
+    M_PARSE_BENCHMARK parse_benchmark = { .data = data, .size = size };
+    const double parse =
+        Benchmark_Measure(M_BenchmarkParse, &parse_benchmark, passes);
+    JSON_VALUE *const root = parse_benchmark.root;
+    Memory_FreePointer(&data);
+    if (root == nullptr) {
+        LOG_ERROR("Failed to parse %s", path);
+        return false;
+    }
+
+    size_t linear_count;
+    size_t indexed_count;
+    const double linear =
+        JSON_BenchmarkQueries(root, false, passes, &linear_count);
+    const double indexed =
+        JSON_BenchmarkQueries(root, true, passes, &indexed_count);
+    JSON_ValueFree(root);
+
+    printf(
+        "%-24s %7d keys %9.1f us parse %9.1f us linear %9.1f us indexed%s\n",
+        path, (int32_t)linear_count, parse / 1000.0, linear / 1000.0,
+        indexed / 1000.0, linear_count != indexed_count ? " MISMATCH" : "");
+    return linear_count == indexed_count;
+}
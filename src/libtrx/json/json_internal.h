@@ -0,0 +1,17 @@
+#pragma once
+
+#include "json.h"
+
+#include <stddef.h>
+
+// Parsed trees live in a single allocation, so the parsers reserve room for
+// the key index of each large object in that same block instead of letting
+// lookups allocate it later.
+
+// Returns the size of the key index for an object with the given number of
+// keys, or 0 if the object is too small to be indexed.
+size_t JSON_ObjectIndexGetSize(size_t length);
+
+// Builds the key index of a parsed object into memory of the size returned
+// by JSON_ObjectIndexGetSize.
+void JSON_ObjectIndexBuildInto(JSON_OBJECT *obj, void *memory);
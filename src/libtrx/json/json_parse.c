@@ -1,5 +1,6 @@
 #include "json.h"
 
+#include "json_internal.h"
 #include "memory.h"
 
 typedef struct {
@@ -614,6 +615,7 @@ static int M_GetObjectSize(M_STATE *state, int is_global_object)
     }
 
     state->dom_size += sizeof(JSON_OBJECT_ELEMENT) * elements;
+    state->dom_size += JSON_ObjectIndexGetSize(elements);
 
     return 0;
 }
@@ -1325,6 +1327,13 @@ static void M_HandleObject(
 
     object->ref_count = 1;
     object->length = elements;
+    object->index = nullptr;
+
+    const size_t index_size = JSON_ObjectIndexGetSize(elements);
+    if (index_size != 0) {
+        JSON_ObjectIndexBuildInto(object, state->dom);
+        state->dom += index_size;
+    }
 }
 
 static void M_HandleArray(M_STATE *state, JSON_ARRAY *array)
@@ -0,0 +1,204 @@
+#include "lz4.h"
+
+#include "utils.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#define LZ4_HASH_BITS 12
+#define LZ4_MIN_MATCH 4
+#define LZ4_LAST_LITERALS 5
+#define LZ4_MATCH_FIND_LIMIT 12
+#define LZ4_MAX_OFFSET 0xFFFF
+#define LZ4_RUN_MASK 15
+
+static uint32_t M_Read32(const uint8_t *ptr);
+static uint32_t M_Hash(uint32_t value);
+static uint8_t *M_WriteLength(uint8_t *out, size_t length);
+static bool M_ReadLength(
+    const uint8_t **ptr, const uint8_t *end, size_t *length);
+
+static uint32_t M_Read32(const uint8_t *const ptr)
+{
+    uint32_t value;
+    memcpy(&value, ptr, sizeof(value));
+    return value;
+}
+
+static uint32_t M_Hash(const uint32_t value)
+{
+    return (value * 2654435761U) >> (32 - LZ4_HASH_BITS);
+}
+
+static uint8_t *M_WriteLength(uint8_t *out, size_t length)
+{
+    while (length >= 255) {
+        *out++ = 255;
+        length -= 255;
+    }
+    *out++ = length;
+    return out;
+}
+
+static bool M_ReadLength(
+    const uint8_t **const ptr, const uint8_t *const end, size_t *const length)
+{
+    uint8_t byte;
+    do {
+        if (*ptr >= end) {
+            return false;
+        }
+        byte = *(*ptr)++;
+        *length += byte;
+    } while (byte == 255);
+    return true;
+}
+
+size_t LZ4_GetBound(const size_t size)
+{
+    return size + size / 255 + 16;
+}
+
+size_t LZ4_Compress(
+    const char *const data, const size_t size, char *const out,
+    const size_t out_size)
+{
+    if (out_size < LZ4_GetBound(size)) {
+        return 0;
+    }
+
+    const uint8_t *const base = (const uint8_t *)data;
+    const uint8_t *const end = base + size;
+    const uint8_t *ip = base;
+    const uint8_t *anchor = base;
+    uint8_t *op = (uint8_t *)out;
+
+    // The format requires the last match to start 12 bytes before the end
+    // and the last 5 bytes to be literals.
+    if (size > LZ4_MATCH_FIND_LIMIT) {
+        const uint8_t *const find_limit = end - LZ4_MATCH_FIND_LIMIT;
+        const uint8_t *const match_limit = end - LZ4_LAST_LITERALS;
+        uint32_t table[1 << LZ4_HASH_BITS] = {};
+
+        while (ip < find_limit) {
+            const uint32_t hash = M_Hash(M_Read32(ip));
+            const uint8_t *ref = base + table[hash];
+            table[hash] = ip - base;
+            if (ref >= ip || ip - ref > LZ4_MAX_OFFSET
+                || M_Read32(ref) != M_Read32(ip)) {
+                ip++;
+                continue;
+            }
+
+            size_t match_length = LZ4_MIN_MATCH;
+            while (ip + match_length < match_limit
+                   && ip[match_length] == ref[match_length]) {
+                match_length++;
+            }
+            while (ip > anchor && ref > base && ip[-1] == ref[-1]) {
+                ip--;
+                ref--;
+                match_length++;
+            }
+
+            const size_t literal_length = ip - anchor;
+            uint8_t *const token = op++;
+            *token = MIN(literal_length, LZ4_RUN_MASK) << 4;
+            if (literal_length >= LZ4_RUN_MASK) {
+                op = M_WriteLength(op, literal_length - LZ4_RUN_MASK);
+            }
+            memcpy(op, anchor, literal_length);
+            op += literal_length;
+
+            const size_t offset = ip - ref;
+            *op++ = offset & 0xFF;
+            *op++ = offset >> 8;
+
+            const size_t extra_length = match_length - LZ4_MIN_MATCH;
+            *token |= MIN(extra_length, LZ4_RUN_MASK);
+            if (extra_length >= LZ4_RUN_MASK) {
+                op = M_WriteLength(op, extra_length - LZ4_RUN_MASK);
+            }
+
+            ip += match_length;
+            anchor = ip;
+        }
+    }
+
+    const size_t literal_length = end - anchor;
+    *op++ = MIN(literal_length, LZ4_RUN_MASK) << 4;
+    if (literal_length >= LZ4_RUN_MASK) {
+        op = M_WriteLength(op, literal_length - LZ4_RUN_MASK);
+    }
+    memcpy(op, anchor, literal_length);
+    op += literal_length;
+    return op - (uint8_t *)out;
+}
+
+bool LZ4_Decompress(
+    const char *const data, const size_t size, char *const out,
+    const size_t out_size)
+{
+    const uint8_t *ip = (const uint8_t *)data;
+    const uint8_t *const ip_end = ip + size;
+    uint8_t *const op_start = (uint8_t *)out;
+    uint8_t *op = op_start;
+    const uint8_t *const op_end = op + out_size;
+
+    while (true) {
+        if (ip >= ip_end) {
+            return false;
+        }
+        const uint8_t token = *ip++;
+
+        size_t literal_length = token >> 4;
+        if (literal_length == LZ4_RUN_MASK
+            && !M_ReadLength(&ip, ip_end, &literal_length)) {
+            return false;
+        }
+        if (literal_length > (size_t)(ip_end - ip)
+            || literal_length > (size_t)(op_end - op)) {
+            return false;
+        }
+        memcpy(op, ip, literal_length);
+        ip += literal_length;
+        op += literal_length;
+
+        // The last sequence has no match.
+        if (ip == ip_end) {
+            break;
+        }
+
+        if (ip_end - ip < 2) {
+            return false;
+        }
+        const size_t offset = ip[0] | (ip[1] << 8);
+        ip += 2;
+        if (offset == 0 || offset > (size_t)(op - op_start)) {
+            return false;
+        }
+
+        size_t match_length = token & LZ4_RUN_MASK;
+        if (match_length == LZ4_RUN_MASK
+            && !M_ReadLength(&ip, ip_end, &match_length)) {
+            return false;
+        }
+        match_length += LZ4_MIN_MATCH;
+        if (match_length > (size_t)(op_end - op)) {
+            return false;
+        }
+
+        // Matches may overlap their own output, so copy forwards.
+        const uint8_t *match = op - offset;
+        if (offset >= match_length) {
+            memcpy(op, match, match_length);
+            op += match_length;
+        } else {
+            for (size_t i = 0; i < match_length; i++) {
+                *op++ = *match++;
+            }
+        }
+    }
+
+    return op == op_end;
+}
@@ -0,0 +1,183 @@
+#include "thread_pool.h"
+
+#include "debug.h"
+#include "log.h"
+#include "memory.h"
+
+#include <SDL2/SDL_atomic.h>
+#include <SDL2/SDL_cpuinfo.h>
+#include <SDL2/SDL_error.h>
+#include <SDL2/SDL_mutex.h>
+#include <SDL2/SDL_thread.h>
+
+typedef struct {
+    THREAD_POOL *pool;
+    int32_t worker_idx;
+    SDL_Thread *thread;
+} M_WORKER;
+
+struct THREAD_POOL {
+    int32_t num_workers;
+    M_WORKER *workers;
+
+    SDL_mutex *mutex;
+    SDL_cond *start_cond;
+    SDL_cond *done_cond;
+    uint32_t generation;
+    int32_t num_busy;
+    bool quit;
+
+    THREAD_POOL_JOB job;
+    void *user_data;
+    int32_t num_jobs;
+    SDL_atomic_t next_job;
+};
+
+static void M_RunJobs(THREAD_POOL *pool, int32_t worker_idx);
+static int M_WorkerThread(void *arg);
+
+static void M_RunJobs(THREAD_POOL *const pool, const int32_t worker_idx)
+{
+    while (true) {
+        const int32_t job_idx = SDL_AtomicAdd(&pool->next_job, 1);
+        if (job_idx >= pool->num_jobs) {
+            break;
+        }
+        pool->job(pool->user_data, job_idx, worker_idx);
+    }
+}
+
+static int M_WorkerThread(void *const arg)
+{
+    const M_WORKER *const worker = arg;
+    THREAD_POOL *const pool = worker->pool;
+    uint32_t generation = 0;
+
+    SDL_LockMutex(pool->mutex);
+    while (true) {
+        while (!pool->quit && pool->generation == generation) {
+            SDL_CondWait(pool->start_cond, pool->mutex);
+        }
+        if (pool->quit) {
+            break;
+        }
+        generation = pool->generation;
+        SDL_UnlockMutex(pool->mutex);
+
+        M_RunJobs(pool, worker->worker_idx);
+
+        SDL_LockMutex(pool->mutex);
+        pool->num_busy--;
+        if (pool->num_busy == 0) {
+            SDL_CondSignal(pool->done_cond);
+        }
+    }
+    SDL_UnlockMutex(pool->mutex);
+    return 0;
+}
+
+int32_t ThreadPool_GetCPUCount(void)
+{
+    const int32_t count = SDL_GetCPUCount();
+    return count > 0 ? count : 1;
+}
+
+THREAD_POOL *ThreadPool_Create(const int32_t num_workers)
+{
+    ASSERT(num_workers >= 1);
+    THREAD_POOL *const pool = Memory_Alloc(sizeof(THREAD_POOL));
+    pool->num_workers = 1;
+    pool->mutex = SDL_CreateMutex();
+    pool->start_cond = SDL_CreateCond();
+    pool->done_cond = SDL_CreateCond();
+    if (pool->mutex == nullptr || pool->start_cond == nullptr
+        || pool->done_cond == nullptr) {
+        LOG_ERROR("Failed to create thread pool: %s", SDL_GetError());
+        return pool;
+    }
+
+    pool->workers = Memory_Alloc(sizeof(M_WORKER) * num_workers);
+    for (int32_t i = 1; i < num_workers; i++) {
+        M_WORKER *const worker = &pool->workers[i];
+        worker->pool = pool;
+        worker->worker_idx = i;
+        worker->thread = SDL_CreateThread(M_WorkerThread, "worker", worker);
+        if (worker->thread == nullptr) {
+            LOG_ERROR("SDL_CreateThread(): %s", SDL_GetError());
+            break;
+        }
+        pool->num_workers++;
+    }
+
+    LOG_DEBUG("Created thread pool with %d workers", pool->num_workers);
+    return pool;
+}
+
+void ThreadPool_Free(THREAD_POOL *const pool)
+{
+    if (pool == nullptr) {
+        return;
+    }
+
+    if (pool->mutex != nullptr) {
+        SDL_LockMutex(pool->mutex);
+        pool->quit = true;
+        SDL_CondBroadcast(pool->start_cond);
+        SDL_UnlockMutex(pool->mutex);
+    }
+
+    for (int32_t i = 1; i < pool->num_workers; i++) {
+        SDL_WaitThread(pool->workers[i].thread, nullptr);
+    }
+
+    if (pool->done_cond != nullptr) {
+        SDL_DestroyCond(pool->done_cond);
+    }
+    if (pool->start_cond != nullptr) {
+        SDL_DestroyCond(pool->start_cond);
+    }
+    if (pool->mutex != nullptr) {
+        SDL_DestroyMutex(pool->mutex);
+    }
+    Memory_Free(pool->workers);
+    Memory_Free(pool);
+}
+
+int32_t ThreadPool_GetWorkerCount(const THREAD_POOL *const pool)
+{
+    return pool->num_workers;
+}
+
+void ThreadPool_Run(
+    THREAD_POOL *const pool, const THREAD_POOL_JOB job, void *const user_data,
+    const int32_t num_jobs)
+{
+    if (num_jobs <= 0) {
+        return;
+    }
+
+    if (pool->num_workers == 1 || num_jobs == 1) {
+        for (int32_t i = 0; i < num_jobs; i++) {
+            job(user_data, i, 0);
+        }
+        return;
+    }
+
+    SDL_LockMutex(pool->mutex);
+    pool->job = job;
+    pool->user_data = user_data;
+    pool->num_jobs = num_jobs;
+    SDL_AtomicSet(&pool->next_job, 0);
+    pool->num_busy = pool->num_workers - 1;
+    pool->generation++;
+    SDL_CondBroadcast(pool->start_cond);
+    SDL_UnlockMutex(pool->mutex);
+
+    M_RunJobs(pool, 0);
+
+    SDL_LockMutex(pool->mutex);
+    while (pool->num_busy > 0) {
+        SDL_CondWait(pool->done_cond, pool->mutex);
+    }
+    SDL_UnlockMutex(pool->mutex);
+}
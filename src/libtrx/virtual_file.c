@@ -7,7 +7,109 @@
 
 #include <string.h>
 
-VFILE *VFile_CreateFromPath(const char *const path)
+#if defined(_WIN32)
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+static char *M_MapFile(const char *path, size_t *out_size);
+static void M_UnmapFile(char *data, size_t size);
+static VFILE *M_CreateFromMapping(const char *path);
+static VFILE *M_CreateFromRead(const char *path);
+
+#if defined(_WIN32)
+static char *M_MapFile(const char *const path, size_t *const out_size)
+{
+    char *full_path = File_GetFullPath(path);
+    const HANDLE handle = CreateFileA(
+        full_path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    Memory_FreePointer(&full_path);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return nullptr;
+    }
+
+    char *data = nullptr;
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart == 0) {
+        goto end;
+    }
+
+    const HANDLE mapping =
+        CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping == nullptr) {
+        goto end;
+    }
+    data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (data != nullptr) {
+        *out_size = size.QuadPart;
+    }
+
+end:
+    CloseHandle(handle);
+    return data;
+}
+
+static void M_UnmapFile(char *const data, const size_t size)
+{
+    UnmapViewOfFile(data);
+}
+#else
+static char *M_MapFile(const char *const path, size_t *const out_size)
+{
+    char *full_path = File_GetFullPath(path);
+    const int fd = open(full_path, O_RDONLY);
+    Memory_FreePointer(&full_path);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    char *data = nullptr;
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        goto end;
+    }
+
+    data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        data = nullptr;
+        goto end;
+    }
+    *out_size = st.st_size;
+
+end:
+    close(fd);
+    return data;
+}
+
+static void M_UnmapFile(char *const data, const size_t size)
+{
+    munmap(data, size);
+}
+#endif
+
+static VFILE *M_CreateFromMapping(const char *const path)
+{
+    size_t data_size = 0;
+    char *const data = M_MapFile(path, &data_size);
+    if (data == nullptr) {
+        return nullptr;
+    }
+
+    VFILE *const file = Memory_Alloc(sizeof(VFILE));
+    file->content = data;
+    file->size = data_size;
+    file->cur_ptr = file->content;
+    file->is_mapped = true;
+    return file;
+}
+
+static VFILE *M_CreateFromRead(const char *const path)
 {
     MYFILE *fp = File_Open(path, FILE_OPEN_READ);
     if (!fp) {
@@ -33,6 +135,17 @@ VFILE *VFile_CreateFromPath(const char *const path)
     return file;
 }
 
+VFILE *VFile_CreateFromPath(const char *const path)
+{
+    // Map the file where possible so that its pages are loaded on demand and
+    // not duplicated on the heap; fall back to reading it whole otherwise.
+    VFILE *const file = M_CreateFromMapping(path);
+    if (file != nullptr) {
+        return file;
+    }
+    return M_CreateFromRead(path);
+}
+
 VFILE *VFile_CreateFromBuffer(const char *data, size_t size)
 {
     VFILE *const file = Memory_Alloc(sizeof(VFILE));
@@ -45,7 +158,13 @@ VFILE *VFile_CreateFromBuffer(const char *data, size_t size)
 void VFile_Close(VFILE *file)
 {
     ASSERT(file != nullptr);
-    Memory_FreePointer(&file->content);
+    if (file->is_mapped) {
+        M_UnmapFile(file->content, file->size);
+        file->content = nullptr;
+    } else {
+        Memory_FreePointer(&file->content);
+    }
+    Memory_FreePointer(&file->scratch);
     Memory_FreePointer(&file);
 }
 
@@ -80,6 +199,24 @@ void VFile_Read(VFILE *const file, void *const target, const size_t size)
     ASSERT(VFile_TryRead(file, target, size));
 }
 
+const void *VFile_ReadView(
+    VFILE *const file, const size_t size, const size_t align)
+{
+    const size_t cur_pos = VFile_GetPos(file);
+    ASSERT(cur_pos + size <= file->size);
+    const void *result = file->cur_ptr;
+    if (align > 1 && (uintptr_t)result % align != 0) {
+        if (file->scratch_size < size) {
+            file->scratch = Memory_Realloc(file->scratch, size);
+            file->scratch_size = size;
+        }
+        memcpy(file->scratch, result, size);
+        result = file->scratch;
+    }
+    file->cur_ptr += size;
+    return result;
+}
+
 bool VFile_TryRead(VFILE *const file, void *const target, const size_t size)
 {
     const size_t cur_pos = VFile_GetPos(file);
@@ -5,20 +5,32 @@
 #include "global/const.h"
 #include "global/vars.h"
 
+#include <libtrx/config.h>
 #include <libtrx/utils.h>
 
-bool Box_SearchLOT(LOT_INFO *lot, int32_t expansion)
+static int16_t *M_GetZone(const LOT_INFO *lot);
+static bool M_IsSharingEnabled(void);
+
+static int16_t *M_GetZone(const LOT_INFO *const lot)
 {
     const bool flip_status = Room_GetFlipStatus();
-    int16_t *zone;
     if (lot->fly) {
-        zone = g_FlyZone[flip_status];
+        return g_FlyZone[flip_status];
     } else if (lot->step == STEP_L) {
-        zone = g_GroundZone[flip_status];
+        return g_GroundZone[flip_status];
     } else {
-        zone = g_GroundZone2[flip_status];
+        return g_GroundZone2[flip_status];
     }
+}
 
+static bool M_IsSharingEnabled(void)
+{
+    return g_Config.gameplay.enable_shared_pathfinding;
+}
+
+bool Box_SearchLOT(LOT_INFO *lot, int32_t expansion)
+{
+    const int16_t *const zone = M_GetZone(lot);
     int16_t search_zone = zone[lot->head];
     for (int i = 0; i < expansion; i++) {
         if (lot->head == NO_BOX) {
@@ -214,7 +226,11 @@ TARGET_TYPE Box_CalculateTarget(XYZ_32 *target, ITEM *item, LOT_INFO *lot)
     int32_t top = 0;
     int32_t bottom = 0;
 
-    Box_UpdateLOT(lot, MAX_EXPANSION);
+    if (M_IsSharingEnabled()) {
+        LOT_UpdateSharedSearch(lot, M_GetZone(lot), g_NumberBoxes);
+    } else {
+        Box_UpdateLOT(lot, MAX_EXPANSION);
+    }
 
     target->x = item->pos.x;
     target->y = item->pos.y;
@@ -12,6 +12,253 @@
 #include <libtrx/game/matrix.h>
 #include <libtrx/utils.h>
 
+#include <string.h>
+
+#define MAX_SPHERES 34
+#define MAX_EXTRA_ROTATIONS 8
+// Must be a power of two.
+#define SPHERE_CACHE_SIZE 32
+
+typedef struct {
+    const ITEM *item;
+    GAME_OBJECT_ID object_id;
+    XYZ_32 pos;
+    XYZ_16 rot;
+    const ANIM_FRAME *frame;
+    const void *data;
+    uint32_t mesh_hash;
+    int32_t extra_rotation_count;
+    int16_t extra_rotations[MAX_EXTRA_ROTATIONS];
+
+    int32_t count;
+    SPHERE spheres[MAX_SPHERES];
+    // Encloses all spheres with a positive radius.
+    SPHERE bounds;
+} M_SPHERE_SET;
+
+static M_SPHERE_SET m_SphereCache[SPHERE_CACHE_SIZE];
+static M_SPHERE_SET m_UncachedSpheres;
+static COLLIDE_STATS m_Stats;
+
+static int32_t M_ComputeSpheres(
+    const ITEM *item, const ANIM_FRAME *frame, SPHERE *ptr,
+    int32_t world_space);
+static int32_t M_CountExtraRotations(const ITEM *item, const OBJECT *obj);
+static uint32_t M_HashMeshes(const OBJECT *obj);
+static void M_ComputeBounds(M_SPHERE_SET *set);
+static bool M_IsSphereSetValid(
+    const M_SPHERE_SET *set, const ITEM *item, const ANIM_FRAME *frame,
+    uint32_t mesh_hash);
+static const M_SPHERE_SET *M_GetSphereSet(const ITEM *item);
+
+static int32_t M_ComputeSpheres(
+    const ITEM *const item, const ANIM_FRAME *const frame, SPHERE *ptr,
+    const int32_t world_space)
+{
+    int32_t x;
+    int32_t y;
+    int32_t z;
+    if (world_space) {
+        x = item->pos.x;
+        y = item->pos.y;
+        z = item->pos.z;
+        Matrix_PushUnit();
+    } else {
+        x = 0;
+        y = 0;
+        z = 0;
+        Matrix_Push();
+        Matrix_TranslateAbs32(item->pos);
+    }
+
+    Matrix_Rot16(item->rot);
+
+    Matrix_TranslateRel16(frame->offset);
+    Matrix_Rot16(frame->mesh_rots[0]);
+
+    const OBJECT *const obj = Object_Get(item->object_id);
+    const OBJECT_MESH *mesh = Object_GetMesh(obj->mesh_idx);
+
+    Matrix_Push();
+    Matrix_TranslateRel16(mesh->center);
+    ptr->x = x + (g_MatrixPtr->_03 >> W2V_SHIFT);
+    ptr->y = y + (g_MatrixPtr->_13 >> W2V_SHIFT);
+    ptr->z = z + (g_MatrixPtr->_23 >> W2V_SHIFT);
+    ptr->r = mesh->radius;
+    ptr++;
+    Matrix_Pop();
+
+    const int16_t *extra_rotation = (int16_t *)item->data;
+    for (int32_t i = 1; i < obj->mesh_count; i++) {
+        const ANIM_BONE *const bone = Object_GetBone(obj, i - 1);
+        if (bone->matrix_pop) {
+            Matrix_Pop();
+        }
+        if (bone->matrix_push) {
+            Matrix_Push();
+        }
+
+        Matrix_TranslateRel32(bone->pos);
+        Matrix_Rot16(frame->mesh_rots[i]);
+
+        if (extra_rotation != nullptr) {
+            if (bone->rot_y) {
+                Matrix_RotY(*extra_rotation++);
+            }
+            if (bone->rot_x) {
+                Matrix_RotX(*extra_rotation++);
+            }
+            if (bone->rot_z) {
+                Matrix_RotZ(*extra_rotation++);
+            }
+        }
+
+        mesh = Object_GetMesh(obj->mesh_idx + i);
+        Matrix_Push();
+        Matrix_TranslateRel16(mesh->center);
+        ptr->x = x + (g_MatrixPtr->_03 >> W2V_SHIFT);
+        ptr->y = y + (g_MatrixPtr->_13 >> W2V_SHIFT);
+        ptr->z = z + (g_MatrixPtr->_23 >> W2V_SHIFT);
+        ptr->r = mesh->radius;
+        Matrix_Pop();
+
+        ptr++;
+    }
+
+    Matrix_Pop();
+
+    m_Stats.sphere_sets_computed++;
+    m_Stats.spheres_computed += obj->mesh_count;
+    return obj->mesh_count;
+}
+
+static int32_t M_CountExtraRotations(
+    const ITEM *const item, const OBJECT *const obj)
+{
+    if (item->data == nullptr) {
+        return 0;
+    }
+
+    int32_t count = 0;
+    for (int32_t i = 1; i < obj->mesh_count; i++) {
+        const ANIM_BONE *const bone = Object_GetBone(obj, i - 1);
+        count += bone->rot_x + bone->rot_y + bone->rot_z;
+    }
+    return count;
+}
+
+static uint32_t M_HashMeshes(const OBJECT *const obj)
+{
+    // Meshes can be swapped between objects, for example when Lara holsters
+    // her pistols.
+    uint32_t hash = 0;
+    for (int32_t i = 0; i < obj->mesh_count; i++) {
+        const OBJECT_MESH *const mesh = Object_GetMesh(obj->mesh_idx + i);
+        hash = hash * 31 + (uint32_t)(uintptr_t)mesh;
+    }
+    return hash;
+}
+
+static void M_ComputeBounds(M_SPHERE_SET *const set)
+{
+    BOUNDS_32 box = {
+        .min = { .x = INT32_MAX, .y = INT32_MAX, .z = INT32_MAX },
+        .max = { .x = INT32_MIN, .y = INT32_MIN, .z = INT32_MIN },
+    };
+    for (int32_t i = 0; i < set->count; i++) {
+        const SPHERE *const sphere = &set->spheres[i];
+        if (sphere->r <= 0) {
+            continue;
+        }
+        box.min.x = MIN(box.min.x, sphere->x);
+        box.min.y = MIN(box.min.y, sphere->y);
+        box.min.z = MIN(box.min.z, sphere->z);
+        box.max.x = MAX(box.max.x, sphere->x);
+        box.max.y = MAX(box.max.y, sphere->y);
+        box.max.z = MAX(box.max.z, sphere->z);
+    }
+
+    set->bounds = (SPHERE) {
+        .x = box.min.x / 2 + box.max.x / 2,
+        .y = box.min.y / 2 + box.max.y / 2,
+        .z = box.min.z / 2 + box.max.z / 2,
+        .r = 0,
+    };
+    for (int32_t i = 0; i < set->count; i++) {
+        const SPHERE *const sphere = &set->spheres[i];
+        if (sphere->r <= 0) {
+            continue;
+        }
+        const int32_t dx = sphere->x - set->bounds.x;
+        const int32_t dy = sphere->y - set->bounds.y;
+        const int32_t dz = sphere->z - set->bounds.z;
+        // Round up so that the bounds stay conservative.
+        const int32_t dist =
+            Math_Sqrt(SQUARE(dx) + SQUARE(dy) + SQUARE(dz)) + 1;
+        set->bounds.r = MAX(set->bounds.r, dist + sphere->r);
+    }
+}
+
+static bool M_IsSphereSetValid(
+    const M_SPHERE_SET *const set, const ITEM *const item,
+    const ANIM_FRAME *const frame, const uint32_t mesh_hash)
+{
+    if (set->item != item || set->object_id != item->object_id
+        || set->frame != frame || set->data != item->data
+        || set->mesh_hash != mesh_hash || set->pos.x != item->pos.x
+        || set->pos.y != item->pos.y || set->pos.z != item->pos.z
+        || set->rot.x != item->rot.x || set->rot.y != item->rot.y
+        || set->rot.z != item->rot.z) {
+        return false;
+    }
+
+    const int16_t *const extra_rotations = (const int16_t *)item->data;
+    for (int32_t i = 0; i < set->extra_rotation_count; i++) {
+        if (set->extra_rotations[i] != extra_rotations[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static const M_SPHERE_SET *M_GetSphereSet(const ITEM *const item)
+{
+    const OBJECT *const obj = Object_Get(item->object_id);
+    const ANIM_FRAME *const frame = Item_GetBestFrame(item);
+    const uint32_t mesh_hash = M_HashMeshes(obj);
+    m_Stats.sphere_set_queries++;
+    m_Stats.spheres_queried += obj->mesh_count;
+
+    const int32_t extra_rotation_count = M_CountExtraRotations(item, obj);
+    M_SPHERE_SET *set;
+    if (extra_rotation_count > MAX_EXTRA_ROTATIONS) {
+        set = &m_UncachedSpheres;
+    } else {
+        const uintptr_t slot = (uintptr_t)item / sizeof(ITEM);
+        set = &m_SphereCache[slot & (SPHERE_CACHE_SIZE - 1)];
+        if (M_IsSphereSetValid(set, item, frame, mesh_hash)) {
+            return set;
+        }
+    }
+
+    set->item = item;
+    set->object_id = item->object_id;
+    set->pos = item->pos;
+    set->rot = item->rot;
+    set->frame = frame;
+    set->data = item->data;
+    set->mesh_hash = mesh_hash;
+    set->extra_rotation_count = MIN(extra_rotation_count, MAX_EXTRA_ROTATIONS);
+    if (set->extra_rotation_count > 0) {
+        memcpy(
+            set->extra_rotations, item->data,
+            set->extra_rotation_count * sizeof(int16_t));
+    }
+    set->count = M_ComputeSpheres(item, frame, set->spheres, true);
+    M_ComputeBounds(set);
+    return set;
+}
+
 void Collide_GetCollisionInfo(
     COLL_INFO *coll, int32_t xpos, int32_t ypos, int32_t zpos, int16_t room_num,
     int32_t obj_height)
@@ -136,7 +383,7 @@ void Collide_GetCollisionInfo(
             coll->front_floor = 512;
         } else if (
             coll->lava_is_pit && coll->front_floor > 0
-            && Room_GetPitSector(sector, x, z)->is_death_sector) {
+            && (Room_GetPitSector(sector, x, z)->flags & SF_DEATH)) {
             coll->front_floor = 512;
         }
     }
@@ -171,7 +418,7 @@ void Collide_GetCollisionInfo(
             coll->left_floor = 512;
         } else if (
             coll->lava_is_pit && coll->left_floor > 0
-            && Room_GetPitSector(sector, x, z)->is_death_sector) {
+            && (Room_GetPitSector(sector, x, z)->flags & SF_DEATH)) {
             coll->left_floor = 512;
         }
     }
@@ -206,7 +453,7 @@ void Collide_GetCollisionInfo(
             coll->right_floor = 512;
         } else if (
             coll->lava_is_pit && coll->right_floor > 0
-            && Room_GetPitSector(sector, x, z)->is_death_sector) {
+            && (Room_GetPitSector(sector, x, z)->flags & SF_DEATH)) {
             coll->right_floor = 512;
         }
     }
@@ -491,97 +738,53 @@ int32_t Collide_GetSpheres(ITEM *item, SPHERE *ptr, int32_t world_space)
         return 0;
     }
 
-    int32_t x;
-    int32_t y;
-    int32_t z;
-    if (world_space) {
-        x = item->pos.x;
-        y = item->pos.y;
-        z = item->pos.z;
-        Matrix_PushUnit();
-    } else {
-        x = 0;
-        y = 0;
-        z = 0;
-        Matrix_Push();
-        Matrix_TranslateAbs32(item->pos);
+    if (!world_space) {
+        const int32_t count =
+            M_ComputeSpheres(item, Item_GetBestFrame(item), ptr, false);
+        m_Stats.sphere_set_queries++;
+        m_Stats.spheres_queried += count;
+        return count;
     }
 
-    Matrix_Rot16(item->rot);
-
-    const ANIM_FRAME *const frame = Item_GetBestFrame(item);
-    Matrix_TranslateRel16(frame->offset);
-    Matrix_Rot16(frame->mesh_rots[0]);
-
-    const OBJECT *const obj = Object_Get(item->object_id);
-    const OBJECT_MESH *mesh = Object_GetMesh(obj->mesh_idx);
-
-    Matrix_Push();
-    Matrix_TranslateRel16(mesh->center);
-    ptr->x = x + (g_MatrixPtr->_03 >> W2V_SHIFT);
-    ptr->y = y + (g_MatrixPtr->_13 >> W2V_SHIFT);
-    ptr->z = z + (g_MatrixPtr->_23 >> W2V_SHIFT);
-    ptr->r = mesh->radius;
-    ptr++;
-    Matrix_Pop();
-
-    const int16_t *extra_rotation = (int16_t *)item->data;
-    for (int32_t i = 1; i < obj->mesh_count; i++) {
-        const ANIM_BONE *const bone = Object_GetBone(obj, i - 1);
-        if (bone->matrix_pop) {
-            Matrix_Pop();
-        }
-        if (bone->matrix_push) {
-            Matrix_Push();
-        }
-
-        Matrix_TranslateRel32(bone->pos);
-        Matrix_Rot16(frame->mesh_rots[i]);
-
-        if (extra_rotation != nullptr) {
-            if (bone->rot_y) {
-                Matrix_RotY(*extra_rotation++);
-            }
-            if (bone->rot_x) {
-                Matrix_RotX(*extra_rotation++);
-            }
-            if (bone->rot_z) {
-                Matrix_RotZ(*extra_rotation++);
-            }
-        }
-
-        mesh = Object_GetMesh(obj->mesh_idx + i);
-        Matrix_Push();
-        Matrix_TranslateRel16(mesh->center);
-        ptr->x = x + (g_MatrixPtr->_03 >> W2V_SHIFT);
-        ptr->y = y + (g_MatrixPtr->_13 >> W2V_SHIFT);
-        ptr->z = z + (g_MatrixPtr->_23 >> W2V_SHIFT);
-        ptr->r = mesh->radius;
-        Matrix_Pop();
-
-        ptr++;
-    }
-
-    Matrix_Pop();
-    return obj->mesh_count;
+    const M_SPHERE_SET *const set = M_GetSphereSet(item);
+    memcpy(ptr, set->spheres, set->count * sizeof(SPHERE));
+    return set->count;
 }
 
 int32_t Collide_TestCollision(ITEM *item, ITEM *lara_item)
 {
-    SPHERE slist_baddie[34];
-    SPHERE slist_lara[34];
+    m_Stats.tests++;
+
+    // Copy the item spheres, as looking up Lara's may evict them.
+    SPHERE slist_baddie[MAX_SPHERES];
+    const M_SPHERE_SET *set = M_GetSphereSet(item);
+    const int32_t num1 = set->count;
+    const SPHERE bounds = set->bounds;
+    memcpy(slist_baddie, set->spheres, num1 * sizeof(SPHERE));
+
+    const M_SPHERE_SET *const lara_set = M_GetSphereSet(lara_item);
+    const int32_t num2 = lara_set->count;
+    const SPHERE *const slist_lara = lara_set->spheres;
 
     uint32_t flags = 0;
-    int32_t num1 = Collide_GetSpheres(item, slist_baddie, 1);
-    int32_t num2 = Collide_GetSpheres(lara_item, slist_lara, 1);
+    const int64_t bx = lara_set->bounds.x - bounds.x;
+    const int64_t by = lara_set->bounds.y - bounds.y;
+    const int64_t bz = lara_set->bounds.z - bounds.z;
+    const int64_t br = lara_set->bounds.r + bounds.r;
+    if (bounds.r <= 0 || lara_set->bounds.r <= 0
+        || SQUARE(bx) + SQUARE(by) + SQUARE(bz) >= SQUARE(br)) {
+        m_Stats.tests_culled++;
+        item->touch_bits = flags;
+        return flags;
+    }
 
     for (int i = 0; i < num1; i++) {
-        SPHERE *ptr1 = &slist_baddie[i];
+        const SPHERE *ptr1 = &slist_baddie[i];
         if (ptr1->r <= 0) {
             continue;
         }
         for (int j = 0; j < num2; j++) {
-            SPHERE *ptr2 = &slist_lara[j];
+            const SPHERE *ptr2 = &slist_lara[j];
             if (ptr2->r <= 0) {
                 continue;
             }
@@ -602,6 +805,21 @@ int32_t Collide_TestCollision(ITEM *item, ITEM *lara_item)
     return flags;
 }
 
+void Collide_ResetSphereCache(void)
+{
+    memset(m_SphereCache, 0, sizeof(m_SphereCache));
+}
+
+COLLIDE_STATS Collide_GetStats(void)
+{
+    return m_Stats;
+}
+
+void Collide_ResetStats(void)
+{
+    memset(&m_Stats, 0, sizeof(m_Stats));
+}
+
 void Collide_GetJointAbsPosition(ITEM *item, XYZ_32 *vec, int32_t joint)
 {
     const OBJECT *const obj = Object_Get(item->object_id);
@@ -4,6 +4,15 @@
 
 #include <stdint.h>
 
+typedef struct {
+    uint64_t tests;
+    uint64_t tests_culled;
+    uint64_t sphere_set_queries;
+    uint64_t sphere_sets_computed;
+    uint64_t spheres_queried;
+    uint64_t spheres_computed;
+} COLLIDE_STATS;
+
 void Collide_GetCollisionInfo(
     COLL_INFO *coll, int32_t xpos, int32_t ypos, int32_t zpos, int16_t room_num,
     int32_t objheight);
@@ -16,4 +25,10 @@ int32_t Collide_GetSpheres(ITEM *item, SPHERE *slist, int32_t world_space);
 
 int32_t Collide_TestCollision(ITEM *item, ITEM *lara_item);
 
+// World space spheres are cached per item until its position, rotation,
+// animation frame, extra rotations or meshes change. Call when loading a level.
+void Collide_ResetSphereCache(void);
+COLLIDE_STATS Collide_GetStats(void);
+void Collide_ResetStats(void);
+
 void Collide_GetJointAbsPosition(ITEM *item, XYZ_32 *vec, int32_t joint);
@@ -24,6 +24,7 @@
 
 #include <libtrx/config.h>
 #include <libtrx/debug.h>
+#include <libtrx/game/state_trace.h>
 #include <libtrx/log.h>
 
 #define MODIFY_CONFIG()                                                        \
@@ -33,7 +34,9 @@
     PROCESS_CONFIG(gameplay.enable_tr2_swim_cancel, false);                    \
     PROCESS_CONFIG(gameplay.enable_wading, false);                             \
     PROCESS_CONFIG(gameplay.target_mode, TLM_FULL);                            \
-    PROCESS_CONFIG(gameplay.fix_bear_ai, false);
+    PROCESS_CONFIG(gameplay.fix_bear_ai, false);                               \
+    PROCESS_CONFIG(gameplay.enable_shared_pathfinding, false);                 \
+    PROCESS_CONFIG(gameplay.maximum_active_enemies, NUM_SLOTS);
 
 typedef struct {
     const uint32_t *demo_ptr;
@@ -137,7 +140,9 @@ bool Demo_Start(const int32_t level_num)
     // Remember old inputs in case the demo was forcefully started with some
     // keys pressed. In that case, it should only be stopped if the user
     // presses some other key.
-    Input_Update();
+    if (!Shell_IsHeadless()) {
+        Input_Update();
+    }
 
     Interpolation_Remember();
 
@@ -276,10 +281,23 @@ GF_COMMAND Demo_Control(void)
     Sound_UpdateEffects();
     Overlay_BarHealthTimerTick();
     Output_AnimateTextures(1);
+    StateTrace_Update();
 
     return (GF_COMMAND) { .action = GF_NOOP };
 }
 
+bool Demo_ProcessInput(void)
+{
+    M_PRIV *const p = &m_Priv;
+    return M_ProcessInput(p);
+}
+
+void Demo_OverrideInput(const uint32_t *const data)
+{
+    M_PRIV *const p = &m_Priv;
+    p->demo_ptr = data;
+}
+
 void Demo_StopFlashing(void)
 {
     M_PRIV *const p = &m_Priv;
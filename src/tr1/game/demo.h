@@ -10,3 +10,11 @@ void Demo_StopFlashing(void);
 
 GF_COMMAND Demo_Control(void);
 int32_t Demo_ChooseLevel(int32_t demo_num);
+
+// Reads the next frame of demo input into g_Input. Returns false once the
+// demo data runs out.
+bool Demo_ProcessInput(void);
+
+// Replaces the remaining demo input with a custom list of TombATI key bits,
+// terminated with -1. The data must stay valid until the demo ends.
+void Demo_OverrideInput(const uint32_t *data);
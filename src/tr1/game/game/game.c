@@ -23,6 +23,7 @@
 
 #include <libtrx/config.h>
 #include <libtrx/debug.h>
+#include <libtrx/game/state_trace.h>
 #include <libtrx/game/ui/common.h>
 
 #define FRAME_BUFFER(key)                                                      \
@@ -112,6 +113,7 @@ GF_COMMAND Game_Control(const bool demo_mode)
 
     Interpolation_Remember();
     Stats_UpdateTimer();
+    Savegame_Update();
 
     Lara_Cheat_Control();
     if (g_LevelComplete) {
@@ -181,6 +183,7 @@ GF_COMMAND Game_Control(const bool demo_mode)
         Sound_UpdateEffects();
         Overlay_BarHealthTimerTick();
         Output_AnimateTextures(1);
+        StateTrace_Update();
     }
     return (GF_COMMAND) { .action = GF_NOOP };
 }
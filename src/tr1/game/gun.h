@@ -10,6 +10,9 @@
 
 void Gun_Control(void);
 void Gun_InitialiseNewWeapon(void);
+// Sizes the auto-aim target lists to the creature slot count. Must be called
+// after LOT_InitialiseArray on every level load.
+void Gun_InitialiseTargets(void);
 void Gun_AimWeapon(WEAPON_INFO *winfo, LARA_ARM *arm);
 int32_t Gun_FireWeapon(
     int32_t weapon_type, ITEM *target, ITEM *src, PHD_ANGLE *angles);
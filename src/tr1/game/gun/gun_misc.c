@@ -6,6 +6,7 @@
 #include "game/inventory.h"
 #include "game/items.h"
 #include "game/los.h"
+#include "game/lot.h"
 #include "game/random.h"
 #include "game/savegame.h"
 #include "game/sound.h"
@@ -14,6 +15,7 @@
 #include "global/vars.h"
 
 #include <libtrx/config.h>
+#include <libtrx/game/game_buf.h>
 #include <libtrx/game/math.h>
 #include <libtrx/game/matrix.h>
 #include <libtrx/utils.h>
@@ -48,8 +50,11 @@
 #define SHOTGUN_RARM_XMIN (-65 * DEG_1)
 #define SHOTGUN_RARM_XMAX (+65 * DEG_1)
 
-static ITEM *m_TargetList[NUM_SLOTS];
-static ITEM *m_LastTargetList[NUM_SLOTS];
+// Both lists are nullptr-terminated, so they hold one target fewer than their
+// size.
+static int32_t m_TargetListSize = 0;
+static ITEM **m_TargetList = nullptr;
+static ITEM **m_LastTargetList = nullptr;
 
 WEAPON_INFO g_Weapons[NUM_WEAPONS] = {
     // null
@@ -140,6 +145,19 @@ WEAPON_INFO g_Weapons[NUM_WEAPONS] = {
     },
 };
 
+void Gun_InitialiseTargets(void)
+{
+    m_TargetListSize = LOT_GetSlotCount();
+    m_TargetList = GameBuf_Alloc(
+        m_TargetListSize * sizeof(ITEM *), GBUF_CREATURE_DATA);
+    m_LastTargetList = GameBuf_Alloc(
+        m_TargetListSize * sizeof(ITEM *), GBUF_CREATURE_DATA);
+    for (int32_t i = 0; i < m_TargetListSize; i++) {
+        m_TargetList[i] = nullptr;
+        m_LastTargetList[i] = nullptr;
+    }
+}
+
 void Gun_TargetInfo(WEAPON_INFO *winfo)
 {
     if (!g_Lara.target) {
@@ -206,6 +224,7 @@ void Gun_GetNewTarget(WEAPON_INFO *winfo)
     ITEM *best_target = nullptr;
     int16_t best_yrot = 0x7FFF;
     int16_t num_targets = 0;
+    const int32_t max_targets = m_TargetListSize - 1;
 
     int32_t maxdist = winfo->target_dist;
     int32_t maxdist2 = maxdist * maxdist;
@@ -215,46 +234,62 @@ void Gun_GetNewTarget(WEAPON_INFO *winfo)
     src.z = g_LaraItem->pos.z;
     src.room_num = g_LaraItem->room_num;
 
+    // Gather the candidates in batches so that their line of sight checks
+    // can be resolved together.
+    ITEM *candidates[LOS_BATCH_SIZE];
+    LOS_QUERY queries[LOS_BATCH_SIZE];
     int16_t item_num = Item_GetNextActive();
-    while (item_num != NO_ITEM) {
-        ITEM *const item = Item_Get(item_num);
-        item_num = item->next_active;
-        if (item->hit_points <= 0) {
-            continue;
-        }
+    while (item_num != NO_ITEM && num_targets < max_targets) {
+        int32_t count = 0;
+        while (item_num != NO_ITEM && count < LOS_BATCH_SIZE) {
+            ITEM *const item = Item_Get(item_num);
+            item_num = item->next_active;
+            if (item->hit_points <= 0) {
+                continue;
+            }
 
-        int32_t x = item->pos.x - src.x;
-        int32_t y = item->pos.y - src.y;
-        int32_t z = item->pos.z - src.z;
-        if (ABS(x) > maxdist || ABS(y) > maxdist || ABS(z) > maxdist) {
-            continue;
-        }
+            int32_t x = item->pos.x - src.x;
+            int32_t y = item->pos.y - src.y;
+            int32_t z = item->pos.z - src.z;
+            if (ABS(x) > maxdist || ABS(y) > maxdist || ABS(z) > maxdist) {
+                continue;
+            }
 
-        int32_t dist = x * x + y * y + z * z;
-        if (dist >= maxdist2) {
-            continue;
-        }
+            int32_t dist = x * x + y * y + z * z;
+            if (dist >= maxdist2) {
+                continue;
+            }
 
-        GAME_VECTOR target;
-        Gun_FindTargetPoint(item, &target);
-        if (!LOS_Check(&src, &target)) {
-            continue;
+            candidates[count] = item;
+            queries[count].start = src;
+            Gun_FindTargetPoint(item, &queries[count].target);
+            count++;
         }
+        LOS_CheckBatch(queries, count);
 
-        PHD_ANGLE ang[2];
-        Math_GetVectorAngles(
-            target.x - src.x, target.y - src.y, target.z - src.z, ang);
-        ang[0] -= g_Lara.torso_rot.y + g_LaraItem->rot.y;
-        ang[1] -= g_Lara.torso_rot.x + g_LaraItem->rot.x;
-        if (ang[0] >= winfo->lock_angles[0] && ang[0] <= winfo->lock_angles[1]
-            && ang[1] >= winfo->lock_angles[2]
-            && ang[1] <= winfo->lock_angles[3]) {
-            int16_t yrot = ABS(ang[0]);
-            m_TargetList[num_targets] = item;
-            num_targets++;
-            if (yrot < best_yrot) {
-                best_yrot = yrot;
-                best_target = item;
+        for (int32_t i = 0; i < count && num_targets < max_targets; i++) {
+            if (!queries[i].is_visible) {
+                continue;
+            }
+
+            ITEM *const item = candidates[i];
+            const GAME_VECTOR *const target = &queries[i].target;
+            PHD_ANGLE ang[2];
+            Math_GetVectorAngles(
+                target->x - src.x, target->y - src.y, target->z - src.z, ang);
+            ang[0] -= g_Lara.torso_rot.y + g_LaraItem->rot.y;
+            ang[1] -= g_Lara.torso_rot.x + g_LaraItem->rot.x;
+            if (ang[0] >= winfo->lock_angles[0]
+                && ang[0] <= winfo->lock_angles[1]
+                && ang[1] >= winfo->lock_angles[2]
+                && ang[1] <= winfo->lock_angles[3]) {
+                int16_t yrot = ABS(ang[0]);
+                m_TargetList[num_targets] = item;
+                num_targets++;
+                if (yrot < best_yrot) {
+                    best_yrot = yrot;
+                    best_target = item;
+                }
             }
         }
     }
@@ -268,7 +303,7 @@ void Gun_GetNewTarget(WEAPON_INFO *winfo)
     }
 
     if (num_targets > 0) {
-        for (int slot = 0; slot < NUM_SLOTS; slot++) {
+        for (int slot = 0; slot < m_TargetListSize; slot++) {
             if (!m_TargetList[slot]) {
                 g_Lara.target = nullptr;
             }
@@ -287,7 +322,7 @@ void Gun_GetNewTarget(WEAPON_INFO *winfo)
     }
 
     if (g_Lara.target != m_LastTargetList[0]) {
-        for (int slot = NUM_SLOTS - 1; slot > 0; slot--) {
+        for (int slot = m_TargetListSize - 1; slot > 0; slot--) {
             m_LastTargetList[slot] = m_LastTargetList[slot - 1];
         }
         m_LastTargetList[0] = g_Lara.target;
@@ -301,12 +336,13 @@ void Gun_ChangeTarget(WEAPON_INFO *winfo)
     g_Lara.target = nullptr;
     bool found_new_target = false;
 
-    for (int new_target = 0; new_target < NUM_SLOTS; new_target++) {
+    for (int new_target = 0; new_target < m_TargetListSize; new_target++) {
         if (!m_TargetList[new_target]) {
             break;
         }
 
-        for (int last_target = 0; last_target < NUM_SLOTS; last_target++) {
+        for (int last_target = 0; last_target < m_TargetListSize;
+             last_target++) {
             if (!m_LastTargetList[last_target]) {
                 found_new_target = true;
                 break;
@@ -324,7 +360,8 @@ void Gun_ChangeTarget(WEAPON_INFO *winfo)
     }
 
     if (g_Lara.target != m_LastTargetList[0]) {
-        for (int last_target = NUM_SLOTS - 1; last_target > 0; last_target--) {
+        for (int last_target = m_TargetListSize - 1; last_target > 0;
+             last_target--) {
             m_LastTargetList[last_target] = m_LastTargetList[last_target - 1];
         }
         m_LastTargetList[0] = g_Lara.target;
@@ -8,6 +8,7 @@
 
 extern WEAPON_INFO g_Weapons[NUM_WEAPONS];
 
+void Gun_InitialiseTargets(void);
 void Gun_TargetInfo(WEAPON_INFO *winfo);
 void Gun_GetNewTarget(WEAPON_INFO *winfo);
 void Gun_ChangeTarget(WEAPON_INFO *winfo);
@@ -0,0 +1,492 @@
+#include "game/headless.h"
+
+#include "game/camera.h"
+#include "game/collide.h"
+#include "game/demo.h"
+#include "game/effects.h"
+#include "game/game.h"
+#include "game/game_flow.h"
+#include "game/input.h"
+#include "game/item_actions.h"
+#include "game/items.h"
+#include "game/lara/cheat.h"
+#include "game/lara/common.h"
+#include "game/lara/hair.h"
+#include "game/level.h"
+#include "game/los.h"
+#include "game/lot.h"
+#include "game/objects/common.h"
+#include "game/output.h"
+#include "game/overlay.h"
+#include "game/room.h"
+#include "game/savegame/savegame_bson.h"
+#include "game/shell.h"
+#include "game/sound.h"
+#include "global/vars.h"
+
+#include <libtrx/benchmark.h>
+#include <libtrx/config.h>
+#include <libtrx/filesystem.h>
+#include <libtrx/game/state_trace.h>
+#include <libtrx/json.h>
+#include <libtrx/log.h>
+#include <libtrx/memory.h>
+#include <libtrx/strings.h>
+
+#include <stdio.h>
+#include <string.h>
+
+#define SCRIPT_DELIMITERS " \t\r"
+#define GAMEFLOW_BENCHMARK_PASSES 100
+
+typedef struct {
+    const char *name;
+    uint32_t bit;
+} M_KEY;
+
+typedef struct {
+    const char *name;
+    void (*control)(void *user_data);
+} M_STEP;
+
+typedef struct {
+    int32_t tick_count;
+} M_REPLAY;
+
+// Key names of the scripted input file, mapped onto the TombATI key bits used
+// by the demo data.
+static const M_KEY m_Keys[] = {
+    // clang-format off
+    { "forward",    1 << 0 },
+    { "back",       1 << 1 },
+    { "left",       1 << 2 },
+    { "right",      1 << 3 },
+    { "jump",       1 << 4 },
+    { "draw",       1 << 5 },
+    { "action",     1 << 6 },
+    { "slow",       1 << 7 },
+    { "option",     1 << 8 },
+    { "look",       1 << 9 },
+    { "step_left",  1 << 10 },
+    { "step_right", 1 << 11 },
+    { "roll",       1 << 12 },
+    { nullptr,      0 },
+    // clang-format on
+};
+
+static void M_ControlItems(void *user_data);
+static void M_ControlEffects(void *user_data);
+static void M_ControlLara(void *user_data);
+static void M_ControlCamera(void *user_data);
+static void M_ControlSound(void *user_data);
+
+// The logic part of Demo_Control, split up so that each subsystem is timed
+// separately.
+static const M_STEP m_Steps[] = {
+    { .name = "items", .control = M_ControlItems },
+    { .name = "effects", .control = M_ControlEffects },
+    { .name = "lara", .control = M_ControlLara },
+    { .name = "camera", .control = M_ControlCamera },
+    { .name = "sound", .control = M_ControlSound },
+    { .name = nullptr }, // sentinel
+};
+
+static double m_StepTimes[sizeof(m_Steps) / sizeof(m_Steps[0])] = {};
+
+static bool M_ParseKey(const char *name, uint32_t *out_bit);
+static char *M_NextToken(char **cursor);
+static uint32_t *M_LoadScript(const char *path);
+static int32_t M_WakeCreatures(void);
+static void M_Tick(void);
+static void M_Replay(void *user_data);
+static void M_Report(int32_t tick_count, double total);
+static void M_ReportCreatures(void);
+static void M_ReportHeightCache(void);
+static void M_ReportCollisions(int32_t tick_count);
+static void M_ReportLOS(int32_t tick_count);
+static bool M_ReportTrace(void);
+static bool M_BenchmarkSavegame(const char *label);
+static bool M_RunLevelBenchmark(bool (*benchmark)(const char *label));
+
+static bool M_ParseKey(const char *const name, uint32_t *const out_bit)
+{
+    for (const M_KEY *key = m_Keys; key->name != nullptr; key++) {
+        if (strcmp(key->name, name) == 0) {
+            *out_bit = key->bit;
+            return true;
+        }
+    }
+    return false;
+}
+
+static char *M_NextToken(char **const cursor)
+{
+    char *c = *cursor;
+    while (*c != '\0' && strchr(SCRIPT_DELIMITERS, *c) != nullptr) {
+        c++;
+    }
+    if (*c == '\0') {
+        *cursor = c;
+        return nullptr;
+    }
+
+    char *const token = c;
+    while (*c != '\0' && strchr(SCRIPT_DELIMITERS, *c) == nullptr) {
+        c++;
+    }
+    if (*c != '\0') {
+        *c++ = '\0';
+    }
+    *cursor = c;
+    return token;
+}
+
+static uint32_t *M_LoadScript(const char *const path)
+{
+    char *data = nullptr;
+    if (!File_Load(path, &data, nullptr)) {
+        return nullptr;
+    }
+
+    int32_t count = 0;
+    int32_t capacity = 256;
+    uint32_t *words = Memory_Alloc(sizeof(uint32_t) * capacity);
+
+    int32_t line_num = 0;
+    char *next_line = data;
+    while (next_line != nullptr) {
+        char *cursor = next_line;
+        next_line = strchr(cursor, '\n');
+        if (next_line != nullptr) {
+            *next_line++ = '\0';
+        }
+        line_num++;
+
+        char *const comment = strchr(cursor, '#');
+        if (comment != nullptr) {
+            *comment = '\0';
+        }
+
+        const char *token = M_NextToken(&cursor);
+        if (token == nullptr) {
+            continue;
+        }
+
+        int32_t frames;
+        if (!String_ParseInteger(token, &frames) || frames <= 0) {
+            LOG_ERROR("%s:%d: invalid frame count '%s'", path, line_num, token);
+            goto fail;
+        }
+
+        uint32_t input = 0;
+        while ((token = M_NextToken(&cursor)) != nullptr) {
+            uint32_t bit;
+            if (!M_ParseKey(token, &bit)) {
+                LOG_ERROR("%s:%d: unknown key '%s'", path, line_num, token);
+                goto fail;
+            }
+            input |= bit;
+        }
+
+        if (count + frames + 1 > capacity) {
+            while (count + frames + 1 > capacity) {
+                capacity *= 2;
+            }
+            words = Memory_Realloc(words, sizeof(uint32_t) * capacity);
+        }
+        for (int32_t i = 0; i < frames; i++) {
+            words[count++] = input;
+        }
+    }
+
+    words[count] = (uint32_t)-1;
+    LOG_INFO("Loaded %d frames of input from %s", count, path);
+    Memory_FreePointer(&data);
+    return words;
+
+fail:
+    Memory_FreePointer(&words);
+    Memory_FreePointer(&data);
+    return nullptr;
+}
+
+static int32_t M_WakeCreatures(void)
+{
+    int32_t count = 0;
+    for (int16_t item_num = 0; item_num < Item_GetTotalCount(); item_num++) {
+        ITEM *const item = Item_Get(item_num);
+        if (!Object_Get(item->object_id)->intelligent || item->active
+            || item->status != IS_INACTIVE || (item->flags & IF_KILLED)) {
+            continue;
+        }
+
+        item->touch_bits = 0;
+        item->status =
+            LOT_EnableBaddieAI(item_num, false) ? IS_ACTIVE : IS_INVISIBLE;
+        Item_AddActive(item_num);
+        count++;
+    }
+    return count;
+}
+
+static void M_ControlItems(void *const user_data)
+{
+    Item_Control();
+}
+
+static void M_ControlEffects(void *const user_data)
+{
+    Effect_Control();
+}
+
+static void M_ControlLara(void *const user_data)
+{
+    Lara_Control();
+    Lara_Hair_Control();
+}
+
+static void M_ControlCamera(void *const user_data)
+{
+    Camera_Update();
+}
+
+static void M_ControlSound(void *const user_data)
+{
+    Sound_ResetAmbient();
+    ItemAction_RunActive();
+    Sound_UpdateEffects();
+}
+
+static void M_Tick(void)
+{
+    Lara_Cheat_Control();
+    Game_ProcessInput();
+    Output_ResetDynamicLights();
+
+    for (int32_t i = 0; m_Steps[i].name != nullptr; i++) {
+        m_StepTimes[i] += Benchmark_Measure(m_Steps[i].control, nullptr, 1);
+    }
+
+    Overlay_BarHealthTimerTick();
+    Output_AnimateTextures(1);
+    StateTrace_Update();
+}
+
+static void M_Replay(void *const user_data)
+{
+    M_REPLAY *const replay = user_data;
+    while (!g_LevelComplete) {
+        g_Input.any = 0;
+        g_InputDB.any = 0;
+        if (!Demo_ProcessInput()) {
+            break;
+        }
+        M_Tick();
+        replay->tick_count++;
+    }
+}
+
+static void M_Report(const int32_t tick_count, const double total)
+{
+    const double total_ms = total / 1e6;
+    printf(
+        "ticks: %d\ntime: %.2f ms\nticks/s: %.1f\n", tick_count, total_ms,
+        total_ms > 0.0 ? tick_count * 1000.0 / total_ms : 0.0);
+    for (int32_t i = 0; m_Steps[i].name != nullptr; i++) {
+        const double ms = m_StepTimes[i] / 1e6;
+        printf(
+            "%-8s %10.2f ms %8.4f ms/tick %5.1f%%\n", m_Steps[i].name, ms,
+            tick_count > 0 ? ms / tick_count : 0.0,
+            total_ms > 0.0 ? ms * 100.0 / total_ms : 0.0);
+    }
+    fflush(stdout);
+    LOG_INFO("%d ticks in %.2f ms", tick_count, total_ms);
+}
+
+static void M_ReportCreatures(void)
+{
+    const LOT_STATS stats = LOT_GetStats();
+    printf(
+        "ai slots: %d active, %d peak, %d limit\nai node memory: %.1f KiB\n",
+        stats.slots_used, stats.peak_slots_used, stats.slot_count,
+        stats.node_memory / 1024.0);
+    // The auto-aim target lists are sized to the creature slots.
+    const int32_t slot_count = LOT_GetSlotCount();
+    printf(
+        "target list memory: %.1f KiB for %d targets\n",
+        2 * slot_count * sizeof(ITEM *) / 1024.0, slot_count - 1);
+}
+
+static void M_ReportHeightCache(void)
+{
+    const ROOM_HEIGHT_CACHE_STATS stats = Room_GetHeightCacheStats();
+    const uint64_t queries = stats.hits + stats.misses;
+    if (queries == 0) {
+        printf("height cache: disabled\n");
+        return;
+    }
+    printf(
+        "height cache: %llu queries, %.1f%% hits, %llu invalidations\n",
+        (unsigned long long)queries, stats.hits * 100.0 / queries,
+        (unsigned long long)stats.invalidations);
+}
+
+static void M_ReportCollisions(const int32_t tick_count)
+{
+    const COLLIDE_STATS stats = Collide_GetStats();
+    const double ticks = MAX(tick_count, 1);
+    printf(
+        "collision: %.1f tests per tick, %.1f%% culled\n"
+        "spheres per tick: %.1f computed, %.1f without the cache\n",
+        stats.tests / ticks,
+        stats.tests ? stats.tests_culled * 100.0 / stats.tests : 0.0,
+        stats.spheres_computed / ticks, stats.spheres_queried / ticks);
+}
+
+static void M_ReportLOS(const int32_t tick_count)
+{
+    const LOS_STATS stats = LOS_GetStats();
+    printf(
+        "line of sight: %.1f checks per tick, %.1f%% cached\n",
+        stats.queries / (double)MAX(tick_count, 1),
+        stats.queries ? stats.hits * 100.0 / stats.queries : 0.0);
+}
+
+static bool M_ReportTrace(void)
+{
+    const STATE_TRACE_STATUS status = StateTrace_GetStatus();
+    if (!status.is_comparing) {
+        return true;
+    }
+    if (!status.is_diverged) {
+        printf("trace: %d checkpoints match\n", status.checkpoint_count);
+        return true;
+    }
+
+    if (status.diverged_subsystems == 0) {
+        printf(
+            "trace: diverged at frame %d: %d checkpoints, expected %d\n",
+            status.diverged_frame, status.checkpoint_count,
+            status.reference_count);
+        return false;
+    }
+
+    printf("trace: diverged at frame %d in:", status.diverged_frame);
+    for (int32_t i = 0; i < STATE_TRACE_NUMBER_OF; i++) {
+        if (status.diverged_subsystems & (1 << i)) {
+            printf(" %s", StateTrace_GetSubsystemName(i));
+        }
+    }
+    printf("\n");
+    return false;
+}
+
+static bool M_BenchmarkSavegame(const char *const label)
+{
+    return Savegame_BSON_Benchmark(&g_GameInfo, label);
+}
+
+static bool M_RunLevelBenchmark(bool (*const benchmark)(const char *label))
+{
+    bool result = true;
+    const GF_LEVEL_TABLE *const table = GF_GetLevelTable(GFLT_MAIN);
+    for (int32_t i = 0; i < table->count; i++) {
+        const GF_LEVEL *const level = &table->levels[i];
+        if (level->type != GFL_NORMAL && level->type != GFL_GYM
+            && level->type != GFL_BONUS) {
+            continue;
+        }
+        if (!Level_Initialise(level)) {
+            result = false;
+            continue;
+        }
+        result &= benchmark(level->path);
+    }
+    fflush(stdout);
+    return result;
+}
+
+bool Headless_Run(const HEADLESS_OPTIONS *const options)
+{
+    if (options->benchmark_rooms) {
+        return M_RunLevelBenchmark(Room_Benchmark);
+    }
+    if (options->benchmark_los) {
+        return M_RunLevelBenchmark(LOS_Benchmark);
+    }
+    if (options->benchmark_json) {
+        const bool result = JSON_Benchmark(
+            Shell_GetGameFlowPath(), GAMEFLOW_BENCHMARK_PASSES);
+        return M_RunLevelBenchmark(M_BenchmarkSavegame) && result;
+    }
+
+    const int32_t level_num = Demo_ChooseLevel(options->demo_num);
+    const GF_LEVEL *const level = GF_GetLevel(GFLT_DEMOS, level_num);
+    if (level == nullptr) {
+        LOG_ERROR("Missing demo: %d", options->demo_num);
+        return false;
+    }
+
+    uint32_t *script = nullptr;
+    if (options->input_path != nullptr) {
+        script = M_LoadScript(options->input_path);
+        if (script == nullptr) {
+            return false;
+        }
+    }
+
+    Room_SetHeightCacheEnabled(!options->disable_height_cache);
+    const CONFIG user_config = g_Config;
+    if (!Level_Initialise(level) || !Demo_Start(level_num)) {
+        Memory_FreePointer(&script);
+        return false;
+    }
+    if (script != nullptr) {
+        Demo_OverrideInput(script);
+    }
+    if (options->wake_creatures) {
+        g_Config.gameplay.enable_shared_pathfinding =
+            user_config.gameplay.enable_shared_pathfinding;
+        g_Config.gameplay.maximum_active_enemies =
+            user_config.gameplay.maximum_active_enemies;
+        const int32_t count = M_WakeCreatures();
+        printf(
+            "creatures: %d, shared pathfinding: %s\n", count,
+            g_Config.gameplay.enable_shared_pathfinding ? "on" : "off");
+    }
+
+    bool result = true;
+    if (options->compare_path != nullptr) {
+        result = StateTrace_StartComparing(options->compare_path);
+    } else if (options->trace_path != nullptr) {
+        result = StateTrace_StartRecording(
+            options->trace_path, options->trace_interval);
+    }
+    if (!result) {
+        Demo_End();
+        Memory_FreePointer(&script);
+        return false;
+    }
+    Game_SetIsPlaying(true);
+
+    Room_ResetHeightCacheStats();
+    Collide_ResetStats();
+    LOS_ResetStats();
+    memset(m_StepTimes, 0, sizeof(m_StepTimes));
+    M_REPLAY replay = {};
+    const double total = Benchmark_Measure(M_Replay, &replay, 1);
+
+    StateTrace_Stop();
+    if (options->wake_creatures) {
+        M_ReportCreatures();
+    }
+    M_ReportHeightCache();
+    M_ReportCollisions(replay.tick_count);
+    M_ReportLOS(replay.tick_count);
+    Game_SetIsPlaying(false);
+    Demo_End();
+    Memory_FreePointer(&script);
+
+    M_Report(replay.tick_count, total);
+    return M_ReportTrace();
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <stdint.h>
+
+typedef struct {
+    int32_t demo_num;
+    // Activates every enemy in the level at the start to stress the AI. Unlike
+    // regular demos, the configured pathfinding mode is kept.
+    bool wake_creatures;
+    // Instead of replaying a demo, times room lookups at the centre of every
+    // room of every level and checks them against the original linear scan.
+    bool benchmark_rooms;
+    // Times random line of sight checks in every level, with and without the
+    // result cache.
+    bool benchmark_los;
+    // Times writing, parsing and querying the gameflow and the savegame of
+    // every level, with and without the object key index.
+    bool benchmark_json;
+    // Bypasses the floor and ceiling height cache to measure its effect.
+    bool disable_height_cache;
+    // Replaces the recorded demo input with a scripted input file.
+    char *input_path;
+    // Records a state trace, or compares the replay against one.
+    char *trace_path;
+    char *compare_path;
+    int32_t trace_interval;
+} HEADLESS_OPTIONS;
+
+// Replays a demo level as fast as possible without rendering and prints the
+// tick rate along with the time spent in each part of the game logic. Returns
+// false if the demo cannot be run or diverges from the compared state trace.
+bool Headless_Run(const HEADLESS_OPTIONS *options);
@@ -31,6 +31,8 @@ static BOUNDS_16 m_InterpolatedBounds = {};
 
 void Item_Control(void)
 {
+    LOT_StartSearchFrame();
+
     int16_t item_num = Item_GetNextActive();
     while (item_num != NO_ITEM) {
         ITEM *item = Item_Get(item_num);
@@ -2,9 +2,11 @@
 
 #include "game/camera.h"
 #include "game/carrier.h"
+#include "game/collide.h"
 #include "game/effects.h"
 #include "game/game.h"
 #include "game/game_flow.h"
+#include "game/gun.h"
 #include "game/inject.h"
 #include "game/inventory_ring/vars.h"
 #include "game/items.h"
@@ -437,6 +439,7 @@ static void M_CompleteSetup(const GF_LEVEL *const level)
     Mutant_ToggleExplosions(Object_Get(O_EXPLOSION_1)->loaded);
 
     Inject_AllInjections(&m_LevelInfo);
+    Room_InvalidateHeightCache();
 
     Level_LoadAnimFrames(&m_LevelInfo);
     Level_LoadAnimCommands();
@@ -610,6 +613,7 @@ bool Level_Initialise(const GF_LEVEL *const level)
 
     Camera_Reset();
     Pierre_Reset();
+    Collide_ResetSphereCache();
 
     Lara_InitialiseLoad(NO_ITEM);
     Level_Load(level);
@@ -621,6 +625,7 @@ bool Level_Initialise(const GF_LEVEL *const level)
 
     Effect_InitialiseArray();
     LOT_InitialiseArray();
+    Gun_InitialiseTargets();
 
     Overlay_Init();
     Overlay_BarSetHealthTimer(100);
@@ -1,16 +1,72 @@
 #include "game/los.h"
 
+#include "game/camera.h"
 #include "game/room.h"
 #include "global/const.h"
 
+#include <libtrx/benchmark.h>
+#include <libtrx/hash.h>
+#include <libtrx/memory.h>
 #include <libtrx/utils.h>
 
 #include <stdint.h>
-
+#include <stdio.h>
+#include <string.h>
+
+// Must be a power of two.
+#define LOS_CACHE_SIZE 256
+#define BENCHMARK_RAYS 128
+#define BENCHMARK_PASSES 100
+
+typedef struct {
+    uint32_t version;
+    bool is_chunky;
+    bool is_visible;
+    GAME_VECTOR start;
+    GAME_VECTOR target;
+    GAME_VECTOR result;
+} M_CACHE_ENTRY;
+
+typedef struct {
+    const LOS_QUERY *rays;
+    LOS_QUERY *results;
+    int32_t count;
+} M_BENCHMARK;
+
+static struct {
+    bool is_enabled;
+    // Set while checking a ray that depends on object heights.
+    bool is_volatile;
+    LOS_STATS stats;
+    M_CACHE_ENTRY entries[LOS_CACHE_SIZE];
+} m_Cache = {
+    .is_enabled = true,
+};
+
+static bool M_IsBlocked(const SECTOR *sector, int32_t x, int32_t y, int32_t z);
 static int32_t M_CheckX(const GAME_VECTOR *start, GAME_VECTOR *target);
 static int32_t M_CheckZ(const GAME_VECTOR *start, GAME_VECTOR *target);
 static bool M_ClipTarget(
     const GAME_VECTOR *start, GAME_VECTOR *target, const SECTOR *sector);
+static bool M_Check(const GAME_VECTOR *start, GAME_VECTOR *target);
+static bool M_IsSameVector(const GAME_VECTOR *a, const GAME_VECTOR *b);
+static M_CACHE_ENTRY *M_GetCacheEntry(
+    const GAME_VECTOR *start, const GAME_VECTOR *target);
+static uint32_t M_Random(uint32_t *seed);
+static GAME_VECTOR M_GetRandomPoint(int16_t room_num, uint32_t *seed);
+static void M_BenchmarkChecks(void *user_data);
+
+static bool M_IsBlocked(
+    const SECTOR *const sector, const int32_t x, const int32_t y,
+    const int32_t z)
+{
+    if (Room_GetPitSector(sector, x, z)->flags
+        & (SF_FLOOR_OBJECTS | SF_CEILING_OBJECTS)) {
+        m_Cache.is_volatile = true;
+    }
+    return y > Room_GetHeight(sector, x, y, z)
+        || y < Room_GetCeiling(sector, x, y, z);
+}
 
 static int32_t M_CheckX(
     const GAME_VECTOR *const start, GAME_VECTOR *const target)
@@ -35,8 +91,7 @@ static int32_t M_CheckX(
 
         while (x > target->x) {
             sector = Room_GetSector(x, y, z, &room_num);
-            if (y > Room_GetHeight(sector, x, y, z)
-                || y < Room_GetCeiling(sector, x, y, z)) {
+            if (M_IsBlocked(sector, x, y, z)) {
                 target->x = x;
                 target->y = y;
                 target->z = z;
@@ -47,8 +102,7 @@ static int32_t M_CheckX(
             last_room = room_num;
 
             sector = Room_GetSector(x - 1, y, z, &room_num);
-            if (y > Room_GetHeight(sector, x - 1, y, z)
-                || y < Room_GetCeiling(sector, x - 1, y, z)) {
+            if (M_IsBlocked(sector, x - 1, y, z)) {
                 target->x = x;
                 target->y = y;
                 target->z = z;
@@ -67,8 +121,7 @@ static int32_t M_CheckX(
 
         while (x < target->x) {
             sector = Room_GetSector(x, y, z, &room_num);
-            if (y > Room_GetHeight(sector, x, y, z)
-                || y < Room_GetCeiling(sector, x, y, z)) {
+            if (M_IsBlocked(sector, x, y, z)) {
                 target->x = x;
                 target->y = y;
                 target->z = z;
@@ -79,8 +132,7 @@ static int32_t M_CheckX(
             last_room = room_num;
 
             sector = Room_GetSector(x + 1, y, z, &room_num);
-            if (y > Room_GetHeight(sector, x + 1, y, z)
-                || y < Room_GetCeiling(sector, x + 1, y, z)) {
+            if (M_IsBlocked(sector, x + 1, y, z)) {
                 target->x = x;
                 target->y = y;
                 target->z = z;
@@ -121,8 +173,7 @@ static int32_t M_CheckZ(
 
         while (z > target->z) {
             sector = Room_GetSector(x, y, z, &room_num);
-            if (y > Room_GetHeight(sector, x, y, z)
-                || y < Room_GetCeiling(sector, x, y, z)) {
+            if (M_IsBlocked(sector, x, y, z)) {
                 target->x = x;
                 target->y = y;
                 target->z = z;
@@ -133,8 +184,7 @@ static int32_t M_CheckZ(
             last_room = room_num;
 
             sector = Room_GetSector(x, y, z - 1, &room_num);
-            if (y > Room_GetHeight(sector, x, y, z - 1)
-                || y < Room_GetCeiling(sector, x, y, z - 1)) {
+            if (M_IsBlocked(sector, x, y, z - 1)) {
                 target->x = x;
                 target->y = y;
                 target->z = z;
@@ -153,8 +203,7 @@ static int32_t M_CheckZ(
 
         while (z < target->z) {
             sector = Room_GetSector(x, y, z, &room_num);
-            if (y > Room_GetHeight(sector, x, y, z)
-                || y < Room_GetCeiling(sector, x, y, z)) {
+            if (M_IsBlocked(sector, x, y, z)) {
                 target->x = x;
                 target->y = y;
                 target->z = z;
@@ -165,8 +214,7 @@ static int32_t M_CheckZ(
             last_room = room_num;
 
             sector = Room_GetSector(x, y, z + 1, &room_num);
-            if (y > Room_GetHeight(sector, x, y, z + 1)
-                || y < Room_GetCeiling(sector, x, y, z + 1)) {
+            if (M_IsBlocked(sector, x, y, z + 1)) {
                 target->x = x;
                 target->y = y;
                 target->z = z;
@@ -192,6 +240,11 @@ static bool M_ClipTarget(
     int32_t dy = target->y - start->y;
     int32_t dz = target->z - start->z;
 
+    if (Room_GetPitSector(sector, target->x, target->z)->flags
+        & (SF_FLOOR_OBJECTS | SF_CEILING_OBJECTS)) {
+        m_Cache.is_volatile = true;
+    }
+
     const int32_t height =
         Room_GetHeight(sector, target->x, target->y, target->z);
     if (target->y > height && start->y < height) {
@@ -213,7 +266,7 @@ static bool M_ClipTarget(
     return true;
 }
 
-bool LOS_Check(const GAME_VECTOR *const start, GAME_VECTOR *const target)
+static bool M_Check(const GAME_VECTOR *const start, GAME_VECTOR *const target)
 {
     int32_t los1;
     int32_t los2;
@@ -235,3 +288,200 @@ bool LOS_Check(const GAME_VECTOR *const start, GAME_VECTOR *const target)
 
     return M_ClipTarget(start, target, sector) && los1 == 1 && los2 == 1;
 }
+
+static bool M_IsSameVector(
+    const GAME_VECTOR *const a, const GAME_VECTOR *const b)
+{
+    return a->x == b->x && a->y == b->y && a->z == b->z
+        && a->room_num == b->room_num;
+}
+
+static M_CACHE_ENTRY *M_GetCacheEntry(
+    const GAME_VECTOR *const start, const GAME_VECTOR *const target)
+{
+    const uint32_t key[] = {
+        start->x, start->y, start->z, target->x, target->y, target->z,
+    };
+    const uint32_t hash = Hash_Mix32(key, sizeof(key) / sizeof(key[0]));
+    return &m_Cache.entries[hash & (LOS_CACHE_SIZE - 1)];
+}
+
+bool LOS_Check(const GAME_VECTOR *const start, GAME_VECTOR *const target)
+{
+    m_Cache.stats.queries++;
+    if (!m_Cache.is_enabled) {
+        return M_Check(start, target);
+    }
+
+    // The camera checks with chunky heights, which must not be mixed up with
+    // the regular results.
+    const uint32_t version = Room_GetGeometryVersion();
+    const bool is_chunky = Camera_IsChunky();
+    M_CACHE_ENTRY *const entry = M_GetCacheEntry(start, target);
+    if (entry->version == version && entry->is_chunky == is_chunky
+        && M_IsSameVector(&entry->start, start)
+        && M_IsSameVector(&entry->target, target)) {
+        m_Cache.stats.hits++;
+        *target = entry->result;
+        return entry->is_visible;
+    }
+
+    const GAME_VECTOR input = *target;
+    m_Cache.is_volatile = false;
+    const bool is_visible = M_Check(start, target);
+    if (m_Cache.is_volatile) {
+        m_Cache.stats.uncacheable++;
+        return is_visible;
+    }
+
+    entry->version = version;
+    entry->is_chunky = is_chunky;
+    entry->is_visible = is_visible;
+    entry->start = *start;
+    entry->target = input;
+    entry->result = *target;
+    return is_visible;
+}
+
+void LOS_CheckBatch(LOS_QUERY *const queries, const int32_t count)
+{
+    for (int32_t base = 0; base < count; base += LOS_BATCH_SIZE) {
+        const int32_t batch_count = MIN(count - base, LOS_BATCH_SIZE);
+        LOS_QUERY *const batch = &queries[base];
+
+        GAME_VECTOR inputs[LOS_BATCH_SIZE];
+        for (int32_t i = 0; i < batch_count; i++) {
+            inputs[i] = batch[i].target;
+        }
+
+        for (int32_t i = 0; i < batch_count; i++) {
+            LOS_QUERY *const query = &batch[i];
+            const LOS_QUERY *duplicate = nullptr;
+            for (int32_t j = 0; j < i; j++) {
+                if (M_IsSameVector(&batch[j].start, &query->start)
+                    && M_IsSameVector(&inputs[j], &inputs[i])) {
+                    duplicate = &batch[j];
+                    break;
+                }
+            }
+
+            if (duplicate != nullptr) {
+                m_Cache.stats.duplicates++;
+                query->target = duplicate->target;
+                query->is_visible = duplicate->is_visible;
+            } else {
+                query->is_visible = LOS_Check(&query->start, &query->target);
+            }
+        }
+    }
+}
+
+void LOS_SetCacheEnabled(const bool is_enabled)
+{
+    m_Cache.is_enabled = is_enabled;
+    memset(m_Cache.entries, 0, sizeof(m_Cache.entries));
+}
+
+LOS_STATS LOS_GetStats(void)
+{
+    return m_Cache.stats;
+}
+
+void LOS_ResetStats(void)
+{
+    memset(&m_Cache.stats, 0, sizeof(m_Cache.stats));
+}
+
+static uint32_t M_Random(uint32_t *const seed)
+{
+    // Keeps the game's own random generator untouched.
+    *seed = *seed * 1103515245 + 12345;
+    return *seed >> 8;
+}
+
+static GAME_VECTOR M_GetRandomPoint(
+    const int16_t room_num, uint32_t *const seed)
+{
+    const ROOM *const room = Room_Get(room_num);
+    const int32_t size_x = MAX(room->size.x - 2, 1) * WALL_L;
+    const int32_t size_z = MAX(room->size.z - 2, 1) * WALL_L;
+    const int32_t size_y = MAX(room->min_floor - room->max_ceiling, 1);
+    GAME_VECTOR point = { .room_num = room_num };
+    point.x = room->pos.x + WALL_L + M_Random(seed) % size_x;
+    point.y = room->max_ceiling + M_Random(seed) % size_y;
+    point.z = room->pos.z + WALL_L + M_Random(seed) % size_z;
+    return point;
+}
+
+static void M_BenchmarkChecks(void *const user_data)
+{
+    const M_BENCHMARK *const benchmark = user_data;
+    for (int32_t i = 0; i < benchmark->count; i++) {
+        LOS_QUERY *const result = &benchmark->results[i];
+        *result = benchmark->rays[i];
+        result->is_visible = LOS_Check(&result->start, &result->target);
+    }
+}
+
+bool LOS_Benchmark(const char *const label)
+{
+    int16_t *room_nums = Memory_Alloc(sizeof(int16_t) * Room_GetCount());
+    int32_t room_count = 0;
+    for (int32_t i = 0; i < Room_GetCount(); i++) {
+        if (Room_Get(i)->flip_status != RFS_FLIPPED) {
+            room_nums[room_count++] = i;
+        }
+    }
+
+    // Cast rays from random points to random points in the same or an
+    // adjoining room, where most of the game's checks take place.
+    uint32_t seed = 0x5EED;
+    LOS_QUERY rays[BENCHMARK_RAYS];
+    for (int32_t i = 0; i < BENCHMARK_RAYS && room_count > 0; i++) {
+        const int16_t room_num = room_nums[M_Random(&seed) % room_count];
+        int16_t adjoining[12];
+        const int32_t adjoining_count =
+            Room_GetAdjoiningRooms(room_num, adjoining, 12);
+        rays[i].start = M_GetRandomPoint(room_num, &seed);
+        rays[i].target = M_GetRandomPoint(
+            adjoining[M_Random(&seed) % adjoining_count], &seed);
+    }
+    const int32_t count = room_count > 0 ? BENCHMARK_RAYS : 0;
+    Memory_FreePointer(&room_nums);
+
+    LOS_QUERY expected[BENCHMARK_RAYS];
+    LOS_QUERY results[BENCHMARK_RAYS];
+    M_BENCHMARK benchmark = {
+        .rays = rays,
+        .results = expected,
+        .count = count,
+    };
+    LOS_SetCacheEnabled(false);
+    const double uncached =
+        Benchmark_Measure(M_BenchmarkChecks, &benchmark, BENCHMARK_PASSES);
+    LOS_SetCacheEnabled(true);
+    LOS_ResetStats();
+    benchmark.results = results;
+    const double cached =
+        Benchmark_Measure(M_BenchmarkChecks, &benchmark, BENCHMARK_PASSES);
+    const LOS_STATS stats = LOS_GetStats();
+
+    int32_t mismatches = 0;
+    int32_t visible = 0;
+    for (int32_t i = 0; i < count; i++) {
+        visible += expected[i].is_visible;
+        if (results[i].is_visible != expected[i].is_visible
+            || !M_IsSameVector(&results[i].target, &expected[i].target)) {
+            mismatches++;
+        }
+    }
+
+    printf(
+        "%-24s %4d rays %3d visible %9.1f ns uncached %9.1f ns cached "
+        "%5.1f%% hits%s\n",
+        label, count, visible, count > 0 ? uncached / count : 0.0,
+        count > 0 ? cached / count : 0.0,
+        stats.queries ? stats.hits * 100.0 / stats.queries : 0.0,
+        mismatches > 0 ? " MISMATCH" : "");
+    return mismatches == 0;
+}
@@ -2,4 +2,33 @@
 
 #include "global/types.h"
 
+// The largest batch whose duplicate queries are coalesced. Larger batches are
+// split up.
+#define LOS_BATCH_SIZE 32
+
+typedef struct {
+    GAME_VECTOR start;
+    // Clipped to the first obstruction, like the target of LOS_Check.
+    GAME_VECTOR target;
+    bool is_visible;
+} LOS_QUERY;
+
+typedef struct {
+    uint64_t queries;
+    uint64_t hits;
+    uint64_t duplicates;
+    // Rays that pass sectors with bridges, trapdoors and similar objects,
+    // whose heights can change at any time.
+    uint64_t uncacheable;
+} LOS_STATS;
+
+// Results are memoised until the room geometry changes.
 bool LOS_Check(const GAME_VECTOR *start, GAME_VECTOR *target);
+void LOS_CheckBatch(LOS_QUERY *queries, int32_t count);
+
+void LOS_SetCacheEnabled(bool is_enabled);
+LOS_STATS LOS_GetStats(void);
+void LOS_ResetStats(void);
+// Times random rays in the loaded level with and without the cache and prints
+// the results.
+bool LOS_Benchmark(const char *label);
@@ -6,24 +6,41 @@
 #include "global/const.h"
 #include "global/vars.h"
 
+#include <libtrx/config.h>
 #include <libtrx/debug.h>
 #include <libtrx/game/game_buf.h>
 #include <libtrx/utils.h>
 
+static int32_t m_SlotCount = 0;
 static int32_t m_SlotsUsed = 0;
+static int32_t m_PeakSlotsUsed = 0;
+static int32_t m_NodeArrayCount = 0;
 static CREATURE *m_BaddieSlots = nullptr;
 
+static int32_t M_GetSlotLimit(void);
+
+static int32_t M_GetSlotLimit(void)
+{
+    return MIN(g_Config.gameplay.maximum_active_enemies, m_SlotCount);
+}
+
 void LOT_InitialiseArray(void)
 {
+    // Creature slots are cheap, so allocate as many as the limit allows. The
+    // large per-slot box node arrays are only allocated when a slot is first
+    // used. Demos always need the original slot count.
+    m_SlotCount = MAX(g_Config.gameplay.maximum_active_enemies, NUM_SLOTS);
     m_BaddieSlots =
-        GameBuf_Alloc(NUM_SLOTS * sizeof(CREATURE), GBUF_CREATURE_DATA);
-    for (int i = 0; i < NUM_SLOTS; i++) {
+        GameBuf_Alloc(m_SlotCount * sizeof(CREATURE), GBUF_CREATURE_DATA);
+    for (int32_t i = 0; i < m_SlotCount; i++) {
         CREATURE *creature = &m_BaddieSlots[i];
         creature->item_num = NO_ITEM;
-        creature->lot.node =
-            GameBuf_Alloc(sizeof(BOX_NODE) * g_NumberBoxes, GBUF_CREATURE_LOT);
+        creature->lot.node = nullptr;
     }
     m_SlotsUsed = 0;
+    m_PeakSlotsUsed = 0;
+    m_NodeArrayCount = 0;
+    LOT_ResetSearch(MAX_EXPANSION, NUM_SLOTS);
 }
 
 void LOT_DisableBaddieAI(int16_t item_num)
@@ -43,8 +60,9 @@ bool LOT_EnableBaddieAI(int16_t item_num, int32_t always)
         return true;
     }
 
-    if (m_SlotsUsed < NUM_SLOTS) {
-        for (int32_t slot = 0; slot < NUM_SLOTS; slot++) {
+    if (m_SlotsUsed < M_GetSlotLimit()) {
+        // Prefer the lowest free slot to reuse already allocated nodes.
+        for (int32_t slot = 0; slot < m_SlotCount; slot++) {
             CREATURE *creature = &m_BaddieSlots[slot];
             if (creature->item_num == NO_ITEM) {
                 LOT_InitialiseSlot(item_num, slot);
@@ -64,8 +82,11 @@ bool LOT_EnableBaddieAI(int16_t item_num, int32_t always)
     }
 
     int32_t worst_slot = -1;
-    for (int32_t slot = 0; slot < NUM_SLOTS; slot++) {
+    for (int32_t slot = 0; slot < m_SlotCount; slot++) {
         CREATURE *creature = &m_BaddieSlots[slot];
+        if (creature->item_num == NO_ITEM) {
+            continue;
+        }
         const ITEM *const item = Item_Get(creature->item_num);
         int32_t x = (item->pos.x - g_Camera.pos.x) >> 8;
         int32_t y = (item->pos.y - g_Camera.pos.y) >> 8;
@@ -90,6 +111,12 @@ bool LOT_EnableBaddieAI(int16_t item_num, int32_t always)
 void LOT_InitialiseSlot(int16_t item_num, int32_t slot)
 {
     CREATURE *creature = &m_BaddieSlots[slot];
+    if (creature->lot.node == nullptr) {
+        creature->lot.node =
+            GameBuf_Alloc(sizeof(BOX_NODE) * g_NumberBoxes, GBUF_CREATURE_LOT);
+        m_NodeArrayCount++;
+    }
+
     ITEM *const item = Item_Get(item_num);
     item->data = creature;
     creature->item_num = item_num;
@@ -139,6 +166,7 @@ void LOT_InitialiseSlot(int16_t item_num, int32_t slot)
     LOT_CreateZone(item);
 
     m_SlotsUsed++;
+    m_PeakSlotsUsed = MAX(m_PeakSlotsUsed, m_SlotsUsed);
 }
 
 void LOT_CreateZone(ITEM *item)
@@ -182,6 +210,22 @@ void LOT_InitialiseLOT(LOT_INFO *LOT)
     LOT_ClearLOT(LOT);
 }
 
+int32_t LOT_GetSlotCount(void)
+{
+    return m_SlotCount;
+}
+
+LOT_STATS LOT_GetStats(void)
+{
+    return (LOT_STATS) {
+        .slot_count = M_GetSlotLimit(),
+        .slots_used = m_SlotsUsed,
+        .peak_slots_used = m_PeakSlotsUsed,
+        .node_memory = (size_t)m_NodeArrayCount * g_NumberBoxes
+            * sizeof(BOX_NODE),
+    };
+}
+
 void LOT_ClearLOT(LOT_INFO *LOT)
 {
     LOT->search_num = 0;
@@ -2,8 +2,17 @@
 
 #include "global/types.h"
 
+#include <stddef.h>
 #include <stdint.h>
 
+typedef struct {
+    int32_t slot_count;
+    int32_t slots_used;
+    int32_t peak_slots_used;
+    // Memory taken by the box node arrays of all slots used so far.
+    size_t node_memory;
+} LOT_STATS;
+
 void LOT_InitialiseArray(void);
 void LOT_DisableBaddieAI(int16_t item_num);
 bool LOT_EnableBaddieAI(int16_t item_num, int32_t always);
@@ -11,3 +20,7 @@ void LOT_InitialiseSlot(int16_t item_num, int32_t slot);
 void LOT_CreateZone(ITEM *item);
 void LOT_InitialiseLOT(LOT_INFO *LOT);
 void LOT_ClearLOT(LOT_INFO *LOT);
+// Returns the number of allocated creature slots, which is the most enemies
+// that can be active at once in the current level.
+int32_t LOT_GetSlotCount(void);
+LOT_STATS LOT_GetStats(void);
@@ -60,6 +60,7 @@ static void M_Initialise(
     }
     door_pos->block = box_num;
     door_pos->old_sector = *door_pos->sector;
+    door_pos->is_shut = false;
 }
 
 static bool M_LaraDoorCollision(const SECTOR *const sector)
@@ -102,6 +103,10 @@ static void M_Shut(DOORPOS_DATA *const d)
     sector->portal_room.sky = NO_ROOM;
     sector->portal_room.pit = NO_ROOM;
     sector->portal_room.wall = NO_ROOM;
+    if (!d->is_shut) {
+        d->is_shut = true;
+        Room_InvalidateHeightCache();
+    }
 
     const int16_t box_num = d->block;
     if (box_num != NO_BOX) {
@@ -118,6 +123,10 @@ static void M_Open(DOORPOS_DATA *const d)
     }
 
     *sector = d->old_sector;
+    if (d->is_shut) {
+        d->is_shut = false;
+        Room_InvalidateHeightCache();
+    }
 
     const int16_t box_num = d->block;
     if (box_num != NO_BOX) {
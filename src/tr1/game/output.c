@@ -27,6 +27,7 @@
 
 #define MAX_LIGHTNINGS 64
 #define PHD_IONE (PHD_ONE / 4)
+#define ROOM_VERTEX_BATCH 64
 
 typedef struct {
     struct {
@@ -446,34 +447,92 @@ static void M_CalcSkyboxLight(const OBJECT_MESH *const mesh)
 
 static void M_CalcRoomVertices(const ROOM_MESH *const mesh)
 {
-    for (int32_t i = 0; i < mesh->num_vertices; i++) {
-        PHD_VBUF *const vbuf = &m_VBuf[i];
-        const ROOM_VERTEX *const vertex = &mesh->vertices[i];
-
-        M_CalcVertex(vbuf, vertex->pos);
-
-        vbuf->g = vertex->light_adder;
-        if (vbuf->zv >= Output_GetNearZ()) {
-            const int32_t depth = ((int32_t)vbuf->zv) >> W2V_SHIFT;
-            if (depth > Output_GetDrawDistMax()) {
-                vbuf->g = MAX_LIGHTING;
-                if (!m_IsSkyboxEnabled) {
-                    vbuf->clip |= 16;
-                }
+    const MATRIX mptr = *g_MatrixPtr;
+    const int32_t near_z = Output_GetNearZ();
+    const int32_t draw_dist_max = Output_GetDrawDistMax();
+    const int32_t center_x = Viewport_GetCenterX();
+    const int32_t center_y = Viewport_GetCenterY();
+    const int32_t persp_z = g_PhdPersp;
+    const int32_t left = g_PhdLeft;
+    const int32_t top = g_PhdTop;
+    const int32_t right = g_PhdRight;
+    const int32_t bottom = g_PhdBottom;
+
+    int32_t xv_batch[ROOM_VERTEX_BATCH];
+    int32_t yv_batch[ROOM_VERTEX_BATCH];
+    int32_t zv_batch[ROOM_VERTEX_BATCH];
+
+    for (int32_t base = 0; base < mesh->num_vertices;
+         base += ROOM_VERTEX_BATCH) {
+        const int32_t count =
+            MIN(ROOM_VERTEX_BATCH, mesh->num_vertices - base);
+        const ROOM_VERTEX *const vertices = &mesh->vertices[base];
+
+        // Keep the integer transform free of branches and apart from the
+        // projection, so the compiler can vectorise it.
+        for (int32_t i = 0; i < count; i++) {
+            const XYZ_16 pos = vertices[i].pos;
+            // clang-format off
+            xv_batch[i] =
+                mptr._00 * pos.x + mptr._01 * pos.y + mptr._02 * pos.z +
+                mptr._03;
+            yv_batch[i] =
+                mptr._10 * pos.x + mptr._11 * pos.y + mptr._12 * pos.z +
+                mptr._13;
+            zv_batch[i] =
+                mptr._20 * pos.x + mptr._21 * pos.y + mptr._22 * pos.z +
+                mptr._23;
+            // clang-format on
+        }
+
+        for (int32_t i = 0; i < count; i++) {
+            PHD_VBUF *const vbuf = &m_VBuf[base + i];
+            const double xv = xv_batch[i];
+            const double yv = yv_batch[i];
+            const double zv = zv_batch[i];
+
+            vbuf->xv = xv;
+            vbuf->yv = yv;
+            vbuf->zv = zv;
+
+            uint16_t clip_flags;
+            if (zv < near_z) {
+                clip_flags = 0x8000;
             } else {
-                vbuf->g += Output_CalcFogShade(depth);
-                if (!m_IsWaterEffect) {
-                    CLAMPG(vbuf->g, MAX_LIGHTING);
+                const double persp = persp_z / zv;
+                const double xs = center_x + xv * persp;
+                const double ys = center_y + yv * persp;
+                clip_flags = (xs < left ? 1 : 0) | (xs > right ? 2 : 0)
+                    | (ys < top ? 4 : 0) | (ys > bottom ? 8 : 0);
+                vbuf->xs = xs;
+                vbuf->ys = ys;
+            }
+            vbuf->clip = clip_flags;
+
+            vbuf->g = vertices[i].light_adder;
+            if (vbuf->zv >= near_z) {
+                const int32_t depth = ((int32_t)vbuf->zv) >> W2V_SHIFT;
+                if (depth > draw_dist_max) {
+                    vbuf->g = MAX_LIGHTING;
+                    if (!m_IsSkyboxEnabled) {
+                        vbuf->clip |= 16;
+                    }
+                } else {
+                    vbuf->g += Output_CalcFogShade(depth);
+                    if (!m_IsWaterEffect) {
+                        CLAMPG(vbuf->g, MAX_LIGHTING);
+                    }
                 }
             }
-        }
 
-        if (m_IsWaterEffect) {
-            vbuf->g += m_ShadeTable[(
-                ((uint8_t)m_WibbleOffset
-                 + (uint8_t)m_RandTable[(mesh->num_vertices - i) % WIBBLE_SIZE])
-                % WIBBLE_SIZE)];
-            CLAMP(vbuf->g, 0, 0x1FFF);
+            if (m_IsWaterEffect) {
+                const int32_t rand_idx =
+                    (mesh->num_vertices - base - i) % WIBBLE_SIZE;
+                vbuf->g += m_ShadeTable[(
+                    ((uint8_t)m_WibbleOffset + (uint8_t)m_RandTable[rand_idx])
+                    % WIBBLE_SIZE)];
+                CLAMP(vbuf->g, 0, 0x1FFF);
+            }
         }
     }
 }
@@ -518,11 +577,17 @@ void Output_ReserveVertexBuffer(const size_t size)
 
 void Output_SetWindowSize(int width, int height)
 {
+    if (Shell_IsHeadless()) {
+        return;
+    }
     S_Output_SetWindowSize(width, height);
 }
 
 void Output_ApplyRenderSettings(void)
 {
+    if (Shell_IsHeadless()) {
+        return;
+    }
     S_Output_ApplyRenderSettings();
     if (m_BackdropImagePath) {
         Output_LoadBackgroundFromFile(m_BackdropImagePath);
@@ -531,6 +596,10 @@ void Output_ApplyRenderSettings(void)
 
 void Output_DownloadTextures(int page_count)
 {
+    // There is no renderer to upload to when running headless.
+    if (Shell_IsHeadless()) {
+        return;
+    }
     S_Output_DownloadTextures(page_count);
 }
 
@@ -1039,6 +1108,9 @@ void Output_DrawUISprite(
 bool Output_LoadBackgroundFromFile(const char *const path)
 {
     ASSERT(path != nullptr);
+    if (Shell_IsHeadless()) {
+        return false;
+    }
     const char *old_path = m_BackdropImagePath;
     m_BackdropImagePath = File_GuessExtension(path, m_ImageExtensions);
     Memory_FreePointer(&old_path);
@@ -1062,7 +1134,9 @@ void Output_LoadBackgroundFromObject(void)
 
 void Output_UnloadBackground(void)
 {
-    S_Output_DownloadBackdropSurface(nullptr);
+    if (!Shell_IsHeadless()) {
+        S_Output_DownloadBackdropSurface(nullptr);
+    }
     Memory_FreePointer(&m_BackdropImagePath);
 }
 
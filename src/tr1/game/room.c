@@ -16,9 +16,52 @@
 #include "global/const.h"
 #include "global/vars.h"
 
+#include <libtrx/benchmark.h>
 #include <libtrx/game/game_buf.h>
+#include <libtrx/hash.h>
+#include <libtrx/memory.h>
 #include <libtrx/utils.h>
 
+#include <stdio.h>
+#include <string.h>
+
+// Must be a power of two.
+#define HEIGHT_CACHE_SIZE 2048
+#define BENCHMARK_PASSES 1000
+
+typedef struct {
+    uint32_t generation;
+    const SECTOR *sector;
+    int32_t x;
+    int32_t z;
+    bool is_chunky;
+    int8_t height_type;
+    int16_t floor;
+    int16_t ceiling;
+    // Only set when the triggers call objects with floor or ceiling height
+    // functions. Their results depend on the animation state of the objects
+    // and are always evaluated on top of the cached height.
+    const TRIGGER *floor_trigger;
+    const TRIGGER *ceiling_trigger;
+} M_HEIGHT_ENTRY;
+
+typedef struct {
+    int32_t (*find)(int32_t x, int32_t y, int32_t z);
+    const XYZ_32 *points;
+    int32_t count;
+} M_BENCHMARK;
+
+static struct {
+    bool is_enabled;
+    bool flip_status;
+    uint32_t generation;
+    ROOM_HEIGHT_CACHE_STATS stats;
+    M_HEIGHT_ENTRY entries[HEIGHT_CACHE_SIZE];
+} m_HeightCache = {
+    .is_enabled = true,
+    .generation = 1,
+};
+
 static void M_TriggerMusicTrack(int16_t track, const TRIGGER *const trigger);
 
 static int16_t M_GetFloorTiltHeight(
@@ -27,6 +70,12 @@ static int16_t M_GetCeilingTiltHeight(
     const SECTOR *sector, const int32_t x, const int32_t z);
 static SECTOR *M_GetSkySector(const SECTOR *sector, int32_t x, int32_t z);
 static bool M_TestLava(const ITEM *const item);
+static void M_FillHeightEntry(
+    M_HEIGHT_ENTRY *entry, const SECTOR *sector, int32_t x, int32_t z);
+static void M_CheckFlipStatus(void);
+static const M_HEIGHT_ENTRY *M_GetHeightEntry(
+    const SECTOR *sector, int32_t x, int32_t z);
+static void M_BenchmarkLookups(void *user_data);
 
 static void M_TriggerMusicTrack(int16_t track, const TRIGGER *const trigger)
 {
@@ -245,21 +294,111 @@ SECTOR *Room_GetSector(int32_t x, int32_t y, int32_t z, int16_t *room_num)
     return sector;
 }
 
-int16_t Room_GetCeiling(const SECTOR *sector, int32_t x, int32_t y, int32_t z)
+static void M_FillHeightEntry(
+    M_HEIGHT_ENTRY *const entry, const SECTOR *const sector, const int32_t x,
+    const int32_t z)
 {
-    int16_t *data;
-    int16_t type;
-    int16_t trigger;
-
+    const SECTOR *const pit_sector = Room_GetPitSector(sector, x, z);
     const SECTOR *const sky_sector = M_GetSkySector(sector, x, z);
-    int16_t height = M_GetCeilingTiltHeight(sky_sector, x, z);
 
-    sector = Room_GetPitSector(sector, x, z);
-    if (sector->trigger == nullptr) {
+    g_HeightType = HT_WALL;
+    entry->floor = M_GetFloorTiltHeight(pit_sector, x, z);
+    entry->height_type = g_HeightType;
+    entry->ceiling = M_GetCeilingTiltHeight(sky_sector, x, z);
+
+    entry->floor_trigger =
+        (pit_sector->flags & SF_FLOOR_OBJECTS) ? pit_sector->trigger : nullptr;
+    entry->ceiling_trigger = (pit_sector->flags & SF_CEILING_OBJECTS)
+        ? pit_sector->trigger
+        : nullptr;
+}
+
+static void M_CheckFlipStatus(void)
+{
+    // Flipping swaps the room geometry wholesale, so rather than relying on
+    // every caller of Room_FlipMap, notice the change here.
+    if (m_HeightCache.flip_status != Room_GetFlipStatus()) {
+        m_HeightCache.flip_status = Room_GetFlipStatus();
+        Room_InvalidateHeightCache();
+    }
+}
+
+static const M_HEIGHT_ENTRY *M_GetHeightEntry(
+    const SECTOR *const sector, const int32_t x, const int32_t z)
+{
+    static M_HEIGHT_ENTRY uncached;
+    const bool is_chunky = Camera_IsChunky();
+
+    if (!m_HeightCache.is_enabled) {
+        M_FillHeightEntry(&uncached, sector, x, z);
+        return &uncached;
+    }
+
+    M_CheckFlipStatus();
+
+    const uint32_t key[] = { (uint32_t)((uintptr_t)sector >> 2), x, z };
+    const uint32_t hash = Hash_Mix32(key, sizeof(key) / sizeof(key[0]));
+
+    M_HEIGHT_ENTRY *const entry =
+        &m_HeightCache.entries[hash & (HEIGHT_CACHE_SIZE - 1)];
+    if (entry->generation == m_HeightCache.generation
+        && entry->sector == sector && entry->x == x && entry->z == z
+        && entry->is_chunky == is_chunky) {
+        m_HeightCache.stats.hits++;
+        return entry;
+    }
+
+    m_HeightCache.stats.misses++;
+    M_FillHeightEntry(entry, sector, x, z);
+    entry->generation = m_HeightCache.generation;
+    entry->sector = sector;
+    entry->x = x;
+    entry->z = z;
+    entry->is_chunky = is_chunky;
+    return entry;
+}
+
+void Room_InvalidateHeightCache(void)
+{
+    m_HeightCache.stats.invalidations++;
+    m_HeightCache.generation++;
+    if (m_HeightCache.generation == 0) {
+        memset(m_HeightCache.entries, 0, sizeof(m_HeightCache.entries));
+        m_HeightCache.generation = 1;
+    }
+}
+
+uint32_t Room_GetGeometryVersion(void)
+{
+    M_CheckFlipStatus();
+    return m_HeightCache.generation;
+}
+
+void Room_SetHeightCacheEnabled(const bool is_enabled)
+{
+    m_HeightCache.is_enabled = is_enabled;
+    Room_InvalidateHeightCache();
+}
+
+ROOM_HEIGHT_CACHE_STATS Room_GetHeightCacheStats(void)
+{
+    return m_HeightCache.stats;
+}
+
+void Room_ResetHeightCacheStats(void)
+{
+    memset(&m_HeightCache.stats, 0, sizeof(m_HeightCache.stats));
+}
+
+int16_t Room_GetCeiling(const SECTOR *sector, int32_t x, int32_t y, int32_t z)
+{
+    const M_HEIGHT_ENTRY *const entry = M_GetHeightEntry(sector, x, z);
+    int16_t height = entry->ceiling;
+    if (entry->ceiling_trigger == nullptr) {
         return height;
     }
 
-    const TRIGGER_CMD *cmd = sector->trigger->command;
+    const TRIGGER_CMD *cmd = entry->ceiling_trigger->command;
     for (; cmd != nullptr; cmd = cmd->next_cmd) {
         if (cmd->type != TO_OBJECT) {
             continue;
@@ -277,16 +416,14 @@ int16_t Room_GetCeiling(const SECTOR *sector, int32_t x, int32_t y, int32_t z)
 
 int16_t Room_GetHeight(const SECTOR *sector, int32_t x, int32_t y, int32_t z)
 {
-    g_HeightType = HT_WALL;
-    sector = Room_GetPitSector(sector, x, z);
-
-    int16_t height = M_GetFloorTiltHeight(sector, x, z);
-
-    if (sector->trigger == nullptr) {
+    const M_HEIGHT_ENTRY *const entry = M_GetHeightEntry(sector, x, z);
+    g_HeightType = entry->height_type;
+    int16_t height = entry->floor;
+    if (entry->floor_trigger == nullptr) {
         return height;
     }
 
-    const TRIGGER_CMD *cmd = sector->trigger->command;
+    const TRIGGER_CMD *cmd = entry->floor_trigger->command;
     for (; cmd != nullptr; cmd = cmd->next_cmd) {
         if (cmd->type != TO_OBJECT) {
             continue;
@@ -471,6 +608,8 @@ void Room_AlterFloorHeight(const ITEM *const item, const int32_t height)
             sky_sector->ceiling.height + ROUND_TO_CLICK(height);
     }
 
+    Room_InvalidateHeightCache();
+
     if (g_Boxes[sector->box].overlap_index & BLOCKABLE) {
         if (height < 0) {
             g_Boxes[sector->box].overlap_index |= BLOCKED;
@@ -518,13 +657,13 @@ static bool M_TestLava(const ITEM *const item)
     int16_t room_num = item->room_num;
     const SECTOR *const sector =
         Room_GetSector(item->pos.x, MAX_HEIGHT, item->pos.z, &room_num);
-    return sector->is_death_sector;
+    return sector->flags & SF_DEATH;
 }
 
 void Room_TestSectorTrigger(const ITEM *const item, const SECTOR *const sector)
 {
     const bool is_heavy = item->object_id != O_LARA;
-    if (!is_heavy && sector->is_death_sector && M_TestLava(item)) {
+    if (!is_heavy && (sector->flags & SF_DEATH) && M_TestLava(item)) {
         Lara_CatchFire();
     }
 
@@ -824,3 +963,57 @@ bool Room_IsOnWalkable(
 
     return object_found && room_height == height;
 }
+
+static void M_BenchmarkLookups(void *const user_data)
+{
+    const M_BENCHMARK *const benchmark = user_data;
+    // Accumulate the results so the lookups cannot be optimised away.
+    volatile int32_t sink = 0;
+    for (int32_t i = 0; i < benchmark->count; i++) {
+        const XYZ_32 *const point = &benchmark->points[i];
+        sink += benchmark->find(point->x, point->y, point->z);
+    }
+}
+
+bool Room_Benchmark(const char *const label)
+{
+    const int32_t room_count = Room_GetCount();
+    XYZ_32 *points = Memory_Alloc(sizeof(XYZ_32) * room_count);
+    int32_t count = 0;
+    int32_t mismatches = 0;
+    for (int32_t i = 0; i < room_count; i++) {
+        const ROOM *const room = Room_Get(i);
+        if (room->flip_status == RFS_FLIPPED) {
+            continue;
+        }
+        const XYZ_32 point = {
+            .x = room->pos.x + room->size.x * WALL_L / 2,
+            .y = (room->max_ceiling + room->min_floor) / 2,
+            .z = room->pos.z + room->size.z * WALL_L / 2,
+        };
+        if (Room_FindByPos(point.x, point.y, point.z)
+            != Room_FindByPosLinear(point.x, point.y, point.z)) {
+            mismatches++;
+        }
+        points[count++] = point;
+    }
+
+    M_BENCHMARK benchmark = {
+        .find = Room_FindByPosLinear,
+        .points = points,
+        .count = count,
+    };
+    const double linear =
+        Benchmark_Measure(M_BenchmarkLookups, &benchmark, BENCHMARK_PASSES);
+    benchmark.find = Room_FindByPos;
+    const double grid =
+        Benchmark_Measure(M_BenchmarkLookups, &benchmark, BENCHMARK_PASSES);
+    Memory_FreePointer(&points);
+
+    printf(
+        "%-24s %4d rooms %9.1f ns linear %9.1f ns grid %6.1fx%s\n", label,
+        room_count, count > 0 ? linear / count : 0.0,
+        count > 0 ? grid / count : 0.0, grid > 0.0 ? linear / grid : 0.0,
+        mismatches > 0 ? " MISMATCH" : "");
+    return mismatches == 0;
+}
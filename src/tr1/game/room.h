@@ -7,6 +7,12 @@
 
 #include <stdint.h>
 
+typedef struct {
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t invalidations;
+} ROOM_HEIGHT_CACHE_STATS;
+
 int16_t Room_GetTiltType(const SECTOR *sector, int32_t x, int32_t y, int32_t z);
 int32_t Room_FindGridShift(int32_t src, int32_t dst);
 void Room_GetNewRoom(int32_t x, int32_t y, int32_t z, int16_t room_num);
@@ -16,6 +22,18 @@ SECTOR *Room_GetSector(int32_t x, int32_t y, int32_t z, int16_t *room_num);
 SECTOR *Room_GetPitSector(const SECTOR *sector, int32_t x, int32_t z);
 int16_t Room_GetCeiling(const SECTOR *sector, int32_t x, int32_t y, int32_t z);
 int16_t Room_GetHeight(const SECTOR *sector, int32_t x, int32_t y, int32_t z);
+// Room_GetHeight and Room_GetCeiling cache the sector heights per position.
+// Call after changing sector geometry outside of Room_AlterFloorHeight.
+void Room_InvalidateHeightCache(void);
+// Changes whenever the sector geometry changes, other than through objects
+// with floor or ceiling height functions.
+uint32_t Room_GetGeometryVersion(void);
+void Room_SetHeightCacheEnabled(bool is_enabled);
+ROOM_HEIGHT_CACHE_STATS Room_GetHeightCacheStats(void);
+void Room_ResetHeightCacheStats(void);
+// Compares the room lookups of the loaded level with a linear search and
+// prints the timings.
+bool Room_Benchmark(const char *label);
 int16_t Room_GetWaterHeight(int32_t x, int32_t y, int32_t z, int16_t room_num);
 
 void Room_TestTriggers(const ITEM *item);
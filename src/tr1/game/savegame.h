@@ -55,6 +55,8 @@ int32_t Savegame_GetLevelNumber(int32_t slot_num);
 
 bool Savegame_Load(int32_t slot_num);
 bool Savegame_Save(int32_t slot_num);
+// Reports a background savegame write that has failed. Call once per frame.
+void Savegame_Update(void);
 bool Savegame_UpdateDeathCounters(int32_t slot_num, GAME_INFO *game_info);
 bool Savegame_LoadOnlyResumeInfo(int32_t slot_num, GAME_INFO *game_info);
 
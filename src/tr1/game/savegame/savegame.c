@@ -1,5 +1,6 @@
 #include "game/savegame.h"
 
+#include "game/console/common.h"
 #include "game/game.h"
 #include "game/game_flow.h"
 #include "game/game_string.h"
@@ -21,6 +22,8 @@
 #include "global/types.h"
 #include "global/vars.h"
 
+#include <libtrx/async_writer.h>
+#include <libtrx/benchmark.h>
 #include <libtrx/config.h>
 #include <libtrx/debug.h>
 #include <libtrx/enum_map.h>
@@ -42,7 +45,7 @@ typedef struct {
     bool (*fill_info)(MYFILE *fp, SAVEGAME_INFO *info);
     bool (*load_from_file)(MYFILE *fp, GAME_INFO *game_info);
     bool (*load_only_resume_info)(MYFILE *fp, GAME_INFO *game_info);
-    void (*save_to_file)(MYFILE *fp, GAME_INFO *game_info);
+    void (*save_to_file)(const char *path, GAME_INFO *game_info);
     bool (*update_death_counters)(MYFILE *fp, GAME_INFO *game_info);
 } SAVEGAME_STRATEGY;
 
@@ -77,6 +80,9 @@ static const SAVEGAME_STRATEGY m_Strategies[] = {
 };
 
 static void M_Clear(void);
+static bool M_WaitForPendingSave(void);
+static void M_FinishPendingSave(void);
+static void M_UpdateRequester(void);
 static void M_LoadPreprocess(void);
 static void M_LoadPostprocess(void);
 
@@ -96,6 +102,67 @@ static void M_Clear(void)
     }
 }
 
+static bool M_WaitForPendingSave(void)
+{
+    if (!AsyncWriter_Wait()) {
+        LOG_ERROR("Failed to write the last savegame");
+        return false;
+    }
+    return true;
+}
+
+static void M_FinishPendingSave(void)
+{
+    // The slot info was filled in optimistically when saving; if the write
+    // failed, tell the player and read back what is actually on disk.
+    if (!M_WaitForPendingSave()) {
+        Console_Log(GS(OSD_SAVE_GAME_FAIL));
+        Savegame_ScanSavedGames();
+    }
+}
+
+static void M_UpdateRequester(void)
+{
+    g_SaveCounter = 0;
+    g_SavedGamesCount = 0;
+    for (int i = 0; i < m_SaveSlots; i++) {
+        const SAVEGAME_INFO *const savegame_info = &m_SavegameInfo[i];
+        if (savegame_info->level_title) {
+            if (savegame_info->counter > g_SaveCounter) {
+                g_SaveCounter = savegame_info->counter;
+            }
+            g_SavedGamesCount++;
+        }
+    }
+
+    REQUEST_INFO *req = &g_SavegameRequester;
+    Requester_ClearTextstrings(req);
+    Requester_Init(&g_SavegameRequester, Savegame_GetSlotCount());
+
+    for (int i = 0; i < req->max_items; i++) {
+        SAVEGAME_INFO *savegame_info = &m_SavegameInfo[i];
+
+        if (savegame_info->level_title) {
+            if (savegame_info->counter == g_SaveCounter) {
+                m_NewestSlot = i;
+            }
+            Requester_AddItem(
+                req, false, "%s %d", savegame_info->level_title,
+                savegame_info->counter);
+        } else {
+            Requester_AddItem(req, true, GS(MISC_EMPTY_SLOT_FMT), i + 1);
+        }
+    }
+
+    if (req->requested >= req->vis_lines) {
+        req->line_offset = req->requested - req->vis_lines + 1;
+    } else if (req->requested < req->line_offset) {
+        req->line_offset = req->requested;
+    }
+
+    g_SaveCounter++;
+}
+
 static void M_LoadPreprocess(void)
 {
     Savegame_InitCurrentInfo();
@@ -229,6 +296,11 @@ RESUME_INFO *Savegame_GetCurrentInfo(const GF_LEVEL *const level)
 
 void Savegame_Shutdown(void)
 {
+    if (AsyncWriter_IsBusy()) {
+        LOG_WARNING("Waiting for the last savegame to finish writing");
+    }
+    M_WaitForPendingSave();
+    AsyncWriter_Shutdown();
     M_Clear();
     Memory_FreePointer(&m_SavegameInfo);
     Memory_FreePointer(&g_GameInfo.current);
@@ -476,6 +548,8 @@ bool Savegame_IsSlotFree(const int32_t slot_num)
 
 bool Savegame_Load(const int32_t slot_num)
 {
+    M_FinishPendingSave();
+    BENCHMARK *const benchmark = Benchmark_Start();
     GAME_INFO *const game_info = &g_GameInfo;
     SAVEGAME_INFO *savegame_info = &m_SavegameInfo[slot_num];
     ASSERT(savegame_info->format != 0);
@@ -502,11 +576,22 @@ bool Savegame_Load(const int32_t slot_num)
 
     g_GameInfo.save_initial_version = m_SavegameInfo[slot_num].initial_version;
 
+    Benchmark_End(benchmark, "savegame load");
     return ret;
 }
 
+void Savegame_Update(void)
+{
+    if (!AsyncWriter_IsBusy()) {
+        M_FinishPendingSave();
+    }
+}
+
 bool Savegame_Save(const int32_t slot_num)
 {
+    // Report a failed previous write before its slot info gets overwritten.
+    M_FinishPendingSave();
+    BENCHMARK *const benchmark = Benchmark_Start();
     GAME_INFO *const game_info = &g_GameInfo;
     bool ret = true;
     Savegame_BindSlot(slot_num);
@@ -533,18 +618,21 @@ bool Savegame_Save(const int32_t slot_num)
                 Memory_Alloc(strlen(SAVES_DIR) + strlen(filename) + 2);
             sprintf(full_path, "%s/%s", SAVES_DIR, filename);
 
-            MYFILE *fp = File_Open(full_path, FILE_OPEN_WRITE);
-            if (fp) {
-                strategy->save_to_file(fp, game_info);
-                savegame_info->format = strategy->format;
-                Memory_FreePointer(&savegame_info->full_path);
-                savegame_info->full_path = Memory_DupStr(File_GetPath(fp));
-                savegame_info->counter = g_SaveCounter;
-                savegame_info->level_num = current_level->num;
-                File_Close(fp);
-            } else {
-                ret = false;
-            }
+            // The file is written in the background, so fill in the slot
+            // info directly rather than reading it back.
+            strategy->save_to_file(full_path, game_info);
+            savegame_info->format = strategy->format;
+            Memory_FreePointer(&savegame_info->full_path);
+            savegame_info->full_path = Memory_DupStr(full_path);
+            savegame_info->counter = g_SaveCounter;
+            savegame_info->level_num = current_level->num;
+            Memory_FreePointer(&savegame_info->level_title);
+            savegame_info->level_title = Memory_DupStr(current_level->title);
+            savegame_info->initial_version = g_GameInfo.save_initial_version;
+            savegame_info->features.restart =
+                savegame_info->initial_version >= VERSION_LEGACY;
+            savegame_info->features.select_level =
+                savegame_info->initial_version >= VERSION_1;
 
             Memory_FreePointer(&filename);
             Memory_FreePointer(&full_path);
@@ -558,13 +646,15 @@ bool Savegame_Save(const int32_t slot_num)
             req, slot_num, false, "%s %d", current_level->title, g_SaveCounter);
     }
 
-    Savegame_ScanSavedGames();
+    M_UpdateRequester();
 
+    Benchmark_End(benchmark, "savegame snapshot");
     return ret;
 }
 
 bool Savegame_UpdateDeathCounters(int32_t slot_num, GAME_INFO *game_info)
 {
+    M_FinishPendingSave();
     ASSERT(game_info != nullptr);
     ASSERT(slot_num >= 0);
     SAVEGAME_INFO *savegame_info = &m_SavegameInfo[slot_num];
@@ -589,6 +679,7 @@ bool Savegame_UpdateDeathCounters(int32_t slot_num, GAME_INFO *game_info)
 
 bool Savegame_LoadOnlyResumeInfo(int32_t slot_num, GAME_INFO *game_info)
 {
+    M_FinishPendingSave();
     ASSERT(game_info != nullptr);
     SAVEGAME_INFO *savegame_info = &m_SavegameInfo[slot_num];
     ASSERT(savegame_info->format != 0);
@@ -614,11 +705,9 @@ bool Savegame_LoadOnlyResumeInfo(int32_t slot_num, GAME_INFO *game_info)
 
 void Savegame_ScanSavedGames(void)
 {
+    M_WaitForPendingSave();
     M_Clear();
 
-    g_SaveCounter = 0;
-    g_SavedGamesCount = 0;
-
     for (int i = 0; i < m_SaveSlots; i++) {
         SAVEGAME_INFO *savegame_info = &m_SavegameInfo[i];
         const SAVEGAME_STRATEGY *strategy = &m_Strategies[0];
@@ -653,41 +742,9 @@ void Savegame_ScanSavedGames(void)
             }
             strategy++;
         }
-
-        if (savegame_info->level_title) {
-            if (savegame_info->counter > g_SaveCounter) {
-                g_SaveCounter = savegame_info->counter;
-            }
-            g_SavedGamesCount++;
-        }
-    }
-
-    REQUEST_INFO *req = &g_SavegameRequester;
-    Requester_ClearTextstrings(req);
-    Requester_Init(&g_SavegameRequester, Savegame_GetSlotCount());
-
-    for (int i = 0; i < req->max_items; i++) {
-        SAVEGAME_INFO *savegame_info = &m_SavegameInfo[i];
-
-        if (savegame_info->level_title) {
-            if (savegame_info->counter == g_SaveCounter) {
-                m_NewestSlot = i;
-            }
-            Requester_AddItem(
-                req, false, "%s %d", savegame_info->level_title,
-                savegame_info->counter);
-        } else {
-            Requester_AddItem(req, true, GS(MISC_EMPTY_SLOT_FMT), i + 1);
-        }
     }
 
-    if (req->requested >= req->vis_lines) {
-        req->line_offset = req->requested - req->vis_lines + 1;
-    } else if (req->requested < req->line_offset) {
-        req->line_offset = req->requested;
-    }
-
-    g_SaveCounter++;
+    M_UpdateRequester();
 }
 
 void Savegame_ScanAvailableLevels(REQUEST_INFO *req)
@@ -16,20 +16,27 @@
 #include "global/const.h"
 #include "global/vars.h"
 
+#include <libtrx/async_writer.h>
+#include <libtrx/benchmark.h>
 #include <libtrx/bson.h>
 #include <libtrx/config.h>
 #include <libtrx/debug.h>
 #include <libtrx/json.h>
 #include <libtrx/log.h>
+#include <libtrx/lz4.h>
 #include <libtrx/memory.h>
 #include <libtrx/utils.h>
 
 #include <inttypes.h>
 #include <stdio.h>
+#include <string.h>
 #include <zconf.h>
 #include <zlib.h>
 
 #define SAVEGAME_BSON_MAGIC MKTAG('T', '1', 'M', 'B')
+#define SAVEGAME_BSON_LZ4_MAGIC MKTAG('T', '1', 'M', 'L')
+#define SAVEGAME_BSON_READ_CHUNK 16384
+#define SAVEGAME_BSON_BENCHMARK_PASSES 100
 
 #pragma pack(push, 1)
 typedef struct {
@@ -46,75 +53,507 @@ typedef struct {
     int16_t id_map[NUM_EFFECTS];
 } SAVEGAME_BSON_FX_ORDER;
 
+typedef struct {
+    char *data;
+    size_t size;
+    int16_t initial_version;
+    int32_t version;
+} SAVEGAME_BSON_SAVE_JOB;
+
+// A compression format, identified by the magic in the savegame header.
+typedef struct {
+    uint32_t magic;
+    const char *name;
+    size_t (*get_bound)(size_t size);
+    bool (*compress)(
+        const char *data, size_t size, char *out, size_t *out_size);
+    bool (*decompress)(MYFILE *fp, size_t size, char *out, size_t out_size);
+} SAVEGAME_BSON_CODEC;
+
+// Sentinel for optional item fields that must not overwrite the current value.
+#define SAVEGAME_BSON_NO_VALUE INT32_MIN
+
+typedef struct {
+    int32_t obj_num;
+    XYZ_32 pos;
+    XYZ_16 rot;
+    int16_t room_num;
+    int16_t speed;
+    int16_t fall_speed;
+    int16_t current_anim_state;
+    int16_t goal_anim_state;
+    int16_t required_anim_state;
+    int16_t anim_num;
+    int16_t frame_num;
+    int16_t hit_points;
+    uint16_t flags;
+    int16_t timer;
+    int32_t status;
+    bool active;
+    bool gravity;
+    bool collidable;
+    bool intelligent;
+    int32_t head_rot;
+    int32_t neck_rot;
+    int32_t max_turn;
+    int32_t creature_flags;
+    int32_t creature_mood;
+    int32_t fx_num;
+    int32_t bl_status;
+} SAVEGAME_BSON_ITEM;
+
+typedef struct {
+    XYZ_32 pos;
+    int16_t room_num;
+    int32_t object_id;
+    int16_t speed;
+    int16_t fall_speed;
+    int16_t frame_num;
+    int16_t counter;
+    int16_t shade;
+} SAVEGAME_BSON_EFFECT;
+
+typedef struct {
+    bool status;
+    int32_t effect;
+    int32_t timer;
+    int32_t table[MAX_FLIP_MAPS];
+} SAVEGAME_BSON_FLIPMAP;
+
+typedef struct {
+    const char *key;
+    const BSON_DECODE_FIELD *fields;
+    int32_t field_count;
+    size_t offset;
+} SAVEGAME_BSON_SECTION;
+
+typedef struct {
+    GAME_INFO *game_info;
+    const char *data;
+    size_t size;
+    JSON_VALUE *root;
+    size_t count;
+} SAVEGAME_BSON_BENCHMARK;
+
+static size_t M_LZ4GetBound(size_t size);
+static bool M_LZ4Compress(
+    const char *data, size_t size, char *out, size_t *out_size);
+static bool M_LZ4Decompress(
+    MYFILE *fp, size_t size, char *out, size_t out_size);
+static size_t M_ZlibGetBound(size_t size);
+static bool M_ZlibCompress(
+    const char *data, size_t size, char *out, size_t *out_size);
+static bool M_ZlibDecompress(
+    MYFILE *fp, size_t size, char *out, size_t out_size);
+static const SAVEGAME_BSON_CODEC *M_GetCodec(uint32_t magic);
+static char *M_Encode(
+    const char *data, size_t size, int16_t initial_version, int32_t version,
+    size_t *out_size);
+static char *M_EncodeJob(void *user_data, size_t *out_size);
 static void M_SaveRaw(MYFILE *fp, JSON_VALUE *root, int32_t version);
-static JSON_VALUE *M_ParseFromBuffer(
-    const char *buffer, size_t buffer_size, int32_t *version_out);
+static char *M_ReadFromFile(MYFILE *fp, int32_t *version_out, size_t *out_size);
 static JSON_VALUE *M_ParseFromFile(MYFILE *fp, int32_t *version_out);
-static bool M_LoadResumeInfo(JSON_ARRAY *levels_arr, RESUME_INFO *resume_info);
+static BSON_READER *M_GetArray(
+    const BSON_READER *parent, const char *key, BSON_READER *out);
+static BSON_READER *M_GetObject(
+    const BSON_READER *parent, const char *key, BSON_READER *out);
+static bool M_LoadResumeInfo(BSON_READER *resume_arr, RESUME_INFO *resume_info);
 static bool M_LoadDiscontinuedStartInfo(
-    JSON_ARRAY *start_arr, GAME_INFO *game_info);
+    BSON_READER *start_arr, GAME_INFO *game_info);
 static bool M_LoadDiscontinuedEndInfo(
-    JSON_ARRAY *end_arr, GAME_INFO *game_info);
+    BSON_READER *end_arr, GAME_INFO *game_info);
 static bool M_LoadMisc(
-    JSON_OBJECT *misc_obj, GAME_INFO *game_info, uint16_t header_version);
-static bool M_LoadInventory(JSON_OBJECT *inv_obj);
-static bool M_LoadFlipmaps(JSON_OBJECT *flipmap_obj);
-static bool M_LoadCameras(JSON_ARRAY *cameras_arr);
-static bool M_LoadItems(JSON_ARRAY *items_arr, uint16_t header_version);
-static bool M_LoadEffects(JSON_ARRAY *fx_arr);
-static bool M_LoadArm(JSON_OBJECT *arm_obj, LARA_ARM *arm);
-static bool M_LoadAmmo(JSON_OBJECT *ammo_obj, AMMO_INFO *ammo);
-static bool M_LoadLOT(JSON_OBJECT *lot_obj, LOT_INFO *lot);
-static bool M_LoadLara(
-    JSON_OBJECT *lara_obj, LARA_INFO *lara, uint16_t header_version);
-static bool M_LoadCurrentMusic(JSON_OBJECT *music_obj);
-static bool M_LoadMusicTrackFlags(JSON_ARRAY *music_track_arr);
-static JSON_ARRAY *M_DumpResumeInfo(RESUME_INFO *game_info);
-static JSON_OBJECT *M_DumpMisc(GAME_INFO *game_info);
-static JSON_OBJECT *M_DumpInventory(void);
-static JSON_OBJECT *M_DumpFlipmaps(void);
-static JSON_ARRAY *M_DumpCameras(void);
-static JSON_ARRAY *M_DumpItems(void);
-static JSON_ARRAY *M_DumpEffects(void);
-static JSON_OBJECT *M_DumpArm(LARA_ARM *arm);
-static JSON_OBJECT *M_DumpAmmo(AMMO_INFO *ammo);
-static JSON_OBJECT *M_DumpLOT(LOT_INFO *lot);
-static JSON_OBJECT *M_DumpLara(LARA_INFO *lara);
-static JSON_OBJECT *M_DumpCurrentMusic(void);
-static JSON_ARRAY *M_DumpMusicTrackFlags(void);
+    BSON_READER *misc_obj, GAME_INFO *game_info, uint16_t header_version);
+static bool M_LoadInventory(BSON_READER *inv_obj);
+static bool M_LoadFlipmaps(BSON_READER *flipmap_obj);
+static bool M_LoadCameras(BSON_READER *cameras_arr);
+static bool M_LoadCarriedItems(const BSON_FIELD *field, int32_t item_num);
+static bool M_LoadItems(BSON_READER *items_arr, uint16_t header_version);
+static bool M_LoadEffects(BSON_READER *fx_arr);
+static bool M_LoadLaraMeshes(const BSON_FIELD *field, LARA_INFO *lara);
+static bool M_LoadLara(BSON_READER *lara_obj, LARA_INFO *lara);
+static bool M_LoadCurrentMusic(BSON_READER *music_obj);
+static bool M_LoadMusicTrackFlags(BSON_READER *music_track_arr);
+static void M_DumpResumeInfo(
+    BSON_WRITER *writer, const char *key, RESUME_INFO *resume_info);
+static void M_DumpMisc(
+    BSON_WRITER *writer, const char *key, GAME_INFO *game_info);
+static void M_DumpInventory(BSON_WRITER *writer, const char *key);
+static void M_DumpFlipmaps(BSON_WRITER *writer, const char *key);
+static void M_DumpCameras(BSON_WRITER *writer, const char *key);
+static void M_DumpItems(BSON_WRITER *writer, const char *key);
+static void M_DumpEffects(BSON_WRITER *writer, const char *key);
+static void M_DumpArm(BSON_WRITER *writer, const char *key, LARA_ARM *arm);
+static void M_DumpAmmo(BSON_WRITER *writer, const char *key, AMMO_INFO *ammo);
+static void M_DumpLOT(BSON_WRITER *writer, const char *key, LOT_INFO *lot);
+static void M_DumpLara(BSON_WRITER *writer, const char *key, LARA_INFO *lara);
+static void M_DumpCurrentMusic(BSON_WRITER *writer, const char *key);
+static void M_DumpMusicTrackFlags(BSON_WRITER *writer, const char *key);
 
 static void M_GetFXOrder(SAVEGAME_BSON_FX_ORDER *order);
 static bool M_IsValidItemObject(
     GAME_OBJECT_ID saved_obj_id, GAME_OBJECT_ID current_obj_id);
 
-static void M_SaveRaw(MYFILE *fp, JSON_VALUE *root, int32_t version)
+static size_t M_WalkBSON(BSON_READER *reader);
+static void M_BenchmarkStream(void *user_data);
+static void M_BenchmarkTree(void *user_data);
+static void M_BenchmarkParse(void *user_data);
+static void M_BenchmarkCursor(void *user_data);
+
+// The tables below list the fields in the order they are written, which lets
+// the decoder match each key on the first try.
+static const BSON_DECODE_FIELD m_ItemFields[] = {
+    // clang-format off
+    BSON_DECODE_INT_FIELD("obj_num", SAVEGAME_BSON_ITEM, obj_num),
+    BSON_DECODE_INT_FIELD("x", SAVEGAME_BSON_ITEM, pos.x),
+    BSON_DECODE_INT_FIELD("y", SAVEGAME_BSON_ITEM, pos.y),
+    BSON_DECODE_INT_FIELD("z", SAVEGAME_BSON_ITEM, pos.z),
+    BSON_DECODE_INT_FIELD("x_rot", SAVEGAME_BSON_ITEM, rot.x),
+    BSON_DECODE_INT_FIELD("y_rot", SAVEGAME_BSON_ITEM, rot.y),
+    BSON_DECODE_INT_FIELD("z_rot", SAVEGAME_BSON_ITEM, rot.z),
+    BSON_DECODE_INT_FIELD("room_num", SAVEGAME_BSON_ITEM, room_num),
+    BSON_DECODE_INT_FIELD("speed", SAVEGAME_BSON_ITEM, speed),
+    BSON_DECODE_INT_FIELD("fall_speed", SAVEGAME_BSON_ITEM, fall_speed),
+    BSON_DECODE_INT_FIELD("current_anim", SAVEGAME_BSON_ITEM, current_anim_state),
+    BSON_DECODE_INT_FIELD("goal_anim", SAVEGAME_BSON_ITEM, goal_anim_state),
+    BSON_DECODE_INT_FIELD("required_anim", SAVEGAME_BSON_ITEM, required_anim_state),
+    BSON_DECODE_INT_FIELD("anim_num", SAVEGAME_BSON_ITEM, anim_num),
+    BSON_DECODE_INT_FIELD("frame_num", SAVEGAME_BSON_ITEM, frame_num),
+    BSON_DECODE_INT_FIELD("hitpoints", SAVEGAME_BSON_ITEM, hit_points),
+    BSON_DECODE_INT_FIELD("flags", SAVEGAME_BSON_ITEM, flags),
+    BSON_DECODE_INT_FIELD("status", SAVEGAME_BSON_ITEM, status),
+    BSON_DECODE_BOOL_FIELD("active", SAVEGAME_BSON_ITEM, active),
+    BSON_DECODE_BOOL_FIELD("gravity", SAVEGAME_BSON_ITEM, gravity),
+    BSON_DECODE_BOOL_FIELD("collidable", SAVEGAME_BSON_ITEM, collidable),
+    BSON_DECODE_BOOL_FIELD("intelligent", SAVEGAME_BSON_ITEM, intelligent),
+    BSON_DECODE_INT_FIELD("timer", SAVEGAME_BSON_ITEM, timer),
+    BSON_DECODE_INT_FIELD("head_rot", SAVEGAME_BSON_ITEM, head_rot),
+    BSON_DECODE_INT_FIELD("neck_rot", SAVEGAME_BSON_ITEM, neck_rot),
+    BSON_DECODE_INT_FIELD("max_turn", SAVEGAME_BSON_ITEM, max_turn),
+    BSON_DECODE_INT_FIELD("creature_flags", SAVEGAME_BSON_ITEM, creature_flags),
+    BSON_DECODE_INT_FIELD("creature_mood", SAVEGAME_BSON_ITEM, creature_mood),
+    BSON_DECODE_INT_FIELD("fx_num", SAVEGAME_BSON_ITEM, fx_num),
+    BSON_DECODE_INT_FIELD("bl_status", SAVEGAME_BSON_ITEM, bl_status),
+    // clang-format on
+};
+
+static const BSON_DECODE_FIELD m_CarriedItemFields[] = {
+    // clang-format off
+    BSON_DECODE_INT_FIELD("object_id", CARRIED_ITEM, object_id),
+    BSON_DECODE_INT_FIELD("x", CARRIED_ITEM, pos.x),
+    BSON_DECODE_INT_FIELD("y", CARRIED_ITEM, pos.y),
+    BSON_DECODE_INT_FIELD("z", CARRIED_ITEM, pos.z),
+    BSON_DECODE_INT_FIELD("y_rot", CARRIED_ITEM, rot.y),
+    BSON_DECODE_INT_FIELD("room_num", CARRIED_ITEM, room_num),
+    BSON_DECODE_INT_FIELD("fall_speed", CARRIED_ITEM, fall_speed),
+    BSON_DECODE_INT_FIELD("status", CARRIED_ITEM, status),
+    // clang-format on
+};
+
+static const BSON_DECODE_FIELD m_EffectFields[] = {
+    // clang-format off
+    BSON_DECODE_INT_FIELD("x", SAVEGAME_BSON_EFFECT, pos.x),
+    BSON_DECODE_INT_FIELD("y", SAVEGAME_BSON_EFFECT, pos.y),
+    BSON_DECODE_INT_FIELD("z", SAVEGAME_BSON_EFFECT, pos.z),
+    BSON_DECODE_INT_FIELD("room_number", SAVEGAME_BSON_EFFECT, room_num),
+    BSON_DECODE_INT_FIELD("object_number", SAVEGAME_BSON_EFFECT, object_id),
+    BSON_DECODE_INT_FIELD("speed", SAVEGAME_BSON_EFFECT, speed),
+    BSON_DECODE_INT_FIELD("fall_speed", SAVEGAME_BSON_EFFECT, fall_speed),
+    BSON_DECODE_INT_FIELD("frame_number", SAVEGAME_BSON_EFFECT, frame_num),
+    BSON_DECODE_INT_FIELD("counter", SAVEGAME_BSON_EFFECT, counter),
+    BSON_DECODE_INT_FIELD("shade", SAVEGAME_BSON_EFFECT, shade),
+    // clang-format on
+};
+
+static const BSON_DECODE_FIELD m_FlipmapFields[] = {
+    // clang-format off
+    BSON_DECODE_BOOL_FIELD("status", SAVEGAME_BSON_FLIPMAP, status),
+    BSON_DECODE_INT_FIELD("effect", SAVEGAME_BSON_FLIPMAP, effect),
+    BSON_DECODE_INT_FIELD("timer", SAVEGAME_BSON_FLIPMAP, timer),
+    // clang-format on
+};
+
+static const BSON_DECODE_FIELD m_LaraFields[] = {
+    // clang-format off
+    BSON_DECODE_INT_FIELD("item_number", LARA_INFO, item_num),
+    BSON_DECODE_INT_FIELD("gun_status", LARA_INFO, gun_status),
+    BSON_DECODE_INT_FIELD("gun_type", LARA_INFO, gun_type),
+    BSON_DECODE_INT_FIELD("request_gun_type", LARA_INFO, request_gun_type),
+    BSON_DECODE_INT_FIELD("calc_fall_speed", LARA_INFO, calc_fall_speed),
+    BSON_DECODE_INT_FIELD("water_status", LARA_INFO, water_status),
+    BSON_DECODE_INT_FIELD("pose_count", LARA_INFO, pose_count),
+    BSON_DECODE_INT_FIELD("hit_frame", LARA_INFO, hit_frame),
+    BSON_DECODE_INT_FIELD("hit_direction", LARA_INFO, hit_direction),
+    BSON_DECODE_INT_FIELD("air", LARA_INFO, air),
+    BSON_DECODE_INT_FIELD("dive_count", LARA_INFO, dive_timer),
+    BSON_DECODE_INT_FIELD("death_count", LARA_INFO, death_timer),
+    BSON_DECODE_INT_FIELD("current_active", LARA_INFO, current_active),
+    BSON_DECODE_INT_FIELD("hit_effect_count", LARA_INFO, hit_effect_count),
+    BSON_DECODE_INT_FIELD("mesh_effects", LARA_INFO, mesh_effects),
+    BSON_DECODE_INT_FIELD("target_angle1", LARA_INFO, target_angles[0]),
+    BSON_DECODE_INT_FIELD("target_angle2", LARA_INFO, target_angles[1]),
+    BSON_DECODE_INT_FIELD("turn_rate", LARA_INFO, turn_rate),
+    BSON_DECODE_INT_FIELD("move_angle", LARA_INFO, move_angle),
+    BSON_DECODE_INT_FIELD("head_rot.y", LARA_INFO, head_rot.y),
+    BSON_DECODE_INT_FIELD("head_rot.x", LARA_INFO, head_rot.x),
+    BSON_DECODE_INT_FIELD("head_rot.z", LARA_INFO, head_rot.z),
+    BSON_DECODE_INT_FIELD("torso_rot.y", LARA_INFO, torso_rot.y),
+    BSON_DECODE_INT_FIELD("torso_rot.x", LARA_INFO, torso_rot.x),
+    BSON_DECODE_INT_FIELD("torso_rot.z", LARA_INFO, torso_rot.z),
+    BSON_DECODE_INT_FIELD("interact_target.item_num", LARA_INFO, interact_target.item_num),
+    BSON_DECODE_INT_FIELD("interact_target.move_count", LARA_INFO, interact_target.move_count),
+    BSON_DECODE_BOOL_FIELD("interact_target.is_moving", LARA_INFO, interact_target.is_moving),
+    // clang-format on
+};
+
+static const BSON_DECODE_FIELD m_ArmFields[] = {
+    // clang-format off
+    BSON_DECODE_INT_FIELD("frame_num", LARA_ARM, frame_num),
+    BSON_DECODE_INT_FIELD("lock", LARA_ARM, lock),
+    BSON_DECODE_INT_FIELD("x_rot", LARA_ARM, rot.x),
+    BSON_DECODE_INT_FIELD("y_rot", LARA_ARM, rot.y),
+    BSON_DECODE_INT_FIELD("z_rot", LARA_ARM, rot.z),
+    BSON_DECODE_INT_FIELD("flash_gun", LARA_ARM, flash_gun),
+    // clang-format on
+};
+
+static const BSON_DECODE_FIELD m_AmmoFields[] = {
+    // clang-format off
+    BSON_DECODE_INT_FIELD("ammo", AMMO_INFO, ammo),
+    BSON_DECODE_INT_FIELD("hit", AMMO_INFO, hit),
+    BSON_DECODE_INT_FIELD("miss", AMMO_INFO, miss),
+    // clang-format on
+};
+
+static const BSON_DECODE_FIELD m_LOTFields[] = {
+    // clang-format off
+    BSON_DECODE_INT_FIELD("head", LOT_INFO, head),
+    BSON_DECODE_INT_FIELD("tail", LOT_INFO, tail),
+    BSON_DECODE_INT_FIELD("search_num", LOT_INFO, search_num),
+    BSON_DECODE_INT_FIELD("block_mask", LOT_INFO, block_mask),
+    BSON_DECODE_INT_FIELD("step", LOT_INFO, step),
+    BSON_DECODE_INT_FIELD("drop", LOT_INFO, drop),
+    BSON_DECODE_INT_FIELD("fly", LOT_INFO, fly),
+    BSON_DECODE_INT_FIELD("zone_count", LOT_INFO, zone_count),
+    BSON_DECODE_INT_FIELD("target_box", LOT_INFO, target_box),
+    BSON_DECODE_INT_FIELD("required_box", LOT_INFO, required_box),
+    BSON_DECODE_INT_FIELD("x", LOT_INFO, target.x),
+    BSON_DECODE_INT_FIELD("y", LOT_INFO, target.y),
+    BSON_DECODE_INT_FIELD("z", LOT_INFO, target.z),
+    // clang-format on
+};
+
+#define M_FIELD_COUNT(fields) ((int32_t)(sizeof(fields) / sizeof(fields[0])))
+
+static const int32_t m_ItemFieldCount = M_FIELD_COUNT(m_ItemFields);
+static const int32_t m_CarriedItemFieldCount =
+    M_FIELD_COUNT(m_CarriedItemFields);
+static const int32_t m_EffectFieldCount = M_FIELD_COUNT(m_EffectFields);
+static const int32_t m_FlipmapFieldCount = M_FIELD_COUNT(m_FlipmapFields);
+static const int32_t m_LaraFieldCount = M_FIELD_COUNT(m_LaraFields);
+
+// Every one of these sub-objects has to be present in a valid save.
+static const SAVEGAME_BSON_SECTION m_LaraSections[] = {
+    // clang-format off
+    { "left_arm",  m_ArmFields,  M_FIELD_COUNT(m_ArmFields),  offsetof(LARA_INFO, left_arm) },
+    { "right_arm", m_ArmFields,  M_FIELD_COUNT(m_ArmFields),  offsetof(LARA_INFO, right_arm) },
+    { "pistols",   m_AmmoFields, M_FIELD_COUNT(m_AmmoFields), offsetof(LARA_INFO, pistols) },
+    { "magnums",   m_AmmoFields, M_FIELD_COUNT(m_AmmoFields), offsetof(LARA_INFO, magnums) },
+    { "uzis",      m_AmmoFields, M_FIELD_COUNT(m_AmmoFields), offsetof(LARA_INFO, uzis) },
+    { "shotgun",   m_AmmoFields, M_FIELD_COUNT(m_AmmoFields), offsetof(LARA_INFO, shotgun) },
+    { "lot",       m_LOTFields,  M_FIELD_COUNT(m_LOTFields),  offsetof(LARA_INFO, lot) },
+    // clang-format on
+};
+
+static const int32_t m_LaraSectionCount = M_FIELD_COUNT(m_LaraSections);
+
+// New savegames are written with the first codec. The others are kept so
+// that older savegames still load.
+static const SAVEGAME_BSON_CODEC m_Codecs[] = {
+    {
+        .magic = SAVEGAME_BSON_LZ4_MAGIC,
+        .name = "lz4",
+        .get_bound = M_LZ4GetBound,
+        .compress = M_LZ4Compress,
+        .decompress = M_LZ4Decompress,
+    },
+    {
+        .magic = SAVEGAME_BSON_MAGIC,
+        .name = "zlib",
+        .get_bound = M_ZlibGetBound,
+        .compress = M_ZlibCompress,
+        .decompress = M_ZlibDecompress,
+    },
+    {}, // sentinel
+};
+
+static size_t M_LZ4GetBound(const size_t size)
 {
-    size_t uncompressed_size;
-    char *uncompressed = BSON_Write(root, &uncompressed_size);
-
-    uLongf compressed_size = compressBound(uncompressed_size);
-    char *compressed = Memory_Alloc(compressed_size);
-    if (compress(
-            (Bytef *)compressed, &compressed_size, (const Bytef *)uncompressed,
-            (uLongf)uncompressed_size)
-        != Z_OK) {
-        Shell_ExitSystem("Failed to compress savegame data");
+    return LZ4_GetBound(size);
+}
+
+static bool M_LZ4Compress(
+    const char *const data, const size_t size, char *const out,
+    size_t *const out_size)
+{
+    const size_t compressed_size = LZ4_Compress(data, size, out, *out_size);
+    if (compressed_size == 0) {
+        LOG_ERROR("Failed to compress the data");
+        return false;
     }
+    *out_size = compressed_size;
+    return true;
+}
 
-    Memory_FreePointer(&uncompressed);
+static bool M_LZ4Decompress(
+    MYFILE *const fp, const size_t size, char *const out,
+    const size_t out_size)
+{
+    char *compressed = Memory_Alloc(size);
+    File_ReadData(fp, compressed, size);
+    const bool result = LZ4_Decompress(compressed, size, out, out_size);
+    Memory_FreePointer(&compressed);
+    if (!result) {
+        LOG_ERROR("Failed to decompress the data");
+    }
+    return result;
+}
 
-    SAVEGAME_BSON_HEADER header = {
-        .magic = SAVEGAME_BSON_MAGIC,
-        .initial_version = g_GameInfo.save_initial_version,
+static size_t M_ZlibGetBound(const size_t size)
+{
+    return compressBound(size);
+}
+
+static bool M_ZlibCompress(
+    const char *const data, const size_t size, char *const out,
+    size_t *const out_size)
+{
+    uLongf compressed_size = *out_size;
+    const int result = compress(
+        (Bytef *)out, &compressed_size, (const Bytef *)data, (uLongf)size);
+    if (result != Z_OK) {
+        LOG_ERROR("Failed to compress the data (error %d)", result);
+        return false;
+    }
+    *out_size = compressed_size;
+    return true;
+}
+
+// Inflates the file in chunks straight into the output buffer, rather than
+// reading the whole compressed stream into memory first.
+static bool M_ZlibDecompress(
+    MYFILE *const fp, size_t size, char *const out, const size_t out_size)
+{
+    z_stream stream = {
+        .next_out = (Bytef *)out,
+        .avail_out = out_size,
+    };
+    int result = inflateInit(&stream);
+    if (result != Z_OK) {
+        LOG_ERROR("Failed to initialise zlib (error %d)", result);
+        return false;
+    }
+
+    Bytef chunk[SAVEGAME_BSON_READ_CHUNK];
+    while (result == Z_OK) {
+        if (stream.avail_in == 0) {
+            if (size == 0) {
+                break;
+            }
+            const size_t chunk_size = MIN(size, sizeof(chunk));
+            File_ReadData(fp, chunk, chunk_size);
+            size -= chunk_size;
+            stream.next_in = chunk;
+            stream.avail_in = chunk_size;
+        }
+        result = inflate(&stream, Z_NO_FLUSH);
+    }
+    inflateEnd(&stream);
+
+    if (result != Z_STREAM_END || stream.total_out != out_size) {
+        LOG_ERROR("Failed to decompress the data (error %d)", result);
+        return false;
+    }
+    return true;
+}
+
+static const SAVEGAME_BSON_CODEC *M_GetCodec(const uint32_t magic)
+{
+    for (const SAVEGAME_BSON_CODEC *codec = m_Codecs; codec->name != nullptr;
+         codec++) {
+        if (codec->magic == magic) {
+            return codec;
+        }
+    }
+    return nullptr;
+}
+
+static char *M_Encode(
+    const char *const data, const size_t size, const int16_t initial_version,
+    const int32_t version, size_t *const out_size)
+{
+    BENCHMARK *benchmark = Benchmark_Start();
+    const SAVEGAME_BSON_CODEC *const codec = &m_Codecs[0];
+    size_t compressed_size = codec->get_bound(size);
+    char *const out =
+        Memory_Alloc(sizeof(SAVEGAME_BSON_HEADER) + compressed_size);
+    char *const compressed = out + sizeof(SAVEGAME_BSON_HEADER);
+    if (!codec->compress(data, size, compressed, &compressed_size)) {
+        LOG_ERROR("Failed to compress savegame data");
+        Memory_Free(out);
+        Memory_FreePointer(&benchmark);
+        return nullptr;
+    }
+
+    const SAVEGAME_BSON_HEADER header = {
+        .magic = codec->magic,
+        .initial_version = initial_version,
         .version = version,
         .compressed_size = compressed_size,
-        .uncompressed_size = uncompressed_size,
+        .uncompressed_size = size,
     };
+    memcpy(out, &header, sizeof(header));
 
-    File_WriteData(fp, &header, sizeof(header));
-    File_WriteData(fp, compressed, compressed_size);
+    char message[128];
+    snprintf(
+        message, sizeof(message),
+        "savegame compression (%s, %zu -> %zu bytes, %.1f%%)", codec->name,
+        size, compressed_size,
+        size != 0 ? compressed_size * 100.0 / size : 0.0);
+    Benchmark_End(benchmark, message);
 
-    Memory_FreePointer(&compressed);
+    *out_size = sizeof(SAVEGAME_BSON_HEADER) + compressed_size;
+    return out;
+}
+
+static char *M_EncodeJob(void *const user_data, size_t *const out_size)
+{
+    SAVEGAME_BSON_SAVE_JOB *const job = user_data;
+    char *const out = M_Encode(
+        job->data, job->size, job->initial_version, job->version, out_size);
+    Memory_Free(job->data);
+    Memory_Free(job);
+    return out;
+}
+
+static void M_SaveRaw(MYFILE *fp, JSON_VALUE *root, int32_t version)
+{
+    size_t uncompressed_size;
+    char *const uncompressed = BSON_Write(root, &uncompressed_size);
+    if (uncompressed == nullptr) {
+        Shell_ExitSystem("Failed to serialize savegame data");
+    }
+
+    size_t size;
+    char *data = M_Encode(
+        uncompressed, uncompressed_size, g_GameInfo.save_initial_version,
+        version, &size);
+    Memory_Free(uncompressed);
+    if (data == nullptr) {
+        Shell_ExitSystem("Failed to compress savegame data");
+    }
+    File_WriteData(fp, data, size);
+    Memory_FreePointer(&data);
 }
 
 static void M_GetFXOrder(SAVEGAME_BSON_FX_ORDER *order)
@@ -161,119 +600,144 @@ static bool M_IsValidItemObject(
     // clang-format on
 }
 
-static JSON_VALUE *M_ParseFromBuffer(
-    const char *buffer, size_t buffer_size, int32_t *version_out)
+static char *M_ReadFromFile(
+    MYFILE *const fp, int32_t *const version_out, size_t *const out_size)
 {
-    SAVEGAME_BSON_HEADER *header = (SAVEGAME_BSON_HEADER *)buffer;
-    if (header->magic != SAVEGAME_BSON_MAGIC) {
+    SAVEGAME_BSON_HEADER header;
+    const size_t file_size = File_Size(fp);
+    if (file_size < sizeof(header)) {
+        LOG_ERROR("Invalid savegame size");
+        return nullptr;
+    }
+    File_Seek(fp, 0, FILE_SEEK_SET);
+    File_ReadData(fp, &header, sizeof(header));
+
+    const SAVEGAME_BSON_CODEC *const codec = M_GetCodec(header.magic);
+    if (codec == nullptr) {
         LOG_ERROR("Invalid savegame magic");
         return nullptr;
     }
+    if (header.compressed_size < 0 || header.uncompressed_size <= 0
+        || (size_t)header.compressed_size > file_size - sizeof(header)) {
+        LOG_ERROR("Invalid savegame size");
+        return nullptr;
+    }
 
     if (version_out) {
-        *version_out = header->version;
+        *version_out = header.version;
     }
 
-    const char *compressed = buffer + sizeof(SAVEGAME_BSON_HEADER);
-    char *uncompressed = Memory_Alloc(header->uncompressed_size);
-
-    uLongf uncompressed_size = header->uncompressed_size;
-    int error_code = uncompress(
-        (Bytef *)uncompressed, &uncompressed_size, (const Bytef *)compressed,
-        (uLongf)header->compressed_size);
-    if (error_code != Z_OK) {
-        LOG_ERROR("Failed to decompress the data (error %d)", error_code);
-        Memory_FreePointer(&uncompressed);
+    char *out = Memory_Alloc(header.uncompressed_size);
+    if (!codec->decompress(
+            fp, header.compressed_size, out, header.uncompressed_size)) {
+        Memory_FreePointer(&out);
         return nullptr;
     }
 
-    JSON_VALUE *root = BSON_Parse(uncompressed, uncompressed_size);
-    Memory_FreePointer(&uncompressed);
-    return root;
+    *out_size = header.uncompressed_size;
+    return out;
 }
 
 static JSON_VALUE *M_ParseFromFile(MYFILE *fp, int32_t *version_out)
 {
-    const size_t buffer_size = File_Size(fp);
-    char *buffer = Memory_Alloc(buffer_size);
-    File_Seek(fp, 0, FILE_SEEK_SET);
-    File_ReadData(fp, buffer, buffer_size);
+    size_t size;
+    char *data = M_ReadFromFile(fp, version_out, &size);
+    if (data == nullptr) {
+        return nullptr;
+    }
+    JSON_VALUE *const root = BSON_Parse(data, size);
+    Memory_FreePointer(&data);
+    return root;
+}
 
-    JSON_VALUE *ret = M_ParseFromBuffer(buffer, buffer_size, version_out);
-    Memory_FreePointer(&buffer);
-    return ret;
+static BSON_READER *M_GetArray(
+    const BSON_READER *const parent, const char *const key,
+    BSON_READER *const out)
+{
+    return BSON_ReaderGetArray(parent, key, out) ? out : nullptr;
 }
 
-static bool M_LoadResumeInfo(JSON_ARRAY *resume_arr, RESUME_INFO *resume_info)
+static BSON_READER *M_GetObject(
+    const BSON_READER *const parent, const char *const key,
+    BSON_READER *const out)
+{
+    return BSON_ReaderGetObject(parent, key, out) ? out : nullptr;
+}
+
+static bool M_LoadResumeInfo(BSON_READER *resume_arr, RESUME_INFO *resume_info)
 {
     ASSERT(resume_info != nullptr);
     if (!resume_arr) {
         LOG_ERROR("Malformed save: invalid or missing resume array");
         return false;
     }
-    if ((signed)resume_arr->length != GF_GetLevelTable(GFLT_MAIN)->count) {
+    const int32_t length = BSON_ReaderCount(resume_arr);
+    if (length != GF_GetLevelTable(GFLT_MAIN)->count) {
         LOG_ERROR(
             "Malformed save: expected %d resume info elements, got %d",
-            GF_GetLevelTable(GFLT_MAIN)->count, resume_arr->length);
+            GF_GetLevelTable(GFLT_MAIN)->count, length);
         return false;
     }
-    for (int i = 0; i < (signed)resume_arr->length; i++) {
-        JSON_OBJECT *resume_obj = JSON_ArrayGetObject(resume_arr, i);
-        if (!resume_obj) {
+    BSON_FIELD field;
+    for (int i = 0; BSON_ReaderNext(resume_arr, &field); i++) {
+        BSON_READER resume_obj;
+        if (!BSON_FieldGetReader(&field, &resume_obj)) {
             LOG_ERROR("Malformed save: invalid resume info");
             return false;
         }
         RESUME_INFO *resume = &resume_info[i];
-        resume->lara_hitpoints = JSON_ObjectGetInt(
-            resume_obj, "lara_hitpoints",
+        resume->lara_hitpoints = BSON_ReaderGetInt(
+            &resume_obj, "lara_hitpoints",
             g_Config.gameplay.start_lara_hitpoints);
-        resume->pistol_ammo = JSON_ObjectGetInt(resume_obj, "pistol_ammo", 0);
-        resume->magnum_ammo = JSON_ObjectGetInt(resume_obj, "magnum_ammo", 0);
-        resume->uzi_ammo = JSON_ObjectGetInt(resume_obj, "uzi_ammo", 0);
-        resume->shotgun_ammo = JSON_ObjectGetInt(resume_obj, "shotgun_ammo", 0);
-        resume->num_medis = JSON_ObjectGetInt(resume_obj, "num_medis", 0);
+        resume->pistol_ammo = BSON_ReaderGetInt(&resume_obj, "pistol_ammo", 0);
+        resume->magnum_ammo = BSON_ReaderGetInt(&resume_obj, "magnum_ammo", 0);
+        resume->uzi_ammo = BSON_ReaderGetInt(&resume_obj, "uzi_ammo", 0);
+        resume->shotgun_ammo =
+            BSON_ReaderGetInt(&resume_obj, "shotgun_ammo", 0);
+        resume->num_medis = BSON_ReaderGetInt(&resume_obj, "num_medis", 0);
         resume->num_big_medis =
-            JSON_ObjectGetInt(resume_obj, "num_big_medis", 0);
-        resume->num_scions = JSON_ObjectGetInt(resume_obj, "num_scions", 0);
-        resume->gun_status = JSON_ObjectGetInt(resume_obj, "gun_status", 0);
+            BSON_ReaderGetInt(&resume_obj, "num_big_medis", 0);
+        resume->num_scions = BSON_ReaderGetInt(&resume_obj, "num_scions", 0);
+        resume->gun_status = BSON_ReaderGetInt(&resume_obj, "gun_status", 0);
         resume->equipped_gun_type =
-            JSON_ObjectGetInt(resume_obj, "gun_type", LGT_UNARMED);
+            BSON_ReaderGetInt(&resume_obj, "gun_type", LGT_UNARMED);
         resume->holsters_gun_type =
-            JSON_ObjectGetInt(resume_obj, "holsters_gun_type", LGT_UNKNOWN);
+            BSON_ReaderGetInt(&resume_obj, "holsters_gun_type", LGT_UNKNOWN);
         resume->back_gun_type =
-            JSON_ObjectGetInt(resume_obj, "back_gun_type", LGT_UNKNOWN);
+            BSON_ReaderGetInt(&resume_obj, "back_gun_type", LGT_UNKNOWN);
         resume->flags.available =
-            JSON_ObjectGetBool(resume_obj, "available", 0);
+            BSON_ReaderGetBool(&resume_obj, "available", 0);
         resume->flags.got_pistols =
-            JSON_ObjectGetBool(resume_obj, "got_pistols", 0);
+            BSON_ReaderGetBool(&resume_obj, "got_pistols", 0);
         resume->flags.got_magnums =
-            JSON_ObjectGetBool(resume_obj, "got_magnums", 0);
-        resume->flags.got_uzis = JSON_ObjectGetBool(resume_obj, "got_uzis", 0);
+            BSON_ReaderGetBool(&resume_obj, "got_magnums", 0);
+        resume->flags.got_uzis =
+            BSON_ReaderGetBool(&resume_obj, "got_uzis", 0);
         resume->flags.got_shotgun =
-            JSON_ObjectGetBool(resume_obj, "got_shotgun", 0);
-        resume->flags.costume = JSON_ObjectGetBool(resume_obj, "costume", 0);
+            BSON_ReaderGetBool(&resume_obj, "got_shotgun", 0);
+        resume->flags.costume = BSON_ReaderGetBool(&resume_obj, "costume", 0);
 
         resume->stats.timer =
-            JSON_ObjectGetInt(resume_obj, "timer", resume->stats.timer);
-        resume->stats.secret_flags = JSON_ObjectGetInt(
-            resume_obj, "secrets", resume->stats.secret_flags);
+            BSON_ReaderGetInt(&resume_obj, "timer", resume->stats.timer);
+        resume->stats.secret_flags = BSON_ReaderGetInt(
+            &resume_obj, "secrets", resume->stats.secret_flags);
         Stats_UpdateSecrets(&resume->stats);
         resume->stats.kill_count =
-            JSON_ObjectGetInt(resume_obj, "kills", resume->stats.kill_count);
-        resume->stats.pickup_count = JSON_ObjectGetInt(
-            resume_obj, "pickups", resume->stats.pickup_count);
-        resume->stats.max_secret_count = JSON_ObjectGetInt(
-            resume_obj, "max_secrets", resume->stats.max_secret_count);
-        resume->stats.max_kill_count = JSON_ObjectGetInt(
-            resume_obj, "max_kills", resume->stats.max_kill_count);
-        resume->stats.max_pickup_count = JSON_ObjectGetInt(
-            resume_obj, "max_pickups", resume->stats.max_pickup_count);
+            BSON_ReaderGetInt(&resume_obj, "kills", resume->stats.kill_count);
+        resume->stats.pickup_count = BSON_ReaderGetInt(
+            &resume_obj, "pickups", resume->stats.pickup_count);
+        resume->stats.max_secret_count = BSON_ReaderGetInt(
+            &resume_obj, "max_secrets", resume->stats.max_secret_count);
+        resume->stats.max_kill_count = BSON_ReaderGetInt(
+            &resume_obj, "max_kills", resume->stats.max_kill_count);
+        resume->stats.max_pickup_count = BSON_ReaderGetInt(
+            &resume_obj, "max_pickups", resume->stats.max_pickup_count);
     }
     return true;
 }
 
 static bool M_LoadDiscontinuedStartInfo(
-    JSON_ARRAY *start_arr, GAME_INFO *game_info)
+    BSON_READER *start_arr, GAME_INFO *game_info)
 {
     // This function solely exists for backward compatibility with 2.6 and 2.7
     // saves.
@@ -284,48 +748,53 @@ static bool M_LoadDiscontinuedStartInfo(
             "Malformed save: invalid or missing discontinued start array");
         return false;
     }
-    if ((signed)start_arr->length != GF_GetLevelTable(GFLT_MAIN)->count) {
+    const int32_t length = BSON_ReaderCount(start_arr);
+    if (length != GF_GetLevelTable(GFLT_MAIN)->count) {
         LOG_ERROR(
             "Malformed save: expected %d start info elements, got %d",
-            GF_GetLevelTable(GFLT_MAIN)->count, start_arr->length);
+            GF_GetLevelTable(GFLT_MAIN)->count, length);
         return false;
     }
-    for (int i = 0; i < (signed)start_arr->length; i++) {
-        JSON_OBJECT *start_obj = JSON_ArrayGetObject(start_arr, i);
-        if (!start_obj) {
+    BSON_FIELD field;
+    for (int i = 0; BSON_ReaderNext(start_arr, &field); i++) {
+        BSON_READER start_obj;
+        if (!BSON_FieldGetReader(&field, &start_obj)) {
             LOG_ERROR("Malformed save: invalid discontinued start info");
             return false;
         }
         RESUME_INFO *start = &game_info->current[i];
-        start->lara_hitpoints = JSON_ObjectGetInt(
-            start_obj, "lara_hitpoints",
+        start->lara_hitpoints = BSON_ReaderGetInt(
+            &start_obj, "lara_hitpoints",
             g_Config.gameplay.start_lara_hitpoints);
-        start->pistol_ammo = JSON_ObjectGetInt(start_obj, "pistol_ammo", 0);
-        start->magnum_ammo = JSON_ObjectGetInt(start_obj, "magnum_ammo", 0);
-        start->uzi_ammo = JSON_ObjectGetInt(start_obj, "uzi_ammo", 0);
-        start->shotgun_ammo = JSON_ObjectGetInt(start_obj, "shotgun_ammo", 0);
-        start->num_medis = JSON_ObjectGetInt(start_obj, "num_medis", 0);
-        start->num_big_medis = JSON_ObjectGetInt(start_obj, "num_big_medis", 0);
-        start->num_scions = JSON_ObjectGetInt(start_obj, "num_scions", 0);
-        start->gun_status = JSON_ObjectGetInt(start_obj, "gun_status", 0);
+        start->pistol_ammo = BSON_ReaderGetInt(&start_obj, "pistol_ammo", 0);
+        start->magnum_ammo = BSON_ReaderGetInt(&start_obj, "magnum_ammo", 0);
+        start->uzi_ammo = BSON_ReaderGetInt(&start_obj, "uzi_ammo", 0);
+        start->shotgun_ammo = BSON_ReaderGetInt(&start_obj, "shotgun_ammo", 0);
+        start->num_medis = BSON_ReaderGetInt(&start_obj, "num_medis", 0);
+        start->num_big_medis =
+            BSON_ReaderGetInt(&start_obj, "num_big_medis", 0);
+        start->num_scions = BSON_ReaderGetInt(&start_obj, "num_scions", 0);
+        start->gun_status = BSON_ReaderGetInt(&start_obj, "gun_status", 0);
         start->equipped_gun_type =
-            JSON_ObjectGetInt(start_obj, "gun_type", LGT_UNARMED);
+            BSON_ReaderGetInt(&start_obj, "gun_type", LGT_UNARMED);
         start->holsters_gun_type = LGT_UNKNOWN;
         start->back_gun_type = LGT_UNKNOWN;
-        start->flags.available = JSON_ObjectGetBool(start_obj, "available", 0);
+        start->flags.available =
+            BSON_ReaderGetBool(&start_obj, "available", 0);
         start->flags.got_pistols =
-            JSON_ObjectGetBool(start_obj, "got_pistols", 0);
+            BSON_ReaderGetBool(&start_obj, "got_pistols", 0);
         start->flags.got_magnums =
-            JSON_ObjectGetBool(start_obj, "got_magnums", 0);
-        start->flags.got_uzis = JSON_ObjectGetBool(start_obj, "got_uzis", 0);
+            BSON_ReaderGetBool(&start_obj, "got_magnums", 0);
+        start->flags.got_uzis = BSON_ReaderGetBool(&start_obj, "got_uzis", 0);
         start->flags.got_shotgun =
-            JSON_ObjectGetBool(start_obj, "got_shotgun", 0);
-        start->flags.costume = JSON_ObjectGetBool(start_obj, "costume", 0);
+            BSON_ReaderGetBool(&start_obj, "got_shotgun", 0);
+        start->flags.costume = BSON_ReaderGetBool(&start_obj, "costume", 0);
     }
     return true;
 }
 
-static bool M_LoadDiscontinuedEndInfo(JSON_ARRAY *end_arr, GAME_INFO *game_info)
+static bool M_LoadDiscontinuedEndInfo(
+    BSON_READER *end_arr, GAME_INFO *game_info)
 {
     // This function solely exists for backward compatibility with 2.6 and 2.7
     // saves.
@@ -335,54 +804,57 @@ static bool M_LoadDiscontinuedEndInfo(JSON_ARRAY *end_arr, GAME_INFO *game_info)
         LOG_ERROR("Malformed save: invalid or missing resume info array");
         return false;
     }
-    if ((signed)end_arr->length != GF_GetLevelTable(GFLT_MAIN)->count) {
+    const int32_t length = BSON_ReaderCount(end_arr);
+    if (length != GF_GetLevelTable(GFLT_MAIN)->count) {
         LOG_ERROR(
             "Malformed save: expected %d resume info elements, got %d",
-            GF_GetLevelTable(GFLT_MAIN)->count, end_arr->length);
+            GF_GetLevelTable(GFLT_MAIN)->count, length);
         return false;
     }
-    for (int i = 0; i < (signed)end_arr->length; i++) {
-        JSON_OBJECT *end_obj = JSON_ArrayGetObject(end_arr, i);
-        if (!end_obj) {
+    BSON_FIELD field;
+    for (int i = 0; BSON_ReaderNext(end_arr, &field); i++) {
+        BSON_READER end_obj;
+        if (!BSON_FieldGetReader(&field, &end_obj)) {
             LOG_ERROR("Malformed save: invalid resume info");
             return false;
         }
         LEVEL_STATS *end = &game_info->current[i].stats;
-        end->timer = JSON_ObjectGetInt(end_obj, "timer", end->timer);
+        end->timer = BSON_ReaderGetInt(&end_obj, "timer", end->timer);
         end->secret_flags =
-            JSON_ObjectGetInt(end_obj, "secrets", end->secret_flags);
+            BSON_ReaderGetInt(&end_obj, "secrets", end->secret_flags);
         Stats_UpdateSecrets(end);
-        end->kill_count = JSON_ObjectGetInt(end_obj, "kills", end->kill_count);
+        end->kill_count =
+            BSON_ReaderGetInt(&end_obj, "kills", end->kill_count);
         end->pickup_count =
-            JSON_ObjectGetInt(end_obj, "pickups", end->pickup_count);
+            BSON_ReaderGetInt(&end_obj, "pickups", end->pickup_count);
         end->max_secret_count =
-            JSON_ObjectGetInt(end_obj, "max_secrets", end->max_secret_count);
+            BSON_ReaderGetInt(&end_obj, "max_secrets", end->max_secret_count);
         end->max_kill_count =
-            JSON_ObjectGetInt(end_obj, "max_kills", end->max_kill_count);
+            BSON_ReaderGetInt(&end_obj, "max_kills", end->max_kill_count);
         end->max_pickup_count =
-            JSON_ObjectGetInt(end_obj, "max_pickups", end->max_pickup_count);
+            BSON_ReaderGetInt(&end_obj, "max_pickups", end->max_pickup_count);
     }
     return true;
 }
 
 static bool M_LoadMisc(
-    JSON_OBJECT *misc_obj, GAME_INFO *game_info, uint16_t header_version)
+    BSON_READER *misc_obj, GAME_INFO *game_info, uint16_t header_version)
 {
     ASSERT(game_info != nullptr);
     if (!misc_obj) {
         LOG_ERROR("Malformed save: invalid or missing misc info");
         return false;
     }
-    game_info->bonus_flag = JSON_ObjectGetInt(misc_obj, "bonus_flag", 0);
+    game_info->bonus_flag = BSON_ReaderGetInt(misc_obj, "bonus_flag", 0);
     if (header_version >= VERSION_4) {
         game_info->bonus_level_unlock =
-            JSON_ObjectGetBool(misc_obj, "bonus_level_unlock", 0);
-        game_info->death_count = JSON_ObjectGetInt(misc_obj, "death_count", -1);
+            BSON_ReaderGetBool(misc_obj, "bonus_level_unlock", 0);
+        game_info->death_count = BSON_ReaderGetInt(misc_obj, "death_count", -1);
     }
     return true;
 }
 
-static bool M_LoadInventory(JSON_OBJECT *inv_obj)
+static bool M_LoadInventory(BSON_READER *inv_obj)
 {
     if (!inv_obj) {
         LOG_ERROR("Malformed save: invalid or missing inventory info");
@@ -391,78 +863,135 @@ static bool M_LoadInventory(JSON_OBJECT *inv_obj)
     const GF_LEVEL *const current_level = Game_GetCurrentLevel();
     Lara_InitialiseInventory(current_level);
     Inv_AddItemNTimes(
-        O_PICKUP_ITEM_1, JSON_ObjectGetInt(inv_obj, "pickup1", 0));
+        O_PICKUP_ITEM_1, BSON_ReaderGetInt(inv_obj, "pickup1", 0));
     Inv_AddItemNTimes(
-        O_PICKUP_ITEM_2, JSON_ObjectGetInt(inv_obj, "pickup2", 0));
+        O_PICKUP_ITEM_2, BSON_ReaderGetInt(inv_obj, "pickup2", 0));
     Inv_AddItemNTimes(
-        O_PUZZLE_ITEM_1, JSON_ObjectGetInt(inv_obj, "puzzle1", 0));
+        O_PUZZLE_ITEM_1, BSON_ReaderGetInt(inv_obj, "puzzle1", 0));
     Inv_AddItemNTimes(
-        O_PUZZLE_ITEM_2, JSON_ObjectGetInt(inv_obj, "puzzle2", 0));
+        O_PUZZLE_ITEM_2, BSON_ReaderGetInt(inv_obj, "puzzle2", 0));
     Inv_AddItemNTimes(
-        O_PUZZLE_ITEM_3, JSON_ObjectGetInt(inv_obj, "puzzle3", 0));
+        O_PUZZLE_ITEM_3, BSON_ReaderGetInt(inv_obj, "puzzle3", 0));
     Inv_AddItemNTimes(
-        O_PUZZLE_ITEM_4, JSON_ObjectGetInt(inv_obj, "puzzle4", 0));
-    Inv_AddItemNTimes(O_KEY_ITEM_1, JSON_ObjectGetInt(inv_obj, "key1", 0));
-    Inv_AddItemNTimes(O_KEY_ITEM_2, JSON_ObjectGetInt(inv_obj, "key2", 0));
-    Inv_AddItemNTimes(O_KEY_ITEM_3, JSON_ObjectGetInt(inv_obj, "key3", 0));
-    Inv_AddItemNTimes(O_KEY_ITEM_4, JSON_ObjectGetInt(inv_obj, "key4", 0));
-    Inv_AddItemNTimes(O_LEADBAR_ITEM, JSON_ObjectGetInt(inv_obj, "leadbar", 0));
+        O_PUZZLE_ITEM_4, BSON_ReaderGetInt(inv_obj, "puzzle4", 0));
+    Inv_AddItemNTimes(O_KEY_ITEM_1, BSON_ReaderGetInt(inv_obj, "key1", 0));
+    Inv_AddItemNTimes(O_KEY_ITEM_2, BSON_ReaderGetInt(inv_obj, "key2", 0));
+    Inv_AddItemNTimes(O_KEY_ITEM_3, BSON_ReaderGetInt(inv_obj, "key3", 0));
+    Inv_AddItemNTimes(O_KEY_ITEM_4, BSON_ReaderGetInt(inv_obj, "key4", 0));
+    Inv_AddItemNTimes(O_LEADBAR_ITEM, BSON_ReaderGetInt(inv_obj, "leadbar", 0));
     return true;
 }
 
-static bool M_LoadFlipmaps(JSON_OBJECT *flipmap_obj)
+static bool M_LoadFlipmaps(BSON_READER *flipmap_obj)
 {
     if (!flipmap_obj) {
         LOG_ERROR("Malformed save: invalid or missing flipmap info");
         return false;
     }
 
-    if (JSON_ObjectGetBool(flipmap_obj, "status", false)) {
-        Room_FlipMap();
-    }
-
-    Room_SetFlipEffect(JSON_ObjectGetInt(flipmap_obj, "effect", 0));
-    Room_SetFlipTimer(JSON_ObjectGetInt(flipmap_obj, "timer", 0));
+    SAVEGAME_BSON_FLIPMAP flipmap = {};
+    bool has_table = false;
+    int32_t hint = 0;
+    BSON_FIELD field;
+    while (BSON_ReaderNext(flipmap_obj, &field)) {
+        if (BSON_DecodeField(
+                &field, m_FlipmapFields, m_FlipmapFieldCount, &flipmap,
+                &hint)) {
+            continue;
+        }
+        if (strcmp(field.key, "table") != 0) {
+            continue;
+        }
 
-    JSON_ARRAY *flipmap_arr = JSON_ObjectGetArray(flipmap_obj, "table");
-    if (!flipmap_arr) {
+        BSON_READER flipmap_arr;
+        if (field.type != BSON_TYPE_ARRAY
+            || !BSON_FieldGetReader(&field, &flipmap_arr)) {
+            break;
+        }
+        const int32_t length = BSON_ReaderCount(&flipmap_arr);
+        if (length != MAX_FLIP_MAPS) {
+            LOG_ERROR(
+                "Malformed save: expected %d flipmap elements, got %d",
+                MAX_FLIP_MAPS, length);
+            return false;
+        }
+        BSON_FIELD slot;
+        for (int32_t i = 0; BSON_ReaderNext(&flipmap_arr, &slot); i++) {
+            flipmap.table[i] = BSON_FieldGetInt(&slot, 0);
+        }
+        has_table = true;
+    }
+    if (!has_table) {
         LOG_ERROR("Malformed save: invalid or missing flipmap table");
         return false;
     }
-    if (flipmap_arr->length != MAX_FLIP_MAPS) {
-        LOG_ERROR(
-            "Malformed save: expected %d flipmap elements, got %d",
-            MAX_FLIP_MAPS, flipmap_arr->length);
-        return false;
+
+    if (flipmap.status) {
+        Room_FlipMap();
     }
-    for (int32_t i = 0; i < (signed)flipmap_arr->length; i++) {
-        Room_SetFlipSlotFlags(i, JSON_ArrayGetInt(flipmap_arr, i, 0) << 8);
+    Room_SetFlipEffect(flipmap.effect);
+    Room_SetFlipTimer(flipmap.timer);
+    for (int32_t i = 0; i < MAX_FLIP_MAPS; i++) {
+        Room_SetFlipSlotFlags(i, flipmap.table[i] << 8);
     }
 
     return true;
 }
 
-static bool M_LoadCameras(JSON_ARRAY *cameras_arr)
+static bool M_LoadCameras(BSON_READER *cameras_arr)
 {
     if (!cameras_arr) {
         LOG_ERROR("Malformed save: invalid or missing cameras array");
         return false;
     }
     const int32_t num_cameras = Camera_GetFixedObjectCount();
-    if ((signed)cameras_arr->length != num_cameras) {
+    const int32_t length = BSON_ReaderCount(cameras_arr);
+    if (length != num_cameras) {
         LOG_ERROR(
             "Malformed save: expected %d cameras, got %d", num_cameras,
-            cameras_arr->length);
+            length);
         return false;
     }
-    for (int32_t i = 0; i < num_cameras; i++) {
+    BSON_FIELD field;
+    for (int32_t i = 0; BSON_ReaderNext(cameras_arr, &field); i++) {
         OBJECT_VECTOR *const object = Camera_GetFixedObject(i);
-        object->flags = JSON_ArrayGetInt(cameras_arr, i, 0);
+        object->flags = BSON_FieldGetInt(&field, 0);
+    }
+    return true;
+}
+
+static bool M_LoadCarriedItems(
+    const BSON_FIELD *const field, const int32_t item_num)
+{
+    BSON_READER carried_items;
+    if (!BSON_FieldGetReader(field, &carried_items)) {
+        LOG_ERROR("Malformed save: invalid carried items");
+        return false;
+    }
+
+    CARRIED_ITEM *carried_item = Item_Get(item_num)->carried_item;
+    BSON_FIELD carried_item_field;
+    while (BSON_ReaderNext(&carried_items, &carried_item_field)) {
+        if (!carried_item) {
+            LOG_ERROR("Malformed save: carried item mismatch");
+            return false;
+        }
+
+        BSON_READER carried_item_obj;
+        if (BSON_FieldGetReader(&carried_item_field, &carried_item_obj)) {
+            BSON_ReaderDecode(
+                &carried_item_obj, m_CarriedItemFields,
+                m_CarriedItemFieldCount, carried_item);
+        }
+
+        carried_item = carried_item->next_item;
     }
+
+    Carrier_TestItemDrops(item_num);
     return true;
 }
 
-static bool M_LoadItems(JSON_ARRAY *items_arr, uint16_t header_version)
+static bool M_LoadItems(BSON_READER *items_arr, uint16_t header_version)
 {
     if (!items_arr) {
         LOG_ERROR("Malformed save: invalid or missing items array");
@@ -470,16 +999,18 @@ static bool M_LoadItems(JSON_ARRAY *items_arr, uint16_t header_version)
     }
 
     const int32_t item_count = Item_GetLevelCount();
-    if ((signed)items_arr->length != item_count) {
+    const int32_t length = BSON_ReaderCount(items_arr);
+    if (length != item_count) {
         LOG_ERROR(
-            "Malformed save: expected %d items, got %d", item_count,
-            items_arr->length);
+            "Malformed save: expected %d items, got %d", item_count, length);
         return false;
     }
 
-    for (int32_t i = 0; i < item_count; i++) {
-        JSON_OBJECT *item_obj = JSON_ArrayGetObject(items_arr, i);
-        if (!item_obj) {
+    BSON_FIELD field;
+    for (int32_t i = 0; BSON_ReaderNext(items_arr, &field); i++) {
+        BSON_READER item_obj;
+        if (field.type != BSON_TYPE_OBJECT
+            || !BSON_FieldGetReader(&field, &item_obj)) {
             LOG_ERROR("Malformed save: invalid item data");
             return false;
         }
@@ -487,8 +1018,52 @@ static bool M_LoadItems(JSON_ARRAY *items_arr, uint16_t header_version)
         ITEM *const item = Item_Get(i);
         const OBJECT *const obj = Object_Get(item->object_id);
 
-        const GAME_OBJECT_ID obj_id =
-            JSON_ObjectGetInt(item_obj, "obj_num", -1);
+        // Fields missing from the save keep the current values.
+        SAVEGAME_BSON_ITEM data = {
+            .obj_num = -1,
+            .pos = item->pos,
+            .rot = item->rot,
+            .room_num = -1,
+            .speed = item->speed,
+            .fall_speed = item->fall_speed,
+            .current_anim_state = item->current_anim_state,
+            .goal_anim_state = item->goal_anim_state,
+            .required_anim_state = item->required_anim_state,
+            .anim_num = item->anim_num,
+            .frame_num = item->frame_num,
+            .hit_points = item->hit_points,
+            .flags = item->flags,
+            .timer = item->timer,
+            .status = item->status,
+            .active = item->active,
+            .gravity = item->gravity,
+            .collidable = item->collidable,
+            .intelligent = obj->intelligent,
+            .head_rot = SAVEGAME_BSON_NO_VALUE,
+            .neck_rot = SAVEGAME_BSON_NO_VALUE,
+            .max_turn = SAVEGAME_BSON_NO_VALUE,
+            .creature_flags = SAVEGAME_BSON_NO_VALUE,
+            .creature_mood = SAVEGAME_BSON_NO_VALUE,
+            .fx_num = -1,
+            .bl_status = 0,
+        };
+        BSON_FIELD carried_items = {};
+        int32_t hint = 0;
+        BSON_FIELD item_field;
+        while (BSON_ReaderNext(&item_obj, &item_field)) {
+            if (!BSON_DecodeField(
+                    &item_field, m_ItemFields, m_ItemFieldCount, &data,
+                    &hint)
+                && strcmp(item_field.key, "carried_items") == 0) {
+                carried_items = item_field;
+            }
+        }
+        if (item_obj.is_error) {
+            LOG_ERROR("Malformed save: invalid item data");
+            return false;
+        }
+
+        const GAME_OBJECT_ID obj_id = data.obj_num;
         if (!M_IsValidItemObject(obj_id, item->object_id)) {
             LOG_ERROR(
                 "Malformed save: expected object %d, got %d", item->object_id,
@@ -497,74 +1072,63 @@ static bool M_LoadItems(JSON_ARRAY *items_arr, uint16_t header_version)
         }
 
         if (obj->save_position) {
-            item->pos.x = JSON_ObjectGetInt(item_obj, "x", item->pos.x);
-            item->pos.y = JSON_ObjectGetInt(item_obj, "y", item->pos.y);
-            item->pos.z = JSON_ObjectGetInt(item_obj, "z", item->pos.z);
-            item->rot.x = JSON_ObjectGetInt(item_obj, "x_rot", item->rot.x);
-            item->rot.y = JSON_ObjectGetInt(item_obj, "y_rot", item->rot.y);
-            item->rot.z = JSON_ObjectGetInt(item_obj, "z_rot", item->rot.z);
-            item->speed = JSON_ObjectGetInt(item_obj, "speed", item->speed);
-            item->fall_speed =
-                JSON_ObjectGetInt(item_obj, "fall_speed", item->fall_speed);
-
-            int16_t room_num = JSON_ObjectGetInt(item_obj, "room_num", -1);
-            if (room_num != -1 && item->room_num != room_num) {
-                Item_NewRoom(i, room_num);
+            item->pos = data.pos;
+            item->rot = data.rot;
+            item->speed = data.speed;
+            item->fall_speed = data.fall_speed;
+
+            if (data.room_num != -1 && item->room_num != data.room_num) {
+                Item_NewRoom(i, data.room_num);
             }
         }
 
         if (obj->save_anim) {
-            item->current_anim_state = JSON_ObjectGetInt(
-                item_obj, "current_anim", item->current_anim_state);
-            item->goal_anim_state =
-                JSON_ObjectGetInt(item_obj, "goal_anim", item->goal_anim_state);
-            item->required_anim_state = JSON_ObjectGetInt(
-                item_obj, "required_anim", item->required_anim_state);
-            item->anim_num =
-                JSON_ObjectGetInt(item_obj, "anim_num", item->anim_num);
-            item->frame_num =
-                JSON_ObjectGetInt(item_obj, "frame_num", item->frame_num);
+            item->current_anim_state = data.current_anim_state;
+            item->goal_anim_state = data.goal_anim_state;
+            item->required_anim_state = data.required_anim_state;
+            item->anim_num = data.anim_num;
+            item->frame_num = data.frame_num;
         }
 
         if (obj->save_hitpoints) {
-            item->hit_points =
-                JSON_ObjectGetInt(item_obj, "hitpoints", item->hit_points);
+            item->hit_points = data.hit_points;
         }
 
         if (obj->save_flags) {
-            item->flags = JSON_ObjectGetInt(item_obj, "flags", item->flags);
-            item->timer = JSON_ObjectGetInt(item_obj, "timer", item->timer);
+            item->flags = data.flags;
+            item->timer = data.timer;
 
             if (item->flags & IF_KILLED) {
                 Item_Kill(i);
                 item->status = IS_DEACTIVATED;
             } else {
-                if (JSON_ObjectGetBool(item_obj, "active", item->active)
-                    && !item->active) {
+                if (data.active && !item->active) {
                     Item_AddActive(i);
                 }
-                item->status =
-                    JSON_ObjectGetInt(item_obj, "status", item->status);
-                item->gravity =
-                    JSON_ObjectGetBool(item_obj, "gravity", item->gravity);
-                item->collidable = JSON_ObjectGetBool(
-                    item_obj, "collidable", item->collidable);
+                item->status = data.status;
+                item->gravity = data.gravity;
+                item->collidable = data.collidable;
             }
 
-            if (JSON_ObjectGetBool(item_obj, "intelligent", obj->intelligent)) {
+            if (data.intelligent) {
                 LOT_EnableBaddieAI(i, 1);
                 CREATURE *creature = item->data;
                 if (creature) {
-                    creature->head_rotation = JSON_ObjectGetInt(
-                        item_obj, "head_rot", creature->head_rotation);
-                    creature->neck_rotation = JSON_ObjectGetInt(
-                        item_obj, "neck_rot", creature->neck_rotation);
-                    creature->maximum_turn = JSON_ObjectGetInt(
-                        item_obj, "max_turn", creature->maximum_turn);
-                    creature->flags = JSON_ObjectGetInt(
-                        item_obj, "creature_flags", creature->flags);
-                    creature->mood = JSON_ObjectGetInt(
-                        item_obj, "creature_mood", creature->mood);
+                    if (data.head_rot != SAVEGAME_BSON_NO_VALUE) {
+                        creature->head_rotation = data.head_rot;
+                    }
+                    if (data.neck_rot != SAVEGAME_BSON_NO_VALUE) {
+                        creature->neck_rotation = data.neck_rot;
+                    }
+                    if (data.max_turn != SAVEGAME_BSON_NO_VALUE) {
+                        creature->maximum_turn = data.max_turn;
+                    }
+                    if (data.creature_flags != SAVEGAME_BSON_NO_VALUE) {
+                        creature->flags = data.creature_flags;
+                    }
+                    if (data.creature_mood != SAVEGAME_BSON_NO_VALUE) {
+                        creature->mood = data.creature_mood;
+                    }
                 }
             } else if (obj->intelligent) {
                 item->data = nullptr;
@@ -573,54 +1137,21 @@ static bool M_LoadItems(JSON_ARRAY *items_arr, uint16_t header_version)
             if (header_version >= VERSION_3
                 && item->object_id == O_FLAME_EMITTER
                 && g_Config.gameplay.enable_enhanced_saves) {
-                int32_t effect_num = JSON_ObjectGetInt(item_obj, "fx_num", -1);
-                if (effect_num != -1) {
-                    item->data = (void *)(intptr_t)(effect_num + 1);
+                if (data.fx_num != -1) {
+                    item->data = (void *)(intptr_t)(data.fx_num + 1);
                 }
             }
 
             if (header_version >= VERSION_5
                 && item->object_id == O_BACON_LARA) {
-                const int32_t status =
-                    JSON_ObjectGetInt(item_obj, "bl_status", 0);
-                item->data = (void *)(intptr_t)status;
+                item->data = (void *)(intptr_t)data.bl_status;
             }
         }
 
-        JSON_ARRAY *carried_items =
-            JSON_ObjectGetArray(item_obj, "carried_items");
-        if (carried_items) {
-            CARRIED_ITEM *carried_item = item->carried_item;
-            for (int j = 0; j < (signed)carried_items->length; j++) {
-                if (!carried_item) {
-                    LOG_ERROR("Malformed save: carried item mismatch");
-                    return false;
-                }
-
-                JSON_OBJECT *carried_item_obj =
-                    JSON_ArrayGetObject(carried_items, j);
-
-                carried_item->object_id = JSON_ObjectGetInt(
-                    carried_item_obj, "object_id", carried_item->object_id);
-                carried_item->pos.x = JSON_ObjectGetInt(
-                    carried_item_obj, "x", carried_item->pos.x);
-                carried_item->pos.y = JSON_ObjectGetInt(
-                    carried_item_obj, "y", carried_item->pos.y);
-                carried_item->pos.z = JSON_ObjectGetInt(
-                    carried_item_obj, "z", carried_item->pos.z);
-                carried_item->rot.y = JSON_ObjectGetInt(
-                    carried_item_obj, "y_rot", carried_item->rot.y);
-                carried_item->room_num = JSON_ObjectGetInt(
-                    carried_item_obj, "room_num", carried_item->room_num);
-                carried_item->fall_speed = JSON_ObjectGetInt(
-                    carried_item_obj, "fall_speed", carried_item->fall_speed);
-                carried_item->status = JSON_ObjectGetInt(
-                    carried_item_obj, "status", carried_item->status);
-
-                carried_item = carried_item->next_item;
+        if (carried_items.key != nullptr) {
+            if (!M_LoadCarriedItems(&carried_items, i)) {
+                return false;
             }
-
-            Carrier_TestItemDrops(i);
         } else if (header_version < VERSION_4) {
             Carrier_TestLegacyDrops(i);
         }
@@ -629,7 +1160,7 @@ static bool M_LoadItems(JSON_ARRAY *items_arr, uint16_t header_version)
     return true;
 }
 
-static bool M_LoadEffects(JSON_ARRAY *fx_arr)
+static bool M_LoadEffects(BSON_READER *fx_arr)
 {
     if (!g_Config.gameplay.enable_enhanced_saves) {
         return true;
@@ -640,240 +1171,142 @@ static bool M_LoadEffects(JSON_ARRAY *fx_arr)
         return false;
     }
 
-    if ((signed)fx_arr->length >= NUM_EFFECTS) {
+    const int32_t length = BSON_ReaderCount(fx_arr);
+    if (length >= NUM_EFFECTS) {
         LOG_WARNING(
             "Malformed save: expected a max of %d effect, got %d. effect over "
             "the "
             "maximum will not be created.",
-            NUM_EFFECTS - 1, fx_arr->length);
+            NUM_EFFECTS - 1, length);
     }
 
-    for (int i = 0; i < (signed)fx_arr->length; i++) {
-        JSON_OBJECT *fx_obj = JSON_ArrayGetObject(fx_arr, i);
-        if (!fx_obj) {
+    BSON_FIELD field;
+    while (BSON_ReaderNext(fx_arr, &field)) {
+        BSON_READER fx_obj;
+        if (field.type != BSON_TYPE_OBJECT
+            || !BSON_FieldGetReader(&field, &fx_obj)) {
             LOG_ERROR("Malformed save: invalid effect data");
             return false;
         }
 
-        int32_t x = JSON_ObjectGetInt(fx_obj, "x", 0);
-        int32_t y = JSON_ObjectGetInt(fx_obj, "y", 0);
-        int32_t z = JSON_ObjectGetInt(fx_obj, "z", 0);
-        int16_t room_num = JSON_ObjectGetInt(fx_obj, "room_number", 0);
-        GAME_OBJECT_ID obj_id = JSON_ObjectGetInt(fx_obj, "object_number", 0);
-        int16_t speed = JSON_ObjectGetInt(fx_obj, "speed", 0);
-        int16_t fall_speed = JSON_ObjectGetInt(fx_obj, "fall_speed", 0);
-        int16_t frame_num = JSON_ObjectGetInt(fx_obj, "frame_number", 0);
-        int16_t counter = JSON_ObjectGetInt(fx_obj, "counter", 0);
-        int16_t shade = JSON_ObjectGetInt(fx_obj, "shade", 0);
-
-        int16_t effect_num = Effect_Create(room_num);
+        SAVEGAME_BSON_EFFECT data = {};
+        BSON_ReaderDecode(&fx_obj, m_EffectFields, m_EffectFieldCount, &data);
+
+        int16_t effect_num = Effect_Create(data.room_num);
         if (effect_num != NO_EFFECT) {
             EFFECT *effect = Effect_Get(effect_num);
-            effect->pos.x = x;
-            effect->pos.y = y;
-            effect->pos.z = z;
-            effect->object_id = obj_id;
-            effect->speed = speed;
-            effect->fall_speed = fall_speed;
-            effect->frame_num = frame_num;
-            effect->counter = counter;
-            effect->shade = shade;
+            effect->pos = data.pos;
+            effect->object_id = data.object_id;
+            effect->speed = data.speed;
+            effect->fall_speed = data.fall_speed;
+            effect->frame_num = data.frame_num;
+            effect->counter = data.counter;
+            effect->shade = data.shade;
         }
     }
 
     return true;
 }
 
-static bool M_LoadArm(JSON_OBJECT *arm_obj, LARA_ARM *arm)
-{
-    ASSERT(arm != nullptr);
-    if (!arm_obj) {
-        LOG_ERROR("Malformed save: invalid or missing arm info");
-        return false;
-    }
-
-    arm->frame_num = JSON_ObjectGetInt(arm_obj, "frame_num", arm->frame_num);
-    arm->lock = JSON_ObjectGetInt(arm_obj, "lock", arm->lock);
-    arm->rot.x = JSON_ObjectGetInt(arm_obj, "x_rot", arm->rot.x);
-    arm->rot.y = JSON_ObjectGetInt(arm_obj, "y_rot", arm->rot.y);
-    arm->rot.z = JSON_ObjectGetInt(arm_obj, "z_rot", arm->rot.z);
-    arm->flash_gun = JSON_ObjectGetInt(arm_obj, "flash_gun", arm->flash_gun);
-    return true;
-}
-
-static bool M_LoadAmmo(JSON_OBJECT *ammo_obj, AMMO_INFO *ammo)
-{
-    ASSERT(ammo != nullptr);
-    if (!ammo_obj) {
-        LOG_ERROR("Malformed save: invalid or missing ammo info");
-        return false;
-    }
-
-    ammo->ammo = JSON_ObjectGetInt(ammo_obj, "ammo", ammo->ammo);
-    ammo->hit = JSON_ObjectGetInt(ammo_obj, "hit", ammo->hit);
-    ammo->miss = JSON_ObjectGetInt(ammo_obj, "miss", ammo->miss);
-    return true;
-}
-
-static bool M_LoadLOT(JSON_OBJECT *lot_obj, LOT_INFO *lot)
+static bool M_LoadLaraMeshes(const BSON_FIELD *const field, LARA_INFO *lara)
 {
-    ASSERT(lot != nullptr);
-    if (!lot_obj) {
-        LOG_ERROR("Malformed save: invalid or missing LOT info");
-        return false;
-    }
-
-    lot->head = JSON_ObjectGetInt(lot_obj, "head", lot->head);
-    lot->tail = JSON_ObjectGetInt(lot_obj, "tail", lot->tail);
-    lot->search_num = JSON_ObjectGetInt(lot_obj, "search_num", lot->search_num);
-    lot->block_mask = JSON_ObjectGetInt(lot_obj, "block_mask", lot->block_mask);
-    lot->step = JSON_ObjectGetInt(lot_obj, "step", lot->step);
-    lot->drop = JSON_ObjectGetInt(lot_obj, "drop", lot->drop);
-    lot->fly = JSON_ObjectGetInt(lot_obj, "fly", lot->fly);
-    lot->zone_count = JSON_ObjectGetInt(lot_obj, "zone_count", lot->zone_count);
-    lot->target_box = JSON_ObjectGetInt(lot_obj, "target_box", lot->target_box);
-    lot->required_box =
-        JSON_ObjectGetInt(lot_obj, "required_box", lot->required_box);
-    lot->target.x = JSON_ObjectGetInt(lot_obj, "x", lot->target.x);
-    lot->target.y = JSON_ObjectGetInt(lot_obj, "y", lot->target.y);
-    lot->target.z = JSON_ObjectGetInt(lot_obj, "z", lot->target.z);
-    return true;
-}
-
-static bool M_LoadLara(
-    JSON_OBJECT *lara_obj, LARA_INFO *lara, uint16_t header_version)
-{
-    ASSERT(lara != nullptr);
-    if (!lara_obj) {
-        LOG_ERROR("Malformed save: invalid or missing Lara info");
-        return false;
-    }
-
-    lara->item_num = JSON_ObjectGetInt(lara_obj, "item_number", lara->item_num);
-    lara->gun_status =
-        JSON_ObjectGetInt(lara_obj, "gun_status", lara->gun_status);
-    lara->gun_type = JSON_ObjectGetInt(lara_obj, "gun_type", lara->gun_type);
-    lara->request_gun_type =
-        JSON_ObjectGetInt(lara_obj, "request_gun_type", lara->request_gun_type);
-    lara->calc_fall_speed =
-        JSON_ObjectGetInt(lara_obj, "calc_fall_speed", lara->calc_fall_speed);
-    lara->water_status =
-        JSON_ObjectGetInt(lara_obj, "water_status", lara->water_status);
-    lara->pose_count =
-        JSON_ObjectGetInt(lara_obj, "pose_count", lara->pose_count);
-    lara->hit_frame = JSON_ObjectGetInt(lara_obj, "hit_frame", lara->hit_frame);
-    lara->hit_direction =
-        JSON_ObjectGetInt(lara_obj, "hit_direction", lara->hit_direction);
-    lara->air = JSON_ObjectGetInt(lara_obj, "air", lara->air);
-    lara->dive_timer =
-        JSON_ObjectGetInt(lara_obj, "dive_count", lara->dive_timer);
-    lara->death_timer =
-        JSON_ObjectGetInt(lara_obj, "death_count", lara->death_timer);
-    lara->current_active =
-        JSON_ObjectGetInt(lara_obj, "current_active", lara->current_active);
-
-    lara->hit_effect_count =
-        JSON_ObjectGetInt(lara_obj, "hit_effect_count", lara->hit_effect_count);
-    const int32_t hit_effect = JSON_ObjectGetInt(lara_obj, "hit_effect", 0);
-    lara->hit_effect = hit_effect && g_Config.gameplay.enable_enhanced_saves
-        ? Effect_Get(hit_effect)
-        : nullptr;
-
-    lara->mesh_effects =
-        JSON_ObjectGetInt(lara_obj, "mesh_effects", lara->mesh_effects);
-
-    JSON_ARRAY *lara_meshes_arr = JSON_ObjectGetArray(lara_obj, "meshes");
-    if (!lara_meshes_arr) {
+    BSON_READER lara_meshes_arr;
+    if (field->type != BSON_TYPE_ARRAY
+        || !BSON_FieldGetReader(field, &lara_meshes_arr)) {
         LOG_ERROR("Malformed save: invalid or missing Lara meshes");
         return false;
     }
-    if ((signed)lara_meshes_arr->length != LM_NUMBER_OF) {
+    const int32_t length = BSON_ReaderCount(&lara_meshes_arr);
+    if (length != LM_NUMBER_OF) {
         LOG_ERROR(
             "Malformed save: expected %d Lara meshes, got %d", LM_NUMBER_OF,
-            lara_meshes_arr->length);
+            length);
         return false;
     }
 
-    for (int i = 0; i < (signed)lara_meshes_arr->length; i++) {
+    BSON_FIELD mesh_field;
+    for (int i = 0; BSON_ReaderNext(&lara_meshes_arr, &mesh_field); i++) {
         int32_t idx = Object_GetMeshOffset(lara->mesh_ptrs[i]);
-        idx = JSON_ArrayGetInt(lara_meshes_arr, i, idx);
+        idx = BSON_FieldGetInt(&mesh_field, idx);
         OBJECT_MESH *const mesh = Object_FindMesh(idx);
         if (mesh != nullptr) {
             lara->mesh_ptrs[i] = mesh;
         }
     }
+    return true;
+}
 
-    lara->target = nullptr;
-
-    lara->target_angles[0] =
-        JSON_ObjectGetInt(lara_obj, "target_angle1", lara->target_angles[0]);
-    lara->target_angles[1] =
-        JSON_ObjectGetInt(lara_obj, "target_angle2", lara->target_angles[1]);
-    lara->turn_rate = JSON_ObjectGetInt(lara_obj, "turn_rate", lara->turn_rate);
-    lara->move_angle =
-        JSON_ObjectGetInt(lara_obj, "move_angle", lara->move_angle);
-    lara->head_rot.y =
-        JSON_ObjectGetInt(lara_obj, "head_rot.y", lara->head_rot.y);
-    lara->head_rot.x =
-        JSON_ObjectGetInt(lara_obj, "head_rot.x", lara->head_rot.x);
-    lara->head_rot.z =
-        JSON_ObjectGetInt(lara_obj, "head_rot.z", lara->head_rot.z);
-    lara->torso_rot.y =
-        JSON_ObjectGetInt(lara_obj, "torso_rot.y", lara->torso_rot.y);
-    lara->torso_rot.x =
-        JSON_ObjectGetInt(lara_obj, "torso_rot.x", lara->torso_rot.x);
-    lara->torso_rot.z =
-        JSON_ObjectGetInt(lara_obj, "torso_rot.z", lara->torso_rot.z);
-
-    if (!M_LoadArm(
-            JSON_ObjectGetObject(lara_obj, "left_arm"), &lara->left_arm)) {
+static bool M_LoadLara(BSON_READER *lara_obj, LARA_INFO *lara)
+{
+    ASSERT(lara != nullptr);
+    if (!lara_obj) {
+        LOG_ERROR("Malformed save: invalid or missing Lara info");
         return false;
     }
 
-    if (!M_LoadArm(
-            JSON_ObjectGetObject(lara_obj, "right_arm"), &lara->right_arm)) {
-        return false;
-    }
+    int32_t hit_effect = 0;
+    bool has_meshes = false;
+    uint32_t section_mask = 0;
+    int32_t hint = 0;
+    BSON_FIELD field;
+    while (BSON_ReaderNext(lara_obj, &field)) {
+        if (BSON_DecodeField(
+                &field, m_LaraFields, m_LaraFieldCount, lara, &hint)) {
+            continue;
+        }
 
-    if (!M_LoadAmmo(
-            JSON_ObjectGetObject(lara_obj, "pistols"), &lara->pistols)) {
-        return false;
-    }
+        if (strcmp(field.key, "hit_effect") == 0) {
+            hit_effect = BSON_FieldGetInt(&field, 0);
+            continue;
+        }
 
-    if (!M_LoadAmmo(
-            JSON_ObjectGetObject(lara_obj, "magnums"), &lara->magnums)) {
-        return false;
-    }
+        if (strcmp(field.key, "meshes") == 0) {
+            if (!M_LoadLaraMeshes(&field, lara)) {
+                return false;
+            }
+            has_meshes = true;
+            continue;
+        }
 
-    if (!M_LoadAmmo(JSON_ObjectGetObject(lara_obj, "uzis"), &lara->uzis)) {
-        return false;
+        for (int32_t i = 0; i < m_LaraSectionCount; i++) {
+            const SAVEGAME_BSON_SECTION *const section = &m_LaraSections[i];
+            BSON_READER section_obj;
+            if (strcmp(field.key, section->key) != 0
+                || field.type != BSON_TYPE_OBJECT
+                || !BSON_FieldGetReader(&field, &section_obj)) {
+                continue;
+            }
+            BSON_ReaderDecode(
+                &section_obj, section->fields, section->field_count,
+                (char *)lara + section->offset);
+            section_mask |= 1 << i;
+            break;
+        }
     }
 
-    if (!M_LoadAmmo(
-            JSON_ObjectGetObject(lara_obj, "shotgun"), &lara->shotgun)) {
+    if (!has_meshes) {
+        LOG_ERROR("Malformed save: invalid or missing Lara meshes");
         return false;
     }
 
-    if (!M_LoadLOT(JSON_ObjectGetObject(lara_obj, "lot"), &lara->lot)) {
-        return false;
+    for (int32_t i = 0; i < m_LaraSectionCount; i++) {
+        if (!(section_mask & (1 << i))) {
+            LOG_ERROR(
+                "Malformed save: invalid or missing %s info",
+                m_LaraSections[i].key);
+            return false;
+        }
     }
 
-    if (header_version >= VERSION_6) {
-        lara->interact_target.item_num = JSON_ObjectGetInt(
-            lara_obj, "interact_target.item_num",
-            lara->interact_target.item_num);
-        lara->interact_target.move_count = JSON_ObjectGetInt(
-            lara_obj, "interact_target.move_count",
-            lara->interact_target.move_count);
-        lara->interact_target.is_moving = JSON_ObjectGetBool(
-            lara_obj, "interact_target.is_moving",
-            lara->interact_target.is_moving);
-    }
+    lara->hit_effect = hit_effect && g_Config.gameplay.enable_enhanced_saves
+        ? Effect_Get(hit_effect)
+        : nullptr;
+    lara->target = nullptr;
 
     return true;
 }
 
-static bool M_LoadCurrentMusic(JSON_OBJECT *music_obj)
+static bool M_LoadCurrentMusic(BSON_READER *music_obj)
 {
     if (g_Config.audio.music_load_condition == MUSIC_LOAD_NEVER) {
         return true;
@@ -884,11 +1317,11 @@ static bool M_LoadCurrentMusic(JSON_OBJECT *music_obj)
         return true;
     }
 
-    int16_t current_track = JSON_ObjectGetInt(music_obj, "current_track", -1);
-    double timestamp = JSON_ObjectGetDouble(music_obj, "timestamp", -1.0);
+    int16_t current_track = BSON_ReaderGetInt(music_obj, "current_track", -1);
+    double timestamp = BSON_ReaderGetDouble(music_obj, "timestamp", -1.0);
     if (current_track != MX_INACTIVE) {
         const bool is_ambient =
-            JSON_ObjectGetBool(music_obj, "is_ambient", false);
+            BSON_ReaderGetBool(music_obj, "is_ambient", false);
         if (is_ambient) {
             if (g_Config.audio.music_load_condition == MUSIC_LOAD_NON_AMBIENT) {
                 return true;
@@ -907,7 +1340,7 @@ static bool M_LoadCurrentMusic(JSON_OBJECT *music_obj)
     return true;
 }
 
-static bool M_LoadMusicTrackFlags(JSON_ARRAY *music_track_arr)
+static bool M_LoadMusicTrackFlags(BSON_READER *music_track_arr)
 {
     if (!g_Config.audio.load_music_triggers) {
         return true;
@@ -918,373 +1351,371 @@ static bool M_LoadMusicTrackFlags(JSON_ARRAY *music_track_arr)
         return true;
     }
 
-    if ((signed)music_track_arr->length != MAX_MUSIC_TRACKS) {
+    const int32_t length = BSON_ReaderCount(music_track_arr);
+    if (length != MAX_MUSIC_TRACKS) {
         LOG_WARNING(
             "Malformed save: expected %d music track flags, got %d",
-            MAX_MUSIC_TRACKS, music_track_arr->length);
+            MAX_MUSIC_TRACKS, length);
         return true;
     }
 
-    for (int32_t i = 0; i < (signed)music_track_arr->length; i++) {
-        Music_SetTrackFlags(i, JSON_ArrayGetInt(music_track_arr, i, 0));
+    BSON_FIELD field;
+    for (int32_t i = 0; BSON_ReaderNext(music_track_arr, &field); i++) {
+        Music_SetTrackFlags(i, BSON_FieldGetInt(&field, 0));
     }
 
     return true;
 }
 
-static JSON_ARRAY *M_DumpResumeInfo(RESUME_INFO *resume_info)
+static void M_DumpResumeInfo(
+    BSON_WRITER *const writer, const char *const key,
+    RESUME_INFO *const resume_info)
 {
-    JSON_ARRAY *resume_arr = JSON_ArrayNew();
     ASSERT(resume_info != nullptr);
+    BSON_WriterBeginArray(writer, key);
     for (int i = 0; i < GF_GetLevelTable(GFLT_MAIN)->count; i++) {
         RESUME_INFO *resume = &resume_info[i];
-        JSON_OBJECT *resume_obj = JSON_ObjectNew();
-        JSON_ObjectAppendInt(
-            resume_obj, "lara_hitpoints", resume->lara_hitpoints);
-        JSON_ObjectAppendInt(resume_obj, "pistol_ammo", resume->pistol_ammo);
-        JSON_ObjectAppendInt(resume_obj, "magnum_ammo", resume->magnum_ammo);
-        JSON_ObjectAppendInt(resume_obj, "uzi_ammo", resume->uzi_ammo);
-        JSON_ObjectAppendInt(resume_obj, "shotgun_ammo", resume->shotgun_ammo);
-        JSON_ObjectAppendInt(resume_obj, "num_medis", resume->num_medis);
-        JSON_ObjectAppendInt(
-            resume_obj, "num_big_medis", resume->num_big_medis);
-        JSON_ObjectAppendInt(resume_obj, "num_scions", resume->num_scions);
-        JSON_ObjectAppendInt(resume_obj, "gun_status", resume->gun_status);
-        JSON_ObjectAppendInt(resume_obj, "gun_type", resume->equipped_gun_type);
-        JSON_ObjectAppendInt(
-            resume_obj, "holsters_gun_type", resume->holsters_gun_type);
-        JSON_ObjectAppendInt(
-            resume_obj, "back_gun_type", resume->back_gun_type);
-        JSON_ObjectAppendBool(resume_obj, "available", resume->flags.available);
-        JSON_ObjectAppendBool(
-            resume_obj, "got_pistols", resume->flags.got_pistols);
-        JSON_ObjectAppendBool(
-            resume_obj, "got_magnums", resume->flags.got_magnums);
-        JSON_ObjectAppendBool(resume_obj, "got_uzis", resume->flags.got_uzis);
-        JSON_ObjectAppendBool(
-            resume_obj, "got_shotgun", resume->flags.got_shotgun);
-        JSON_ObjectAppendBool(resume_obj, "costume", resume->flags.costume);
-        JSON_ObjectAppendInt(resume_obj, "timer", resume->stats.timer);
-        JSON_ObjectAppendInt(resume_obj, "kills", resume->stats.kill_count);
-        JSON_ObjectAppendInt(resume_obj, "secrets", resume->stats.secret_flags);
-        JSON_ObjectAppendInt(resume_obj, "pickups", resume->stats.pickup_count);
-        JSON_ObjectAppendInt(
-            resume_obj, "max_kills", resume->stats.max_kill_count);
-        JSON_ObjectAppendInt(
-            resume_obj, "max_secrets", resume->stats.max_secret_count);
-        JSON_ObjectAppendInt(
-            resume_obj, "max_pickups", resume->stats.max_pickup_count);
-        JSON_ArrayAppendObject(resume_arr, resume_obj);
-    }
-    return resume_arr;
+        BSON_WriterBeginObject(writer, nullptr);
+        BSON_WriterAppendInt(writer, "lara_hitpoints", resume->lara_hitpoints);
+        BSON_WriterAppendInt(writer, "pistol_ammo", resume->pistol_ammo);
+        BSON_WriterAppendInt(writer, "magnum_ammo", resume->magnum_ammo);
+        BSON_WriterAppendInt(writer, "uzi_ammo", resume->uzi_ammo);
+        BSON_WriterAppendInt(writer, "shotgun_ammo", resume->shotgun_ammo);
+        BSON_WriterAppendInt(writer, "num_medis", resume->num_medis);
+        BSON_WriterAppendInt(writer, "num_big_medis", resume->num_big_medis);
+        BSON_WriterAppendInt(writer, "num_scions", resume->num_scions);
+        BSON_WriterAppendInt(writer, "gun_status", resume->gun_status);
+        BSON_WriterAppendInt(writer, "gun_type", resume->equipped_gun_type);
+        BSON_WriterAppendInt(
+            writer, "holsters_gun_type", resume->holsters_gun_type);
+        BSON_WriterAppendInt(writer, "back_gun_type", resume->back_gun_type);
+        BSON_WriterAppendBool(writer, "available", resume->flags.available);
+        BSON_WriterAppendBool(writer, "got_pistols", resume->flags.got_pistols);
+        BSON_WriterAppendBool(writer, "got_magnums", resume->flags.got_magnums);
+        BSON_WriterAppendBool(writer, "got_uzis", resume->flags.got_uzis);
+        BSON_WriterAppendBool(writer, "got_shotgun", resume->flags.got_shotgun);
+        BSON_WriterAppendBool(writer, "costume", resume->flags.costume);
+        BSON_WriterAppendInt(writer, "timer", resume->stats.timer);
+        BSON_WriterAppendInt(writer, "kills", resume->stats.kill_count);
+        BSON_WriterAppendInt(writer, "secrets", resume->stats.secret_flags);
+        BSON_WriterAppendInt(writer, "pickups", resume->stats.pickup_count);
+        BSON_WriterAppendInt(writer, "max_kills", resume->stats.max_kill_count);
+        BSON_WriterAppendInt(
+            writer, "max_secrets", resume->stats.max_secret_count);
+        BSON_WriterAppendInt(
+            writer, "max_pickups", resume->stats.max_pickup_count);
+        BSON_WriterEnd(writer);
+    }
+    BSON_WriterEnd(writer);
 }
 
-static JSON_OBJECT *M_DumpMisc(GAME_INFO *game_info)
+static void M_DumpMisc(
+    BSON_WRITER *const writer, const char *const key,
+    GAME_INFO *const game_info)
 {
     ASSERT(game_info != nullptr);
-    JSON_OBJECT *misc_obj = JSON_ObjectNew();
-    JSON_ObjectAppendInt(misc_obj, "bonus_flag", game_info->bonus_flag);
-    JSON_ObjectAppendBool(
-        misc_obj, "bonus_level_unlock", game_info->bonus_level_unlock);
-    JSON_ObjectAppendInt(misc_obj, "death_count", game_info->death_count);
-    return misc_obj;
+    BSON_WriterBeginObject(writer, key);
+    BSON_WriterAppendInt(writer, "bonus_flag", game_info->bonus_flag);
+    BSON_WriterAppendBool(
+        writer, "bonus_level_unlock", game_info->bonus_level_unlock);
+    BSON_WriterAppendInt(writer, "death_count", game_info->death_count);
+    BSON_WriterEnd(writer);
 }
 
-static JSON_OBJECT *M_DumpInventory(void)
+static void M_DumpInventory(BSON_WRITER *const writer, const char *const key)
 {
-    JSON_OBJECT *inv_obj = JSON_ObjectNew();
-    JSON_ObjectAppendInt(inv_obj, "pickup1", Inv_RequestItem(O_PICKUP_ITEM_1));
-    JSON_ObjectAppendInt(inv_obj, "pickup2", Inv_RequestItem(O_PICKUP_ITEM_2));
-    JSON_ObjectAppendInt(inv_obj, "puzzle1", Inv_RequestItem(O_PUZZLE_ITEM_1));
-    JSON_ObjectAppendInt(inv_obj, "puzzle2", Inv_RequestItem(O_PUZZLE_ITEM_2));
-    JSON_ObjectAppendInt(inv_obj, "puzzle3", Inv_RequestItem(O_PUZZLE_ITEM_3));
-    JSON_ObjectAppendInt(inv_obj, "puzzle4", Inv_RequestItem(O_PUZZLE_ITEM_4));
-    JSON_ObjectAppendInt(inv_obj, "key1", Inv_RequestItem(O_KEY_ITEM_1));
-    JSON_ObjectAppendInt(inv_obj, "key2", Inv_RequestItem(O_KEY_ITEM_2));
-    JSON_ObjectAppendInt(inv_obj, "key3", Inv_RequestItem(O_KEY_ITEM_3));
-    JSON_ObjectAppendInt(inv_obj, "key4", Inv_RequestItem(O_KEY_ITEM_4));
-    JSON_ObjectAppendInt(inv_obj, "leadbar", Inv_RequestItem(O_LEADBAR_ITEM));
-    return inv_obj;
+    BSON_WriterBeginObject(writer, key);
+    BSON_WriterAppendInt(writer, "pickup1", Inv_RequestItem(O_PICKUP_ITEM_1));
+    BSON_WriterAppendInt(writer, "pickup2", Inv_RequestItem(O_PICKUP_ITEM_2));
+    BSON_WriterAppendInt(writer, "puzzle1", Inv_RequestItem(O_PUZZLE_ITEM_1));
+    BSON_WriterAppendInt(writer, "puzzle2", Inv_RequestItem(O_PUZZLE_ITEM_2));
+    BSON_WriterAppendInt(writer, "puzzle3", Inv_RequestItem(O_PUZZLE_ITEM_3));
+    BSON_WriterAppendInt(writer, "puzzle4", Inv_RequestItem(O_PUZZLE_ITEM_4));
+    BSON_WriterAppendInt(writer, "key1", Inv_RequestItem(O_KEY_ITEM_1));
+    BSON_WriterAppendInt(writer, "key2", Inv_RequestItem(O_KEY_ITEM_2));
+    BSON_WriterAppendInt(writer, "key3", Inv_RequestItem(O_KEY_ITEM_3));
+    BSON_WriterAppendInt(writer, "key4", Inv_RequestItem(O_KEY_ITEM_4));
+    BSON_WriterAppendInt(writer, "leadbar", Inv_RequestItem(O_LEADBAR_ITEM));
+    BSON_WriterEnd(writer);
 }
 
-static JSON_OBJECT *M_DumpFlipmaps(void)
+static void M_DumpFlipmaps(BSON_WRITER *const writer, const char *const key)
 {
-    JSON_OBJECT *flipmap_obj = JSON_ObjectNew();
-    JSON_ObjectAppendBool(flipmap_obj, "status", Room_GetFlipStatus());
-    JSON_ObjectAppendInt(flipmap_obj, "effect", Room_GetFlipEffect());
-    JSON_ObjectAppendInt(flipmap_obj, "timer", Room_GetFlipTimer());
-    JSON_ARRAY *flipmap_arr = JSON_ArrayNew();
+    BSON_WriterBeginObject(writer, key);
+    BSON_WriterAppendBool(writer, "status", Room_GetFlipStatus());
+    BSON_WriterAppendInt(writer, "effect", Room_GetFlipEffect());
+    BSON_WriterAppendInt(writer, "timer", Room_GetFlipTimer());
+    BSON_WriterBeginArray(writer, "table");
     for (int32_t i = 0; i < MAX_FLIP_MAPS; i++) {
-        JSON_ArrayAppendInt(flipmap_arr, Room_GetFlipSlotFlags(i) >> 8);
+        BSON_WriterAppendInt(writer, nullptr, Room_GetFlipSlotFlags(i) >> 8);
     }
-    JSON_ObjectAppendArray(flipmap_obj, "table", flipmap_arr);
-    return flipmap_obj;
+    BSON_WriterEnd(writer);
+    BSON_WriterEnd(writer);
 }
 
-static JSON_ARRAY *M_DumpCameras(void)
+static void M_DumpCameras(BSON_WRITER *const writer, const char *const key)
 {
-    JSON_ARRAY *cameras_arr = JSON_ArrayNew();
+    BSON_WriterBeginArray(writer, key);
     for (int32_t i = 0; i < Camera_GetFixedObjectCount(); i++) {
         const OBJECT_VECTOR *const object = Camera_GetFixedObject(i);
-        JSON_ArrayAppendInt(cameras_arr, object->flags);
+        BSON_WriterAppendInt(writer, nullptr, object->flags);
     }
-    return cameras_arr;
+    BSON_WriterEnd(writer);
 }
 
-static JSON_ARRAY *M_DumpItems(void)
+static void M_DumpItems(BSON_WRITER *const writer, const char *const key)
 {
     Savegame_ProcessItemsBeforeSave();
 
     SAVEGAME_BSON_FX_ORDER fx_order;
     M_GetFXOrder(&fx_order);
 
-    JSON_ARRAY *items_arr = JSON_ArrayNew();
+    BSON_WriterBeginArray(writer, key);
     for (int32_t i = 0; i < Item_GetLevelCount(); i++) {
-        JSON_OBJECT *item_obj = JSON_ObjectNew();
+        BSON_WriterBeginObject(writer, nullptr);
         const ITEM *const item = Item_Get(i);
         const OBJECT *const obj = Object_Get(item->object_id);
 
-        JSON_ObjectAppendInt(item_obj, "obj_num", item->object_id);
+        BSON_WriterAppendInt(writer, "obj_num", item->object_id);
 
         if (obj->save_position) {
-            JSON_ObjectAppendInt(item_obj, "x", item->pos.x);
-            JSON_ObjectAppendInt(item_obj, "y", item->pos.y);
-            JSON_ObjectAppendInt(item_obj, "z", item->pos.z);
-            JSON_ObjectAppendInt(item_obj, "x_rot", item->rot.x);
-            JSON_ObjectAppendInt(item_obj, "y_rot", item->rot.y);
-            JSON_ObjectAppendInt(item_obj, "z_rot", item->rot.z);
-            JSON_ObjectAppendInt(item_obj, "room_num", item->room_num);
-            JSON_ObjectAppendInt(item_obj, "speed", item->speed);
-            JSON_ObjectAppendInt(item_obj, "fall_speed", item->fall_speed);
+            BSON_WriterAppendInt(writer, "x", item->pos.x);
+            BSON_WriterAppendInt(writer, "y", item->pos.y);
+            BSON_WriterAppendInt(writer, "z", item->pos.z);
+            BSON_WriterAppendInt(writer, "x_rot", item->rot.x);
+            BSON_WriterAppendInt(writer, "y_rot", item->rot.y);
+            BSON_WriterAppendInt(writer, "z_rot", item->rot.z);
+            BSON_WriterAppendInt(writer, "room_num", item->room_num);
+            BSON_WriterAppendInt(writer, "speed", item->speed);
+            BSON_WriterAppendInt(writer, "fall_speed", item->fall_speed);
         }
 
         if (obj->save_anim) {
-            JSON_ObjectAppendInt(
-                item_obj, "current_anim", item->current_anim_state);
-            JSON_ObjectAppendInt(item_obj, "goal_anim", item->goal_anim_state);
-            JSON_ObjectAppendInt(
-                item_obj, "required_anim", item->required_anim_state);
-            JSON_ObjectAppendInt(item_obj, "anim_num", item->anim_num);
-            JSON_ObjectAppendInt(item_obj, "frame_num", item->frame_num);
+            BSON_WriterAppendInt(
+                writer, "current_anim", item->current_anim_state);
+            BSON_WriterAppendInt(writer, "goal_anim", item->goal_anim_state);
+            BSON_WriterAppendInt(
+                writer, "required_anim", item->required_anim_state);
+            BSON_WriterAppendInt(writer, "anim_num", item->anim_num);
+            BSON_WriterAppendInt(writer, "frame_num", item->frame_num);
         }
 
         if (obj->save_hitpoints) {
-            JSON_ObjectAppendInt(item_obj, "hitpoints", item->hit_points);
+            BSON_WriterAppendInt(writer, "hitpoints", item->hit_points);
         }
 
         if (obj->save_flags) {
-            JSON_ObjectAppendInt(item_obj, "flags", item->flags);
-            JSON_ObjectAppendInt(item_obj, "status", item->status);
-            JSON_ObjectAppendBool(item_obj, "active", item->active);
-            JSON_ObjectAppendBool(item_obj, "gravity", item->gravity);
-            JSON_ObjectAppendBool(item_obj, "collidable", item->collidable);
-            JSON_ObjectAppendBool(
-                item_obj, "intelligent", obj->intelligent && item->data);
-            JSON_ObjectAppendInt(item_obj, "timer", item->timer);
+            BSON_WriterAppendInt(writer, "flags", item->flags);
+            BSON_WriterAppendInt(writer, "status", item->status);
+            BSON_WriterAppendBool(writer, "active", item->active);
+            BSON_WriterAppendBool(writer, "gravity", item->gravity);
+            BSON_WriterAppendBool(writer, "collidable", item->collidable);
+            BSON_WriterAppendBool(
+                writer, "intelligent", obj->intelligent && item->data);
+            BSON_WriterAppendInt(writer, "timer", item->timer);
             if (obj->intelligent && item->data) {
                 CREATURE *creature = item->data;
-                JSON_ObjectAppendInt(
-                    item_obj, "head_rot", creature->head_rotation);
-                JSON_ObjectAppendInt(
-                    item_obj, "neck_rot", creature->neck_rotation);
-                JSON_ObjectAppendInt(
-                    item_obj, "max_turn", creature->maximum_turn);
-                JSON_ObjectAppendInt(
-                    item_obj, "creature_flags", creature->flags);
-                JSON_ObjectAppendInt(item_obj, "creature_mood", creature->mood);
+                BSON_WriterAppendInt(
+                    writer, "head_rot", creature->head_rotation);
+                BSON_WriterAppendInt(
+                    writer, "neck_rot", creature->neck_rotation);
+                BSON_WriterAppendInt(
+                    writer, "max_turn", creature->maximum_turn);
+                BSON_WriterAppendInt(writer, "creature_flags", creature->flags);
+                BSON_WriterAppendInt(writer, "creature_mood", creature->mood);
             }
 
             if (item->object_id == O_FLAME_EMITTER && item->data) {
                 int32_t effect_num = (int32_t)(intptr_t)item->data - 1;
                 effect_num = fx_order.id_map[effect_num];
-                JSON_ObjectAppendInt(item_obj, "fx_num", effect_num);
+                BSON_WriterAppendInt(writer, "fx_num", effect_num);
             }
 
             if (item->object_id == O_BACON_LARA && item->data) {
                 const int32_t status = (int32_t)(intptr_t)item->data;
-                JSON_ObjectAppendInt(item_obj, "bl_status", status);
+                BSON_WriterAppendInt(writer, "bl_status", status);
             }
         }
 
-        JSON_ARRAY *carried_items_arr = JSON_ArrayNew();
+        BSON_WriterBeginArray(writer, "carried_items");
 
         const CARRIED_ITEM *drop_item = item->carried_item;
         while (drop_item) {
-            JSON_OBJECT *drop_obj = JSON_ObjectNew();
-            JSON_ObjectAppendInt(drop_obj, "object_id", drop_item->object_id);
-            JSON_ObjectAppendInt(drop_obj, "x", drop_item->pos.x);
-            JSON_ObjectAppendInt(drop_obj, "y", drop_item->pos.y);
-            JSON_ObjectAppendInt(drop_obj, "z", drop_item->pos.z);
-            JSON_ObjectAppendInt(drop_obj, "y_rot", drop_item->rot.y);
-            JSON_ObjectAppendInt(drop_obj, "room_num", drop_item->room_num);
-            JSON_ObjectAppendInt(drop_obj, "fall_speed", drop_item->fall_speed);
+            BSON_WriterBeginObject(writer, nullptr);
+            BSON_WriterAppendInt(writer, "object_id", drop_item->object_id);
+            BSON_WriterAppendInt(writer, "x", drop_item->pos.x);
+            BSON_WriterAppendInt(writer, "y", drop_item->pos.y);
+            BSON_WriterAppendInt(writer, "z", drop_item->pos.z);
+            BSON_WriterAppendInt(writer, "y_rot", drop_item->rot.y);
+            BSON_WriterAppendInt(writer, "room_num", drop_item->room_num);
+            BSON_WriterAppendInt(writer, "fall_speed", drop_item->fall_speed);
 
             DROP_STATUS status = Carrier_GetSaveStatus(drop_item);
-            JSON_ObjectAppendInt(drop_obj, "status", status);
+            BSON_WriterAppendInt(writer, "status", status);
 
-            JSON_ArrayAppendObject(carried_items_arr, drop_obj);
+            BSON_WriterEnd(writer);
             drop_item = drop_item->next_item;
         }
 
-        JSON_ObjectAppendArray(item_obj, "carried_items", carried_items_arr);
+        BSON_WriterEnd(writer);
 
-        JSON_ArrayAppendObject(items_arr, item_obj);
+        BSON_WriterEnd(writer);
     }
-    return items_arr;
+    BSON_WriterEnd(writer);
 }
 
-static JSON_ARRAY *M_DumpEffects(void)
+static void M_DumpEffects(BSON_WRITER *const writer, const char *const key)
 {
-    JSON_ARRAY *fx_arr = JSON_ArrayNew();
-
-    SAVEGAME_BSON_FX_ORDER fx_order;
-    M_GetFXOrder(&fx_order);
+    BSON_WriterBeginArray(writer, key);
 
     for (int16_t link_num = Effect_GetActiveNum(); link_num != NO_ITEM;
          link_num = Effect_Get(link_num)->next_active) {
-        JSON_OBJECT *fx_obj = JSON_ObjectNew();
+        BSON_WriterBeginObject(writer, nullptr);
         EFFECT *effect = Effect_Get(link_num);
-        JSON_ObjectAppendInt(fx_obj, "x", effect->pos.x);
-        JSON_ObjectAppendInt(fx_obj, "y", effect->pos.y);
-        JSON_ObjectAppendInt(fx_obj, "z", effect->pos.z);
-        JSON_ObjectAppendInt(fx_obj, "room_number", effect->room_num);
-        JSON_ObjectAppendInt(fx_obj, "object_number", effect->object_id);
-        JSON_ObjectAppendInt(fx_obj, "speed", effect->speed);
-        JSON_ObjectAppendInt(fx_obj, "fall_speed", effect->fall_speed);
-        JSON_ObjectAppendInt(fx_obj, "frame_number", effect->frame_num);
-        JSON_ObjectAppendInt(fx_obj, "counter", effect->counter);
-        JSON_ObjectAppendInt(fx_obj, "shade", effect->shade);
-        JSON_ArrayAppendObject(fx_arr, fx_obj);
-    }
-
-    return fx_arr;
+        BSON_WriterAppendInt(writer, "x", effect->pos.x);
+        BSON_WriterAppendInt(writer, "y", effect->pos.y);
+        BSON_WriterAppendInt(writer, "z", effect->pos.z);
+        BSON_WriterAppendInt(writer, "room_number", effect->room_num);
+        BSON_WriterAppendInt(writer, "object_number", effect->object_id);
+        BSON_WriterAppendInt(writer, "speed", effect->speed);
+        BSON_WriterAppendInt(writer, "fall_speed", effect->fall_speed);
+        BSON_WriterAppendInt(writer, "frame_number", effect->frame_num);
+        BSON_WriterAppendInt(writer, "counter", effect->counter);
+        BSON_WriterAppendInt(writer, "shade", effect->shade);
+        BSON_WriterEnd(writer);
+    }
+
+    BSON_WriterEnd(writer);
 }
 
-static JSON_OBJECT *M_DumpArm(LARA_ARM *arm)
+static void M_DumpArm(
+    BSON_WRITER *const writer, const char *const key, LARA_ARM *const arm)
 {
     ASSERT(arm != nullptr);
-    JSON_OBJECT *arm_obj = JSON_ObjectNew();
-    JSON_ObjectAppendInt(arm_obj, "frame_num", arm->frame_num);
-    JSON_ObjectAppendInt(arm_obj, "lock", arm->lock);
-    JSON_ObjectAppendInt(arm_obj, "x_rot", arm->rot.x);
-    JSON_ObjectAppendInt(arm_obj, "y_rot", arm->rot.y);
-    JSON_ObjectAppendInt(arm_obj, "z_rot", arm->rot.z);
-    JSON_ObjectAppendInt(arm_obj, "flash_gun", arm->flash_gun);
-    return arm_obj;
+    BSON_WriterBeginObject(writer, key);
+    BSON_WriterAppendInt(writer, "frame_num", arm->frame_num);
+    BSON_WriterAppendInt(writer, "lock", arm->lock);
+    BSON_WriterAppendInt(writer, "x_rot", arm->rot.x);
+    BSON_WriterAppendInt(writer, "y_rot", arm->rot.y);
+    BSON_WriterAppendInt(writer, "z_rot", arm->rot.z);
+    BSON_WriterAppendInt(writer, "flash_gun", arm->flash_gun);
+    BSON_WriterEnd(writer);
 }
 
-static JSON_OBJECT *M_DumpAmmo(AMMO_INFO *ammo)
+static void M_DumpAmmo(
+    BSON_WRITER *const writer, const char *const key, AMMO_INFO *const ammo)
 {
     ASSERT(ammo != nullptr);
-    JSON_OBJECT *ammo_obj = JSON_ObjectNew();
-    JSON_ObjectAppendInt(ammo_obj, "ammo", ammo->ammo);
-    JSON_ObjectAppendInt(ammo_obj, "hit", ammo->hit);
-    JSON_ObjectAppendInt(ammo_obj, "miss", ammo->miss);
-    return ammo_obj;
+    BSON_WriterBeginObject(writer, key);
+    BSON_WriterAppendInt(writer, "ammo", ammo->ammo);
+    BSON_WriterAppendInt(writer, "hit", ammo->hit);
+    BSON_WriterAppendInt(writer, "miss", ammo->miss);
+    BSON_WriterEnd(writer);
 }
 
-static JSON_OBJECT *M_DumpLOT(LOT_INFO *lot)
+static void M_DumpLOT(
+    BSON_WRITER *const writer, const char *const key, LOT_INFO *const lot)
 {
     ASSERT(lot != nullptr);
-    JSON_OBJECT *lot_obj = JSON_ObjectNew();
-    // JSON_ObjectAppendInt(lot_obj, "node", lot->node);
-    JSON_ObjectAppendInt(lot_obj, "head", lot->head);
-    JSON_ObjectAppendInt(lot_obj, "tail", lot->tail);
-    JSON_ObjectAppendInt(lot_obj, "search_num", lot->search_num);
-    JSON_ObjectAppendInt(lot_obj, "block_mask", lot->block_mask);
-    JSON_ObjectAppendInt(lot_obj, "step", lot->step);
-    JSON_ObjectAppendInt(lot_obj, "drop", lot->drop);
-    JSON_ObjectAppendInt(lot_obj, "fly", lot->fly);
-    JSON_ObjectAppendInt(lot_obj, "zone_count", lot->zone_count);
-    JSON_ObjectAppendInt(lot_obj, "target_box", lot->target_box);
-    JSON_ObjectAppendInt(lot_obj, "required_box", lot->required_box);
-    JSON_ObjectAppendInt(lot_obj, "x", lot->target.x);
-    JSON_ObjectAppendInt(lot_obj, "y", lot->target.y);
-    JSON_ObjectAppendInt(lot_obj, "z", lot->target.z);
-    return lot_obj;
+    BSON_WriterBeginObject(writer, key);
+    // BSON_WriterAppendInt(writer, "node", lot->node);
+    BSON_WriterAppendInt(writer, "head", lot->head);
+    BSON_WriterAppendInt(writer, "tail", lot->tail);
+    BSON_WriterAppendInt(writer, "search_num", lot->search_num);
+    BSON_WriterAppendInt(writer, "block_mask", lot->block_mask);
+    BSON_WriterAppendInt(writer, "step", lot->step);
+    BSON_WriterAppendInt(writer, "drop", lot->drop);
+    BSON_WriterAppendInt(writer, "fly", lot->fly);
+    BSON_WriterAppendInt(writer, "zone_count", lot->zone_count);
+    BSON_WriterAppendInt(writer, "target_box", lot->target_box);
+    BSON_WriterAppendInt(writer, "required_box", lot->required_box);
+    BSON_WriterAppendInt(writer, "x", lot->target.x);
+    BSON_WriterAppendInt(writer, "y", lot->target.y);
+    BSON_WriterAppendInt(writer, "z", lot->target.z);
+    BSON_WriterEnd(writer);
 }
 
-static JSON_OBJECT *M_DumpLara(LARA_INFO *lara)
+static void M_DumpLara(
+    BSON_WRITER *const writer, const char *const key, LARA_INFO *const lara)
 {
     ASSERT(lara != nullptr);
-    JSON_OBJECT *lara_obj = JSON_ObjectNew();
-    JSON_ObjectAppendInt(lara_obj, "item_number", lara->item_num);
-    JSON_ObjectAppendInt(lara_obj, "gun_status", lara->gun_status);
-    JSON_ObjectAppendInt(lara_obj, "gun_type", lara->gun_type);
-    JSON_ObjectAppendInt(lara_obj, "request_gun_type", lara->request_gun_type);
-    JSON_ObjectAppendInt(lara_obj, "calc_fall_speed", lara->calc_fall_speed);
-    JSON_ObjectAppendInt(lara_obj, "water_status", lara->water_status);
-    JSON_ObjectAppendInt(lara_obj, "pose_count", lara->pose_count);
-    JSON_ObjectAppendInt(lara_obj, "hit_frame", lara->hit_frame);
-    JSON_ObjectAppendInt(lara_obj, "hit_direction", lara->hit_direction);
-    JSON_ObjectAppendInt(lara_obj, "air", lara->air);
-    JSON_ObjectAppendInt(lara_obj, "dive_count", lara->dive_timer);
-    JSON_ObjectAppendInt(lara_obj, "death_count", lara->death_timer);
-    JSON_ObjectAppendInt(lara_obj, "current_active", lara->current_active);
-
-    JSON_ObjectAppendInt(lara_obj, "hit_effect_count", lara->hit_effect_count);
-    JSON_ObjectAppendInt(
-        lara_obj, "hit_effect",
+    BSON_WriterBeginObject(writer, key);
+    BSON_WriterAppendInt(writer, "item_number", lara->item_num);
+    BSON_WriterAppendInt(writer, "gun_status", lara->gun_status);
+    BSON_WriterAppendInt(writer, "gun_type", lara->gun_type);
+    BSON_WriterAppendInt(writer, "request_gun_type", lara->request_gun_type);
+    BSON_WriterAppendInt(writer, "calc_fall_speed", lara->calc_fall_speed);
+    BSON_WriterAppendInt(writer, "water_status", lara->water_status);
+    BSON_WriterAppendInt(writer, "pose_count", lara->pose_count);
+    BSON_WriterAppendInt(writer, "hit_frame", lara->hit_frame);
+    BSON_WriterAppendInt(writer, "hit_direction", lara->hit_direction);
+    BSON_WriterAppendInt(writer, "air", lara->air);
+    BSON_WriterAppendInt(writer, "dive_count", lara->dive_timer);
+    BSON_WriterAppendInt(writer, "death_count", lara->death_timer);
+    BSON_WriterAppendInt(writer, "current_active", lara->current_active);
+
+    BSON_WriterAppendInt(writer, "hit_effect_count", lara->hit_effect_count);
+    BSON_WriterAppendInt(
+        writer, "hit_effect",
         lara->hit_effect ? Effect_GetNum(lara->hit_effect) : 0);
 
-    JSON_ObjectAppendInt(lara_obj, "mesh_effects", lara->mesh_effects);
-    JSON_ARRAY *lara_meshes_arr = JSON_ArrayNew();
+    BSON_WriterAppendInt(writer, "mesh_effects", lara->mesh_effects);
+    BSON_WriterBeginArray(writer, "meshes");
     for (int i = 0; i < LM_NUMBER_OF; i++) {
-        JSON_ArrayAppendInt(
-            lara_meshes_arr, Object_GetMeshOffset(lara->mesh_ptrs[i]));
-    }
-    JSON_ObjectAppendArray(lara_obj, "meshes", lara_meshes_arr);
-
-    JSON_ObjectAppendInt(lara_obj, "target_angle1", lara->target_angles[0]);
-    JSON_ObjectAppendInt(lara_obj, "target_angle2", lara->target_angles[1]);
-    JSON_ObjectAppendInt(lara_obj, "turn_rate", lara->turn_rate);
-    JSON_ObjectAppendInt(lara_obj, "move_angle", lara->move_angle);
-    JSON_ObjectAppendInt(lara_obj, "head_rot.y", lara->head_rot.y);
-    JSON_ObjectAppendInt(lara_obj, "head_rot.x", lara->head_rot.x);
-    JSON_ObjectAppendInt(lara_obj, "head_rot.z", lara->head_rot.z);
-    JSON_ObjectAppendInt(lara_obj, "torso_rot.y", lara->torso_rot.y);
-    JSON_ObjectAppendInt(lara_obj, "torso_rot.x", lara->torso_rot.x);
-    JSON_ObjectAppendInt(lara_obj, "torso_rot.z", lara->torso_rot.z);
-
-    JSON_ObjectAppendObject(lara_obj, "left_arm", M_DumpArm(&lara->left_arm));
-    JSON_ObjectAppendObject(lara_obj, "right_arm", M_DumpArm(&lara->right_arm));
-    JSON_ObjectAppendObject(lara_obj, "pistols", M_DumpAmmo(&lara->pistols));
-    JSON_ObjectAppendObject(lara_obj, "magnums", M_DumpAmmo(&lara->magnums));
-    JSON_ObjectAppendObject(lara_obj, "uzis", M_DumpAmmo(&lara->uzis));
-    JSON_ObjectAppendObject(lara_obj, "shotgun", M_DumpAmmo(&lara->shotgun));
-    JSON_ObjectAppendObject(lara_obj, "lot", M_DumpLOT(&lara->lot));
-
-    JSON_ObjectAppendInt(
-        lara_obj, "interact_target.item_num", lara->interact_target.item_num);
-    JSON_ObjectAppendInt(
-        lara_obj, "interact_target.move_count",
+        BSON_WriterAppendInt(
+            writer, nullptr, Object_GetMeshOffset(lara->mesh_ptrs[i]));
+    }
+    BSON_WriterEnd(writer);
+
+    BSON_WriterAppendInt(writer, "target_angle1", lara->target_angles[0]);
+    BSON_WriterAppendInt(writer, "target_angle2", lara->target_angles[1]);
+    BSON_WriterAppendInt(writer, "turn_rate", lara->turn_rate);
+    BSON_WriterAppendInt(writer, "move_angle", lara->move_angle);
+    BSON_WriterAppendInt(writer, "head_rot.y", lara->head_rot.y);
+    BSON_WriterAppendInt(writer, "head_rot.x", lara->head_rot.x);
+    BSON_WriterAppendInt(writer, "head_rot.z", lara->head_rot.z);
+    BSON_WriterAppendInt(writer, "torso_rot.y", lara->torso_rot.y);
+    BSON_WriterAppendInt(writer, "torso_rot.x", lara->torso_rot.x);
+    BSON_WriterAppendInt(writer, "torso_rot.z", lara->torso_rot.z);
+
+    M_DumpArm(writer, "left_arm", &lara->left_arm);
+    M_DumpArm(writer, "right_arm", &lara->right_arm);
+    M_DumpAmmo(writer, "pistols", &lara->pistols);
+    M_DumpAmmo(writer, "magnums", &lara->magnums);
+    M_DumpAmmo(writer, "uzis", &lara->uzis);
+    M_DumpAmmo(writer, "shotgun", &lara->shotgun);
+    M_DumpLOT(writer, "lot", &lara->lot);
+
+    BSON_WriterAppendInt(
+        writer, "interact_target.item_num", lara->interact_target.item_num);
+    BSON_WriterAppendInt(
+        writer, "interact_target.move_count",
         lara->interact_target.move_count);
-    JSON_ObjectAppendBool(
-        lara_obj, "interact_target.is_moving", lara->interact_target.is_moving);
+    BSON_WriterAppendBool(
+        writer, "interact_target.is_moving", lara->interact_target.is_moving);
 
-    return lara_obj;
+    BSON_WriterEnd(writer);
 }
 
-static JSON_OBJECT *M_DumpCurrentMusic(void)
+static void M_DumpCurrentMusic(BSON_WRITER *const writer, const char *const key)
 {
     const MUSIC_TRACK_ID current_track = Music_GetCurrentPlayingTrack();
     const bool is_ambient = current_track == Music_GetCurrentLoopedTrack();
-    JSON_OBJECT *const current_music_obj = JSON_ObjectNew();
-    JSON_ObjectAppendInt(current_music_obj, "current_track", current_track);
-    JSON_ObjectAppendDouble(
-        current_music_obj, "timestamp", Music_GetTimestamp());
-    JSON_ObjectAppendBool(current_music_obj, "is_ambient", is_ambient);
-
-    return current_music_obj;
+    BSON_WriterBeginObject(writer, key);
+    BSON_WriterAppendInt(writer, "current_track", current_track);
+    BSON_WriterAppendDouble(writer, "timestamp", Music_GetTimestamp());
+    BSON_WriterAppendBool(writer, "is_ambient", is_ambient);
+    BSON_WriterEnd(writer);
 }
 
-static JSON_ARRAY *M_DumpMusicTrackFlags(void)
+static void M_DumpMusicTrackFlags(
+    BSON_WRITER *const writer, const char *const key)
 {
-    JSON_ARRAY *music_track_arr = JSON_ArrayNew();
+    BSON_WriterBeginArray(writer, key);
     for (int32_t i = 0; i < MAX_MUSIC_TRACKS; i++) {
-        JSON_ArrayAppendInt(music_track_arr, Music_GetTrackFlags(i));
+        BSON_WriterAppendInt(writer, nullptr, Music_GetTrackFlags(i));
     }
-    return music_track_arr;
+    BSON_WriterEnd(writer);
 }
 
 char *Savegame_BSON_GetSaveFileName(int32_t slot)
@@ -1299,19 +1730,20 @@ char *Savegame_BSON_GetSaveFileName(int32_t slot)
 bool Savegame_BSON_FillInfo(MYFILE *fp, SAVEGAME_INFO *info)
 {
     bool ret = false;
-    JSON_VALUE *root = M_ParseFromFile(fp, nullptr);
-    JSON_OBJECT *root_obj = JSON_ValueAsObject(root);
-    if (root_obj) {
-        info->counter = JSON_ObjectGetInt(root_obj, "save_counter", -1);
-        info->level_num = JSON_ObjectGetInt(root_obj, "level_num", -1);
+    size_t size;
+    char *data = M_ReadFromFile(fp, nullptr, &size);
+    BSON_READER root;
+    if (BSON_ReaderInit(&root, data, size)) {
+        info->counter = BSON_ReaderGetInt(&root, "save_counter", -1);
+        info->level_num = BSON_ReaderGetInt(&root, "level_num", -1);
         const char *level_title =
-            JSON_ObjectGetString(root_obj, "level_title", nullptr);
+            BSON_ReaderGetString(&root, "level_title", nullptr);
         if (level_title) {
             info->level_title = Memory_DupStr(level_title);
         }
         ret = info->level_num != -1;
     }
-    JSON_ValueFree(root);
+    Memory_FreePointer(&data);
 
     SAVEGAME_BSON_HEADER header;
     File_Seek(fp, 0, FILE_SEEK_SET);
@@ -1335,72 +1767,73 @@ bool Savegame_BSON_LoadFromFile(MYFILE *fp, GAME_INFO *game_info)
     File_ReadData(fp, &header, sizeof(SAVEGAME_BSON_HEADER));
     File_Seek(fp, 0, FILE_SEEK_SET);
 
-    JSON_VALUE *root = M_ParseFromFile(fp, nullptr);
-    JSON_OBJECT *root_obj = JSON_ValueAsObject(root);
-    if (!root_obj) {
+    // The savegame is inflated straight into one buffer and the sections are
+    // read from it in place, without building a document tree first.
+    size_t size;
+    char *data = M_ReadFromFile(fp, nullptr, &size);
+    BSON_READER root;
+    BSON_READER section;
+    if (!BSON_ReaderInit(&root, data, size)) {
         LOG_ERROR("Malformed save: cannot parse BSON data");
         goto cleanup;
     }
 
     if (!M_LoadResumeInfo(
-            JSON_ObjectGetArray(root_obj, "current_info"),
-            game_info->current)) {
+            M_GetArray(&root, "current_info", &section), game_info->current)) {
         LOG_WARNING(
             "Failed to load RESUME_INFO current properly. "
             "Checking if save is legacy.");
         // Check for 2.6 and 2.7 legacy start and end info.
         if (!M_LoadDiscontinuedStartInfo(
-                JSON_ObjectGetArray(root_obj, "start_info"), game_info)) {
+                M_GetArray(&root, "start_info", &section), game_info)) {
             goto cleanup;
         }
         if (!M_LoadDiscontinuedEndInfo(
-                JSON_ObjectGetArray(root_obj, "end_info"), game_info)) {
+                M_GetArray(&root, "end_info", &section), game_info)) {
             goto cleanup;
         }
     }
 
     if (!M_LoadMisc(
-            JSON_ObjectGetObject(root_obj, "misc"), game_info,
-            header.version)) {
+            M_GetObject(&root, "misc", &section), game_info, header.version)) {
         goto cleanup;
     }
 
-    if (!M_LoadInventory(JSON_ObjectGetObject(root_obj, "inventory"))) {
+    if (!M_LoadInventory(M_GetObject(&root, "inventory", &section))) {
         goto cleanup;
     }
 
-    if (!M_LoadFlipmaps(JSON_ObjectGetObject(root_obj, "flipmap"))) {
+    if (!M_LoadFlipmaps(M_GetObject(&root, "flipmap", &section))) {
         goto cleanup;
     }
 
-    if (!M_LoadCameras(JSON_ObjectGetArray(root_obj, "cameras"))) {
+    if (!M_LoadCameras(M_GetArray(&root, "cameras", &section))) {
         goto cleanup;
     }
 
     Savegame_ProcessItemsBeforeLoad();
 
-    if (!M_LoadItems(JSON_ObjectGetArray(root_obj, "items"), header.version)) {
+    if (!M_LoadItems(M_GetArray(&root, "items", &section), header.version)) {
         goto cleanup;
     }
 
     if (header.version >= VERSION_3) {
-        if (!M_LoadEffects(JSON_ObjectGetArray(root_obj, "fx"))) {
+        if (!M_LoadEffects(M_GetArray(&root, "fx", &section))) {
             goto cleanup;
         }
     }
 
-    if (!M_LoadLara(
-            JSON_ObjectGetObject(root_obj, "lara"), &g_Lara, header.version)) {
+    if (!M_LoadLara(M_GetObject(&root, "lara", &section), &g_Lara)) {
         goto cleanup;
     }
 
     if (header.version >= VERSION_3) {
-        if (!M_LoadCurrentMusic(JSON_ObjectGetObject(root_obj, "music"))) {
+        if (!M_LoadCurrentMusic(M_GetObject(&root, "music", &section))) {
             goto cleanup;
         }
 
         if (!M_LoadMusicTrackFlags(
-                JSON_ObjectGetArray(root_obj, "music_track_flags"))) {
+                M_GetArray(&root, "music_track_flags", &section))) {
             goto cleanup;
         }
     }
@@ -1408,7 +1841,7 @@ bool Savegame_BSON_LoadFromFile(MYFILE *fp, GAME_INFO *game_info)
     ret = true;
 
 cleanup:
-    JSON_ValueFree(root);
+    Memory_FreePointer(&data);
     return ret;
 }
 
@@ -1417,26 +1850,27 @@ bool Savegame_BSON_LoadOnlyResumeInfo(MYFILE *fp, GAME_INFO *game_info)
     ASSERT(game_info != nullptr);
 
     bool ret = false;
-    JSON_VALUE *root = M_ParseFromFile(fp, nullptr);
-    JSON_OBJECT *root_obj = JSON_ValueAsObject(root);
-    if (!root_obj) {
+    size_t size;
+    char *data = M_ReadFromFile(fp, nullptr, &size);
+    BSON_READER root;
+    BSON_READER section;
+    if (!BSON_ReaderInit(&root, data, size)) {
         LOG_ERROR("Malformed save: cannot parse BSON data");
         goto cleanup;
     }
 
     if (!M_LoadResumeInfo(
-            JSON_ObjectGetArray(root_obj, "current_info"),
-            game_info->current)) {
+            M_GetArray(&root, "current_info", &section), game_info->current)) {
         LOG_WARNING(
             "Failed to load RESUME_INFO current properly. Checking if "
             "save is legacy.");
         // Check for 2.6 and 2.7 legacy start and end info.
         if (!M_LoadDiscontinuedStartInfo(
-                JSON_ObjectGetArray(root_obj, "start_info"), game_info)) {
+                M_GetArray(&root, "start_info", &section), game_info)) {
             goto cleanup;
         }
         if (!M_LoadDiscontinuedEndInfo(
-                JSON_ObjectGetArray(root_obj, "end_info"), game_info)) {
+                M_GetArray(&root, "end_info", &section), game_info)) {
             goto cleanup;
         }
     }
@@ -1444,37 +1878,48 @@ bool Savegame_BSON_LoadOnlyResumeInfo(MYFILE *fp, GAME_INFO *game_info)
     ret = true;
 
 cleanup:
-    JSON_ValueFree(root);
+    Memory_FreePointer(&data);
     return ret;
 }
 
-void Savegame_BSON_SaveToFile(MYFILE *fp, GAME_INFO *game_info)
+char *Savegame_BSON_Dump(GAME_INFO *const game_info, size_t *const out_size)
 {
     ASSERT(game_info != nullptr);
 
     const GF_LEVEL *const current_level = Game_GetCurrentLevel();
-    JSON_OBJECT *root_obj = JSON_ObjectNew();
-
-    JSON_ObjectAppendString(root_obj, "level_title", current_level->title);
-    JSON_ObjectAppendInt(root_obj, "save_counter", g_SaveCounter);
-    JSON_ObjectAppendInt(root_obj, "level_num", current_level->num);
-
-    JSON_ObjectAppendObject(root_obj, "misc", M_DumpMisc(game_info));
-    JSON_ObjectAppendArray(
-        root_obj, "current_info", M_DumpResumeInfo(game_info->current));
-    JSON_ObjectAppendObject(root_obj, "inventory", M_DumpInventory());
-    JSON_ObjectAppendObject(root_obj, "flipmap", M_DumpFlipmaps());
-    JSON_ObjectAppendArray(root_obj, "cameras", M_DumpCameras());
-    JSON_ObjectAppendArray(root_obj, "items", M_DumpItems());
-    JSON_ObjectAppendArray(root_obj, "fx", M_DumpEffects());
-    JSON_ObjectAppendObject(root_obj, "lara", M_DumpLara(&g_Lara));
-    JSON_ObjectAppendObject(root_obj, "music", M_DumpCurrentMusic());
-    JSON_ObjectAppendArray(
-        root_obj, "music_track_flags", M_DumpMusicTrackFlags());
-
-    JSON_VALUE *root = JSON_ValueFromObject(root_obj);
-    M_SaveRaw(fp, root, SAVEGAME_CURRENT_VERSION);
-    JSON_ValueFree(root);
+    BSON_WRITER writer;
+    BSON_WriterInit(&writer, SAVEGAME_BSON_WRITER_CAPACITY);
+    BSON_WriterBeginObject(&writer, nullptr);
+
+    BSON_WriterAppendString(&writer, "level_title", current_level->title);
+    BSON_WriterAppendInt(&writer, "save_counter", g_SaveCounter);
+    BSON_WriterAppendInt(&writer, "level_num", current_level->num);
+
+    M_DumpMisc(&writer, "misc", game_info);
+    M_DumpResumeInfo(&writer, "current_info", game_info->current);
+    M_DumpInventory(&writer, "inventory");
+    M_DumpFlipmaps(&writer, "flipmap");
+    M_DumpCameras(&writer, "cameras");
+    M_DumpItems(&writer, "items");
+    M_DumpEffects(&writer, "fx");
+    M_DumpLara(&writer, "lara", &g_Lara);
+    M_DumpCurrentMusic(&writer, "music");
+    M_DumpMusicTrackFlags(&writer, "music_track_flags");
+
+    BSON_WriterEnd(&writer);
+    return BSON_WriterFinish(&writer, out_size);
+}
+
+void Savegame_BSON_SaveToFile(const char *const path, GAME_INFO *game_info)
+{
+    // Only the snapshot below touches the game state; compressing and
+    // writing the file happen on the writer thread.
+    SAVEGAME_BSON_SAVE_JOB *const job =
+        Memory_Alloc(sizeof(SAVEGAME_BSON_SAVE_JOB));
+    job->data = Savegame_BSON_Dump(game_info, &job->size);
+    job->initial_version = g_GameInfo.save_initial_version;
+    job->version = SAVEGAME_CURRENT_VERSION;
+    AsyncWriter_Submit(path, M_EncodeJob, job);
 }
 
 bool Savegame_BSON_UpdateDeathCounters(MYFILE *fp, GAME_INFO *game_info)
@@ -1504,3 +1949,94 @@ cleanup:
     JSON_ValueFree(root);
     return result;
 }
+
+static size_t M_WalkBSON(BSON_READER *const reader)
+{
+    // Visit every field in place, the way the loader does.
+    size_t count = 0;
+    BSON_FIELD field;
+    while (BSON_ReaderNext(reader, &field)) {
+        BSON_READER child;
+        if (BSON_FieldGetReader(&field, &child)) {
+            count += M_WalkBSON(&child);
+        } else {
+            count++;
+        }
+    }
+    return count;
+}
+
+static void M_BenchmarkStream(void *const user_data)
+{
+    SAVEGAME_BSON_BENCHMARK *const benchmark = user_data;
+    Memory_Free(Savegame_BSON_Dump(benchmark->game_info, nullptr));
+}
+
+static void M_BenchmarkTree(void *const user_data)
+{
+    SAVEGAME_BSON_BENCHMARK *const benchmark = user_data;
+    Memory_Free(BSON_Write(benchmark->root, nullptr));
+}
+
+static void M_BenchmarkParse(void *const user_data)
+{
+    SAVEGAME_BSON_BENCHMARK *const benchmark = user_data;
+    JSON_ValueFree(BSON_Parse(benchmark->data, benchmark->size));
+}
+
+static void M_BenchmarkCursor(void *const user_data)
+{
+    SAVEGAME_BSON_BENCHMARK *const benchmark = user_data;
+    BSON_READER reader;
+    BSON_ReaderInit(&reader, benchmark->data, benchmark->size);
+    benchmark->count = M_WalkBSON(&reader);
+}
+
+bool Savegame_BSON_Benchmark(
+    GAME_INFO *const game_info, const char *const label)
+{
+    const int32_t passes = SAVEGAME_BSON_BENCHMARK_PASSES;
+    SAVEGAME_BSON_BENCHMARK benchmark = { .game_info = game_info };
+
+    // Serialising the game state in a single pass versus writing out the
+    // equivalent tree.
+    const double stream =
+        Benchmark_Measure(M_BenchmarkStream, &benchmark, passes);
+
+    size_t size;
+    char *data = Savegame_BSON_Dump(game_info, &size);
+    benchmark.data = data;
+    benchmark.size = size;
+
+    // Reading the savegame into a tree versus walking it in place.
+    const double parse =
+        Benchmark_Measure(M_BenchmarkParse, &benchmark, passes);
+    const double cursor =
+        Benchmark_Measure(M_BenchmarkCursor, &benchmark, passes);
+
+    benchmark.root = BSON_Parse(data, size);
+    Memory_FreePointer(&data);
+    if (benchmark.root == nullptr || benchmark.count == 0) {
+        LOG_ERROR("Failed to parse the savegame of %s", label);
+        JSON_ValueFree(benchmark.root);
+        return false;
+    }
+    const double tree = Benchmark_Measure(M_BenchmarkTree, &benchmark, passes);
+
+    // Querying the tree the way loading a savegame does.
+    size_t linear_count;
+    size_t indexed_count;
+    const double linear =
+        JSON_BenchmarkQueries(benchmark.root, false, passes, &linear_count);
+    const double indexed =
+        JSON_BenchmarkQueries(benchmark.root, true, passes, &indexed_count);
+    JSON_ValueFree(benchmark.root);
+
+    printf(
+        "%-24s %7d bytes %8.1f us stream %8.1f us tree %8.1f us parse "
+        "%8.1f us cursor %8.1f us linear %8.1f us indexed%s\n",
+        label, (int32_t)size, stream / 1000.0, tree / 1000.0, parse / 1000.0,
+        cursor / 1000.0, linear / 1000.0, indexed / 1000.0,
+        linear_count != indexed_count ? " MISMATCH" : "");
+    return linear_count == indexed_count;
+}
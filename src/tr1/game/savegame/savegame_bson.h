@@ -5,13 +5,22 @@
 
 #include <libtrx/filesystem.h>
 
+#include <stddef.h>
 #include <stdint.h>
 
 // TR1X implementation of savegames.
 
+#define SAVEGAME_BSON_WRITER_CAPACITY (64 * 1024)
+
 char *Savegame_BSON_GetSaveFileName(int32_t slot);
 bool Savegame_BSON_FillInfo(MYFILE *fp, SAVEGAME_INFO *info);
 bool Savegame_BSON_LoadFromFile(MYFILE *fp, GAME_INFO *game_info);
 bool Savegame_BSON_LoadOnlyResumeInfo(MYFILE *fp, GAME_INFO *game_info);
-void Savegame_BSON_SaveToFile(MYFILE *fp, GAME_INFO *game_info);
+// Serialises the current game state into an uncompressed BSON document,
+// allocated with Memory_Alloc.
+char *Savegame_BSON_Dump(GAME_INFO *game_info, size_t *out_size);
+void Savegame_BSON_SaveToFile(const char *path, GAME_INFO *game_info);
 bool Savegame_BSON_UpdateDeathCounters(MYFILE *fp, GAME_INFO *game_info);
+// Times writing and reading the savegame of the current game state and prints
+// the results.
+bool Savegame_BSON_Benchmark(GAME_INFO *game_info, const char *label);
@@ -692,7 +692,7 @@ bool Savegame_Legacy_LoadOnlyResumeInfo(MYFILE *fp, GAME_INFO *game_info)
     return true;
 }
 
-void Savegame_Legacy_SaveToFile(MYFILE *fp, GAME_INFO *game_info)
+void Savegame_Legacy_SaveToFile(const char *const path, GAME_INFO *game_info)
 {
     ASSERT(game_info != nullptr);
 
@@ -828,7 +828,13 @@ void Savegame_Legacy_SaveToFile(MYFILE *fp, GAME_INFO *game_info)
     M_Write(&flip_effect, sizeof(int32_t));
     M_Write(&flip_timer, sizeof(int32_t));
 
-    File_WriteData(fp, buffer, m_SGBufPos);
+    MYFILE *const fp = File_Open(path, FILE_OPEN_WRITE);
+    if (fp != nullptr) {
+        File_WriteData(fp, buffer, m_SGBufPos);
+        File_Close(fp);
+    } else {
+        LOG_ERROR("Cannot open %s for writing", path);
+    }
     Memory_FreePointer(&buffer);
 }
 
@@ -13,5 +13,5 @@ char *Savegame_Legacy_GetSaveFileName(int32_t slot);
 bool Savegame_Legacy_FillInfo(MYFILE *fp, SAVEGAME_INFO *info);
 bool Savegame_Legacy_LoadFromFile(MYFILE *fp, GAME_INFO *game_info);
 bool Savegame_Legacy_LoadOnlyResumeInfo(MYFILE *fp, GAME_INFO *game_info);
-void Savegame_Legacy_SaveToFile(MYFILE *fp, GAME_INFO *game_info);
+void Savegame_Legacy_SaveToFile(const char *path, GAME_INFO *game_info);
 bool Savegame_Legacy_UpdateDeathCounters(MYFILE *fp, GAME_INFO *game_info);
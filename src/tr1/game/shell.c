@@ -6,12 +6,14 @@
 #include "game/game.h"
 #include "game/game_flow.h"
 #include "game/game_string.h"
+#include "game/headless.h"
 #include "game/input.h"
 #include "game/level.h"
 #include "game/music.h"
 #include "game/option.h"
 #include "game/output.h"
 #include "game/random.h"
+#include "game/room.h"
 #include "game/savegame.h"
 #include "game/screen.h"
 #include "game/sound.h"
@@ -22,12 +24,15 @@
 
 #include <libtrx/config.h>
 #include <libtrx/debug.h>
+#include <libtrx/engine/audio.h>
 #include <libtrx/enum_map.h>
 #include <libtrx/filesystem.h>
 #include <libtrx/game/game_buf.h>
 #include <libtrx/game/game_string_table.h>
+#include <libtrx/game/state_trace.h>
 #include <libtrx/game/ui/common.h>
 #include <libtrx/memory.h>
+#include <libtrx/strings.h>
 
 #include <stdarg.h>
 #include <stdint.h>
@@ -62,11 +67,93 @@ static struct {
 };
 static M_MOD m_ActiveMod = M_MOD_UNKNOWN;
 
+static struct {
+    bool is_parsed;
+    bool is_headless;
+    HEADLESS_OPTIONS options;
+} m_Benchmark = {
+    .options = {
+        .demo_num = -1,
+        .trace_interval = STATE_TRACE_DEFAULT_INTERVAL,
+    },
+};
+
 static const char *m_CurrentGameFlowPath;
 
+static void M_ParseArgs(void);
 static void M_LoadConfig(void);
 static void M_HandleConfigChange(const EVENT *event, void *data);
 
+static void M_ParseArgs(void)
+{
+    if (m_Benchmark.is_parsed) {
+        return;
+    }
+    m_Benchmark.is_parsed = true;
+    m_ActiveMod = M_MOD_OG;
+
+    char **args = nullptr;
+    int32_t arg_count = 0;
+    S_Shell_GetCommandLine(&arg_count, &args);
+    for (int32_t i = 0; i < arg_count; i++) {
+        if (!strcmp(args[i], "-gold")) {
+            m_ActiveMod = M_MOD_UB;
+        }
+        if (!strcmp(args[i], "-demo_pc")) {
+            m_ActiveMod = M_MOD_DEMO_PC;
+        }
+        if (!strcmp(args[i], "-benchmark")) {
+            m_Benchmark.is_headless = true;
+            if (i + 1 < arg_count
+                && String_ParseInteger(
+                    args[i + 1], &m_Benchmark.options.demo_num)) {
+                i++;
+            }
+        }
+        if (!strcmp(args[i], "-benchmark-rooms")) {
+            m_Benchmark.is_headless = true;
+            m_Benchmark.options.benchmark_rooms = true;
+        }
+        if (!strcmp(args[i], "-benchmark-ai")) {
+            m_Benchmark.is_headless = true;
+            m_Benchmark.options.wake_creatures = true;
+        }
+        if (!strcmp(args[i], "-benchmark-los")) {
+            m_Benchmark.is_headless = true;
+            m_Benchmark.options.benchmark_los = true;
+        }
+        if (!strcmp(args[i], "-benchmark-json")) {
+            m_Benchmark.is_headless = true;
+            m_Benchmark.options.benchmark_json = true;
+        }
+        if (!strcmp(args[i], "-no-height-cache")) {
+            m_Benchmark.options.disable_height_cache = true;
+        }
+        if (i + 1 < arg_count) {
+            char **target = nullptr;
+            if (!strcmp(args[i], "-benchmark-input")) {
+                target = &m_Benchmark.options.input_path;
+            } else if (!strcmp(args[i], "-trace")) {
+                target = &m_Benchmark.options.trace_path;
+            } else if (!strcmp(args[i], "-trace-compare")) {
+                target = &m_Benchmark.options.compare_path;
+            } else if (!strcmp(args[i], "-trace-interval")) {
+                String_ParseInteger(
+                    args[++i], &m_Benchmark.options.trace_interval);
+            }
+            if (target != nullptr) {
+                m_Benchmark.is_headless = true;
+                Memory_FreePointer(target);
+                *target = Memory_DupStr(args[++i]);
+            }
+        }
+    }
+    for (int i = 0; i < arg_count; i++) {
+        Memory_FreePointer(&args[i]);
+    }
+    Memory_FreePointer(&args);
+}
+
 static void M_HandleConfigChange(const EVENT *const event, void *const data)
 {
     const CONFIG *const old = &g_Config;
@@ -80,6 +167,13 @@ static void M_HandleConfigChange(const EVENT *const event, void *const data)
     if (CHANGED(audio.music_volume)) {
         Music_SetVolume(g_Config.audio.music_volume);
     }
+    if (CHANGED(audio.enable_sample_interpolation)) {
+        Audio_Sample_SetInterpolation(
+            g_Config.audio.enable_sample_interpolation);
+    }
+    if (CHANGED(audio.enable_sample_cache)) {
+        Audio_Sample_SetCacheEnabled(g_Config.audio.enable_sample_cache);
+    }
 
     if (CHANGED(gameplay.maximum_save_slots) && Savegame_IsInitialised()) {
         Savegame_Shutdown();
@@ -105,24 +199,30 @@ void Shell_Init(
     Text_Init();
     UI_Init();
 
-    Input_Init();
-    Sound_Init();
-    Music_Init();
+    if (!Shell_IsHeadless()) {
+        Input_Init();
+        Sound_Init();
+        Music_Init();
+    }
 
     M_LoadConfig();
 
     Clock_Init();
 
-    S_Shell_CreateWindow();
-    S_Shell_Init();
+    if (!Shell_IsHeadless()) {
+        S_Shell_CreateWindow();
+        S_Shell_Init();
+    }
 
     Random_Seed();
 
-    if (!Output_Init()) {
-        Shell_ExitSystem("Could not initialise video system");
-        return;
+    if (!Shell_IsHeadless()) {
+        if (!Output_Init()) {
+            Shell_ExitSystem("Could not initialise video system");
+            return;
+        }
+        Screen_Init();
     }
-    Screen_Init();
 
     GF_Init();
     GF_Load(game_flow_path);
@@ -138,15 +238,19 @@ void Shell_Init(
 
 void Shell_Shutdown(void)
 {
+    StateTrace_Stop();
     Console_Shutdown();
+    Room_Shutdown();
     GameBuf_Shutdown();
     Savegame_Shutdown();
     GF_Shutdown();
 
-    Output_Shutdown();
-    Input_Shutdown();
-    Music_Shutdown();
-    Sound_Shutdown();
+    if (!Shell_IsHeadless()) {
+        Output_Shutdown();
+        Input_Shutdown();
+        Music_Shutdown();
+        Sound_Shutdown();
+    }
     UI_Shutdown();
     Text_Shutdown();
     Config_Shutdown();
@@ -163,25 +267,15 @@ const char *Shell_GetGameFlowPath(void)
     return m_ModPaths[m_ActiveMod].game_flow_path;
 }
 
-void Shell_Main(void)
+bool Shell_IsHeadless(void)
 {
-    m_ActiveMod = M_MOD_OG;
+    M_ParseArgs();
+    return m_Benchmark.is_headless;
+}
 
-    char **args = nullptr;
-    int32_t arg_count = 0;
-    S_Shell_GetCommandLine(&arg_count, &args);
-    for (int32_t i = 0; i < arg_count; i++) {
-        if (!strcmp(args[i], "-gold")) {
-            m_ActiveMod = M_MOD_UB;
-        }
-        if (!strcmp(args[i], "-demo_pc")) {
-            m_ActiveMod = M_MOD_DEMO_PC;
-        }
-    }
-    for (int i = 0; i < arg_count; i++) {
-        Memory_FreePointer(&args[i]);
-    }
-    Memory_FreePointer(&args);
+void Shell_Main(void)
+{
+    M_ParseArgs();
 
     GameString_Init();
     EnumMap_Init();
@@ -191,6 +285,16 @@ void Shell_Main(void)
         m_ModPaths[m_ActiveMod].game_flow_path,
         m_ModPaths[m_ActiveMod].game_strings_path);
 
+    if (Shell_IsHeadless()) {
+        const bool result = Headless_Run(&m_Benchmark.options);
+        Memory_FreePointer(&m_Benchmark.options.input_path);
+        Memory_FreePointer(&m_Benchmark.options.trace_path);
+        Memory_FreePointer(&m_Benchmark.options.compare_path);
+        EnumMap_Shutdown();
+        GameString_Shutdown();
+        Shell_Terminate(result ? 0 : 1);
+    }
+
     GF_COMMAND gf_cmd = GF_DoFrontendSequence();
     bool loop_continue = !Shell_IsExiting();
     while (loop_continue) {
@@ -207,6 +207,8 @@ bool Sound_Init(void)
     m_MasterVolume = 32;
     m_MasterVolumeDefault = 32;
     m_SoundIsActive = Audio_Init();
+    Audio_Sample_SetInterpolation(g_Config.audio.enable_sample_interpolation);
+    Audio_Sample_SetCacheEnabled(g_Config.audio.enable_sample_cache);
     return m_SoundIsActive;
 }
 
@@ -93,7 +93,6 @@
 #define MAX_LIGHTING 0x1FFF
 #define NO_VERT_MOVE 0x2000
 #define MAX_EXPANSION 5
-#define NO_BOX (-1)
 #define BOX_NUMBER 0x7FFF
 #define BLOCKABLE 0x8000
 #define BLOCKED 0x4000
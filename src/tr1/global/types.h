@@ -151,6 +151,7 @@ typedef struct {
     SECTOR *sector;
     SECTOR old_sector;
     int16_t block;
+    bool is_shut;
 } DOORPOS_DATA;
 
 typedef struct {
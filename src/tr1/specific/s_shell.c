@@ -9,6 +9,7 @@
 #include "game/sound.h"
 
 #include <libtrx/config.h>
+#include <libtrx/engine/audio.h>
 #include <libtrx/filesystem.h>
 #include <libtrx/game/ui/common.h>
 #include <libtrx/gfx/common.h>
@@ -152,6 +153,8 @@ void S_Shell_Init(void)
 
 void Shell_ProcessEvents(void)
 {
+    Audio_Stream_Update();
+
     SDL_Event event;
     while (SDL_PollEvent(&event) != 0) {
         switch (event.type) {
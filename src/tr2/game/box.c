@@ -1,10 +1,12 @@
 #include "game/box.h"
 
+#include "game/game_flow.h"
 #include "game/random.h"
 #include "game/room.h"
 #include "global/const.h"
 #include "global/vars.h"
 
+#include <libtrx/config.h>
 #include <libtrx/utils.h>
 
 #define BOX_OVERLAP_BITS 0x3FFF
@@ -13,7 +15,6 @@
 #define BOX_NUM_BITS (~BOX_END_BIT) // = 0x7FFF
 #define BOX_STALK_DIST 3 // tiles
 #define BOX_ESCAPE_DIST 5 // tiles
-#define BOX_MAX_EXPANSION 5
 
 #define BOX_BIFF (WALL_L / 2) // = 0x200 = 512
 #define BOX_CLIP_LEFT 1
@@ -24,16 +25,28 @@
     (BOX_CLIP_LEFT | BOX_CLIP_RIGHT | BOX_CLIP_TOP | BOX_CLIP_BOTTOM) // = 15
 #define BOX_CLIP_SECONDARY 16
 
-int32_t Box_SearchLOT(LOT_INFO *const lot, const int32_t expansion)
+static int16_t *M_GetZone(const LOT_INFO *lot);
+static bool M_IsSharingEnabled(void);
+
+static int16_t *M_GetZone(const LOT_INFO *const lot)
 {
     const bool flip_status = Room_GetFlipStatus();
-    int16_t *zone;
-    if (lot->fly) {
-        zone = g_FlyZone[flip_status];
-    } else {
-        zone = g_GroundZone[BOX_ZONE(lot->step)][flip_status];
+    if (lot->fly != 0) {
+        return g_FlyZone[flip_status];
     }
+    return g_GroundZone[BOX_ZONE(lot->step)][flip_status];
+}
 
+static bool M_IsSharingEnabled(void)
+{
+    // Demos rely on the original search timing.
+    return g_Config.gameplay.enable_shared_pathfinding
+        && GF_GetCurrentLevel()->type != GFL_DEMO;
+}
+
+bool Box_SearchLOT(LOT_INFO *const lot, const int32_t expansion)
+{
+    const int16_t *const zone = M_GetZone(lot);
     const int16_t search_zone = zone[lot->head];
     for (int32_t i = 0; i < expansion; i++) {
         if (lot->head == NO_BOX) {
@@ -102,7 +115,7 @@ int32_t Box_SearchLOT(LOT_INFO *const lot, const int32_t expansion)
     return true;
 }
 
-int32_t Box_UpdateLOT(LOT_INFO *const lot, const int32_t expansion)
+bool Box_UpdateLOT(LOT_INFO *const lot, const int32_t expansion)
 {
     if (lot->required_box == NO_BOX || lot->required_box == lot->target_box) {
         goto end;
@@ -226,7 +239,11 @@ int32_t Box_ValidBox(
 TARGET_TYPE Box_CalculateTarget(
     XYZ_32 *const target, const ITEM *const item, LOT_INFO *const lot)
 {
-    Box_UpdateLOT(lot, BOX_MAX_EXPANSION);
+    if (M_IsSharingEnabled()) {
+        LOT_UpdateSharedSearch(lot, M_GetZone(lot), g_BoxCount);
+    } else {
+        Box_UpdateLOT(lot, BOX_MAX_EXPANSION);
+    }
 
     *target = item->pos;
 
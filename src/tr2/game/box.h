@@ -6,9 +6,9 @@
 #define BOX_BLOCKED_SEARCH 0x8000
 #define BOX_BLOCKABLE 0x8000
 #define BOX_ZONE(num) (((num) / STEP_L) - 1)
+#define BOX_MAX_EXPANSION 5
 
-int32_t Box_SearchLOT(LOT_INFO *lot, int32_t expansion);
-int32_t Box_UpdateLOT(LOT_INFO *lot, int32_t expansion);
+bool Box_SearchLOT(LOT_INFO *lot, int32_t expansion);
 void Box_TargetBox(LOT_INFO *lot, int16_t box_num);
 int32_t Box_StalkBox(const ITEM *item, const ITEM *enemy, int16_t box_num);
 int32_t Box_EscapeBox(const ITEM *item, const ITEM *enemy, int16_t box_num);
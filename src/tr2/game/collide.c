@@ -123,7 +123,7 @@ void Collide_GetCollisionInfo(
         coll->side_front.floor = 512;
     } else if (
         coll->lava_is_pit && coll->side_front.floor > 0
-        && Room_GetPitSector(sector, x, z)->is_death_sector) {
+        && (Room_GetPitSector(sector, x, z)->flags & SF_DEATH)) {
         coll->side_front.floor = 512;
     }
 
@@ -151,7 +151,7 @@ void Collide_GetCollisionInfo(
         coll->side_left.floor = 512;
     } else if (
         coll->lava_is_pit && coll->side_left.floor > 0
-        && Room_GetPitSector(sector, x, z)->is_death_sector) {
+        && (Room_GetPitSector(sector, x, z)->flags & SF_DEATH)) {
         coll->side_left.floor = 512;
     }
 
@@ -179,7 +179,7 @@ void Collide_GetCollisionInfo(
         coll->side_right.floor = 512;
     } else if (
         coll->lava_is_pit && coll->side_right.floor > 0
-        && Room_GetPitSector(sector, x, z)->is_death_sector) {
+        && (Room_GetPitSector(sector, x, z)->flags & SF_DEATH)) {
         coll->side_right.floor = 512;
     }
 
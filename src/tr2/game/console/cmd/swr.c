@@ -0,0 +1,74 @@
+#include "game/game_string.h"
+#include "game/render/common.h"
+#include "game/render/swr_span.h"
+
+#include <libtrx/game/console/common.h>
+#include <libtrx/game/console/registry.h>
+#include <libtrx/strings.h>
+
+static void M_ShowStats(void);
+static void M_Benchmark(void);
+static COMMAND_RESULT M_Entrypoint(const COMMAND_CONTEXT *ctx);
+
+static void M_ShowStats(void)
+{
+    const RENDER_SW_STATS stats = Render_GetSWStats();
+    if (stats.threads == 0) {
+        Console_Log(GS(OSD_SWR_INACTIVE));
+        return;
+    }
+    Console_Log(
+        GS(OSD_SWR_STATS), stats.threads, stats.bands, stats.frames,
+        stats.frames > 0 ? stats.time_ms / stats.frames : 0.0);
+    Console_Log(
+        GS(OSD_SWR_KERNEL), SWR_Span_GetKernelName(SWR_Span_GetKernel()));
+}
+
+static void M_Benchmark(void)
+{
+    SWR_SPAN_BENCHMARK results[SWR_SPAN_KERNEL_NUMBER_OF];
+    SWR_Span_Benchmark(results);
+
+    const SWR_SPAN_BENCHMARK *const scalar = &results[SWR_SPAN_KERNEL_SCALAR];
+    for (SWR_SPAN_KERNEL kernel = 0; kernel < SWR_SPAN_KERNEL_NUMBER_OF;
+         kernel++) {
+        const SWR_SPAN_BENCHMARK *const result = &results[kernel];
+        const char *const name = SWR_Span_GetKernelName(kernel);
+        if (!result->is_supported) {
+            Console_Log(GS(OSD_SWR_BENCHMARK_UNSUPPORTED), name);
+        } else if (!result->is_exact) {
+            Console_Log(GS(OSD_SWR_BENCHMARK_MISMATCH), name);
+        } else {
+            const double time = result->opaque_ns + result->transparent_ns;
+            Console_Log(
+                GS(OSD_SWR_BENCHMARK), name, result->opaque_ns,
+                result->transparent_ns,
+                time > 0.0
+                    ? (scalar->opaque_ns + scalar->transparent_ns) / time
+                    : 0.0);
+        }
+    }
+}
+
+static COMMAND_RESULT M_Entrypoint(const COMMAND_CONTEXT *const ctx)
+{
+    if (String_IsEmpty(ctx->args)) {
+        M_ShowStats();
+        return CR_SUCCESS;
+    }
+
+    if (String_Equivalent(ctx->args, "reset")) {
+        Render_ResetSWStats();
+        Console_Log(GS(OSD_SWR_RESET));
+        return CR_SUCCESS;
+    }
+
+    if (String_Equivalent(ctx->args, "bench")) {
+        M_Benchmark();
+        return CR_SUCCESS;
+    }
+
+    return CR_BAD_INVOCATION;
+}
+
+REGISTER_CONSOLE_COMMAND("swr", M_Entrypoint)
@@ -0,0 +1,39 @@
+#include "game/game_string.h"
+#include "game/output.h"
+
+#include <libtrx/game/console/common.h>
+#include <libtrx/game/console/registry.h>
+#include <libtrx/strings.h>
+
+static void M_ShowStats(void);
+static COMMAND_RESULT M_Entrypoint(const COMMAND_CONTEXT *ctx);
+
+static void M_ShowStats(void)
+{
+    const OUTPUT_ROOM_VERTEX_CACHE_STATS stats =
+        Output_GetRoomVertexCacheStats();
+    const uint32_t total = stats.hits + stats.misses;
+    const int32_t hit_rate =
+        total > 0 ? (int32_t)((uint64_t)stats.hits * 100 / total) : 0;
+    Console_Log(
+        GS(OSD_ROOM_VERTEX_CACHE_STATS), stats.hits, stats.misses, hit_rate,
+        (int32_t)(stats.bytes / 1024));
+}
+
+static COMMAND_RESULT M_Entrypoint(const COMMAND_CONTEXT *const ctx)
+{
+    if (String_IsEmpty(ctx->args)) {
+        M_ShowStats();
+        return CR_SUCCESS;
+    }
+
+    if (String_Equivalent(ctx->args, "reset")) {
+        Output_ResetRoomVertexCacheStats();
+        Console_Log(GS(OSD_ROOM_VERTEX_CACHE_RESET));
+        return CR_SUCCESS;
+    }
+
+    return CR_BAD_INVOCATION;
+}
+
+REGISTER_CONSOLE_COMMAND("vcache", M_Entrypoint)
@@ -842,7 +842,7 @@ void Creature_GetBaddieTarget(const int16_t item_num, const int32_t goody)
 
     ITEM *best_item = nullptr;
     int32_t best_distance = INT32_MAX;
-    for (int32_t i = 0; i < NUM_SLOTS; i++) {
+    for (int32_t i = 0; i < LOT_GetSlotCount(); i++) {
         const int16_t target_item_num = g_BaddieSlots[i].item_num;
         if (target_item_num == NO_ITEM || target_item_num == item_num) {
             continue;
@@ -22,6 +22,7 @@
 #include "global/vars.h"
 
 #include <libtrx/config.h>
+#include <libtrx/game/state_trace.h>
 
 bool Game_Start(const GF_LEVEL *const level, const GF_SEQUENCE_CONTEXT seq_ctx)
 {
@@ -149,6 +150,7 @@ GF_COMMAND Game_Control(const bool demo_mode)
         Stats_UpdateTimer();
     }
 
+    StateTrace_Update();
     return (GF_COMMAND) { .action = GF_NOOP };
 }
 
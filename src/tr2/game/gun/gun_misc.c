@@ -4,6 +4,7 @@
 #include "game/gun/gun.h"
 #include "game/items.h"
 #include "game/los.h"
+#include "game/lot.h"
 #include "game/objects/general/window.h"
 #include "game/output.h"
 #include "game/random.h"
@@ -114,7 +115,7 @@ void Gun_GetNewTarget(const WEAPON_INFO *const winfo)
     ITEM *best_target = nullptr;
 
     const int16_t max_dist = winfo->target_dist;
-    for (int32_t i = 0; i < NUM_SLOTS; i++) {
+    for (int32_t i = 0; i < LOT_GetSlotCount(); i++) {
         const int16_t item_num = g_BaddieSlots[i].item_num;
         if (item_num == NO_ITEM || item_num == g_Lara.item_num) {
             continue;
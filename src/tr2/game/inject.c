@@ -285,6 +285,7 @@ static void M_RoomShift(
     room->pos.z += z_shift;
     room->min_floor += y_shift;
     room->max_ceiling += y_shift;
+    Room_InvalidateLookup();
 
     // Move any items in the room to match.
     for (int32_t i = 0; i < Item_GetTotalCount(); i++) {
@@ -52,6 +52,8 @@ static OBJECT_BOUNDS M_ConvertBounds(const int16_t *const bounds_in)
 
 void Item_Control(void)
 {
+    LOT_StartSearchFrame();
+
     int16_t item_num = Item_GetNextActive();
     while (item_num != NO_ITEM) {
         const ITEM *const item = Item_Get(item_num);
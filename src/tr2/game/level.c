@@ -268,6 +268,8 @@ static void M_InitialiseSoundEffects(void)
         sample_id++;
     }
 
+    Audio_Sample_DecodeAll();
+
 finish:
     if (fp != nullptr) {
         File_Close(fp);
@@ -438,6 +440,7 @@ bool Level_Initialise(const GF_LEVEL *const level)
 void Level_Unload(void)
 {
     strcpy(g_LevelFileName, "");
+    Output_ClearRoomVertexCache();
     Output_InitialiseTexturePages(0, true);
     Output_InitialiseObjectTextures(0);
 
@@ -2,27 +2,46 @@
 
 #include "game/box.h"
 #include "game/camera.h"
+#include "game/game_flow.h"
 #include "global/const.h"
 #include "global/vars.h"
 
+#include <libtrx/config.h>
 #include <libtrx/debug.h>
 #include <libtrx/game/game_buf.h>
 #include <libtrx/utils.h>
 
+static int32_t m_SlotCount = 0;
 static int32_t m_SlotsUsed = 0;
+
+static int32_t M_GetSlotLimit(void);
+
+static int32_t M_GetSlotLimit(void)
+{
+    // Demos rely on the original slot count.
+    if (GF_GetCurrentLevel()->type == GFL_DEMO) {
+        return NUM_SLOTS;
+    }
+    return MIN(g_Config.gameplay.maximum_active_enemies, m_SlotCount);
+}
+
 void LOT_InitialiseArray(void)
 {
+    // Creature slots are cheap, so allocate as many as the limit allows. The
+    // large per-slot box node arrays are only allocated when a slot is first
+    // used.
+    m_SlotCount = MAX(g_Config.gameplay.maximum_active_enemies, NUM_SLOTS);
     g_BaddieSlots =
-        GameBuf_Alloc(NUM_SLOTS * sizeof(CREATURE), GBUF_CREATURE_DATA);
+        GameBuf_Alloc(m_SlotCount * sizeof(CREATURE), GBUF_CREATURE_DATA);
 
-    for (int32_t i = 0; i < NUM_SLOTS; i++) {
+    for (int32_t i = 0; i < m_SlotCount; i++) {
         CREATURE *const creature = &g_BaddieSlots[i];
         creature->item_num = NO_ITEM;
-        creature->lot.node =
-            GameBuf_Alloc(g_BoxCount * sizeof(BOX_NODE), GBUF_CREATURE_LOT);
+        creature->lot.node = nullptr;
     }
 
     m_SlotsUsed = 0;
+    LOT_ResetSearch(BOX_MAX_EXPANSION, NUM_SLOTS);
 }
 
 void LOT_DisableBaddieAI(const int16_t item_num)
@@ -54,8 +73,9 @@ bool LOT_EnableBaddieAI(const int16_t item_num, const bool always)
         return true;
     }
 
-    if (m_SlotsUsed < NUM_SLOTS) {
-        for (int32_t slot = 0; slot < NUM_SLOTS; slot++) {
+    if (m_SlotsUsed < M_GetSlotLimit()) {
+        // Prefer the lowest free slot to reuse already allocated nodes.
+        for (int32_t slot = 0; slot < m_SlotCount; slot++) {
             if (g_BaddieSlots[slot].item_num == NO_ITEM) {
                 LOT_InitialiseSlot(item_num, slot);
                 return true;
@@ -74,8 +94,11 @@ bool LOT_EnableBaddieAI(const int16_t item_num, const bool always)
     }
 
     int32_t worst_slot = -1;
-    for (int32_t slot = 0; slot < NUM_SLOTS; slot++) {
+    for (int32_t slot = 0; slot < m_SlotCount; slot++) {
         const int32_t item_num = g_BaddieSlots[slot].item_num;
+        if (item_num == NO_ITEM) {
+            continue;
+        }
         const ITEM *const item = Item_Get(item_num);
         const int32_t dx = (item->pos.x - g_Camera.pos.pos.x) >> 8;
         const int32_t dy = (item->pos.y - g_Camera.pos.pos.y) >> 8;
@@ -100,8 +123,12 @@ bool LOT_EnableBaddieAI(const int16_t item_num, const bool always)
 
 void LOT_InitialiseSlot(const int16_t item_num, const int32_t slot)
 {
-
     CREATURE *const creature = &g_BaddieSlots[slot];
+    if (creature->lot.node == nullptr) {
+        creature->lot.node =
+            GameBuf_Alloc(g_BoxCount * sizeof(BOX_NODE), GBUF_CREATURE_LOT);
+    }
+
     ITEM *const item = Item_Get(item_num);
 
     if (item_num == g_Lara.item_num) {
@@ -204,6 +231,11 @@ void LOT_CreateZone(ITEM *const item)
     }
 }
 
+int32_t LOT_GetSlotCount(void)
+{
+    return m_SlotCount;
+}
+
 void LOT_ClearLOT(LOT_INFO *const lot)
 {
     lot->search_num = 0;
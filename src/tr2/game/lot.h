@@ -8,3 +8,7 @@ bool LOT_EnableBaddieAI(int16_t item_num, bool always);
 void LOT_InitialiseSlot(int16_t item_num, int32_t slot);
 void LOT_CreateZone(ITEM *item);
 void LOT_ClearLOT(LOT_INFO *LOT);
+
+// Number of allocated creature slots in g_BaddieSlots, some of which may be
+// unused.
+int32_t LOT_GetSlotCount(void);
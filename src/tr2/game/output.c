@@ -13,9 +13,13 @@
 #include <libtrx/debug.h>
 #include <libtrx/game/math.h>
 #include <libtrx/game/matrix.h>
+#include <libtrx/game/rooms.h>
 #include <libtrx/log.h>
+#include <libtrx/memory.h>
 #include <libtrx/utils.h>
 
+#include <string.h>
+
 typedef enum {
     COLOR_BLACK = 0,
     COLOR_GRAY = 1,
@@ -36,6 +40,35 @@ typedef struct {
     uint8_t palette_index;
 } NAMED_COLOR;
 
+#define ROOM_VERTEX_BATCH 64
+#define ROOM_VERTEX_FOG_FAR (-1)
+
+// Everything the projected room vertices depend on, apart from lighting.
+typedef struct {
+    const ROOM_VERTEX *vertices;
+    int32_t num_vertices;
+    MATRIX matrix;
+    double base_z;
+    float near_z;
+    float far_z;
+    float persp;
+    float rhw_o_persp;
+    float win_left;
+    float win_top;
+    float win_right;
+    float win_bottom;
+    float win_center_x;
+    float win_center_y;
+} M_ROOM_VERTEX_KEY;
+
+typedef struct {
+    bool valid;
+    M_ROOM_VERTEX_KEY key;
+    int32_t capacity;
+    PHD_VBUF *vbufs;
+    int16_t *fog;
+} M_ROOM_VERTEX_CACHE;
+
 static NAMED_COLOR m_NamedColors[COLOR_NUMBER_OF] = {
     // clang-format off
     [COLOR_BLACK]      = {.rgb = {.r = 0x00, .g = 0x00, .b = 0x00}},
@@ -59,8 +92,17 @@ static float m_WibbleTable[32];
 static int16_t m_ShadesTable[32];
 static int32_t m_RandomTable[32];
 static BACKGROUND_TYPE m_BackgroundType = BK_TRANSPARENT;
-
-static void M_CalcRoomVertices(const ROOM_MESH *mesh, int32_t far_clip);
+static M_ROOM_VERTEX_CACHE *m_RoomVertexCache = nullptr;
+static int32_t m_RoomVertexCacheCount = 0;
+static OUTPUT_ROOM_VERTEX_CACHE_STATS m_RoomVertexCacheStats = {};
+
+static bool M_RoomVertexKeyEquals(
+    const M_ROOM_VERTEX_KEY *a, const M_ROOM_VERTEX_KEY *b);
+static M_ROOM_VERTEX_CACHE *M_GetRoomVertexCache(int16_t room_num);
+static void M_CalcRoomVertices(
+    const ROOM_MESH *mesh, const M_ROOM_VERTEX_KEY *key, int16_t *fog);
+static void M_ShadeRoomVertices(const ROOM_MESH *mesh, const int16_t *fog);
+static void M_PrepareRoomVertices(int16_t room_num, const ROOM_MESH *mesh);
 static void M_CalcRoomVerticesWibble(const ROOM_MESH *mesh);
 static void M_DrawRoomSprites(const ROOM_MESH *mesh);
 
@@ -109,96 +151,198 @@ static void M_InsertBar(
     }
 }
 
-static void M_CalcRoomVertices(const ROOM_MESH *const mesh, int32_t far_clip)
+static bool M_RoomVertexKeyEquals(
+    const M_ROOM_VERTEX_KEY *const a, const M_ROOM_VERTEX_KEY *const b)
 {
-    const double base_z = g_Config.rendering.enable_zbuffer
-        ? 0.0
-        : (g_MidSort << (W2V_SHIFT + 8));
-
-    for (int32_t i = 0; i < mesh->num_vertices; i++) {
-        PHD_VBUF *const vbuf = &g_PhdVBuf[i];
-        const ROOM_VERTEX *const vertex = &mesh->vertices[i];
-
-        // clang-format off
-        const MATRIX *const mptr = g_MatrixPtr;
-        const double xv = (
-            mptr->_00 * vertex->pos.x +
-            mptr->_01 * vertex->pos.y +
-            mptr->_02 * vertex->pos.z +
-            mptr->_03
-        );
-        const double yv = (
-            mptr->_10 * vertex->pos.x +
-            mptr->_11 * vertex->pos.y +
-            mptr->_12 * vertex->pos.z +
-            mptr->_13
-        );
-        const int32_t zv_int = (
-            mptr->_20 * vertex->pos.x +
-            mptr->_21 * vertex->pos.y +
-            mptr->_22 * vertex->pos.z +
-            mptr->_23
-        );
-        const double zv = zv_int;
-        // clang-format on
+    // clang-format off
+    return a->vertices == b->vertices
+        && a->num_vertices == b->num_vertices
+        && memcmp(&a->matrix, &b->matrix, sizeof(MATRIX)) == 0
+        && a->base_z == b->base_z
+        && a->near_z == b->near_z
+        && a->far_z == b->far_z
+        && a->persp == b->persp
+        && a->rhw_o_persp == b->rhw_o_persp
+        && a->win_left == b->win_left
+        && a->win_top == b->win_top
+        && a->win_right == b->win_right
+        && a->win_bottom == b->win_bottom
+        && a->win_center_x == b->win_center_x
+        && a->win_center_y == b->win_center_y;
+    // clang-format on
+}
 
-        vbuf->xv = xv;
-        vbuf->yv = yv;
-        vbuf->zv = zv;
+static M_ROOM_VERTEX_CACHE *M_GetRoomVertexCache(const int16_t room_num)
+{
+    if (m_RoomVertexCache == nullptr) {
+        m_RoomVertexCacheCount = Room_GetCount();
+        m_RoomVertexCache =
+            Memory_Alloc(sizeof(M_ROOM_VERTEX_CACHE) * m_RoomVertexCacheCount);
+    }
+    ASSERT(room_num >= 0 && room_num < m_RoomVertexCacheCount);
+    return &m_RoomVertexCache[room_num];
+}
 
-        int16_t shade = vertex->light_adder;
-        if (g_IsWaterEffect) {
-            shade += m_ShadesTable
-                [((uint8_t)g_WibbleOffset
-                  + (uint8_t)
-                      m_RandomTable[(mesh->num_vertices - i) % WIBBLE_SIZE])
-                 % WIBBLE_SIZE];
+static void M_CalcRoomVertices(
+    const ROOM_MESH *const mesh, const M_ROOM_VERTEX_KEY *const key,
+    int16_t *const fog)
+{
+    const MATRIX mptr = key->matrix;
+    const double base_z = key->base_z;
+    const float near_z = key->near_z;
+    const float far_z = key->far_z;
+    const float persp_z = key->persp;
+    const float rhw_o_persp = key->rhw_o_persp;
+    const float center_x = key->win_center_x;
+    const float center_y = key->win_center_y;
+    const float win_left = key->win_left;
+    const float win_top = key->win_top;
+    const float win_right = key->win_right;
+    const float win_bottom = key->win_bottom;
+
+    int32_t xv_batch[ROOM_VERTEX_BATCH];
+    int32_t yv_batch[ROOM_VERTEX_BATCH];
+    int32_t zv_batch[ROOM_VERTEX_BATCH];
+
+    for (int32_t base = 0; base < mesh->num_vertices;
+         base += ROOM_VERTEX_BATCH) {
+        const int32_t count =
+            MIN(ROOM_VERTEX_BATCH, mesh->num_vertices - base);
+        const ROOM_VERTEX *const vertices = &mesh->vertices[base];
+
+        // Keep the integer transform free of branches and apart from the
+        // projection, so the compiler can vectorise it.
+        for (int32_t i = 0; i < count; i++) {
+            const XYZ_16 pos = vertices[i].pos;
+            // clang-format off
+            xv_batch[i] =
+                mptr._00 * pos.x + mptr._01 * pos.y + mptr._02 * pos.z +
+                mptr._03;
+            yv_batch[i] =
+                mptr._10 * pos.x + mptr._11 * pos.y + mptr._12 * pos.z +
+                mptr._13;
+            zv_batch[i] =
+                mptr._20 * pos.x + mptr._21 * pos.y + mptr._22 * pos.z +
+                mptr._23;
+            // clang-format on
         }
 
-        uint16_t clip_flags = 0;
-        if (zv < g_FltNearZ) {
-            clip_flags = 0xFF80;
-        } else {
-            const double persp = g_FltPersp / zv;
-            const int32_t depth = zv_int >> W2V_SHIFT;
-            vbuf->zv += base_z;
+        for (int32_t i = 0; i < count; i++) {
+            PHD_VBUF *const vbuf = &g_PhdVBuf[base + i];
+            const double xv = xv_batch[i];
+            const double yv = yv_batch[i];
+            const int32_t zv_int = zv_batch[i];
+            const double zv = zv_int;
 
-            if (depth < FOG_END) {
-                if (depth > FOG_START) {
-                    shade += depth - FOG_START;
-                }
-                vbuf->rhw = persp * g_FltRhwOPersp;
-            } else {
-                // clip_flags = far_clip;
-                shade = 0x1FFF;
-                vbuf->zv = g_FltFarZ;
-                vbuf->rhw = persp * g_FltRhwOPersp;
-            }
+            vbuf->xv = xv;
+            vbuf->yv = yv;
+            vbuf->zv = zv;
 
-            double xs = xv * persp + g_FltWinCenterX;
-            double ys = yv * persp + g_FltWinCenterY;
+            int16_t vertex_fog = 0;
+            uint16_t clip_flags = 0;
+            if (zv < near_z) {
+                clip_flags = 0xFF80;
+            } else {
+                const double persp = persp_z / zv;
+                const int32_t depth = zv_int >> W2V_SHIFT;
+                vbuf->zv += base_z;
+
+                if (depth < FOG_END) {
+                    if (depth > FOG_START) {
+                        vertex_fog = depth - FOG_START;
+                    }
+                } else {
+                    vertex_fog = ROOM_VERTEX_FOG_FAR;
+                    vbuf->zv = far_z;
+                }
+                vbuf->rhw = persp * rhw_o_persp;
 
-            if (xs < g_FltWinLeft) {
-                clip_flags |= 1;
-            } else if (xs > g_FltWinRight) {
-                clip_flags |= 2;
-            }
+                const double xs = xv * persp + center_x;
+                const double ys = yv * persp + center_y;
+                clip_flags = (xs < win_left ? 1 : 0) | (xs > win_right ? 2 : 0)
+                    | (ys < win_top ? 4 : 0) | (ys > win_bottom ? 8 : 0);
 
-            if (ys < g_FltWinTop) {
-                clip_flags |= 4;
-            } else if (ys > g_FltWinBottom) {
-                clip_flags |= 8;
+                vbuf->xs = xs;
+                vbuf->ys = ys;
             }
 
-            vbuf->xs = xs;
-            vbuf->ys = ys;
-            // clip_flags |= (~((uint8_t)(vbuf->zv / 0x155555.p0))) << 8;
+            fog[base + i] = vertex_fog;
+            vbuf->clip = clip_flags;
         }
+    }
+}
 
+static void M_ShadeRoomVertices(
+    const ROOM_MESH *const mesh, const int16_t *const fog)
+{
+    const bool is_water = g_IsWaterEffect;
+    const uint8_t wibble_offset = g_WibbleOffset;
+
+    for (int32_t i = 0; i < mesh->num_vertices; i++) {
+        int16_t shade = mesh->vertices[i].light_adder;
+        if (is_water) {
+            shade += m_ShadesTable
+                [(wibble_offset
+                  + (uint8_t)
+                      m_RandomTable[(mesh->num_vertices - i) % WIBBLE_SIZE])
+                 % WIBBLE_SIZE];
+        }
+        if (fog[i] == ROOM_VERTEX_FOG_FAR) {
+            shade = 0x1FFF;
+        } else {
+            shade += fog[i];
+        }
         CLAMP(shade, 0, 0x1FFF);
-        vbuf->g = shade;
-        vbuf->clip = clip_flags;
+        g_PhdVBuf[i].g = shade;
+    }
+}
+
+static void M_PrepareRoomVertices(
+    const int16_t room_num, const ROOM_MESH *const mesh)
+{
+    const M_ROOM_VERTEX_KEY key = {
+        .vertices = mesh->vertices,
+        .num_vertices = mesh->num_vertices,
+        .matrix = *g_MatrixPtr,
+        .base_z = g_Config.rendering.enable_zbuffer
+            ? 0.0
+            : (g_MidSort << (W2V_SHIFT + 8)),
+        .near_z = g_FltNearZ,
+        .far_z = g_FltFarZ,
+        .persp = g_FltPersp,
+        .rhw_o_persp = g_FltRhwOPersp,
+        .win_left = g_FltWinLeft,
+        .win_top = g_FltWinTop,
+        .win_right = g_FltWinRight,
+        .win_bottom = g_FltWinBottom,
+        .win_center_x = g_FltWinCenterX,
+        .win_center_y = g_FltWinCenterY,
+    };
+
+    M_ROOM_VERTEX_CACHE *const cache = M_GetRoomVertexCache(room_num);
+    const size_t vbuf_size = sizeof(PHD_VBUF) * mesh->num_vertices;
+    if (cache->valid && M_RoomVertexKeyEquals(&cache->key, &key)) {
+        memcpy(g_PhdVBuf, cache->vbufs, vbuf_size);
+        m_RoomVertexCacheStats.hits++;
+    } else {
+        if (cache->capacity < mesh->num_vertices) {
+            m_RoomVertexCacheStats.bytes -=
+                cache->capacity * (sizeof(PHD_VBUF) + sizeof(int16_t));
+            cache->capacity = mesh->num_vertices;
+            cache->vbufs = Memory_Realloc(cache->vbufs, vbuf_size);
+            cache->fog = Memory_Realloc(
+                cache->fog, sizeof(int16_t) * mesh->num_vertices);
+            m_RoomVertexCacheStats.bytes +=
+                cache->capacity * (sizeof(PHD_VBUF) + sizeof(int16_t));
+        }
+        M_CalcRoomVertices(mesh, &key, cache->fog);
+        memcpy(cache->vbufs, g_PhdVBuf, vbuf_size);
+        cache->key = key;
+        cache->valid = true;
+        m_RoomVertexCacheStats.misses++;
     }
+
+    M_ShadeRoomVertices(mesh, cache->fog);
 }
 
 static void M_CalcRoomVerticesWibble(const ROOM_MESH *const mesh)
@@ -426,7 +570,7 @@ void Output_DrawObjectMesh_I(const OBJECT_MESH *const mesh, const int32_t clip)
     Matrix_Pop();
 }
 
-void Output_DrawRoom(const ROOM_MESH *const mesh, const bool is_outside)
+void Output_DrawRoom(const int16_t room_num, const ROOM_MESH *const mesh)
 {
     g_FltWinLeft = g_PhdWinLeft;
     g_FltWinTop = g_PhdWinTop;
@@ -435,7 +579,7 @@ void Output_DrawRoom(const ROOM_MESH *const mesh, const bool is_outside)
     g_FltWinCenterX = g_PhdWinCenterX;
     g_FltWinCenterY = g_PhdWinCenterY;
 
-    M_CalcRoomVertices(mesh, is_outside ? 0 : 16);
+    M_PrepareRoomVertices(room_num, mesh);
 
     if (g_IsWibbleEffect) {
         Render_EnableZBuffer(false, true);
@@ -821,6 +965,29 @@ void Output_CalculateWibbleTable(void)
     }
 }
 
+void Output_ClearRoomVertexCache(void)
+{
+    for (int32_t i = 0; i < m_RoomVertexCacheCount; i++) {
+        M_ROOM_VERTEX_CACHE *const cache = &m_RoomVertexCache[i];
+        Memory_FreePointer(&cache->vbufs);
+        Memory_FreePointer(&cache->fog);
+    }
+    Memory_FreePointer(&m_RoomVertexCache);
+    m_RoomVertexCacheCount = 0;
+    m_RoomVertexCacheStats.bytes = 0;
+}
+
+void Output_ResetRoomVertexCacheStats(void)
+{
+    m_RoomVertexCacheStats.hits = 0;
+    m_RoomVertexCacheStats.misses = 0;
+}
+
+OUTPUT_ROOM_VERTEX_CACHE_STATS Output_GetRoomVertexCacheStats(void)
+{
+    return m_RoomVertexCacheStats;
+}
+
 int32_t Output_GetObjectBounds(const BOUNDS_16 *const bounds)
 {
     const MATRIX *const m = g_MatrixPtr;
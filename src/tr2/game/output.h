@@ -4,6 +4,7 @@
 
 #include <libtrx/game/output.h>
 
+#include <stddef.h>
 #include <stdint.h>
 
 typedef struct {
@@ -16,9 +17,15 @@ typedef struct {
     float g;
 } VERTEX_INFO;
 
+typedef struct {
+    uint32_t hits;
+    uint32_t misses;
+    size_t bytes;
+} OUTPUT_ROOM_VERTEX_CACHE_STATS;
+
 void Output_DrawObjectMesh(const OBJECT_MESH *mesh, int32_t clip);
 void Output_DrawObjectMesh_I(const OBJECT_MESH *mesh, int32_t clip);
-void Output_DrawRoom(const ROOM_MESH *mesh, bool is_outside);
+void Output_DrawRoom(int16_t room_num, const ROOM_MESH *mesh);
 void Output_DrawSkybox(const OBJECT_MESH *mesh);
 
 void Output_InsertClippedPoly_Textured(
@@ -73,6 +80,11 @@ void Output_InsertShadow(
     int16_t radius, const BOUNDS_16 *bounds, const ITEM *item);
 
 void Output_CalculateWibbleTable(void);
+
+// Room vertices are projected once and reused while the view stays the same.
+void Output_ClearRoomVertexCache(void);
+void Output_ResetRoomVertexCacheStats(void);
+OUTPUT_ROOM_VERTEX_CACHE_STATS Output_GetRoomVertexCacheStats(void);
 int32_t Output_GetObjectBounds(const BOUNDS_16 *bounds);
 void Output_SetupBelowWater(bool is_underwater);
 void Output_SetupAboveWater(bool is_underwater);
@@ -418,3 +418,16 @@ void Render_SetWet(const bool is_wet)
         r->SetWet(r, is_wet);
     }
 }
+
+RENDER_SW_STATS Render_GetSWStats(void)
+{
+    if (M_GetRenderer() != &m_Renderer_SW) {
+        return (RENDER_SW_STATS) {};
+    }
+    return Renderer_SW_GetStats(&m_Renderer_SW);
+}
+
+void Render_ResetSWStats(void)
+{
+    Renderer_SW_ResetStats(&m_Renderer_SW);
+}
@@ -24,6 +24,13 @@ typedef enum {
     // clang-format on
 } RENDER_RESET_FLAGS;
 
+typedef struct {
+    int32_t threads;
+    int32_t bands;
+    int32_t frames;
+    double time_ms;
+} RENDER_SW_STATS;
+
 void Render_Init(void);
 void Render_Shutdown(void);
 
@@ -48,6 +55,11 @@ void Render_ClearZBuffer(void);
 void Render_EnableZBuffer(bool z_write_enable, bool z_test_enable);
 void Render_SetWet(bool is_wet);
 
+// Rasterization time of the software renderer since the last reset. Empty
+// while the hardware renderer is in use.
+RENDER_SW_STATS Render_GetSWStats(void);
+void Render_ResetSWStats(void);
+
 // TODO: there's too much repetition for these
 void Render_InsertFlatFace3s(
     const FACE3 *faces, int32_t num, SORT_TYPE sort_type);
@@ -4,12 +4,23 @@
 
 #include <libtrx/config.h>
 #include <libtrx/game/game_buf.h>
+#include <libtrx/memory.h>
 #include <libtrx/utils.h>
 
+#include <string.h>
+
+#define SORT_RADIX_BITS 8
+#define SORT_RADIX_SIZE (1 << SORT_RADIX_BITS)
+#define SORT_RADIX_MASK (SORT_RADIX_SIZE - 1)
+#define SORT_RADIX_PASSES (32 / SORT_RADIX_BITS)
+
 bool g_DiscardTransparent = false;
 static uint8_t *m_LabTextureUVFlag = nullptr;
+static SORT_ITEM *m_SortScratch = nullptr;
+static int32_t m_SortScratchSize = 0;
 
-static void M_QuickSort(int32_t left, int32_t right);
+static inline uint32_t M_GetSortKey(const SORT_ITEM *item);
+static void M_RadixSort(int32_t count);
 static inline void M_ClipG(
     VERTEX_INFO *buf, const VERTEX_INFO *vtx1, const VERTEX_INFO *vtx2,
     float clip);
@@ -17,35 +28,64 @@ static inline void M_ClipGUV(
     VERTEX_INFO *buf, const VERTEX_INFO *vtx1, const VERTEX_INFO *vtx2,
     float clip);
 
-static void M_QuickSort(const int32_t left, const int32_t right)
+static inline uint32_t M_GetSortKey(const SORT_ITEM *const item)
 {
-    const int32_t compare = g_SortBuffer[(left + right) / 2]._1;
-    int32_t i = left;
-    int32_t j = right;
+    // Map the signed depth to an unsigned key that puts far polygons first.
+    return ~((uint32_t)item->_1 ^ 0x80000000);
+}
 
-    do {
-        while ((i < right) && (g_SortBuffer[i]._1 > compare)) {
-            i++;
-        }
-        while ((left < j) && (compare > g_SortBuffer[j]._1)) {
-            j--;
+static void M_RadixSort(const int32_t count)
+{
+    if (count > m_SortScratchSize) {
+        m_SortScratchSize = count;
+        m_SortScratch =
+            Memory_Realloc(m_SortScratch, sizeof(SORT_ITEM) * count);
+    }
+
+    uint32_t histograms[SORT_RADIX_PASSES][SORT_RADIX_SIZE] = {};
+    for (int32_t i = 0; i < count; i++) {
+        const uint32_t key = M_GetSortKey(&g_SortBuffer[i]);
+        for (int32_t pass = 0; pass < SORT_RADIX_PASSES; pass++) {
+            const uint32_t digit =
+                (key >> (pass * SORT_RADIX_BITS)) & SORT_RADIX_MASK;
+            histograms[pass][digit]++;
         }
-        if (i > j) {
-            break;
+    }
+
+    SORT_ITEM *src = g_SortBuffer;
+    SORT_ITEM *dst = m_SortScratch;
+    for (int32_t pass = 0; pass < SORT_RADIX_PASSES; pass++) {
+        const int32_t shift = pass * SORT_RADIX_BITS;
+        uint32_t *const histogram = histograms[pass];
+
+        // Depths rarely span the full key range, so the top digits are
+        // usually shared by every polygon and the pass can be skipped.
+        const uint32_t first_digit =
+            (M_GetSortKey(&src[0]) >> shift) & SORT_RADIX_MASK;
+        if (histogram[first_digit] == (uint32_t)count) {
+            continue;
         }
 
-        SORT_ITEM tmp_item;
-        SWAP(g_SortBuffer[i], g_SortBuffer[j], tmp_item);
+        uint32_t offset = 0;
+        for (int32_t i = 0; i < SORT_RADIX_SIZE; i++) {
+            const uint32_t digit_count = histogram[i];
+            histogram[i] = offset;
+            offset += digit_count;
+        }
 
-        i++;
-        j--;
-    } while (i <= j);
+        for (int32_t i = 0; i < count; i++) {
+            const uint32_t digit =
+                (M_GetSortKey(&src[i]) >> shift) & SORT_RADIX_MASK;
+            dst[histogram[digit]++] = src[i];
+        }
 
-    if (left < j) {
-        M_QuickSort(left, j);
+        SORT_ITEM *const tmp = src;
+        src = dst;
+        dst = tmp;
     }
-    if (i < right) {
-        M_QuickSort(i, right);
+
+    if (src != g_SortBuffer) {
+        memcpy(g_SortBuffer, src, sizeof(SORT_ITEM) * count);
     }
 }
 
@@ -100,7 +140,7 @@ void Render_SortPolyList(void)
         for (int32_t i = 0; i < g_SurfaceCount; i++) {
             g_SortBuffer[i]._1 += i;
         }
-        M_QuickSort(0, g_SurfaceCount - 1);
+        M_RadixSort(g_SurfaceCount);
     }
 }
 
@@ -3,19 +3,25 @@
 #include "decomp/decomp.h"
 #include "game/output.h"
 #include "game/render/priv.h"
+#include "game/render/swr_span.h"
 #include "global/vars.h"
 
 #include <libtrx/benchmark.h>
+#include <libtrx/config.h>
 #include <libtrx/debug.h>
 #include <libtrx/memory.h>
+#include <libtrx/thread_pool.h>
 #include <libtrx/utils.h>
 
+#include <SDL2/SDL_timer.h>
+
 #define MAKE_Q_ID(g) ((g >> 16) & 0xFF)
 #define MAKE_TEX_ID(v, u) ((((v >> 16) & 0xFF) << 8) | ((u >> 16) & 0xFF))
 #define MAKE_PAL_IDX(c) (c)
 #define PIX_FMT uint8_t
 #define PIX_FMT_GL GL_UNSIGNED_BYTE
 #define ALPHA_FMT uint8_t
+#define BANDS_PER_WORKER 4
 
 typedef enum {
     POLY_GTMAP,
@@ -29,11 +35,41 @@ typedef enum {
     POLY_SPRITE,
 } POLY_TYPE;
 
+// Rasterization state private to a single worker. Each worker scan-converts
+// polygons into its own X buffer and only touches the rows between clip_y1
+// (inclusive) and clip_y2 (exclusive).
+typedef struct {
+    void *xbuffer;
+    int32_t xgen_y1;
+    int32_t xgen_y2;
+    int32_t clip_y1;
+    int32_t clip_y2;
+} M_CONTEXT;
+
+typedef struct {
+    int32_t y1;
+    int32_t y2;
+    int32_t count;
+    int32_t *polys;
+} M_BAND;
+
 typedef struct {
     GFX_2D_RENDERER *renderer_2d;
     GFX_2D_SURFACE *surface;
     GFX_2D_SURFACE *surface_alpha;
     GFX_COLOR palette[256];
+
+    THREAD_POOL *pool;
+    int32_t num_contexts;
+    M_CONTEXT *contexts;
+    int32_t num_bands;
+    int32_t band_capacity;
+    M_BAND *bands;
+
+    struct {
+        int32_t frames;
+        Uint64 ticks;
+    } stats;
 } M_PRIV;
 
 #pragma pack(push, 1)
@@ -103,64 +139,73 @@ typedef struct {
 #pragma pack(pop)
 
 static VERTEX_INFO m_VBuffer[32] = {};
-static void *m_XBuffer = nullptr;
-static int32_t m_XGenY1 = 0;
-static int32_t m_XGenY2 = 0;
 
 static void M_FlatA(
-    GFX_2D_SURFACE *alpha_surface, GFX_2D_SURFACE *target_surface, int32_t y1,
-    int32_t y2, uint8_t color_idx);
+    const M_CONTEXT *ctx, GFX_2D_SURFACE *alpha_surface,
+    GFX_2D_SURFACE *target_surface, int32_t y1, int32_t y2, uint8_t color_idx);
 static void M_TransA(
-    GFX_2D_SURFACE *alpha_surface, GFX_2D_SURFACE *target_surface, int32_t y1,
-    int32_t y2, uint8_t depth);
+    const M_CONTEXT *ctx, GFX_2D_SURFACE *alpha_surface,
+    GFX_2D_SURFACE *target_surface, int32_t y1, int32_t y2, uint8_t depth);
 static void M_GourA(
-    GFX_2D_SURFACE *alpha_surface, GFX_2D_SURFACE *target_surface, int32_t y1,
-    int32_t y2, uint8_t color_idx);
+    const M_CONTEXT *ctx, GFX_2D_SURFACE *alpha_surface,
+    GFX_2D_SURFACE *target_surface, int32_t y1, int32_t y2, uint8_t color_idx);
 static void M_GTMapA(
-    GFX_2D_SURFACE *alpha_surface, GFX_2D_SURFACE *target_surface, int32_t y1,
-    int32_t y2, const uint8_t *tex_page);
+    const M_CONTEXT *ctx, GFX_2D_SURFACE *alpha_surface,
+    GFX_2D_SURFACE *target_surface, int32_t y1, int32_t y2,
+    const uint8_t *tex_page);
 static void M_WGTMapA(
-    GFX_2D_SURFACE *alpha_surface, GFX_2D_SURFACE *target_surface, int32_t y1,
-    int32_t y2, const uint8_t *tex_page);
+    const M_CONTEXT *ctx, GFX_2D_SURFACE *alpha_surface,
+    GFX_2D_SURFACE *target_surface, int32_t y1, int32_t y2,
+    const uint8_t *tex_page);
 static void M_GTMapPersp32FP(
-    GFX_2D_SURFACE *alpha_surface, GFX_2D_SURFACE *target_surface, int32_t y1,
-    int32_t y2, const uint8_t *tex_page);
+    const M_CONTEXT *ctx, GFX_2D_SURFACE *alpha_surface,
+    GFX_2D_SURFACE *target_surface, int32_t y1, int32_t y2,
+    const uint8_t *tex_page);
 static void M_WGTMapPersp32FP(
-    GFX_2D_SURFACE *alpha_surface, GFX_2D_SURFACE *target_surface, int32_t y1,
-    int32_t y2, const uint8_t *tex_page);
+    const M_CONTEXT *ctx, GFX_2D_SURFACE *alpha_surface,
+    GFX_2D_SURFACE *target_surface, int32_t y1, int32_t y2,
+    const uint8_t *tex_page);
 
-static bool M_XGenX(const int16_t *obj_ptr);
-static bool M_XGenXG(const int16_t *obj_ptr);
-static bool M_XGenXGUV(const int16_t *obj_ptr);
+static bool M_XGenX(M_CONTEXT *ctx, const int16_t *obj_ptr);
+static bool M_XGenXG(M_CONTEXT *ctx, const int16_t *obj_ptr);
+static bool M_XGenXGUV(M_CONTEXT *ctx, const int16_t *obj_ptr);
 
 static void M_DrawPolyFlat(
-    const int16_t *obj_ptr, GFX_2D_SURFACE *target_surface,
+    M_CONTEXT *ctx, const int16_t *obj_ptr, GFX_2D_SURFACE *target_surface,
     GFX_2D_SURFACE *alpha_surface);
 static void M_DrawPolyTrans(
-    const int16_t *obj_ptr, GFX_2D_SURFACE *target_surface,
+    M_CONTEXT *ctx, const int16_t *obj_ptr, GFX_2D_SURFACE *target_surface,
     GFX_2D_SURFACE *alpha_surface);
 static void M_DrawPolyGouraud(
-    const int16_t *obj_ptr, GFX_2D_SURFACE *target_surface,
+    M_CONTEXT *ctx, const int16_t *obj_ptr, GFX_2D_SURFACE *target_surface,
     GFX_2D_SURFACE *alpha_surface);
 static void M_DrawPolyGTMap(
-    const int16_t *obj_ptr, GFX_2D_SURFACE *target_surface,
+    M_CONTEXT *ctx, const int16_t *obj_ptr, GFX_2D_SURFACE *target_surface,
     GFX_2D_SURFACE *alpha_surface);
 static void M_DrawPolyWGTMap(
-    const int16_t *obj_ptr, GFX_2D_SURFACE *target_surface,
+    M_CONTEXT *ctx, const int16_t *obj_ptr, GFX_2D_SURFACE *target_surface,
     GFX_2D_SURFACE *alpha_surface);
 static void M_DrawPolyGTMapPersp(
-    const int16_t *obj_ptr, GFX_2D_SURFACE *target_surface,
+    M_CONTEXT *ctx, const int16_t *obj_ptr, GFX_2D_SURFACE *target_surface,
     GFX_2D_SURFACE *alpha_surface);
 static void M_DrawPolyWGTMapPersp(
-    const int16_t *obj_ptr, GFX_2D_SURFACE *target_surface,
+    M_CONTEXT *ctx, const int16_t *obj_ptr, GFX_2D_SURFACE *target_surface,
     GFX_2D_SURFACE *alpha_surface);
 static void M_DrawPolyLine(
-    const int16_t *obj_ptr, GFX_2D_SURFACE *target_surface,
+    M_CONTEXT *ctx, const int16_t *obj_ptr, GFX_2D_SURFACE *target_surface,
     GFX_2D_SURFACE *alpha_surface);
 static void M_DrawScaledSpriteC(
-    const int16_t *obj_ptr, GFX_2D_SURFACE *target_surface,
+    M_CONTEXT *ctx, const int16_t *obj_ptr, GFX_2D_SURFACE *target_surface,
     GFX_2D_SURFACE *alpha_surface);
 
+static int32_t M_GetWorkerCount(void);
+static void M_OpenWorkers(M_PRIV *priv);
+static void M_CloseWorkers(M_PRIV *priv);
+static bool M_GetPolyBounds(const int16_t *obj_ptr, int32_t *y1, int32_t *y2);
+static void M_BinPolyList(M_PRIV *priv);
+static void M_DrawPoly(M_PRIV *priv, M_CONTEXT *ctx, int32_t sort_idx);
+static void M_DrawBand(void *user_data, int32_t band_idx, int32_t worker_idx);
+
 static void M_InsertFlatFace3s(
     RENDERER *const renderer, const FACE3 *faces, int32_t num,
     SORT_TYPE sort_type);
@@ -187,7 +232,7 @@ static void M_InsertSprite(
     int32_t y1, int32_t sprite_idx, const int16_t shade);
 
 static void (*m_PolyDrawRoutines[])(
-    const int16_t *, GFX_2D_SURFACE *, GFX_2D_SURFACE *) = {
+    M_CONTEXT *, const int16_t *, GFX_2D_SURFACE *, GFX_2D_SURFACE *) = {
     // clang-format off
     [POLY_GTMAP]        = M_DrawPolyGTMap,
     [POLY_WGTMAP]       = M_DrawPolyWGTMap,
@@ -202,15 +247,16 @@ static void (*m_PolyDrawRoutines[])(
 };
 
 static void M_FlatA(
-    GFX_2D_SURFACE *const alpha_surface, GFX_2D_SURFACE *const target_surface,
-    int32_t y1, int32_t y2, const uint8_t color_idx)
+    const M_CONTEXT *const ctx, GFX_2D_SURFACE *const alpha_surface,
+    GFX_2D_SURFACE *const target_surface, int32_t y1, int32_t y2,
+    const uint8_t color_idx)
 {
     int32_t y_size = y2 - y1;
     if (y_size <= 0) {
         return;
     }
 
-    const XBUF_X *xbuf = (const XBUF_X *)m_XBuffer + y1;
+    const XBUF_X *xbuf = (const XBUF_X *)ctx->xbuffer + y1;
     const int32_t target_stride = target_surface->desc.pitch;
     const int32_t alpha_stride = alpha_surface->desc.pitch;
     PIX_FMT *target_ptr = target_surface->buffer + y1 * target_stride;
@@ -233,15 +279,16 @@ static void M_FlatA(
 }
 
 static void M_TransA(
-    GFX_2D_SURFACE *alpha_surface, GFX_2D_SURFACE *const target_surface,
-    const int32_t y1, const int32_t y2, const uint8_t depth)
+    const M_CONTEXT *const ctx, GFX_2D_SURFACE *alpha_surface,
+    GFX_2D_SURFACE *const target_surface, const int32_t y1, const int32_t y2,
+    const uint8_t depth)
 {
     int32_t y_size = y2 - y1;
     if (y_size <= 0 || depth >= LIGHT_MAP_SIZE) {
         return;
     }
 
-    const XBUF_X *xbuf = (const XBUF_X *)m_XBuffer + y1;
+    const XBUF_X *xbuf = (const XBUF_X *)ctx->xbuffer + y1;
     const int32_t target_stride = target_surface->desc.pitch;
     const int32_t alpha_stride = alpha_surface->desc.pitch;
     PIX_FMT *target_ptr = target_surface->buffer + y1 * target_stride;
@@ -273,15 +320,16 @@ static void M_TransA(
 }
 
 static void M_GourA(
-    GFX_2D_SURFACE *alpha_surface, GFX_2D_SURFACE *const target_surface,
-    const int32_t y1, const int32_t y2, const uint8_t color_idx)
+    const M_CONTEXT *const ctx, GFX_2D_SURFACE *alpha_surface,
+    GFX_2D_SURFACE *const target_surface, const int32_t y1, const int32_t y2,
+    const uint8_t color_idx)
 {
     int32_t y_size = y2 - y1;
     if (y_size <= 0) {
         return;
     }
 
-    const XBUF_XG *xbuf = (const XBUF_XG *)m_XBuffer + y1;
+    const XBUF_XG *xbuf = (const XBUF_XG *)ctx->xbuffer + y1;
     const int32_t target_stride = target_surface->desc.pitch;
     const int32_t alpha_stride = alpha_surface->desc.pitch;
     PIX_FMT *target_ptr = target_surface->buffer + y1 * target_stride;
@@ -316,19 +364,21 @@ static void M_GourA(
 }
 
 static void M_GTMapA(
-    GFX_2D_SURFACE *const alpha_surface, GFX_2D_SURFACE *const target_surface,
-    const int32_t y1, const int32_t y2, const uint8_t *const tex_page)
+    const M_CONTEXT *const ctx, GFX_2D_SURFACE *const alpha_surface,
+    GFX_2D_SURFACE *const target_surface, const int32_t y1, const int32_t y2,
+    const uint8_t *const tex_page)
 {
     int32_t y_size = y2 - y1;
     if (y_size <= 0) {
         return;
     }
 
-    const XBUF_XGUV *xbuf = (const XBUF_XGUV *)m_XBuffer + y1;
+    const XBUF_XGUV *xbuf = (const XBUF_XGUV *)ctx->xbuffer + y1;
     const int32_t target_stride = target_surface->desc.pitch;
     const int32_t alpha_stride = alpha_surface->desc.pitch;
     PIX_FMT *target_ptr = target_surface->buffer + y1 * target_stride;
     ALPHA_FMT *alpha_ptr = alpha_surface->buffer + y1 * alpha_stride;
+    const LIGHT_MAP *const light_maps = Output_GetLightMap(0);
 
     while (y_size > 0) {
         const int32_t x = xbuf->x1 / PHD_ONE;
@@ -337,25 +387,20 @@ static void M_GTMapA(
             goto loop_end;
         }
 
-        int32_t g = xbuf->g1;
-        int32_t u = xbuf->u1;
-        int32_t v = xbuf->v1;
-        const int32_t g_add = (xbuf->g2 - g) / x_size;
-        const int32_t u_add = (xbuf->u2 - u) / x_size;
-        const int32_t v_add = (xbuf->v2 - v) / x_size;
-
-        PIX_FMT *target_line_ptr = target_ptr + x;
-        ALPHA_FMT *alpha_line_ptr = alpha_ptr + x;
-        while (x_size > 0) {
-            uint8_t color_idx = tex_page[MAKE_TEX_ID(v, u)];
-            *target_line_ptr++ = MAKE_PAL_IDX(
-                Output_GetLightMap(MAKE_Q_ID(g))->index[color_idx]);
-            *alpha_line_ptr++ = 255;
-            g += g_add;
-            u += u_add;
-            v += v_add;
-            x_size--;
-        }
+        const SWR_SPAN span = {
+            .target = target_ptr + x,
+            .alpha = alpha_ptr + x,
+            .tex_page = tex_page,
+            .light_maps = light_maps,
+            .num_pixels = x_size,
+            .g = xbuf->g1,
+            .g_add = (xbuf->g2 - xbuf->g1) / x_size,
+            .u = xbuf->u1,
+            .u_add = (xbuf->u2 - xbuf->u1) / x_size,
+            .v = xbuf->v1,
+            .v_add = (xbuf->v2 - xbuf->v1) / x_size,
+        };
+        SWR_Span_Draw(&span, false);
 
     loop_end:
         y_size--;
@@ -366,19 +411,21 @@ static void M_GTMapA(
 }
 
 static void M_WGTMapA(
-    GFX_2D_SURFACE *alpha_surface, GFX_2D_SURFACE *target_surface,
-    const int32_t y1, const int32_t y2, const uint8_t *tex_page)
+    const M_CONTEXT *const ctx, GFX_2D_SURFACE *alpha_surface,
+    GFX_2D_SURFACE *target_surface, const int32_t y1, const int32_t y2,
+    const uint8_t *tex_page)
 {
     int32_t y_size = y2 - y1;
     if (y_size <= 0) {
         return;
     }
 
-    const XBUF_XGUV *xbuf = (const XBUF_XGUV *)m_XBuffer + y1;
+    const XBUF_XGUV *xbuf = (const XBUF_XGUV *)ctx->xbuffer + y1;
     const int32_t target_stride = target_surface->desc.pitch;
     const int32_t alpha_stride = alpha_surface->desc.pitch;
     PIX_FMT *target_ptr = target_surface->buffer + y1 * target_stride;
     ALPHA_FMT *alpha_ptr = alpha_surface->buffer + y1 * alpha_stride;
+    const LIGHT_MAP *const light_maps = Output_GetLightMap(0);
 
     while (y_size > 0) {
         const int32_t x = xbuf->x1 / PHD_ONE;
@@ -387,29 +434,20 @@ static void M_WGTMapA(
             goto loop_end;
         }
 
-        int32_t g = xbuf->g1;
-        int32_t u = xbuf->u1;
-        int32_t v = xbuf->v1;
-        const int32_t g_add = (xbuf->g2 - g) / x_size;
-        const int32_t u_add = (xbuf->u2 - u) / x_size;
-        const int32_t v_add = (xbuf->v2 - v) / x_size;
-
-        PIX_FMT *target_line_ptr = target_ptr + x;
-        ALPHA_FMT *alpha_line_ptr = alpha_ptr + x;
-        while (x_size > 0) {
-            const uint8_t color_idx = tex_page[MAKE_TEX_ID(v, u)];
-            if (color_idx != 0) {
-                *target_line_ptr = MAKE_PAL_IDX(
-                    Output_GetLightMap(MAKE_Q_ID(g))->index[color_idx]);
-                *alpha_line_ptr = 255;
-            }
-            target_line_ptr++;
-            alpha_line_ptr++;
-            g += g_add;
-            u += u_add;
-            v += v_add;
-            x_size--;
-        }
+        const SWR_SPAN span = {
+            .target = target_ptr + x,
+            .alpha = alpha_ptr + x,
+            .tex_page = tex_page,
+            .light_maps = light_maps,
+            .num_pixels = x_size,
+            .g = xbuf->g1,
+            .g_add = (xbuf->g2 - xbuf->g1) / x_size,
+            .u = xbuf->u1,
+            .u_add = (xbuf->u2 - xbuf->u1) / x_size,
+            .v = xbuf->v1,
+            .v_add = (xbuf->v2 - xbuf->v1) / x_size,
+        };
+        SWR_Span_Draw(&span, true);
 
     loop_end:
         y_size--;
@@ -419,163 +457,63 @@ static void M_WGTMapA(
     }
 }
 
-static void M_GTMapPersp32FP(
-    GFX_2D_SURFACE *alpha_surface, GFX_2D_SURFACE *const target_surface,
-    const int32_t y1, const int32_t y2, const uint8_t *const tex_page)
+static inline void M_DrawPerspRun(
+    PIX_FMT *const target_ptr, ALPHA_FMT *const alpha_ptr,
+    const uint8_t *const tex_page, const LIGHT_MAP *const light_maps,
+    const bool transparent, const int32_t num_pixels, int32_t g,
+    const int32_t g_add, int32_t u, const int32_t u_add, int32_t v,
+    const int32_t v_add)
 {
-    int32_t y_size = y2 - y1;
-    if (y_size <= 0) {
-        return;
-    }
-
-    const XBUF_XGUVP *xbuf = (const XBUF_XGUVP *)m_XBuffer + y1;
-    const int32_t target_stride = target_surface->desc.pitch;
-    const int32_t alpha_stride = alpha_surface->desc.pitch;
-    PIX_FMT *target_ptr = target_surface->buffer + y1 * target_stride;
-    ALPHA_FMT *alpha_ptr = alpha_surface->buffer + y1 * alpha_stride;
-
-    while (y_size > 0) {
-        const int32_t x = xbuf->x1 / PHD_ONE;
-        int32_t x_size = (xbuf->x2 / PHD_ONE) - x;
-        if (x_size <= 0) {
-            goto loop_end;
-        }
-
-        int32_t g = xbuf->g1;
-        double u = xbuf->u1;
-        double v = xbuf->v1;
-        double rhw = xbuf->rhw1;
-
-        const int32_t g_add = (xbuf->g2 - g) / x_size;
-
-        int32_t u0 = PHD_HALF * u / rhw;
-        int32_t v0 = PHD_HALF * v / rhw;
-
-        PIX_FMT *target_line_ptr = target_ptr + x;
-        ALPHA_FMT *alpha_line_ptr = alpha_ptr + x;
-        int32_t batch_size = 32;
-
-        if (x_size >= batch_size) {
-            const double u_add =
-                (xbuf->u2 - u) / (double)x_size * (double)batch_size;
-            const double v_add =
-                (xbuf->v2 - v) / (double)x_size * (double)batch_size;
-            const double rhw_add =
-                (xbuf->rhw2 - rhw) / (double)x_size * (double)batch_size;
-
-            while (x_size >= batch_size) {
-                u += u_add;
-                v += v_add;
-                rhw += rhw_add;
-
-                const int32_t u1 = PHD_HALF * u / rhw;
-                const int32_t v1 = PHD_HALF * v / rhw;
-
-                const int32_t u0_add = (u1 - u0) / batch_size;
-                const int32_t v0_add = (v1 - v0) / batch_size;
-
-                if ((ABS(u0_add) + ABS(v0_add)) < (PHD_ONE / 2)) {
-                    int32_t batch_counter = batch_size / 2;
-                    while (batch_counter--) {
-                        const uint8_t color_idx = tex_page[MAKE_TEX_ID(v0, u0)];
-                        const uint8_t color =
-                            Output_GetLightMap(MAKE_Q_ID(g))->index[color_idx];
-                        *target_line_ptr++ = MAKE_PAL_IDX(color);
-                        *target_line_ptr++ = MAKE_PAL_IDX(color);
-                        *alpha_line_ptr++ = 255;
-                        *alpha_line_ptr++ = 255;
-                        g += g_add * 2;
-                        u0 += u0_add * 2;
-                        v0 += v0_add * 2;
-                    }
-                } else {
-                    int32_t batch_counter = batch_size;
-                    while (batch_counter--) {
-                        const uint8_t color_idx = tex_page[MAKE_TEX_ID(v0, u0)];
-                        const uint8_t color =
-                            Output_GetLightMap(MAKE_Q_ID(g))->index[color_idx];
-                        *target_line_ptr++ = MAKE_PAL_IDX(color);
-                        *alpha_line_ptr++ = 255;
-                        g += g_add;
-                        u0 += u0_add;
-                        v0 += v0_add;
-                    }
-                }
-
-                u0 = u1;
-                v0 = v1;
-                x_size -= batch_size;
-            }
-        }
-
-        if (x_size > 1) {
-            const int32_t u1 = PHD_HALF * xbuf->u2 / xbuf->rhw2;
-            const int32_t v1 = PHD_HALF * xbuf->v2 / xbuf->rhw2;
-            const int32_t u0_add = (u1 - u0) / x_size;
-            const int32_t v0_add = (v1 - v0) / x_size;
-
-            batch_size = x_size & ~1;
-            x_size -= batch_size;
-
-            if ((ABS(u0_add) + ABS(v0_add)) < (PHD_ONE / 2)) {
-                int32_t batch_counter = batch_size / 2;
-                while (batch_counter--) {
-                    const uint8_t color_idx = tex_page[MAKE_TEX_ID(v0, u0)];
-                    const uint8_t color =
-                        Output_GetLightMap(MAKE_Q_ID(g))->index[color_idx];
-                    *target_line_ptr++ = MAKE_PAL_IDX(color);
-                    *target_line_ptr++ = MAKE_PAL_IDX(color);
-                    *alpha_line_ptr++ = 255;
-                    *alpha_line_ptr++ = 255;
-                    g += g_add * 2;
-                    u0 += u0_add * 2;
-                    v0 += v0_add * 2;
-                }
-            } else {
-                int32_t batch_counter = batch_size;
-                while (batch_counter--) {
-                    const uint8_t color_idx = tex_page[MAKE_TEX_ID(v0, u0)];
-                    const uint8_t color =
-                        Output_GetLightMap(MAKE_Q_ID(g))->index[color_idx];
-                    *target_line_ptr++ = MAKE_PAL_IDX(color);
-                    *alpha_line_ptr++ = 255;
-                    g += g_add;
-                    u0 += u0_add;
-                    v0 += v0_add;
-                }
+    // Magnified texels are stretched over pixel pairs to halve the lookups.
+    // num_pixels is always even in this case.
+    if ((ABS(u_add) + ABS(v_add)) < (PHD_ONE / 2)) {
+        for (int32_t i = 0; i < num_pixels; i += 2) {
+            const uint8_t color_idx = tex_page[MAKE_TEX_ID(v, u)];
+            if (!transparent || color_idx != 0) {
+                const uint8_t color = light_maps[MAKE_Q_ID(g)].index[color_idx];
+                target_ptr[i] = MAKE_PAL_IDX(color);
+                target_ptr[i + 1] = MAKE_PAL_IDX(color);
+                alpha_ptr[i] = 255;
+                alpha_ptr[i + 1] = 255;
             }
+            g += g_add * 2;
+            u += u_add * 2;
+            v += v_add * 2;
         }
-
-        if (x_size == 1) {
-            const uint8_t color_idx = tex_page[MAKE_TEX_ID(v0, u0)];
-            const uint8_t color =
-                Output_GetLightMap(MAKE_Q_ID(g))->index[color_idx];
-            *target_line_ptr = MAKE_PAL_IDX(color);
-            *alpha_line_ptr = 255;
-        }
-
-    loop_end:
-        y_size--;
-        xbuf++;
-        target_ptr += target_stride;
-        alpha_ptr += alpha_stride;
+    } else {
+        const SWR_SPAN span = {
+            .target = target_ptr,
+            .alpha = alpha_ptr,
+            .tex_page = tex_page,
+            .light_maps = light_maps,
+            .num_pixels = num_pixels,
+            .g = g,
+            .g_add = g_add,
+            .u = u,
+            .u_add = u_add,
+            .v = v,
+            .v_add = v_add,
+        };
+        SWR_Span_Draw(&span, transparent);
     }
 }
 
-static void M_WGTMapPersp32FP(
-    GFX_2D_SURFACE *alpha_surface, GFX_2D_SURFACE *const target_surface,
-    const int32_t y1, const int32_t y2, const uint8_t *const tex_page)
+static inline void M_DrawPerspSpans(
+    const M_CONTEXT *const ctx, GFX_2D_SURFACE *const alpha_surface,
+    GFX_2D_SURFACE *const target_surface, const int32_t y1, const int32_t y2,
+    const uint8_t *const tex_page, const bool transparent)
 {
     int32_t y_size = y2 - y1;
     if (y_size <= 0) {
         return;
     }
 
-    const XBUF_XGUVP *xbuf = (const XBUF_XGUVP *)m_XBuffer + y1;
+    const XBUF_XGUVP *xbuf = (const XBUF_XGUVP *)ctx->xbuffer + y1;
     const int32_t target_stride = target_surface->desc.pitch;
     const int32_t alpha_stride = alpha_surface->desc.pitch;
     PIX_FMT *target_ptr = target_surface->buffer + y1 * target_stride;
     ALPHA_FMT *alpha_ptr = alpha_surface->buffer + y1 * alpha_stride;
+    const LIGHT_MAP *const light_maps = Output_GetLightMap(0);
 
     while (y_size > 0) {
         const int32_t x = xbuf->x1 / PHD_ONE;
@@ -614,46 +552,13 @@ static void M_WGTMapPersp32FP(
                 const int32_t u1 = PHD_HALF * u / rhw;
                 const int32_t v1 = PHD_HALF * v / rhw;
 
-                const int32_t u0_add = (u1 - u0) / batch_size;
-                const int32_t v0_add = (v1 - v0) / batch_size;
-
-                if ((ABS(u0_add) + ABS(v0_add)) < (PHD_ONE / 2)) {
-                    int32_t batch_counter = batch_size / 2;
-                    while (batch_counter--) {
-                        const uint8_t color_idx = tex_page[MAKE_TEX_ID(v0, u0)];
-                        if (color_idx != 0) {
-                            const uint8_t color =
-                                Output_GetLightMap(MAKE_Q_ID(g))
-                                    ->index[color_idx];
-                            target_line_ptr[0] = MAKE_PAL_IDX(color);
-                            target_line_ptr[1] = MAKE_PAL_IDX(color);
-                            alpha_line_ptr[0] = 255;
-                            alpha_line_ptr[1] = 255;
-                        }
-                        target_line_ptr += 2;
-                        alpha_line_ptr += 2;
-                        g += g_add * 2;
-                        u0 += u0_add * 2;
-                        v0 += v0_add * 2;
-                    }
-                } else {
-                    int32_t batch_counter = batch_size;
-                    while (batch_counter--) {
-                        const uint8_t color_idx = tex_page[MAKE_TEX_ID(v0, u0)];
-                        if (color_idx != 0) {
-                            const uint8_t color =
-                                Output_GetLightMap(MAKE_Q_ID(g))
-                                    ->index[color_idx];
-                            *target_line_ptr = MAKE_PAL_IDX(color);
-                            *alpha_line_ptr = 255;
-                        }
-                        target_line_ptr++;
-                        alpha_line_ptr++;
-                        g += g_add;
-                        u0 += u0_add;
-                        v0 += v0_add;
-                    }
-                }
+                M_DrawPerspRun(
+                    target_line_ptr, alpha_line_ptr, tex_page, light_maps,
+                    transparent, batch_size, g, g_add, u0,
+                    (u1 - u0) / batch_size, v0, (v1 - v0) / batch_size);
+                target_line_ptr += batch_size;
+                alpha_line_ptr += batch_size;
+                g += g_add * batch_size;
 
                 u0 = u1;
                 v0 = v1;
@@ -670,48 +575,20 @@ static void M_WGTMapPersp32FP(
             batch_size = x_size & ~1;
             x_size -= batch_size;
 
-            if ((ABS(u0_add) + ABS(v0_add)) < (PHD_ONE / 2)) {
-                int32_t batch_counter = batch_size / 2;
-                while (batch_counter--) {
-                    const uint8_t color_idx = tex_page[MAKE_TEX_ID(v0, u0)];
-                    if (color_idx != 0) {
-                        const uint8_t color =
-                            Output_GetLightMap(MAKE_Q_ID(g))->index[color_idx];
-                        target_line_ptr[0] = MAKE_PAL_IDX(color);
-                        target_line_ptr[1] = MAKE_PAL_IDX(color);
-                        alpha_line_ptr[0] = 255;
-                        alpha_line_ptr[1] = 255;
-                    }
-                    target_line_ptr += 2;
-                    alpha_line_ptr += 2;
-                    g += g_add * 2;
-                    u0 += u0_add * 2;
-                    v0 += v0_add * 2;
-                };
-            } else {
-                int32_t batch_counter = batch_size;
-                while (batch_counter--) {
-                    const uint8_t color_idx = tex_page[MAKE_TEX_ID(v0, u0)];
-                    if (color_idx != 0) {
-                        const uint8_t color =
-                            Output_GetLightMap(MAKE_Q_ID(g))->index[color_idx];
-                        *target_line_ptr = MAKE_PAL_IDX(color);
-                        *alpha_line_ptr = 255;
-                    }
-                    target_line_ptr++;
-                    alpha_line_ptr++;
-                    g += g_add;
-                    u0 += u0_add;
-                    v0 += v0_add;
-                }
-            }
+            M_DrawPerspRun(
+                target_line_ptr, alpha_line_ptr, tex_page, light_maps,
+                transparent, batch_size, g, g_add, u0, u0_add, v0, v0_add);
+            target_line_ptr += batch_size;
+            alpha_line_ptr += batch_size;
+            g += g_add * batch_size;
+            u0 += u0_add * batch_size;
+            v0 += v0_add * batch_size;
         }
 
         if (x_size == 1) {
             const uint8_t color_idx = tex_page[MAKE_TEX_ID(v0, u0)];
-            if (color_idx != 0) {
-                const uint8_t color =
-                    Output_GetLightMap(MAKE_Q_ID(g))->index[color_idx];
+            if (!transparent || color_idx != 0) {
+                const uint8_t color = light_maps[MAKE_Q_ID(g)].index[color_idx];
                 *target_line_ptr = MAKE_PAL_IDX(color);
                 *alpha_line_ptr = 255;
             }
@@ -725,7 +602,25 @@ static void M_WGTMapPersp32FP(
     }
 }
 
-static bool M_XGenX(const int16_t *obj_ptr)
+static void M_GTMapPersp32FP(
+    const M_CONTEXT *const ctx, GFX_2D_SURFACE *const alpha_surface,
+    GFX_2D_SURFACE *const target_surface, const int32_t y1, const int32_t y2,
+    const uint8_t *const tex_page)
+{
+    M_DrawPerspSpans(
+        ctx, alpha_surface, target_surface, y1, y2, tex_page, false);
+}
+
+static void M_WGTMapPersp32FP(
+    const M_CONTEXT *const ctx, GFX_2D_SURFACE *const alpha_surface,
+    GFX_2D_SURFACE *const target_surface, const int32_t y1, const int32_t y2,
+    const uint8_t *const tex_page)
+{
+    M_DrawPerspSpans(
+        ctx, alpha_surface, target_surface, y1, y2, tex_page, true);
+}
+
+static bool M_XGenX(M_CONTEXT *ctx, const int16_t *obj_ptr)
 {
     int32_t pt_count = *obj_ptr++;
     const XGEN_X *pt2 = (const XGEN_X *)obj_ptr;
@@ -746,7 +641,7 @@ static bool M_XGenX(const int16_t *obj_ptr)
             const int32_t x_size = x2 - x1;
             int32_t y_size = y2 - y1;
 
-            XBUF_X *x_ptr = (XBUF_X *)m_XBuffer + y1;
+            XBUF_X *x_ptr = (XBUF_X *)ctx->xbuffer + y1;
             const int32_t x_add = PHD_ONE * x_size / y_size;
             int32_t x = x1 * PHD_ONE + (PHD_ONE - 1);
 
@@ -760,7 +655,7 @@ static bool M_XGenX(const int16_t *obj_ptr)
             const int32_t x_size = x1 - x2;
             int32_t y_size = y1 - y2;
 
-            XBUF_X *x_ptr = (XBUF_X *)m_XBuffer + y2;
+            XBUF_X *x_ptr = (XBUF_X *)ctx->xbuffer + y2;
             const int32_t x_add = PHD_ONE * x_size / y_size;
             int32_t x = x2 * PHD_ONE + 1;
 
@@ -772,16 +667,12 @@ static bool M_XGenX(const int16_t *obj_ptr)
         }
     }
 
-    if (y_min == y_max) {
-        return false;
-    }
-
-    m_XGenY1 = y_min;
-    m_XGenY2 = y_max;
-    return true;
+    ctx->xgen_y1 = MAX(y_min, ctx->clip_y1);
+    ctx->xgen_y2 = MIN(y_max, ctx->clip_y2);
+    return ctx->xgen_y1 < ctx->xgen_y2;
 }
 
-static bool M_XGenXG(const int16_t *obj_ptr)
+static bool M_XGenXG(M_CONTEXT *ctx, const int16_t *obj_ptr)
 {
     int32_t pt_count = *obj_ptr++;
     const XGEN_XG *pt2 = (const XGEN_XG *)obj_ptr;
@@ -805,7 +696,7 @@ static bool M_XGenXG(const int16_t *obj_ptr)
             const int32_t x_size = x2 - x1;
             int32_t y_size = y2 - y1;
 
-            XBUF_XG *xg_ptr = (XBUF_XG *)m_XBuffer + y1;
+            XBUF_XG *xg_ptr = (XBUF_XG *)ctx->xbuffer + y1;
             const int32_t x_add = PHD_ONE * x_size / y_size;
             const int32_t g_add = PHD_HALF * g_size / y_size;
             int32_t x = x1 * PHD_ONE + (PHD_ONE - 1);
@@ -824,7 +715,7 @@ static bool M_XGenXG(const int16_t *obj_ptr)
             const int32_t x_size = x1 - x2;
             int32_t y_size = y1 - y2;
 
-            XBUF_XG *xg_ptr = (XBUF_XG *)m_XBuffer + y2;
+            XBUF_XG *xg_ptr = (XBUF_XG *)ctx->xbuffer + y2;
             const int32_t x_add = PHD_ONE * x_size / y_size;
             const int32_t g_add = PHD_HALF * g_size / y_size;
             int32_t x = x2 * PHD_ONE + 1;
@@ -840,16 +731,12 @@ static bool M_XGenXG(const int16_t *obj_ptr)
         }
     }
 
-    if (y_min == y_max) {
-        return false;
-    }
-
-    m_XGenY1 = y_min;
-    m_XGenY2 = y_max;
-    return true;
+    ctx->xgen_y1 = MAX(y_min, ctx->clip_y1);
+    ctx->xgen_y2 = MIN(y_max, ctx->clip_y2);
+    return ctx->xgen_y1 < ctx->xgen_y2;
 }
 
-static bool M_XGenXGUV(const int16_t *obj_ptr)
+static bool M_XGenXGUV(M_CONTEXT *ctx, const int16_t *obj_ptr)
 {
     int32_t pt_count = *obj_ptr++;
     const XGEN_XGUV *pt2 = (const XGEN_XGUV *)obj_ptr;
@@ -879,7 +766,7 @@ static bool M_XGenXGUV(const int16_t *obj_ptr)
             const int32_t x_size = x2 - x1;
             int32_t y_size = y2 - y1;
 
-            XBUF_XGUV *xguv_ptr = (XBUF_XGUV *)m_XBuffer + y1;
+            XBUF_XGUV *xguv_ptr = (XBUF_XGUV *)ctx->xbuffer + y1;
             const int32_t x_add = PHD_ONE * x_size / y_size;
             const int32_t g_add = PHD_HALF * g_size / y_size;
             const int32_t u_add = PHD_HALF * u_size / y_size;
@@ -908,7 +795,7 @@ static bool M_XGenXGUV(const int16_t *obj_ptr)
             const int32_t x_size = x1 - x2;
             int32_t y_size = y1 - y2;
 
-            XBUF_XGUV *xguv_ptr = (XBUF_XGUV *)m_XBuffer + y2;
+            XBUF_XGUV *xguv_ptr = (XBUF_XGUV *)ctx->xbuffer + y2;
             const int32_t x_add = PHD_ONE * x_size / y_size;
             const int32_t g_add = PHD_HALF * g_size / y_size;
             const int32_t u_add = PHD_HALF * u_size / y_size;
@@ -932,16 +819,12 @@ static bool M_XGenXGUV(const int16_t *obj_ptr)
         }
     }
 
-    if (y_min == y_max) {
-        return false;
-    }
-
-    m_XGenY1 = y_min;
-    m_XGenY2 = y_max;
-    return true;
+    ctx->xgen_y1 = MAX(y_min, ctx->clip_y1);
+    ctx->xgen_y2 = MIN(y_max, ctx->clip_y2);
+    return ctx->xgen_y1 < ctx->xgen_y2;
 }
 
-static bool M_XGenXGUVPerspFP(const int16_t *obj_ptr)
+static bool M_XGenXGUVPerspFP(M_CONTEXT *ctx, const int16_t *obj_ptr)
 {
     int32_t pt_count = *obj_ptr++;
     const XGEN_XGUVP *pt2 = (const XGEN_XGUVP *)obj_ptr;
@@ -976,7 +859,7 @@ static bool M_XGenXGUVPerspFP(const int16_t *obj_ptr)
             const int32_t x_size = x2 - x1;
             int32_t y_size = y2 - y1;
 
-            XBUF_XGUVP *xguv_ptr = (XBUF_XGUVP *)m_XBuffer + y1;
+            XBUF_XGUVP *xguv_ptr = (XBUF_XGUVP *)ctx->xbuffer + y1;
             const int32_t x_add = PHD_ONE * x_size / y_size;
             const int32_t g_add = PHD_HALF * g_size / y_size;
             const float u_add = u_size / (float)y_size;
@@ -1010,7 +893,7 @@ static bool M_XGenXGUVPerspFP(const int16_t *obj_ptr)
             const int32_t x_size = x1 - x2;
             int32_t y_size = y1 - y2;
 
-            XBUF_XGUVP *xguv_ptr = (XBUF_XGUVP *)m_XBuffer + y2;
+            XBUF_XGUVP *xguv_ptr = (XBUF_XGUVP *)ctx->xbuffer + y2;
             const int32_t x_add = PHD_ONE * x_size / y_size;
             const int32_t g_add = PHD_HALF * g_size / y_size;
             const float u_add = u_size / (float)y_size;
@@ -1038,89 +921,91 @@ static bool M_XGenXGUVPerspFP(const int16_t *obj_ptr)
         }
     }
 
-    if (y_min == y_max) {
-        return false;
-    }
-
-    m_XGenY1 = y_min;
-    m_XGenY2 = y_max;
-    return true;
+    ctx->xgen_y1 = MAX(y_min, ctx->clip_y1);
+    ctx->xgen_y2 = MIN(y_max, ctx->clip_y2);
+    return ctx->xgen_y1 < ctx->xgen_y2;
 }
 
 static void M_DrawPolyFlat(
-    const int16_t *const obj_ptr, GFX_2D_SURFACE *const target_surface,
-    GFX_2D_SURFACE *const alpha_surface)
+    M_CONTEXT *const ctx, const int16_t *const obj_ptr,
+    GFX_2D_SURFACE *const target_surface, GFX_2D_SURFACE *const alpha_surface)
 {
-    if (M_XGenX(obj_ptr + 1)) {
-        M_FlatA(alpha_surface, target_surface, m_XGenY1, m_XGenY2, *obj_ptr);
+    if (M_XGenX(ctx, obj_ptr + 1)) {
+        M_FlatA(
+            ctx, alpha_surface, target_surface, ctx->xgen_y1, ctx->xgen_y2,
+            *obj_ptr);
     }
 }
 
 static void M_DrawPolyTrans(
-    const int16_t *const obj_ptr, GFX_2D_SURFACE *const target_surface,
-    GFX_2D_SURFACE *const alpha_surface)
+    M_CONTEXT *const ctx, const int16_t *const obj_ptr,
+    GFX_2D_SURFACE *const target_surface, GFX_2D_SURFACE *const alpha_surface)
 {
-    if (M_XGenX(obj_ptr + 1)) {
-        M_TransA(alpha_surface, target_surface, m_XGenY1, m_XGenY2, *obj_ptr);
+    if (M_XGenX(ctx, obj_ptr + 1)) {
+        M_TransA(
+            ctx, alpha_surface, target_surface, ctx->xgen_y1, ctx->xgen_y2,
+            *obj_ptr);
     }
 }
 
 static void M_DrawPolyGouraud(
-    const int16_t *const obj_ptr, GFX_2D_SURFACE *const target_surface,
-    GFX_2D_SURFACE *const alpha_surface)
+    M_CONTEXT *const ctx, const int16_t *const obj_ptr,
+    GFX_2D_SURFACE *const target_surface, GFX_2D_SURFACE *const alpha_surface)
 {
-    if (M_XGenXG(obj_ptr + 1)) {
-        M_GourA(alpha_surface, target_surface, m_XGenY1, m_XGenY2, *obj_ptr);
+    if (M_XGenXG(ctx, obj_ptr + 1)) {
+        M_GourA(
+            ctx, alpha_surface, target_surface, ctx->xgen_y1, ctx->xgen_y2,
+            *obj_ptr);
     }
 }
 
 static void M_DrawPolyGTMap(
-    const int16_t *const obj_ptr, GFX_2D_SURFACE *const target_surface,
-    GFX_2D_SURFACE *const alpha_surface)
+    M_CONTEXT *const ctx, const int16_t *const obj_ptr,
+    GFX_2D_SURFACE *const target_surface, GFX_2D_SURFACE *const alpha_surface)
 {
-    if (M_XGenXGUV(obj_ptr + 1)) {
+    if (M_XGenXGUV(ctx, obj_ptr + 1)) {
         M_GTMapA(
-            alpha_surface, target_surface, m_XGenY1, m_XGenY2,
+            ctx, alpha_surface, target_surface, ctx->xgen_y1, ctx->xgen_y2,
             Output_GetTexturePage8(*obj_ptr));
     }
 }
 
 static void M_DrawPolyWGTMap(
-    const int16_t *const obj_ptr, GFX_2D_SURFACE *const target_surface,
-    GFX_2D_SURFACE *const alpha_surface)
+    M_CONTEXT *const ctx, const int16_t *const obj_ptr,
+    GFX_2D_SURFACE *const target_surface, GFX_2D_SURFACE *const alpha_surface)
 {
-    if (M_XGenXGUV(obj_ptr + 1)) {
+    if (M_XGenXGUV(ctx, obj_ptr + 1)) {
         M_WGTMapA(
-            alpha_surface, target_surface, m_XGenY1, m_XGenY2,
+            ctx, alpha_surface, target_surface, ctx->xgen_y1, ctx->xgen_y2,
             Output_GetTexturePage8(*obj_ptr));
     }
 }
 
 static void M_DrawPolyGTMapPersp(
-    const int16_t *const obj_ptr, GFX_2D_SURFACE *const target_surface,
-    GFX_2D_SURFACE *const alpha_surface)
+    M_CONTEXT *const ctx, const int16_t *const obj_ptr,
+    GFX_2D_SURFACE *const target_surface, GFX_2D_SURFACE *const alpha_surface)
 {
-    if (M_XGenXGUVPerspFP(obj_ptr + 1)) {
+    if (M_XGenXGUVPerspFP(ctx, obj_ptr + 1)) {
         M_GTMapPersp32FP(
-            alpha_surface, target_surface, m_XGenY1, m_XGenY2,
+            ctx, alpha_surface, target_surface, ctx->xgen_y1, ctx->xgen_y2,
             Output_GetTexturePage8(*obj_ptr));
     }
 }
 
 static void M_DrawPolyWGTMapPersp(
-    const int16_t *const obj_ptr, GFX_2D_SURFACE *const target_surface,
-    GFX_2D_SURFACE *const alpha_surface)
+    M_CONTEXT *const ctx, const int16_t *const obj_ptr,
+    GFX_2D_SURFACE *const target_surface, GFX_2D_SURFACE *const alpha_surface)
 {
-    if (M_XGenXGUVPerspFP(obj_ptr + 1)) {
+    if (M_XGenXGUVPerspFP(ctx, obj_ptr + 1)) {
         M_WGTMapPersp32FP(
-            alpha_surface, target_surface, m_XGenY1, m_XGenY2,
+            ctx, alpha_surface, target_surface, ctx->xgen_y1, ctx->xgen_y2,
             Output_GetTexturePage8(*obj_ptr));
     }
 }
 
 static void M_DrawPolyLine(
-    const int16_t *obj_ptr, GFX_2D_SURFACE *const target_surface,
-    GFX_2D_SURFACE *const alpha_surface)
+    M_CONTEXT *const ctx, const int16_t *obj_ptr,
+    GFX_2D_SURFACE *const target_surface, GFX_2D_SURFACE *const alpha_surface)
 {
     int32_t x1 = *obj_ptr++;
     int32_t y1 = *obj_ptr++;
@@ -1169,6 +1054,17 @@ static void M_DrawPolyLine(
         y2 = g_PhdWinMaxY;
     }
 
+    if (y2 < ctx->clip_y1 || y1 >= ctx->clip_y2) {
+        return;
+    }
+
+    // Clipping the line itself to the band would shift the stepping, so
+    // instead step the whole line and drop the pixels outside the band.
+    const PIX_FMT *const band_start =
+        &target_surface->buffer[target_stride * ctx->clip_y1];
+    const PIX_FMT *const band_end =
+        &target_surface->buffer[target_stride * ctx->clip_y2];
+
     int32_t x_size = x2 - x1;
     int32_t y_size = y2 - y1;
     PIX_FMT *target_ptr = &target_surface->buffer[x1 + target_stride * y1];
@@ -1216,7 +1112,9 @@ static void M_DrawPolyLine(
     int32_t part = PHD_ONE * rows / cols;
     for (int32_t i = 0; i < cols; i++) {
         part_sum += part;
-        *target_ptr = lcolor;
+        if (target_ptr >= band_start && target_ptr < band_end) {
+            *target_ptr = lcolor;
+        }
         target_ptr += col_add;
         //*alpha_ptr = 255;
         // alpha_ptr += col_add;
@@ -1229,8 +1127,8 @@ static void M_DrawPolyLine(
 }
 
 static void M_DrawScaledSpriteC(
-    const int16_t *const obj_ptr, GFX_2D_SURFACE *const target_surface,
-    GFX_2D_SURFACE *const alpha_surface)
+    M_CONTEXT *const ctx, const int16_t *const obj_ptr,
+    GFX_2D_SURFACE *const target_surface, GFX_2D_SURFACE *const alpha_surface)
 {
     int32_t x0 = obj_ptr[0];
     int32_t y0 = obj_ptr[1];
@@ -1256,12 +1154,12 @@ static void M_DrawScaledSpriteC(
         u_base -= x0 * u_add;
         x0 = 0;
     }
-    if (y0 < 0) {
-        v_base -= y0 * v_add;
-        y0 = 0;
+    if (y0 < ctx->clip_y1) {
+        v_base += (ctx->clip_y1 - y0) * v_add;
+        y0 = ctx->clip_y1;
     }
     CLAMPG(x1, g_PhdWinMaxX + 1);
-    CLAMPG(y1, g_PhdWinMaxY + 1);
+    CLAMPG(y1, ctx->clip_y2);
 
     const int32_t target_stride = target_surface->desc.pitch;
     const int32_t width = x1 - x0;
@@ -1294,12 +1192,185 @@ static void M_DrawScaledSpriteC(
     }
 }
 
+static int32_t M_GetWorkerCount(void)
+{
+    const int32_t num_threads = g_Config.rendering.software_threads;
+    return num_threads > 0 ? num_threads : ThreadPool_GetCPUCount();
+}
+
+static void M_OpenWorkers(M_PRIV *const priv)
+{
+    const int32_t num_workers = M_GetWorkerCount();
+    if (num_workers > 1) {
+        priv->pool = ThreadPool_Create(num_workers);
+        if (ThreadPool_GetWorkerCount(priv->pool) == 1) {
+            ThreadPool_Free(priv->pool);
+            priv->pool = nullptr;
+        }
+    }
+
+    priv->num_contexts =
+        priv->pool != nullptr ? ThreadPool_GetWorkerCount(priv->pool) : 1;
+    priv->contexts = Memory_Alloc(sizeof(M_CONTEXT) * priv->num_contexts);
+    for (int32_t i = 0; i < priv->num_contexts; i++) {
+        M_CONTEXT *const ctx = &priv->contexts[i];
+        ctx->xbuffer = Memory_Alloc(sizeof(XBUF_XGUVP) * g_PhdWinHeight);
+        ctx->clip_y1 = 0;
+        ctx->clip_y2 = g_PhdWinHeight;
+    }
+
+    if (priv->pool == nullptr) {
+        return;
+    }
+
+    // Split the screen into more bands than there are workers, so that
+    // a band crowded with polygons does not stall the whole frame.
+    priv->num_bands =
+        MIN(priv->num_contexts * BANDS_PER_WORKER, g_PhdWinHeight);
+    priv->bands = Memory_Alloc(sizeof(M_BAND) * priv->num_bands);
+    for (int32_t i = 0; i < priv->num_bands; i++) {
+        M_BAND *const band = &priv->bands[i];
+        band->y1 = i * g_PhdWinHeight / priv->num_bands;
+        band->y2 = (i + 1) * g_PhdWinHeight / priv->num_bands;
+    }
+}
+
+static void M_CloseWorkers(M_PRIV *const priv)
+{
+    ThreadPool_Free(priv->pool);
+    priv->pool = nullptr;
+
+    for (int32_t i = 0; i < priv->num_contexts; i++) {
+        Memory_FreePointer(&priv->contexts[i].xbuffer);
+    }
+    Memory_FreePointer(&priv->contexts);
+    priv->num_contexts = 0;
+
+    for (int32_t i = 0; i < priv->num_bands; i++) {
+        Memory_FreePointer(&priv->bands[i].polys);
+    }
+    Memory_FreePointer(&priv->bands);
+    priv->num_bands = 0;
+    priv->band_capacity = 0;
+}
+
+static bool M_GetPolyBounds(
+    const int16_t *obj_ptr, int32_t *const y1, int32_t *const y2)
+{
+    const int16_t poly_type = *obj_ptr++;
+    size_t vertex_size;
+    switch (poly_type) {
+    case POLY_LINE:
+        *y1 = MIN(obj_ptr[1], obj_ptr[3]);
+        *y2 = MAX(obj_ptr[1], obj_ptr[3]) + 1;
+        return true;
+
+    case POLY_SPRITE:
+        *y1 = obj_ptr[1];
+        *y2 = obj_ptr[3];
+        return true;
+
+    case POLY_FLAT:
+    case POLY_TRANS:
+        vertex_size = sizeof(XGEN_X);
+        break;
+
+    case POLY_GOURAUD:
+        vertex_size = sizeof(XGEN_XG);
+        break;
+
+    case POLY_GTMAP:
+    case POLY_WGTMAP:
+        vertex_size = sizeof(XGEN_XGUV);
+        break;
+
+    case POLY_GTMAP_PERSP:
+    case POLY_WGTMAP_PERSP:
+        vertex_size = sizeof(XGEN_XGUVP);
+        break;
+
+    default:
+        return false;
+    }
+
+    // Every XGEN vertex layout starts with the x and y coordinates.
+    const int32_t stride = vertex_size / sizeof(int16_t);
+    const int32_t pt_count = obj_ptr[1];
+    const int16_t *pt = &obj_ptr[2];
+    *y1 = pt[1];
+    *y2 = pt[1];
+    for (int32_t i = 1; i < pt_count; i++) {
+        pt += stride;
+        CLAMPG(*y1, pt[1]);
+        CLAMPL(*y2, pt[1]);
+    }
+    return true;
+}
+
+static void M_BinPolyList(M_PRIV *const priv)
+{
+    if (g_SurfaceCount > priv->band_capacity) {
+        priv->band_capacity = g_SurfaceCount;
+        for (int32_t i = 0; i < priv->num_bands; i++) {
+            M_BAND *const band = &priv->bands[i];
+            band->polys = Memory_Realloc(
+                band->polys, sizeof(int32_t) * priv->band_capacity);
+        }
+    }
+
+    for (int32_t i = 0; i < priv->num_bands; i++) {
+        priv->bands[i].count = 0;
+    }
+
+    // The sort order is preserved within each band, which is all the
+    // painter's algorithm needs since the bands never overlap.
+    for (int32_t i = 0; i < g_SurfaceCount; i++) {
+        int32_t y1;
+        int32_t y2;
+        if (!M_GetPolyBounds((const int16_t *)g_SortBuffer[i]._0, &y1, &y2)) {
+            continue;
+        }
+        for (int32_t j = 0; j < priv->num_bands; j++) {
+            M_BAND *const band = &priv->bands[j];
+            if (band->y1 >= y2) {
+                break;
+            }
+            if (band->y2 > y1) {
+                band->polys[band->count++] = i;
+            }
+        }
+    }
+}
+
+static void M_DrawPoly(
+    M_PRIV *const priv, M_CONTEXT *const ctx, const int32_t sort_idx)
+{
+    const int16_t *obj_ptr = (const int16_t *)g_SortBuffer[sort_idx]._0;
+    const int16_t poly_type = *obj_ptr++;
+    m_PolyDrawRoutines[poly_type](
+        ctx, obj_ptr, priv->surface, priv->surface_alpha);
+}
+
+static void M_DrawBand(
+    void *const user_data, const int32_t band_idx, const int32_t worker_idx)
+{
+    M_PRIV *const priv = user_data;
+    const M_BAND *const band = &priv->bands[band_idx];
+    M_CONTEXT *const ctx = &priv->contexts[worker_idx];
+    ctx->clip_y1 = band->y1;
+    ctx->clip_y2 = band->y2;
+    for (int32_t i = 0; i < band->count; i++) {
+        M_DrawPoly(priv, ctx, band->polys[i]);
+    }
+}
+
 static void M_Init(RENDERER *const renderer)
 {
     M_PRIV *const priv = Memory_Alloc(sizeof(M_PRIV));
     priv->renderer_2d = GFX_2D_Renderer_Create();
     renderer->priv = priv;
     renderer->initialized = true;
+    SWR_Span_Init();
 }
 
 static void M_Open(RENDERER *const renderer)
@@ -1310,7 +1381,7 @@ static void M_Open(RENDERER *const renderer)
         return;
     }
 
-    m_XBuffer = Memory_Realloc(m_XBuffer, sizeof(XBUF_XGUVP) * g_PhdWinHeight);
+    M_OpenWorkers(priv);
 
     {
         GFX_2D_Surface_Free(priv->surface);
@@ -1349,7 +1420,7 @@ static void M_Close(RENDERER *const renderer)
         return;
     }
 
-    Memory_FreePointer(&m_XBuffer);
+    M_CloseWorkers(priv);
 
     if (priv->surface != nullptr) {
         GFX_2D_Surface_Free(priv->surface);
@@ -1423,12 +1494,18 @@ static void M_DrawPolyList(RENDERER *const renderer)
 
     Render_SortPolyList();
 
-    for (int32_t i = 0; i < g_SurfaceCount; i++) {
-        const int16_t *obj_ptr = (const int16_t *)g_SortBuffer[i]._0;
-        const int16_t poly_type = *obj_ptr++;
-        m_PolyDrawRoutines[poly_type](
-            obj_ptr, priv->surface, priv->surface_alpha);
+    const Uint64 start = SDL_GetPerformanceCounter();
+    if (priv->pool == nullptr) {
+        M_CONTEXT *const ctx = &priv->contexts[0];
+        for (int32_t i = 0; i < g_SurfaceCount; i++) {
+            M_DrawPoly(priv, ctx, i);
+        }
+    } else {
+        M_BinPolyList(priv);
+        ThreadPool_Run(priv->pool, M_DrawBand, priv, priv->num_bands);
     }
+    priv->stats.frames++;
+    priv->stats.ticks += SDL_GetPerformanceCounter() - start;
 
     GFX_2D_Renderer_UploadSurface(priv->renderer_2d, priv->surface);
     GFX_2D_Renderer_UploadAlphaSurface(priv->renderer_2d, priv->surface_alpha);
@@ -2285,6 +2362,30 @@ static void M_InsertSprite(
     g_SurfaceCount++;
 }
 
+RENDER_SW_STATS Renderer_SW_GetStats(const RENDERER *const renderer)
+{
+    const M_PRIV *const priv = renderer->priv;
+    if (priv == nullptr || !renderer->open) {
+        return (RENDER_SW_STATS) {};
+    }
+    return (RENDER_SW_STATS) {
+        .threads = priv->num_contexts,
+        .bands = priv->num_bands,
+        .frames = priv->stats.frames,
+        .time_ms = (double)priv->stats.ticks * 1000.0
+            / (double)SDL_GetPerformanceFrequency(),
+    };
+}
+
+void Renderer_SW_ResetStats(RENDERER *const renderer)
+{
+    M_PRIV *const priv = renderer->priv;
+    if (priv != nullptr) {
+        priv->stats.frames = 0;
+        priv->stats.ticks = 0;
+    }
+}
+
 void Renderer_SW_Prepare(RENDERER *const renderer)
 {
     renderer->Init = M_Init;
@@ -3,3 +3,5 @@
 #include "game/render/priv.h"
 
 void Renderer_SW_Prepare(RENDERER *renderer);
+RENDER_SW_STATS Renderer_SW_GetStats(const RENDERER *renderer);
+void Renderer_SW_ResetStats(RENDERER *renderer);
@@ -0,0 +1,441 @@
+#include "game/render/swr_span.h"
+
+#include <libtrx/benchmark.h>
+#include <libtrx/game/output/const.h>
+#include <libtrx/memory.h>
+
+#include <SDL2/SDL_cpuinfo.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define SWR_SPAN_X86
+    #include <immintrin.h>
+#endif
+
+#define BENCHMARK_SPANS 4096
+#define BENCHMARK_SPAN_SIZE 32
+#define BENCHMARK_PIXELS (BENCHMARK_SPANS * BENCHMARK_SPAN_SIZE)
+#define BENCHMARK_PASSES 50
+
+typedef void (*M_DRAW_FUNC)(const SWR_SPAN *span, bool transparent);
+
+typedef struct {
+    const char *name;
+    bool (*is_supported)(void);
+    M_DRAW_FUNC draw;
+} M_KERNEL;
+
+typedef struct {
+    M_DRAW_FUNC draw;
+    bool transparent;
+    const SWR_SPAN *spans;
+} M_BENCHMARK;
+
+static bool M_IsAlwaysSupported(void);
+static void M_DrawScalar(const SWR_SPAN *span, bool transparent);
+static void M_DrawTail(
+    const SWR_SPAN *span, bool transparent, int32_t offset, uint32_t g,
+    uint32_t u, uint32_t v);
+#ifdef SWR_SPAN_X86
+static bool M_HasSSE2(void);
+static bool M_HasAVX2(void);
+static void M_Store16(
+    uint8_t *target, uint8_t *alpha, __m128i colors, __m128i color_idx,
+    bool transparent);
+static void M_DrawSSE2(const SWR_SPAN *span, bool transparent);
+static void M_DrawAVX2(const SWR_SPAN *span, bool transparent);
+#endif
+static bool M_IsSupported(SWR_SPAN_KERNEL kernel);
+static uint32_t M_Random(uint32_t *seed);
+static void M_BenchmarkDraw(void *user_data);
+static void M_BenchmarkKernel(
+    SWR_SPAN_KERNEL kernel, SWR_SPAN *spans, const uint8_t *expected,
+    SWR_SPAN_BENCHMARK *result);
+
+static const M_KERNEL m_Kernels[SWR_SPAN_KERNEL_NUMBER_OF] = {
+    [SWR_SPAN_KERNEL_SCALAR] = {
+        .name = "scalar",
+        .is_supported = M_IsAlwaysSupported,
+        .draw = M_DrawScalar,
+    },
+#ifdef SWR_SPAN_X86
+    [SWR_SPAN_KERNEL_SSE2] = {
+        .name = "sse2",
+        .is_supported = M_HasSSE2,
+        .draw = M_DrawSSE2,
+    },
+    [SWR_SPAN_KERNEL_AVX2] = {
+        .name = "avx2",
+        .is_supported = M_HasAVX2,
+        .draw = M_DrawAVX2,
+    },
+#else
+    [SWR_SPAN_KERNEL_SSE2] = { .name = "sse2" },
+    [SWR_SPAN_KERNEL_AVX2] = { .name = "avx2" },
+#endif
+};
+
+static SWR_SPAN_KERNEL m_Kernel = SWR_SPAN_KERNEL_SCALAR;
+
+static bool M_IsAlwaysSupported(void)
+{
+    return true;
+}
+
+static void M_DrawScalar(const SWR_SPAN *const span, const bool transparent)
+{
+    const uint8_t *const tex_page = span->tex_page;
+    const LIGHT_MAP *const light_maps = span->light_maps;
+    uint8_t *const target = span->target;
+    uint8_t *const alpha = span->alpha;
+    int32_t g = span->g;
+    int32_t u = span->u;
+    int32_t v = span->v;
+    for (int32_t i = 0; i < span->num_pixels; i++) {
+        const uint8_t color_idx =
+            tex_page[(((v >> 16) & 0xFF) << 8) | ((u >> 16) & 0xFF)];
+        if (!transparent || color_idx != 0) {
+            target[i] = light_maps[(g >> 16) & 0xFF].index[color_idx];
+            alpha[i] = 255;
+        }
+        g += span->g_add;
+        u += span->u_add;
+        v += span->v_add;
+    }
+}
+
+// Finishes the pixels a vector kernel did not cover.
+static void M_DrawTail(
+    const SWR_SPAN *const span, const bool transparent, const int32_t offset,
+    const uint32_t g, const uint32_t u, const uint32_t v)
+{
+    SWR_SPAN tail = *span;
+    tail.target += offset;
+    tail.alpha += offset;
+    tail.num_pixels -= offset;
+    tail.g = g;
+    tail.u = u;
+    tail.v = v;
+    M_DrawScalar(&tail, transparent);
+}
+
+#ifdef SWR_SPAN_X86
+static bool M_HasSSE2(void)
+{
+    return SDL_HasSSE2();
+}
+
+static bool M_HasAVX2(void)
+{
+    return SDL_HasAVX2();
+}
+
+__attribute__((target("sse2"))) static void M_Store16(
+    uint8_t *const target, uint8_t *const alpha, const __m128i colors,
+    const __m128i color_idx, const bool transparent)
+{
+    const __m128i opaque = _mm_set1_epi8(-1);
+    if (!transparent) {
+        _mm_storeu_si128((__m128i *)target, colors);
+        _mm_storeu_si128((__m128i *)alpha, opaque);
+        return;
+    }
+
+    // Keep the pixels behind texels with color index 0.
+    const __m128i keep = _mm_cmpeq_epi8(color_idx, _mm_setzero_si128());
+    const __m128i old_target = _mm_loadu_si128((const __m128i *)target);
+    const __m128i old_alpha = _mm_loadu_si128((const __m128i *)alpha);
+    _mm_storeu_si128(
+        (__m128i *)target,
+        _mm_or_si128(
+            _mm_and_si128(keep, old_target), _mm_andnot_si128(keep, colors)));
+    _mm_storeu_si128(
+        (__m128i *)alpha,
+        _mm_or_si128(old_alpha, _mm_andnot_si128(keep, opaque)));
+}
+
+// Steps the coordinates and computes the table offsets four pixels at a time.
+// SSE2 has no gathers, so the lookups themselves stay scalar.
+__attribute__((target("sse2"))) static void M_DrawSSE2(
+    const SWR_SPAN *const span, const bool transparent)
+{
+    const uint8_t *const tex_page = span->tex_page;
+    const uint8_t *const light_table = (const uint8_t *)span->light_maps;
+    const uint32_t g_add = span->g_add;
+    const uint32_t u_add = span->u_add;
+    const uint32_t v_add = span->v_add;
+    uint32_t g = span->g;
+    uint32_t u = span->u;
+    uint32_t v = span->v;
+
+    __m128i g4 = _mm_setr_epi32(g, g + g_add, g + g_add * 2, g + g_add * 3);
+    __m128i u4 = _mm_setr_epi32(u, u + u_add, u + u_add * 2, u + u_add * 3);
+    __m128i v4 = _mm_setr_epi32(v, v + v_add, v + v_add * 2, v + v_add * 3);
+    const __m128i g_step = _mm_set1_epi32(g_add * 4);
+    const __m128i u_step = _mm_set1_epi32(u_add * 4);
+    const __m128i v_step = _mm_set1_epi32(v_add * 4);
+    const __m128i lo_mask = _mm_set1_epi32(0xFF);
+    const __m128i hi_mask = _mm_set1_epi32(0xFF00);
+
+    int32_t i = 0;
+    for (; i + 16 <= span->num_pixels; i += 16) {
+        uint32_t tex_idx[16];
+        uint32_t light_idx[16];
+        for (int32_t j = 0; j < 16; j += 4) {
+            const __m128i t = _mm_or_si128(
+                _mm_and_si128(_mm_srli_epi32(v4, 8), hi_mask),
+                _mm_and_si128(_mm_srli_epi32(u4, 16), lo_mask));
+            const __m128i l = _mm_and_si128(_mm_srli_epi32(g4, 8), hi_mask);
+            _mm_storeu_si128((__m128i *)&tex_idx[j], t);
+            _mm_storeu_si128((__m128i *)&light_idx[j], l);
+            g4 = _mm_add_epi32(g4, g_step);
+            u4 = _mm_add_epi32(u4, u_step);
+            v4 = _mm_add_epi32(v4, v_step);
+        }
+
+        uint8_t color_idx[16];
+        uint8_t colors[16];
+        for (int32_t j = 0; j < 16; j++) {
+            color_idx[j] = tex_page[tex_idx[j]];
+            colors[j] = light_table[light_idx[j] | color_idx[j]];
+        }
+        M_Store16(
+            span->target + i, span->alpha + i,
+            _mm_loadu_si128((const __m128i *)colors),
+            _mm_loadu_si128((const __m128i *)color_idx), transparent);
+
+        g += g_add * 16;
+        u += u_add * 16;
+        v += v_add * 16;
+    }
+
+    M_DrawTail(span, transparent, i, g, u, v);
+}
+
+// Same as the SSE2 kernel, but eight pixels wide and with 32-byte stores. The
+// lookups stay scalar as gathers are slower than that on many CPUs.
+__attribute__((target("avx2"))) static void M_DrawAVX2(
+    const SWR_SPAN *const span, const bool transparent)
+{
+    const uint8_t *const tex_page = span->tex_page;
+    const uint8_t *const light_table = (const uint8_t *)span->light_maps;
+    const uint32_t g_add = span->g_add;
+    const uint32_t u_add = span->u_add;
+    const uint32_t v_add = span->v_add;
+    uint32_t g = span->g;
+    uint32_t u = span->u;
+    uint32_t v = span->v;
+
+    __m256i g8 = _mm256_setr_epi32(
+        g, g + g_add, g + g_add * 2, g + g_add * 3, g + g_add * 4,
+        g + g_add * 5, g + g_add * 6, g + g_add * 7);
+    __m256i u8 = _mm256_setr_epi32(
+        u, u + u_add, u + u_add * 2, u + u_add * 3, u + u_add * 4,
+        u + u_add * 5, u + u_add * 6, u + u_add * 7);
+    __m256i v8 = _mm256_setr_epi32(
+        v, v + v_add, v + v_add * 2, v + v_add * 3, v + v_add * 4,
+        v + v_add * 5, v + v_add * 6, v + v_add * 7);
+    const __m256i g_step = _mm256_set1_epi32(g_add * 8);
+    const __m256i u_step = _mm256_set1_epi32(u_add * 8);
+    const __m256i v_step = _mm256_set1_epi32(v_add * 8);
+    const __m256i lo_mask = _mm256_set1_epi32(0xFF);
+    const __m256i hi_mask = _mm256_set1_epi32(0xFF00);
+    const __m256i opaque = _mm256_set1_epi8(-1);
+
+    int32_t i = 0;
+    for (; i + 32 <= span->num_pixels; i += 32) {
+        uint32_t tex_idx[32];
+        uint32_t light_idx[32];
+        for (int32_t j = 0; j < 32; j += 8) {
+            const __m256i t = _mm256_or_si256(
+                _mm256_and_si256(_mm256_srli_epi32(v8, 8), hi_mask),
+                _mm256_and_si256(_mm256_srli_epi32(u8, 16), lo_mask));
+            const __m256i l =
+                _mm256_and_si256(_mm256_srli_epi32(g8, 8), hi_mask);
+            _mm256_storeu_si256((__m256i *)&tex_idx[j], t);
+            _mm256_storeu_si256((__m256i *)&light_idx[j], l);
+            g8 = _mm256_add_epi32(g8, g_step);
+            u8 = _mm256_add_epi32(u8, u_step);
+            v8 = _mm256_add_epi32(v8, v_step);
+        }
+
+        uint8_t color_idx[32];
+        uint8_t colors[32];
+        for (int32_t j = 0; j < 32; j++) {
+            color_idx[j] = tex_page[tex_idx[j]];
+            colors[j] = light_table[light_idx[j] | color_idx[j]];
+        }
+
+        __m256i *const target = (__m256i *)(span->target + i);
+        __m256i *const alpha = (__m256i *)(span->alpha + i);
+        const __m256i new_target = _mm256_loadu_si256((const __m256i *)colors);
+        if (!transparent) {
+            _mm256_storeu_si256(target, new_target);
+            _mm256_storeu_si256(alpha, opaque);
+        } else {
+            const __m256i keep = _mm256_cmpeq_epi8(
+                _mm256_loadu_si256((const __m256i *)color_idx),
+                _mm256_setzero_si256());
+            _mm256_storeu_si256(
+                target,
+                _mm256_blendv_epi8(
+                    new_target, _mm256_loadu_si256(target), keep));
+            _mm256_storeu_si256(
+                alpha,
+                _mm256_or_si256(
+                    _mm256_loadu_si256(alpha),
+                    _mm256_andnot_si256(keep, opaque)));
+        }
+
+        g += g_add * 32;
+        u += u_add * 32;
+        v += v_add * 32;
+    }
+
+    // GCC does not clear the upper halves before the tail call, and the
+    // SSE code that follows would stall on every span.
+    _mm256_zeroupper();
+    M_DrawTail(span, transparent, i, g, u, v);
+}
+#endif
+
+static bool M_IsSupported(const SWR_SPAN_KERNEL kernel)
+{
+    return m_Kernels[kernel].is_supported != nullptr
+        && m_Kernels[kernel].is_supported();
+}
+
+static uint32_t M_Random(uint32_t *const seed)
+{
+    *seed = *seed * 1103515245 + 12345;
+    return *seed >> 8;
+}
+
+static void M_BenchmarkDraw(void *const user_data)
+{
+    const M_BENCHMARK *const benchmark = user_data;
+    for (int32_t i = 0; i < BENCHMARK_SPANS; i++) {
+        benchmark->draw(&benchmark->spans[i], benchmark->transparent);
+    }
+}
+
+// Draws the spans opaque and then transparent on top, and compares the
+// result with the scalar output if there is one.
+static void M_BenchmarkKernel(
+    const SWR_SPAN_KERNEL kernel, SWR_SPAN *const spans,
+    const uint8_t *const expected, SWR_SPAN_BENCHMARK *const result)
+{
+    uint8_t *const target = spans[0].target;
+    memset(target, 0, BENCHMARK_PIXELS * 2);
+    M_BENCHMARK benchmark = {
+        .draw = m_Kernels[kernel].draw,
+        .spans = spans,
+    };
+    result->opaque_ns =
+        Benchmark_Measure(M_BenchmarkDraw, &benchmark, BENCHMARK_PASSES)
+        / BENCHMARK_PIXELS;
+
+    // Draw the transparent spans with the texture shifted by a texel, so
+    // that they do not fully cover the opaque pass.
+    for (int32_t i = 0; i < BENCHMARK_SPANS; i++) {
+        spans[i].u += 1 << 16;
+    }
+    benchmark.transparent = true;
+    result->transparent_ns =
+        Benchmark_Measure(M_BenchmarkDraw, &benchmark, BENCHMARK_PASSES)
+        / BENCHMARK_PIXELS;
+    for (int32_t i = 0; i < BENCHMARK_SPANS; i++) {
+        spans[i].u -= 1 << 16;
+    }
+
+    result->is_supported = true;
+    result->is_exact =
+        expected == nullptr || !memcmp(target, expected, BENCHMARK_PIXELS * 2);
+}
+
+void SWR_Span_Init(void)
+{
+    m_Kernel = SWR_SPAN_KERNEL_SCALAR;
+    for (SWR_SPAN_KERNEL kernel = SWR_SPAN_KERNEL_NUMBER_OF - 1;
+         kernel > SWR_SPAN_KERNEL_SCALAR; kernel--) {
+        if (M_IsSupported(kernel)) {
+            m_Kernel = kernel;
+            break;
+        }
+    }
+}
+
+SWR_SPAN_KERNEL SWR_Span_GetKernel(void)
+{
+    return m_Kernel;
+}
+
+const char *SWR_Span_GetKernelName(const SWR_SPAN_KERNEL kernel)
+{
+    return m_Kernels[kernel].name;
+}
+
+void SWR_Span_Draw(const SWR_SPAN *const span, const bool transparent)
+{
+    m_Kernels[m_Kernel].draw(span, transparent);
+}
+
+void SWR_Span_Benchmark(
+    SWR_SPAN_BENCHMARK results[SWR_SPAN_KERNEL_NUMBER_OF])
+{
+    uint32_t seed = 0x5EED;
+    uint8_t *const tex_page = Memory_Alloc(TEXTURE_PAGE_SIZE);
+    for (int32_t i = 0; i < TEXTURE_PAGE_SIZE; i++) {
+        // Roughly one texel in eight is see-through.
+        const uint8_t color_idx = M_Random(&seed);
+        tex_page[i] = color_idx % 8 == 0 ? 0 : color_idx;
+    }
+    LIGHT_MAP *const light_maps =
+        Memory_Alloc(sizeof(LIGHT_MAP) * LIGHT_MAP_COUNT);
+    for (int32_t i = 0; i < LIGHT_MAP_COUNT; i++) {
+        for (int32_t j = 0; j < 256; j++) {
+            light_maps[i].index[j] = M_Random(&seed);
+        }
+    }
+
+    // Spans as the perspective mappers emit them, at up to two texels per
+    // pixel in any direction, with the shade staying within the light maps.
+    uint8_t *const buffer = Memory_Alloc(BENCHMARK_PIXELS * 2);
+    uint8_t *expected = Memory_Alloc(BENCHMARK_PIXELS * 2);
+    SWR_SPAN *const spans = Memory_Alloc(sizeof(SWR_SPAN) * BENCHMARK_SPANS);
+    for (int32_t i = 0; i < BENCHMARK_SPANS; i++) {
+        const int32_t q1 = M_Random(&seed) % LIGHT_MAP_COUNT;
+        const int32_t q2 = M_Random(&seed) % LIGHT_MAP_COUNT;
+        spans[i] = (SWR_SPAN) {
+            .target = buffer + i * BENCHMARK_SPAN_SIZE,
+            .alpha = buffer + BENCHMARK_PIXELS + i * BENCHMARK_SPAN_SIZE,
+            .tex_page = tex_page,
+            .light_maps = light_maps,
+            .num_pixels = BENCHMARK_SPAN_SIZE,
+            .g = q1 << 16,
+            .g_add = (q2 - q1) * 0x10000 / BENCHMARK_SPAN_SIZE,
+            .u = M_Random(&seed),
+            .u_add = (int32_t)(M_Random(&seed) % (4 << 16)) - (2 << 16),
+            .v = M_Random(&seed),
+            .v_add = (int32_t)(M_Random(&seed) % (4 << 16)) - (2 << 16),
+        };
+    }
+
+    M_BenchmarkKernel(
+        SWR_SPAN_KERNEL_SCALAR, spans, nullptr,
+        &results[SWR_SPAN_KERNEL_SCALAR]);
+    memcpy(expected, buffer, BENCHMARK_PIXELS * 2);
+    for (SWR_SPAN_KERNEL kernel = SWR_SPAN_KERNEL_SCALAR + 1;
+         kernel < SWR_SPAN_KERNEL_NUMBER_OF; kernel++) {
+        results[kernel] = (SWR_SPAN_BENCHMARK) {};
+        if (M_IsSupported(kernel)) {
+            M_BenchmarkKernel(kernel, spans, expected, &results[kernel]);
+        }
+    }
+
+    Memory_FreePointer(&expected);
+    Memory_Free(spans);
+    Memory_Free(buffer);
+    Memory_Free(light_maps);
+    Memory_Free(tex_page);
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <libtrx/game/output/types.h>
+
+#include <stdint.h>
+
+// Inner loops of the software renderer's texture mappers. The fastest kernel
+// supported by the CPU is picked at runtime, the scalar one being the
+// fallback. All kernels produce identical output.
+
+typedef enum {
+    SWR_SPAN_KERNEL_SCALAR,
+    SWR_SPAN_KERNEL_SSE2,
+    SWR_SPAN_KERNEL_AVX2,
+    SWR_SPAN_KERNEL_NUMBER_OF,
+} SWR_SPAN_KERNEL;
+
+// A horizontal run of pixels with linearly stepped 16.16 shade and texture
+// coordinates.
+typedef struct {
+    uint8_t *target;
+    uint8_t *alpha;
+    const uint8_t *tex_page;
+    const LIGHT_MAP *light_maps;
+    int32_t num_pixels;
+    int32_t g;
+    int32_t g_add;
+    int32_t u;
+    int32_t u_add;
+    int32_t v;
+    int32_t v_add;
+} SWR_SPAN;
+
+typedef struct {
+    bool is_supported;
+    // Whether the output matched the scalar kernel.
+    bool is_exact;
+    double opaque_ns;
+    double transparent_ns;
+} SWR_SPAN_BENCHMARK;
+
+void SWR_Span_Init(void);
+SWR_SPAN_KERNEL SWR_Span_GetKernel(void);
+const char *SWR_Span_GetKernelName(SWR_SPAN_KERNEL kernel);
+
+// Transparent spans skip the texels with color index 0.
+void SWR_Span_Draw(const SWR_SPAN *span, bool transparent);
+
+// Times every kernel on synthetic spans, in nanoseconds per pixel.
+void SWR_Span_Benchmark(SWR_SPAN_BENCHMARK results[SWR_SPAN_KERNEL_NUMBER_OF]);
@@ -148,14 +148,14 @@ static bool M_TestLava(const ITEM *const item)
     int16_t room_num = item->room_num;
     const SECTOR *const sector =
         Room_GetSector(item->pos.x, MAX_HEIGHT, item->pos.z, &room_num);
-    return sector->is_death_sector;
+    return sector->flags & SF_DEATH;
 }
 
 void Room_TestSectorTrigger(const ITEM *const item, const SECTOR *const sector)
 {
     const bool is_heavy = item->object_id != O_LARA;
     if (!is_heavy) {
-        if (sector->is_death_sector && M_TestLava(item)) {
+        if ((sector->flags & SF_DEATH) && M_TestLava(item)) {
             Lara_TouchLava((ITEM *)item);
         }
 
@@ -648,7 +648,7 @@ int32_t Room_GetHeight(
         height = M_GetFloorTiltHeight(pit_sector, x, z);
     }
 
-    if (pit_sector->trigger == nullptr) {
+    if (!(pit_sector->flags & SF_FLOOR_OBJECTS)) {
         return height;
     }
 
@@ -690,7 +690,7 @@ int32_t Room_GetCeiling(
     int32_t height = M_GetCeilingTiltHeight(sky_sector, x, z);
 
     const SECTOR *const pit_sector = Room_GetPitSector(sector, x, z);
-    if (pit_sector->trigger == nullptr) {
+    if (!(pit_sector->flags & SF_CEILING_OBJECTS)) {
         return height;
     }
 
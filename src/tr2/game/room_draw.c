@@ -376,14 +376,11 @@ void Room_DrawSingleRoomGeometry(const int16_t room_num)
     g_PhdWinBottom = room->bound_bottom;
 
     Output_LightRoom(room);
-    if (m_Outside > 0 && !(room->flags & RF_INSIDE)) {
-        Output_DrawRoom(&room->mesh, true);
-    } else {
-        if (m_Outside >= 0) {
-            Room_Clip(room);
-        }
-        Output_DrawRoom(&room->mesh, false);
+    const bool is_outside = m_Outside > 0 && !(room->flags & RF_INSIDE);
+    if (!is_outside && m_Outside >= 0) {
+        Room_Clip(room);
     }
+    Output_DrawRoom(room_num, &room->mesh);
 }
 
 void Room_DrawSingleRoomObjects(const int16_t room_num)
@@ -14,6 +14,7 @@
 #include "game/output.h"
 #include "game/phase.h"
 #include "game/random.h"
+#include "game/room.h"
 #include "game/render/common.h"
 #include "game/sound.h"
 #include "game/text.h"
@@ -22,10 +23,12 @@
 
 #include <libtrx/config.h>
 #include <libtrx/debug.h>
+#include <libtrx/engine/audio.h>
 #include <libtrx/enum_map.h>
 #include <libtrx/game/game_buf.h>
 #include <libtrx/game/game_string_table.h>
 #include <libtrx/game/shell.h>
+#include <libtrx/game/state_trace.h>
 #include <libtrx/game/ui/common.h>
 #include <libtrx/memory.h>
 
@@ -288,6 +291,13 @@ static void M_HandleConfigChange(const EVENT *const event, void *const data)
     if (CHANGED(audio.music_volume)) {
         Music_SetVolume(g_Config.audio.music_volume);
     }
+    if (CHANGED(audio.enable_sample_interpolation)) {
+        Audio_Sample_SetInterpolation(
+            g_Config.audio.enable_sample_interpolation);
+    }
+    if (CHANGED(audio.enable_sample_cache)) {
+        Audio_Sample_SetCacheEnabled(g_Config.audio.enable_sample_cache);
+    }
 
     if (CHANGED(window.is_fullscreen) || CHANGED(window.is_maximized)
         || CHANGED(window.x) || CHANGED(window.y) || CHANGED(window.width)
@@ -306,7 +316,8 @@ static void M_HandleConfigChange(const EVENT *const event, void *const data)
         || CHANGED(rendering.enable_wireframe)
         || CHANGED(rendering.wireframe_width)
         || CHANGED(rendering.texture_filter)
-        || CHANGED(rendering.lighting_contrast)) {
+        || CHANGED(rendering.lighting_contrast)
+        || CHANGED(rendering.software_threads)) {
         Render_Reset(RENDER_RESET_PARAMS);
     }
 
@@ -433,12 +444,14 @@ void Shell_Main(void)
 
 void Shell_Shutdown(void)
 {
+    StateTrace_Stop();
     GF_Shutdown();
     GameString_Shutdown();
     Console_Shutdown();
     Render_Shutdown();
     Text_Shutdown();
     UI_Shutdown();
+    Room_Shutdown();
     GameBuf_Shutdown();
     Config_Shutdown();
     EnumMap_Shutdown();
@@ -449,6 +462,11 @@ const char *Shell_GetConfigPath(void)
     return "cfg/TR2X.json5";
 }
 
+bool Shell_IsHeadless(void)
+{
+    return false;
+}
+
 const char *Shell_GetGameFlowPath(void)
 {
     return m_CurrentGameFlowPath;
@@ -474,6 +492,8 @@ bool Shell_IsFullscreen(void)
 // TODO: try to call this function in a single place after introducing phases.
 void Shell_ProcessEvents(void)
 {
+    Audio_Stream_Update();
+
     SDL_Event event;
     while (SDL_PollEvent(&event) != 0) {
         switch (event.type) {
@@ -144,6 +144,8 @@ void Sound_Init(void)
     }
 
     Sound_SetMasterVolume(g_Config.audio.sound_volume);
+    Audio_Sample_SetInterpolation(g_Config.audio.enable_sample_interpolation);
+    Audio_Sample_SetCacheEnabled(g_Config.audio.enable_sample_cache);
     M_ClearAllSlots();
 }
 